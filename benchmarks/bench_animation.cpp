@@ -0,0 +1,84 @@
+#include "bmp/bmp.hpp"
+#include "bmp/io/bmp_io.hpp"
+#include "fractal/animation_renderer.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/palettes.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <omp.h>
+#include <vector>
+
+using namespace iheay::bmp;
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+namespace fs = std::filesystem;
+
+// frame after frame (iterate, colorize, save) vs the AnimationRenderer pipeline,
+// against compute alone, the time the pipeline would take if writes were free
+
+static const int WIDTH = 1920;
+static const int HEIGHT = 1080;
+static const int FRAMES = 30;
+
+int main() {
+    const fs::path directory = fs::temp_directory_path() / "iheay_bench_animation";
+    fs::create_directories(directory);
+
+    const FractalKeyframe start { { 5, Complex::Algebraic(-0.75, 0.0) }, { 300, 2.0 }, Complex::Zero() };
+    const FractalKeyframe end { { 0.001, Complex::Algebraic(-0.74364388703, 0.13182590421) }, { 2000, 2.0 }, Complex::Zero() };
+
+    std::vector<FractalKeyframe> keyframes;
+    for (int i = 0; i < FRAMES; ++i)
+        keyframes.push_back(interpolate(start, end, static_cast<double>(i) / (FRAMES - 1)));
+
+    auto builder = FractalRendererBuilder<palettes::Gray>
+        ::get_builder()
+            .set_initial_func( formulas::Zero{} )
+            .set_param_func( formulas::Identity{} )
+            .set_kernel(Kernel::Simd)
+            .set_cycle_detection(true);
+
+    auto frame_path = [&](int frame) { return (directory / std::format("frame_{:04}.bmp", frame)).string(); };
+
+    std::printf("threads: %d\n", omp_get_max_threads());
+
+    EscapeField field(WIDTH, HEIGHT);
+    double begin = omp_get_wtime();
+    for (const FractalKeyframe& key : keyframes)
+        builder.set_viewport(key.viewport).build().render_field(field);
+    const double compute_time = omp_get_wtime() - begin;
+
+    Bmp image = Bmp::empty(WIDTH, HEIGHT);
+    begin = omp_get_wtime();
+    for (int i = 0; i < FRAMES; ++i) {
+        const auto renderer = builder.set_viewport(keyframes[i].viewport).build();
+        renderer.render_field(field);
+        renderer.colorize(field, image);
+        io::save(image, frame_path(i));
+    }
+    const double sequential_time = omp_get_wtime() - begin;
+
+    AnimationStages stages {
+        [&](const FractalKeyframe& key, EscapeField& frame) {
+            builder.set_viewport(key.viewport).build().render_field(frame);
+        },
+        [](const FractalKeyframe&, const EscapeField& frame, Bmp& output) {
+            colorize(frame, output, palettes::Gray{});
+        },
+        [&](int frame, const Bmp& output) {
+            io::save(output, frame_path(frame));
+        }
+    };
+
+    const AnimationStats stats = AnimationRenderer(WIDTH, HEIGHT, stages).render(keyframes);
+
+    std::printf("%d frames %dx%d  compute only %7.3f s  sequential %7.3f s  pipelined %7.3f s  (x%.2f)\n",
+        FRAMES, WIDTH, HEIGHT, compute_time, sequential_time, stats.total_seconds, sequential_time / stats.total_seconds);
+    std::printf("pipeline stages: compute %7.3f s  colorize %7.3f s  write %7.3f s\n",
+        stats.compute_seconds, stats.colorize_seconds, stats.write_seconds);
+
+    fs::remove_all(directory);
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "fractal/animation_plan.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "bench_common.hpp"
+#include <cstdio>
+#include <omp.h>
+#include <vector>
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+// predicted vs measured frame times of a planned zoom, and interpolate()'s fixed 200 + 50 log2(zoom)
+// budgets against the planned ones; false interior counts pixels a budget leaves bounded
+// that escape before probe_max_iter
+
+static const int WIDTH = 960;
+static const int HEIGHT = 540;
+static const int FRAMES = 20;
+
+static auto make_builder() {
+    return FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_initial_func( formulas::Zero{} )
+            .set_param_func( formulas::Identity{} )
+            .set_kernel(Kernel::Simd)
+            .set_cycle_detection(true);
+}
+
+static void render(const FractalKeyframe& key, EscapeField& field) {
+    make_builder()
+        .set_viewport(key.viewport)
+        .set_max_iter(key.config.max_iter)
+        .build()
+        .render_field(field);
+}
+
+static long false_interior(const EscapeField& field, const EscapeField& reference) {
+    long count = 0;
+    for (size_t i = 0; i < field.mu_data().size(); ++i)
+        count += field.mu_data()[i] >= field.max_iter() && reference.mu_data()[i] < reference.max_iter();
+    return count;
+}
+
+int main() {
+    const FractalKeyframe start { { 5, Complex::Algebraic(-0.75, 0.0) }, { 300, 2.0 }, Complex::Zero() };
+    const FractalKeyframe end { { 1e-6, Complex::Algebraic(-0.74364388703, 0.13182590421) }, { 2000, 2.0 }, Complex::Zero() };
+
+    std::vector<FractalKeyframe> keyframes;
+    for (int i = 0; i < FRAMES; ++i)
+        keyframes.push_back(interpolate(start, end, static_cast<double>(i) / (FRAMES - 1)));
+
+    std::printf("threads: %d\n", omp_get_max_threads());
+
+    const PlanOptions options;
+    double begin = omp_get_wtime();
+    const AnimationPlan plan = plan_animation(keyframes, WIDTH, HEIGHT, render, options);
+    const double plan_time = omp_get_wtime() - begin;
+
+    EscapeField field(WIDTH, HEIGHT);
+    EscapeField reference(WIDTH, HEIGHT);
+
+    double fixed_total = 0.0;
+    double planned_total = 0.0;
+    long fixed_false = 0;
+    long planned_false = 0;
+
+    for (int i = 0; i < FRAMES; ++i) {
+        FractalKeyframe probe = keyframes[i];
+        probe.config.max_iter = options.probe_max_iter;
+        render(probe, reference);
+
+        begin = omp_get_wtime();
+        render(keyframes[i], field);
+        const double fixed_time = omp_get_wtime() - begin;
+        const long fixed_bad = false_interior(field, reference);
+
+        begin = omp_get_wtime();
+        render(plan.frames[i].key, field);
+        const double planned_time = omp_get_wtime() - begin;
+        const long planned_bad = false_interior(field, reference);
+
+        std::printf("frame %2d  width %8.1e  fixed %5d %6.3f s %6ld false  planned %5d %6.3f s (predicted %6.3f) %6ld false\n",
+            i, keyframes[i].viewport.width,
+            keyframes[i].config.max_iter, fixed_time, fixed_bad,
+            plan.frames[i].key.config.max_iter, planned_time, plan.frames[i].seconds, planned_bad);
+
+        fixed_total += fixed_time;
+        planned_total += planned_time;
+        fixed_false += fixed_bad;
+        planned_false += planned_bad;
+    }
+
+    std::printf("plan %.3f s  fixed %.3f s, %ld false interior  planned %.3f s (predicted %.3f), %ld false interior\n",
+        plan_time, fixed_total, fixed_false, planned_total, plan.seconds, planned_false);
+
+    return 0;
+}
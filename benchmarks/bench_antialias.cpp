@@ -0,0 +1,98 @@
+#include "fractal/fractal_renderer_builder.hpp"
+#include "bench_common.hpp"
+#include <cmath>
+#include <cstdio>
+#include <omp.h>
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+// plain render vs edge-adaptive antialiasing vs uniform 4x4 supersampling,
+// error is the RMS distance of mu (clamped to the palette range) to a 4x4 reference
+
+static const int WIDTH = 960;
+static const int HEIGHT = 540;
+static const int FACTOR = 4;
+
+static auto make_renderer(Complex center, double width, int max_iter) {
+    return FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_viewport_center(center)
+            .set_viewport_width(width)
+            .set_max_iter(max_iter)
+            .set_initial_func( formulas::Zero{} )
+            .set_param_func( formulas::Identity{} )
+            .set_kernel(Kernel::Simd)
+            .build();
+}
+
+// box-filters a FACTOR times larger render down to WIDTH x HEIGHT
+static MuImage downsample(const MuImage& large) {
+    MuImage small(WIDTH, HEIGHT);
+
+    for (int y = 0; y < HEIGHT; ++y) {
+        for (int x = 0; x < WIDTH; ++x) {
+            double sum = 0.0;
+            for (int j = 0; j < FACTOR; ++j)
+                for (int i = 0; i < FACTOR; ++i)
+                    sum += large.get_pixel(x * FACTOR + i, y * FACTOR + j);
+            small.set_pixel(x, y, sum / (FACTOR * FACTOR));
+        }
+    }
+    return small;
+}
+
+static double rms_error(const MuImage& a, const MuImage& b) {
+    double sum = 0.0;
+    for (int y = 0; y < HEIGHT; ++y)
+        for (int x = 0; x < WIDTH; ++x)
+            sum += (a.get_pixel(x, y) - b.get_pixel(x, y)) * (a.get_pixel(x, y) - b.get_pixel(x, y));
+    return std::sqrt(sum / (WIDTH * HEIGHT));
+}
+
+int main() {
+    struct Frame {
+        const char* name;
+        Complex center;
+        double width;
+        int max_iter;
+    };
+
+    const Frame frames[] = {
+        { "whole set", -0.75, 3.0, 1000 },
+        { "seahorse 1e-3", Complex::Algebraic(-0.74364388703, 0.13182590421), 1e-3, 2000 },
+    };
+
+    std::printf("threads: %d\n", omp_get_max_threads());
+
+    for (const Frame& frame : frames) {
+        const auto renderer = make_renderer(frame.center, frame.width, frame.max_iter);
+
+        MuImage large(WIDTH * FACTOR, HEIGHT * FACTOR);
+        double start = omp_get_wtime();
+        renderer.render(large);
+        const double uniform_time = omp_get_wtime() - start;
+        const MuImage reference = downsample(large);
+
+        MuImage plain(WIDTH, HEIGHT);
+        start = omp_get_wtime();
+        renderer.render(plain);
+        const double plain_time = omp_get_wtime() - start;
+
+        std::printf("%-14s plain   %7.3f s  rms %7.3f\n", frame.name, plain_time, rms_error(plain, reference));
+        std::printf("%-14s uniform %7.3f s  (reference, %dx%d samples)\n", frame.name, uniform_time, FACTOR, FACTOR);
+
+        for (double budget : { 0.25, 1.0, 4.0 }) {
+            MuImage adaptive(WIDTH, HEIGHT);
+            start = omp_get_wtime();
+            const AntialiasStats stats = renderer.render_antialiased(adaptive, { 2.0, 15, budget });
+            const double adaptive_time = omp_get_wtime() - start;
+
+            std::printf("%-14s budget %4.2f %7.3f s  rms %7.3f  refined %ld of %ld edges (%.1f%% of pixels)\n",
+                frame.name, budget, adaptive_time, rms_error(adaptive, reference),
+                stats.refined, stats.edges, 100.0 * stats.refined / (WIDTH * HEIGHT));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,30 @@
+#pragma once // benchmarks/bench_common.hpp
+
+#include <algorithm>
+#include <vector>
+
+// image storing raw mu values, for benchmarks that time or compare renders without a palette
+
+struct MuColorizer {
+    using pixel_type = double;
+
+    double operator()(double mu, int max_iter) const { return std::min(mu, static_cast<double>(max_iter)); }
+};
+
+class MuImage {
+public:
+    using pixel_type = double;
+
+    MuImage(int width, int height) : m_width(width), m_height(height), m_mu(width * height) {}
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+    void set_pixel(int x, int y, double mu) { m_mu[y * m_width + x] = mu; }
+    double get_pixel(int x, int y) const { return m_mu[y * m_width + x]; }
+
+private:
+    int m_width;
+    int m_height;
+    std::vector<double> m_mu;
+};
@@ -0,0 +1,59 @@
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/iteration_state.hpp"
+#include "bench_common.hpp"
+#include <cstdio>
+#include <omp.h>
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+// "deepen until stable": each pass doubles max_iter, rendered from scratch vs continued from
+// the orbits the previous pass left running; changed counts pixels that escaped in the pass
+
+static const int WIDTH = 960;
+static const int HEIGHT = 540;
+
+int main() {
+    auto builder = FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_viewport_center(Complex::Algebraic(-0.74364388703, 0.13182590421))
+            .set_viewport_width(1e-4)
+            .set_initial_func( formulas::Zero{} )
+            .set_param_func( formulas::Identity{} )
+            .set_kernel(Kernel::Simd)
+            .set_precision(Precision::Double)
+            .set_cycle_detection(true);
+
+    std::printf("threads: %d\n", omp_get_max_threads());
+
+    EscapeField fresh(WIDTH, HEIGHT);
+    EscapeField deepened(WIDTH, HEIGHT);
+    IterationState state;
+
+    double fresh_total = 0.0;
+    double resumed_total = 0.0;
+
+    for (int max_iter = 250; max_iter <= 32000; max_iter *= 2) {
+        const auto renderer = builder.set_max_iter(max_iter).build();
+
+        double start = omp_get_wtime();
+        renderer.render_field(fresh);
+        const double fresh_time = omp_get_wtime() - start;
+
+        const long running = state.running();
+        start = omp_get_wtime();
+        const ResumeStats stats = renderer.render_field(deepened, state);
+        const double resumed_time = omp_get_wtime() - start;
+
+        fresh_total += fresh_time;
+        resumed_total += resumed_time;
+
+        std::printf("max_iter %5d  fresh %7.3f s  resumed %7.3f s  (%7ld orbits, %6ld changed, %6ld running, %5zu KiB)\n",
+            max_iter, fresh_time, resumed_time, stats.iterated,
+            stats.resumed ? running - stats.running : 0L, stats.running, state.bytes() / 1024);
+    }
+
+    std::printf("total: fresh %.3f s  resumed %.3f s  (x%.2f)\n", fresh_total, resumed_total, fresh_total / resumed_total);
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "fractal/fractal_renderer_builder.hpp"
+#include "bench_common.hpp"
+#include <cmath>
+#include <cstdio>
+#include <omp.h>
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+// distance estimation with every pixel iterated vs exterior disks skipped,
+// differing counts pixels whose one pixel boundary line changes between the two
+
+struct BoundaryColorizer {
+    using pixel_type = double;
+
+    double operator()(double distance) const { return distance < 1.0 ? 1.0 : 0.0; }
+};
+
+static const int WIDTH = 1920;
+static const int HEIGHT = 1080;
+
+static int differing(const MuImage& a, const MuImage& b) {
+    int count = 0;
+    for (int y = 0; y < HEIGHT; ++y)
+        for (int x = 0; x < WIDTH; ++x)
+            count += a.get_pixel(x, y) != b.get_pixel(x, y);
+    return count;
+}
+
+int main() {
+    struct Frame {
+        const char* name;
+        Complex center;
+        double width;
+        int max_iter;
+    };
+
+    const Frame frames[] = {
+        { "whole set", -0.75, 3.0, 100 },
+        { "whole set", -0.75, 3.0, 1000 },
+        { "seahorse 1e-3", Complex::Algebraic(-0.74364388703, 0.13182590421), 1e-3, 2000 },
+    };
+
+    std::printf("threads: %d\n", omp_get_max_threads());
+
+    for (const Frame& frame : frames) {
+        const auto renderer = FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_viewport_center(frame.center)
+                .set_viewport_width(frame.width)
+                .set_max_iter(frame.max_iter)
+                .set_initial_func( formulas::Zero{} )
+                .set_param_func( formulas::Identity{} )
+                .build();
+
+        MuImage mu(WIDTH, HEIGHT);
+        double start = omp_get_wtime();
+        renderer.render(mu);
+        const double mu_time = omp_get_wtime() - start;
+
+        MuImage full(WIDTH, HEIGHT);
+        start = omp_get_wtime();
+        renderer.render_distance(full, BoundaryColorizer{}, { 0.0 });
+        const double full_time = omp_get_wtime() - start;
+
+        MuImage fast(WIDTH, HEIGHT);
+        start = omp_get_wtime();
+        const DistanceStats stats = renderer.render_distance(fast, BoundaryColorizer{}, { 4.0 });
+        const double fast_time = omp_get_wtime() - start;
+
+        std::printf("%-14s max_iter %5d  mu %7.3f s  distance %7.3f s  skipping %7.3f s  (%.1f%% skipped, %d differing)\n",
+            frame.name, frame.max_iter, mu_time, full_time, fast_time,
+            100.0 * stats.skipped / (WIDTH * HEIGHT), differing(full, fast));
+    }
+
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include "fractal/fractal_renderer_builder.hpp"
+#include "bench_common.hpp"
+#include <cmath>
+#include <cstdio>
+#include <omp.h>
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+// compares throughput of the double and double-double paths on the same region
+
+// sum of the pixels' iteration counts, what the Giter/s figure divides by
+static double iterations(const MuImage& image, int max_iter) {
+    double total = 0;
+    for (int y = 0; y < image.height(); ++y)
+        for (int x = 0; x < image.width(); ++x)
+            total += std::min(std::max(image.get_pixel(x, y), 0.0), static_cast<double>(max_iter));
+    return total;
+}
+
+static void run(const char* name, Precision precision, int repeats) {
+    const int width = 800;
+    const int height = 600;
+    const int max_iter = 1000;
+
+    auto renderer =
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_viewport_center({-0.743643887037, 0.131825904205})
+                .set_viewport_width(1e-4)
+                .set_max_iter(max_iter)
+                .set_initial_func( formulas::Zero{} )
+                .set_param_func( formulas::Identity{} )
+                .set_precision(precision)
+                .build();
+
+    MuImage image(width, height);
+    renderer.render(image); // warm up
+
+    double start = omp_get_wtime();
+    for (int i = 0; i < repeats; ++i)
+        renderer.render(image);
+    double seconds = (omp_get_wtime() - start) / repeats;
+
+    double pixels = static_cast<double>(width) * height;
+
+    std::printf("%-14s %8.3f s  %8.2f Mpixel/s  %6.3f Giter/s\n",
+        name, seconds, pixels / seconds * 1e-6, iterations(image, max_iter) / seconds * 1e-9);
+}
+
+int main() {
+    std::printf("threads: %d\n", omp_get_max_threads());
+
+    run("double", Precision::Double, 5);
+    run("double-double", Precision::DoubleDouble, 5);
+
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/incremental_renderer.hpp"
+#include "bench_common.hpp"
+#include <cstdio>
+#include <omp.h>
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+// cost of a pan / resize step at 4K compared with a full frame
+
+int main() {
+    const int width = 3840;
+    const int height = 2160;
+    const Viewport viewport { 3e-3, Complex::Algebraic(-0.7436447860, 0.1318252536) };
+
+    IncrementalRenderer view(
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_viewport(viewport)
+                .set_max_iter(2000)
+                .set_initial_func( formulas::Zero{} )
+                .set_param_func( formulas::Identity{} )
+                .set_kernel( Kernel::Simd )
+                .build(),
+        viewport
+    );
+
+    std::printf("threads: %d\n", omp_get_max_threads());
+
+    double start = omp_get_wtime();
+    view.resize(width, height);
+    const double full = omp_get_wtime() - start;
+    std::printf("full frame     %8.3f s\n", full);
+
+    struct Step {
+        const char* name;
+        int dx;
+        int dy;
+    };
+
+    for (const Step& step : { Step { "pan 16 px", 16, 0 }, Step { "pan 64x32 px", -64, 32 } }) {
+        start = omp_get_wtime();
+        view.pan(step.dx, step.dy);
+        const double seconds = omp_get_wtime() - start;
+
+        std::printf("%-14s %8.3f s  %5.1f%% of full, %ld computed, %ld copied\n",
+            step.name, seconds, 100.0 * seconds / full,
+            view.last_stats().computed, view.last_stats().copied);
+    }
+
+    start = omp_get_wtime();
+    view.resize(width + 64, height + 36);
+    const double grow = omp_get_wtime() - start;
+    std::printf("grow 64x36     %8.3f s  %5.1f%% of full\n", grow, 100.0 * grow / full);
+
+    return 0;
+}
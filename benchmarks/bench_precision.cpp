@@ -0,0 +1,86 @@
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/precision_selector.hpp"
+#include "bench_common.hpp"
+#include <cmath>
+#include <cstdio>
+#include <omp.h>
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+// double vs float vector kernel on shallow views, and what Precision::Auto makes of them;
+// differing counts pixels whose mu moves by more than 0.02 (an 8-bit step of a steep palette)
+
+static const int WIDTH = 1920;
+static const int HEIGHT = 1080;
+static const int RUNS = 3;
+
+static const char* precision_name(Precision precision) {
+    switch (precision) {
+        case Precision::Float:  return "float";
+        case Precision::Double: return "double";
+        default:                return "other";
+    }
+}
+
+static double best_time(const auto& renderer, MuImage& image) {
+    double best = 1e30;
+    for (int run = 0; run < RUNS; ++run) {
+        const double start = omp_get_wtime();
+        renderer.render(image);
+        best = std::min(best, omp_get_wtime() - start);
+    }
+    return best;
+}
+
+static int differing(const MuImage& a, const MuImage& b) {
+    int count = 0;
+    for (int y = 0; y < HEIGHT; ++y)
+        for (int x = 0; x < WIDTH; ++x)
+            count += std::abs(a.get_pixel(x, y) - b.get_pixel(x, y)) > 0.02;
+    return count;
+}
+
+int main() {
+    struct Frame {
+        const char* name;
+        Complex center;
+        double width;
+        int max_iter;
+    };
+
+    const Frame frames[] = {
+        { "whole set", -0.75, 3.0, 300 },
+        { "whole set", -0.75, 3.0, 5000 },
+        { "bulbs", Complex::Algebraic(-0.9, 0.25), 1.2, 3000 },
+        { "valley", Complex::Algebraic(-0.75, 0.1), 0.5, 500 },
+    };
+
+    std::printf("threads: %d\n", omp_get_max_threads());
+
+    for (const Frame& frame : frames) {
+        auto builder = FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_viewport_center(frame.center)
+                .set_viewport_width(frame.width)
+                .set_max_iter(frame.max_iter)
+                .set_initial_func( formulas::Zero{} )
+                .set_param_func( formulas::Identity{} )
+                .set_kernel(Kernel::Simd);
+
+        MuImage reference(WIDTH, HEIGHT);
+        MuImage single(WIDTH, HEIGHT);
+
+        const double double_time = best_time(builder.set_precision(Precision::Double).build(), reference);
+        const double float_time = best_time(builder.set_precision(Precision::Float).build(), single);
+
+        const Viewport viewport { frame.width, frame.center };
+        const Precision automatic = select_precision(viewport, frame.width / (WIDTH - 1), frame.max_iter);
+
+        std::printf("%-10s max_iter %5d  double %7.3f s  float %7.3f s  (x%.2f, %d differing)  auto: %s\n",
+            frame.name, frame.max_iter, double_time, float_time, double_time / float_time,
+            differing(reference, single), precision_name(automatic));
+    }
+
+    return 0;
+}
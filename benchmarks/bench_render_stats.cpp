@@ -0,0 +1,57 @@
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/render_stats.hpp"
+#include "bench_common.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <omp.h>
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+// cost of RenderStats: full-HD frames rendered plain and with stats, best of several runs each,
+// on the cheapest paths per pixel, where the counting weighs the most
+
+static const int RUNS = 15;
+
+// plain and counted runs alternate, so drifting clocks and neighbours hit both alike
+template <typename Builder>
+static void compare(const char* name, const Builder& builder) {
+    const auto renderer = builder.build();
+
+    MuImage image(1920, 1080);
+    RenderStats stats;
+    double plain = 1e300;
+    double counted = 1e300;
+
+    for (int run = 0; run < RUNS; ++run) {
+        double start = omp_get_wtime();
+        renderer.render(image);
+        plain = std::min(plain, omp_get_wtime() - start);
+
+        start = omp_get_wtime();
+        renderer.render(image, stats);
+        counted = std::min(counted, omp_get_wtime() - start);
+    }
+
+    std::printf("%-26s plain %7.4f s  with stats %7.4f s  overhead %+6.2f%%  utilization %5.1f%%\n",
+        name, plain, counted, 100.0 * (counted / plain - 1.0), 100.0 * stats.utilization());
+}
+
+int main() {
+    auto mandelbrot = FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_viewport({ 3.0, Complex::Algebraic(-0.75, 0.0) })
+            .set_max_iter(1000)
+            .set_initial_func( formulas::Zero{} )
+            .set_param_func( formulas::Identity{} );
+
+    std::printf("threads: %d, stats %s\n", omp_get_max_threads(), render_stats_enabled ? "enabled" : "compiled out");
+
+    compare("whole set, scalar", mandelbrot);
+    compare("whole set, simd", mandelbrot.set_kernel(Kernel::Simd));
+    compare("whole set, simd + cycles", mandelbrot.set_cycle_detection(true));
+    compare("whole set, work stealing", mandelbrot.set_schedule(Schedule::WorkStealing));
+    compare("whole set, simd float", mandelbrot.set_schedule(Schedule::Static).set_cycle_detection(false).set_precision(Precision::Float));
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "fractal/fractal_renderer_builder.hpp"
+#include "utils/thread_pool.hpp"
+#include "bench_common.hpp"
+#include <cstdio>
+#include <memory>
+#include <omp.h>
+#include <vector>
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+// static OpenMP rows vs work-stealing tiles for 1..N threads on a frame with uneven cost
+
+static double seconds_for(Schedule schedule, Kernel kernel, int threads) {
+    omp_set_num_threads(threads);
+
+    auto renderer =
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_viewport_center(Complex::Algebraic(-0.16, 1.035))
+                .set_viewport_width(0.1)
+                .set_max_iter(3000)
+                .set_initial_func( formulas::Zero{} )
+                .set_param_func( formulas::Identity{} )
+                .set_kernel(kernel)
+                .set_schedule(schedule)
+                .set_thread_pool(std::make_shared<iheay::utils::WorkStealingPool>(threads))
+                .build();
+
+    MuImage image(1280, 720);
+    renderer.render(image); // warm up, pool threads are already running
+
+    double start = omp_get_wtime();
+    renderer.render(image);
+    return omp_get_wtime() - start;
+}
+
+int main() {
+    const int max_threads = omp_get_max_threads();
+
+    std::vector<int> counts;
+    for (int n = 1; n < max_threads; n *= 2)
+        counts.push_back(n);
+    counts.push_back(max_threads);
+
+    for (Kernel kernel : { Kernel::Scalar, Kernel::Simd }) {
+        std::printf("%s kernel\n", kernel == Kernel::Simd ? "simd" : "scalar");
+
+        double static_one = 0;
+        double stealing_one = 0;
+
+        for (int n : counts) {
+            double static_time = seconds_for(Schedule::Static, kernel, n);
+            double stealing_time = seconds_for(Schedule::WorkStealing, kernel, n);
+
+            if (n == 1) {
+                static_one = static_time;
+                stealing_one = stealing_time;
+            }
+
+            std::printf("  %3d threads  static %7.3f s (eff %5.1f%%)  work-stealing %7.3f s (eff %5.1f%%)\n",
+                n,
+                static_time, 100.0 * static_one / (static_time * n),
+                stealing_time, 100.0 * stealing_one / (stealing_time * n));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "fractal/fractal_renderer_builder.hpp"
+#include "bench_common.hpp"
+#include <cstdio>
+#include <omp.h>
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+// per-pixel vs Mariani–Silver subdivision on full-HD zoom frames
+
+static double seconds_for(Strategy strategy, Complex center, double width, int max_iter) {
+    auto renderer =
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_viewport_center(center)
+                .set_viewport_width(width)
+                .set_max_iter(max_iter)
+                .set_initial_func( formulas::Zero{} )
+                .set_param_func( formulas::Identity{} )
+                .set_strategy(strategy)
+                .build();
+
+    MuImage image(1920, 1080);
+
+    double start = omp_get_wtime();
+    renderer.render(image);
+    return omp_get_wtime() - start;
+}
+
+int main() {
+    struct Frame {
+        const char* name;
+        Complex center;
+        double width;
+        int max_iter;
+    };
+
+    const Frame frames[] = {
+        { "whole set", -0.75, 3.0, 1000 },
+        { "seahorse 1e-3", Complex::Algebraic(-0.7436447860, 0.1318252536), 1e-3, 2000 },
+        { "seahorse 3e-5", Complex::Algebraic(-0.7436447860, 0.1318252536), 3e-5, 5000 },
+    };
+
+    std::printf("threads: %d\n", omp_get_max_threads());
+
+    for (const Frame& frame : frames) {
+        double per_pixel = seconds_for(Strategy::PerPixel, frame.center, frame.width, frame.max_iter);
+        double subdivided = seconds_for(Strategy::Subdivision, frame.center, frame.width, frame.max_iter);
+
+        std::printf("%-16s per-pixel %7.3f s  subdivision %7.3f s  speedup %5.2fx\n",
+            frame.name, per_pixel, subdivided, per_pixel / subdivided);
+    }
+
+    return 0;
+}
@@ -0,0 +1,173 @@
+#include "fractal/cached_renderer.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/palettes.hpp"
+#include "fractal/tile_server.hpp"
+#include "bench_common.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <omp.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace iheay::bmp;
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+// load generator for the tile server: viewer clients pan across the seahorse valley side by side,
+// each step asks for the visible tiles of its window and a ring of prefetch around it, then reads
+// every answer; latency is from sending a request to having its whole tile. with no argument the
+// server runs in this process, bench_tile_server SOCKET_PATH measures a running iheay_tile_server
+
+static const int TILE_SIZE = 256;
+static const int LEVEL = 5;
+static const int CLIENTS = 4;
+static const int STEPS = 12;
+static const int COLUMNS = 4; // visible window in tiles
+static const int ROWS = 3;
+static const int RING = 1;    // prefetch tiles around it
+
+static const Complex SEAHORSE = Complex::Algebraic(-0.74364388703, 0.13182590421);
+
+struct Latencies {
+    std::mutex mutex;
+    std::vector<double> visible;
+    std::vector<double> prefetch;
+    long errors = 0;
+};
+
+// one viewer: start tile, then a tile to the right per step
+static void viewer(const std::string& socket_path, int64_t tx0, int64_t ty0, Latencies& latencies) {
+    TileClient client(socket_path);
+
+    std::vector<double> visible, prefetch;
+    long errors = 0;
+
+    uint64_t next_id = 0;
+    for (int step = 0; step < STEPS; ++step) {
+        const int64_t left = tx0 + step;
+
+        std::unordered_map<uint64_t, std::pair<double, bool>> sent; // id -> send time, prefetch
+        auto request = [&](int64_t tx, int64_t ty, bool is_prefetch) {
+            const uint64_t id = next_id++;
+            sent[id] = { omp_get_wtime(), is_prefetch };
+            client.send({ id, is_prefetch, "mandelbrot", "fire", LEVEL, tx, ty });
+        };
+
+        for (int64_t ty = ty0; ty < ty0 + ROWS; ++ty)
+            for (int64_t tx = left; tx < left + COLUMNS; ++tx)
+                request(tx, ty, false);
+
+        for (int64_t ty = ty0 - RING; ty < ty0 + ROWS + RING; ++ty)
+            for (int64_t tx = left - RING; tx < left + COLUMNS + RING; ++tx)
+                if (ty < ty0 || ty >= ty0 + ROWS || tx < left || tx >= left + COLUMNS)
+                    request(tx, ty, true);
+
+        for (size_t i = 0; i < sent.size(); ++i) {
+            const TileResponse response = client.receive();
+            const auto [time, is_prefetch] = sent.at(response.id);
+            const double latency = omp_get_wtime() - time;
+
+            if (!response.error.empty())
+                ++errors;
+            else
+                (is_prefetch ? prefetch : visible).push_back(latency);
+        }
+    }
+
+    std::lock_guard lock(latencies.mutex);
+    latencies.visible.insert(latencies.visible.end(), visible.begin(), visible.end());
+    latencies.prefetch.insert(latencies.prefetch.end(), prefetch.begin(), prefetch.end());
+    latencies.errors += errors;
+}
+
+// asks for a far-away ring of prefetch and leaves without reading it
+static void impatient(const std::string& socket_path, int64_t tx0, int64_t ty0) {
+    for (int step = 0; step < STEPS; ++step) {
+        TileClient client(socket_path);
+        uint64_t id = 0;
+        for (int64_t ty = ty0 - 4; ty < ty0; ++ty)
+            for (int64_t tx = tx0 + 8 * step; tx < tx0 + 8 * step + 8; ++tx)
+                client.send({ id++, true, "mandelbrot", "fire", LEVEL, tx, ty });
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+static double percentile(std::vector<double> values, double p) {
+    if (values.empty())
+        return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(p * (values.size() - 1))];
+}
+
+static void print_latencies(const char* name, const std::vector<double>& values) {
+    std::printf("%-9s %6zu tiles   p50 %8.2f ms   p99 %8.2f ms   max %8.2f ms\n", name, values.size(),
+        1e3 * percentile(values, 0.5), 1e3 * percentile(values, 0.99), 1e3 * percentile(values, 1.0));
+}
+
+int main(int argc, char** argv) {
+    std::unique_ptr<TileServer> server;
+    std::string socket_path;
+
+    if (argc > 1) {
+        socket_path = argv[1];
+    } else {
+        socket_path = (std::filesystem::temp_directory_path() / "iheay_bench_tiles.sock").string();
+
+        TileServerOptions options;
+        options.tile_size = TILE_SIZE;
+        options.workers = std::max(1u, std::thread::hardware_concurrency());
+
+        server = std::make_unique<TileServer>(socket_path, options);
+        server->add_formula("mandelbrot", FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_max_iter(1000)
+                .set_initial_func( formulas::Zero{} )
+                .set_param_func( formulas::Identity{} )
+                .set_kernel(Kernel::Simd)
+                .set_cycle_detection(true)
+                .build());
+        server->add_palette("fire", palettes::fire);
+        server->start();
+    }
+
+    // tile under the seahorse, the windows start a little left and above it
+    const double tile_extent = std::ldexp(cached_root_extent, -LEVEL);
+    const int64_t tx0 = static_cast<int64_t>(std::floor(SEAHORSE.real() / tile_extent)) - COLUMNS / 2;
+    const int64_t ty0 = static_cast<int64_t>(std::floor(-SEAHORSE.imag() / tile_extent)) - ROWS / 2;
+
+    std::printf("%d viewers, %d steps of %dx%d visible + ring of %d, %dx%d tiles at level %d\n",
+        CLIENTS, STEPS, COLUMNS, ROWS, RING, TILE_SIZE, TILE_SIZE, LEVEL);
+
+    Latencies latencies;
+    const double begin = omp_get_wtime();
+
+    // viewers one or two tiles apart overlap most of their windows
+    std::vector<std::thread> threads;
+    for (int c = 0; c < CLIENTS; ++c)
+        threads.emplace_back(viewer, socket_path, tx0 + c / 2, ty0 + c % 2, std::ref(latencies));
+    threads.emplace_back(impatient, socket_path, tx0, ty0);
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    const double seconds = omp_get_wtime() - begin;
+
+    print_latencies("visible", latencies.visible);
+    print_latencies("prefetch", latencies.prefetch);
+    std::printf("%.2f s, %.1f tiles/s served, %ld errors\n", seconds,
+        (latencies.visible.size() + latencies.prefetch.size()) / seconds, latencies.errors);
+
+    if (server) {
+        const TileServerStats stats = server->stats();
+        std::printf("server: %ld requests, %ld cache hits, %ld coalesced, %ld rendered, %ld dropped, %ld refused\n",
+            stats.requests, stats.cache_hits, stats.coalesced, stats.rendered, stats.dropped, stats.refused);
+    }
+
+    return 0;
+}
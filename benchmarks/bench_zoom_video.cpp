@@ -0,0 +1,63 @@
+#include "bmp/bmp.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/zoom_video.hpp"
+#include "fractal/palettes.hpp"
+#include <cstdio>
+#include <omp.h>
+#include <vector>
+
+using namespace iheay::bmp;
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+// center zoom rendered frame by frame vs resampled from one exponential map strip;
+// differing counts pixels whose gray level moves by more than 8 between the two
+
+static const int WIDTH = 960;
+static const int HEIGHT = 540;
+static const int FRAMES = 300;
+
+int main() {
+    const Complex center = Complex::Algebraic(-0.74364388703, 0.13182590421);
+    const FractalKeyframe start { { 5, center }, { 300, 2.0 }, Complex::Zero() };
+    const FractalKeyframe end { { 0.001, center }, { 2000, 2.0 }, Complex::Zero() };
+
+    const auto builder = FractalRendererBuilder<palettes::Gray>
+        ::get_builder()
+            .set_initial_func( formulas::Zero{} )
+            .set_param_func( formulas::Identity{} )
+            .set_kernel(Kernel::Simd)
+            .set_precision(Precision::Double);
+
+    std::printf("threads: %d\n", omp_get_max_threads());
+
+    // every frame iterated on its own, kept for the comparison
+    std::vector<Bmp> direct;
+    double begin = omp_get_wtime();
+    for (int i = 0; i < FRAMES; ++i) {
+        FractalKeyframe key = interpolate(start, end, static_cast<double>(i) / (FRAMES - 1));
+        Bmp image = Bmp::empty(WIDTH, HEIGHT);
+        auto frame_builder = builder;
+        frame_builder.set_viewport(key.viewport).set_max_iter(key.config.max_iter).build().render(image);
+        direct.push_back(std::move(image));
+    }
+    const double direct_time = omp_get_wtime() - begin;
+
+    for (double oversample : { 1.0, 0.5 }) {
+        long differing = 0;
+
+        const ZoomVideoStats stats = render_zoom_video(builder, start, end, { WIDTH, HEIGHT, FRAMES, oversample, 2 },
+            [&](int frame, const Bmp& image) {
+                for (size_t p = 0; p < image.pixels().size(); ++p)
+                    differing += std::abs(image.pixels()[p].g - direct[frame].pixels()[p].g) > 8;
+            });
+
+        std::printf("%d frames %dx%d  per frame %7.3f s  exp map (oversample %.1f) %7.3f s, strip %7.3f s  (x%.1f, %.2f%% differing)\n",
+            FRAMES, WIDTH, HEIGHT, direct_time, oversample, stats.animation.total_seconds, stats.strip_seconds,
+            direct_time / stats.animation.total_seconds, 100.0 * differing / (static_cast<double>(FRAMES) * WIDTH * HEIGHT));
+        std::printf("  strip %dx%ld, %.2f samples per frame pixel\n", stats.strip_width, stats.strip_rows,
+            static_cast<double>(stats.samples) / FRAMES / WIDTH / HEIGHT);
+    }
+
+    return 0;
+}
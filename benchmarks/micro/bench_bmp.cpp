@@ -0,0 +1,56 @@
+#include "bmp/bmp.hpp"
+#include "bmp/io/bmp_io.hpp"
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <string>
+
+using namespace iheay::bmp;
+
+// bmp::io round trips through the temp directory, bytes are the pixel data written or read;
+// a second run of load reads from the page cache, so it measures parsing rather than the disk
+
+static std::string bench_path(int width, int height) {
+    return (std::filesystem::temp_directory_path() / ("iheay_bench_" + std::to_string(width) + "x" + std::to_string(height) + ".bmp")).string();
+}
+
+static Bmp gradient(int width, int height) {
+    Bmp image = Bmp::empty(width, height);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            image.set_pixel(x, y, { static_cast<uint8_t>(x), static_cast<uint8_t>(y), static_cast<uint8_t>(x ^ y) });
+    return image;
+}
+
+static void BM_BmpSave(benchmark::State& state) {
+    const int width = static_cast<int>(state.range(0));
+    const int height = static_cast<int>(state.range(1));
+    const Bmp image = gradient(width, height);
+    const std::string path = bench_path(width, height);
+
+    for (auto _ : state)
+        io::save(image, path);
+
+    std::filesystem::remove(path);
+    state.SetBytesProcessed(state.iterations() * width * height * 3);
+}
+
+static void BM_BmpLoad(benchmark::State& state) {
+    const int width = static_cast<int>(state.range(0));
+    const int height = static_cast<int>(state.range(1));
+    const std::string path = bench_path(width, height);
+    io::save(gradient(width, height), path);
+
+    for (auto _ : state) {
+        Bmp image = io::load(path);
+        benchmark::DoNotOptimize(image.pixels().data());
+    }
+
+    std::filesystem::remove(path);
+    state.SetBytesProcessed(state.iterations() * width * height * 3);
+}
+
+// odd widths exercise the row padding
+#define BMP_SIZES ->Args({ 256, 256 })->Args({ 641, 480 })->Args({ 1920, 1080 })->Args({ 3840, 2160 })->Unit(benchmark::kMillisecond)
+
+BENCHMARK(BM_BmpSave) BMP_SIZES;
+BENCHMARK(BM_BmpLoad) BMP_SIZES;
@@ -0,0 +1,118 @@
+#include "bmp/bmp.hpp"
+#include "fractal/escape_field.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/palettes.hpp"
+#include "bench_common.hpp"
+#include <benchmark/benchmark.h>
+
+using namespace iheay::bmp;
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+// the escape-time loop through render_field, per formula and per precision / kernel it supports;
+// items are pixels, "iterations" the loop iterations a frame costs (interior pixels at max_iter)
+
+static const int WIDTH = 160;
+static const int HEIGHT = 90;
+static const int MAX_ITER = 1000;
+
+// seahorse valley, a mix of fast escapes, slow escapes and interior
+static const Viewport MANDELBROT_VIEW { 0.02, Complex::Algebraic(-0.7436, 0.1318) };
+static const Viewport JULIA_VIEW { 3.2, Complex::Zero() };
+static const Complex JULIA_C = Complex::Algebraic(-0.8, 0.156);
+
+static auto mandelbrot() {
+    return FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_viewport(MANDELBROT_VIEW)
+            .set_max_iter(MAX_ITER)
+            .set_initial_func( formulas::Zero{} )
+            .set_param_func( formulas::Identity{} );
+}
+
+static auto julia() {
+    return FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_viewport(JULIA_VIEW)
+            .set_max_iter(MAX_ITER)
+            .set_param_func( formulas::Constant{ JULIA_C } );
+}
+
+// custom iteration functor, the generic scalar loop
+static auto cubic() {
+    return FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_viewport(JULIA_VIEW)
+            .set_max_iter(MAX_ITER)
+            .set_initial_func( formulas::Zero{} )
+            .set_param_func( formulas::Identity{} )
+            .set_iteration_func([](const Complex& z, const Complex& c) { return z * z * z + c; });
+}
+
+// the std::function fallback of formulas known only at runtime
+static auto erased() {
+    return FractalRendererBuilder<MuColorizer>(mandelbrot());
+}
+
+static double frame_iterations(const EscapeField& field) {
+    double total = 0.0;
+    for (double mu : field.mu_data())
+        total += std::min(mu, static_cast<double>(field.max_iter()));
+    return total;
+}
+
+template <typename Builder>
+static void BM_RenderField(benchmark::State& state, Builder builder) {
+    const auto renderer = builder.build();
+    EscapeField field(WIDTH, HEIGHT);
+
+    for (auto _ : state) {
+        renderer.render_field(field);
+        benchmark::DoNotOptimize(field.mu_data().data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * WIDTH * HEIGHT);
+    state.counters["iterations"] = benchmark::Counter(frame_iterations(field) * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+#define RENDER_BENCHMARK(name, builder) \
+    BENCHMARK_CAPTURE(BM_RenderField, name, builder)->Unit(benchmark::kMillisecond)
+
+RENDER_BENCHMARK(mandelbrot_scalar_double,        mandelbrot().set_precision(Precision::Double));
+RENDER_BENCHMARK(mandelbrot_simd_double,          mandelbrot().set_kernel(Kernel::Simd).set_precision(Precision::Double));
+RENDER_BENCHMARK(mandelbrot_simd_float,           mandelbrot().set_kernel(Kernel::Simd).set_precision(Precision::Float));
+RENDER_BENCHMARK(mandelbrot_scalar_double_double, mandelbrot().set_precision(Precision::DoubleDouble));
+RENDER_BENCHMARK(mandelbrot_perturbation,         mandelbrot().set_precision(Precision::Perturbation));
+RENDER_BENCHMARK(mandelbrot_simd_cycle_detection, mandelbrot().set_kernel(Kernel::Simd).set_cycle_detection(true));
+RENDER_BENCHMARK(mandelbrot_subdivision,          mandelbrot().set_precision(Precision::Double).set_strategy(Strategy::Subdivision));
+
+RENDER_BENCHMARK(julia_scalar_double,             julia().set_precision(Precision::Double));
+RENDER_BENCHMARK(julia_simd_double,               julia().set_kernel(Kernel::Simd).set_precision(Precision::Double));
+RENDER_BENCHMARK(julia_simd_float,                julia().set_kernel(Kernel::Simd).set_precision(Precision::Float));
+RENDER_BENCHMARK(julia_scalar_double_double,      julia().set_precision(Precision::DoubleDouble));
+RENDER_BENCHMARK(julia_perturbation,              julia().set_precision(Precision::Perturbation));
+
+RENDER_BENCHMARK(cubic_scalar_double,             cubic().set_precision(Precision::Double));
+RENDER_BENCHMARK(erased_scalar_double,            erased().set_precision(Precision::Double));
+
+// colorizers over a finished 1080p field, items are pixels
+
+template <typename Colorizer>
+static void BM_Colorize(benchmark::State& state) {
+    EscapeField field(1920, 1080);
+    mandelbrot().set_kernel(Kernel::Simd).set_cycle_detection(true).build().render_field(field);
+
+    Bmp image = Bmp::empty(field.width(), field.height());
+
+    for (auto _ : state) {
+        colorize(field, image, Colorizer {});
+        benchmark::DoNotOptimize(image.pixels().data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * field.width() * field.height());
+}
+
+BENCHMARK_TEMPLATE(BM_Colorize, palettes::Fire)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Colorize, palettes::Gray)->Unit(benchmark::kMillisecond);
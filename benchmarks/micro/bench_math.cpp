@@ -0,0 +1,135 @@
+#include "math/complex.hpp"
+#include "math/quaternion.hpp"
+#include "math/ray.hpp"
+#include "math/vec3.hpp"
+#include "ray_tracing/objects/sphere.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using namespace iheay::math;
+using namespace iheay::ray_tracing;
+
+// math and ray tracing primitives over batches of inputs, items are operations
+
+static const int BATCH = 1024;
+
+static std::vector<Complex> complex_batch() {
+    std::vector<Complex> values;
+    for (int i = 0; i < BATCH; ++i)
+        values.push_back(Complex::Algebraic(0.5 + 0.001 * i, -0.25 + 0.002 * i));
+    return values;
+}
+
+template <typename Op>
+static void complex_binary(benchmark::State& state, Op op) {
+    const std::vector<Complex> a = complex_batch();
+    std::vector<Complex> b = complex_batch();
+    std::reverse(b.begin(), b.end());
+
+    for (auto _ : state) {
+        for (int i = 0; i < BATCH; ++i) {
+            Complex result = op(a[i], b[i]);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * BATCH);
+}
+
+static void BM_ComplexAdd(benchmark::State& state) {
+    complex_binary(state, [](const Complex& x, const Complex& y) { return x + y; });
+}
+
+static void BM_ComplexMultiply(benchmark::State& state) {
+    complex_binary(state, [](const Complex& x, const Complex& y) { return x * y; });
+}
+
+static void BM_ComplexDivide(benchmark::State& state) {
+    complex_binary(state, [](const Complex& x, const Complex& y) { return x / y; });
+}
+
+// z^2 + c, the operation the escape-time loop is made of
+static void BM_ComplexSquareAdd(benchmark::State& state) {
+    complex_binary(state, [](const Complex& z, const Complex& c) { return z * z + c; });
+}
+
+BENCHMARK(BM_ComplexAdd);
+BENCHMARK(BM_ComplexMultiply);
+BENCHMARK(BM_ComplexDivide);
+BENCHMARK(BM_ComplexSquareAdd);
+
+static void BM_ComplexPow(benchmark::State& state) {
+    const std::vector<Complex> values = complex_batch();
+    const int n = static_cast<int>(state.range(0));
+
+    for (auto _ : state) {
+        for (const Complex& value : values) {
+            Complex result = value.pow(n);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * BATCH);
+}
+
+BENCHMARK(BM_ComplexPow)->Arg(2)->Arg(5)->Arg(17)->Arg(-3);
+
+static void BM_ComplexTakeRoots(benchmark::State& state) {
+    const std::vector<Complex> values = complex_batch();
+    const int n = static_cast<int>(state.range(0));
+
+    for (auto _ : state) {
+        for (const Complex& value : values) {
+            std::vector<Complex> roots = value.take_roots(n);
+            benchmark::DoNotOptimize(roots.data());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * BATCH);
+}
+
+BENCHMARK(BM_ComplexTakeRoots)->Arg(2)->Arg(3)->Arg(8);
+
+static void BM_QuaternionRotatePoint(benchmark::State& state) {
+    std::vector<Vec3> points;
+    for (int i = 0; i < BATCH; ++i)
+        points.emplace_back(0.1 * i, 1.0 - 0.001 * i, 0.5);
+
+    const Vec3 axis(1.0, 2.0, 3.0);
+
+    for (auto _ : state) {
+        for (const Vec3& point : points) {
+            Vec3 rotated = Quaternion::rotate_point(point, axis, 0.7);
+            benchmark::DoNotOptimize(rotated);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * BATCH);
+}
+
+BENCHMARK(BM_QuaternionRotatePoint);
+
+// range(0) is the share of rays aimed at the sphere, in percent
+static void BM_SphereHit(benchmark::State& state) {
+    const objects::Sphere sphere({ 0.0, 0.0, -1.0 }, 0.5);
+    const int hitting = static_cast<int>(BATCH * state.range(0) / 100);
+
+    std::vector<Ray> rays;
+    for (int i = 0; i < BATCH; ++i) {
+        const double spread = i < hitting ? 0.3 : 3.0;
+        const double t = static_cast<double>(i) / BATCH - 0.5;
+        rays.emplace_back(Vec3(0.0, 0.0, 0.0), Vec3(spread * t, spread * (0.5 - t * t), -1.0));
+    }
+
+    for (auto _ : state) {
+        for (const Ray& ray : rays) {
+            auto record = sphere.hit(ray, 0.0, 100.0);
+            benchmark::DoNotOptimize(record);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * BATCH);
+}
+
+BENCHMARK(BM_SphereHit)->Arg(0)->Arg(50)->Arg(100);
@@ -0,0 +1,16 @@
+#include "utils/logger.hpp"
+#include <benchmark/benchmark.h>
+
+// benchmark_main's own main, with the library's logging turned off first:
+// the renderer and bmp::io log every frame and file, which would time the console and the logger mutex
+int main(int argc, char** argv) {
+    iheay::utils::Logger::set_level(iheay::utils::LogLevel::Off);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
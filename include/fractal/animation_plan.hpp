@@ -0,0 +1,52 @@
+#pragma once // fractal/animation_plan.hpp
+
+#include "fractal/escape_field.hpp"
+#include "fractal/fractal_animation.hpp"
+#include <functional>
+#include <vector>
+
+namespace iheay::fractal {
+
+// iterates a low-resolution preview of the keyframe at key.config.max_iter into field,
+// julia_c and the formula are up to the caller
+using PreviewFunc = std::function<void(const FractalKeyframe& key, EscapeField& field)>;
+
+struct PlanOptions {
+    int preview_width = 64;
+    int preview_height = 36;
+    int probe_max_iter = 10000;     // previews run this deep, pixels still bounded then count as interior
+    int min_max_iter = 100;
+    double escape_tolerance = 1e-3; // fraction of the pixels allowed to escape after the planned max_iter
+    int smoothing = 4;              // a frame gets the largest budget within this many frames of it
+};
+
+struct FramePlan {
+    FractalKeyframe key;     // config.max_iter replaced by the planned budget
+    double interior = 0.0;   // fraction of the preview still bounded at probe_max_iter
+    double seconds = 0.0;    // predicted render time at the full size
+};
+
+struct AnimationPlan {
+    std::vector<FramePlan> frames; // animation order
+    double seconds = 0.0;          // predicted for the whole animation
+
+    std::vector<FractalKeyframe> keyframes() const;
+
+    // predicted time left once the frames with the indices in `finished` took `elapsed` seconds,
+    // in whatever order they were rendered; the prediction for the rest is scaled by how far off it was for those
+    double remaining_seconds(const std::vector<int>& finished, double elapsed) const;
+};
+
+// renders a preview of every keyframe at probe_max_iter and gives each the smallest max_iter
+// that lets at most escape_tolerance of its pixels escape later; render time is the preview
+// timed again at that budget, scaled to width x height. previews hold a larger share of boundary
+// pixels than the full frame, so shallow frames tend to be overestimated
+AnimationPlan plan_animation(
+    const std::vector<FractalKeyframe>& keyframes,
+    int width,
+    int height,
+    const PreviewFunc& preview,
+    const PlanOptions& options = {}
+);
+
+} // namespace iheay::fractal
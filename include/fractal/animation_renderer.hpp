@@ -0,0 +1,50 @@
+#pragma once // fractal/animation_renderer.hpp
+
+#include "bmp/bmp.hpp"
+#include "fractal/escape_field.hpp"
+#include "fractal/fractal_animation.hpp"
+#include <functional>
+#include <vector>
+
+namespace iheay::fractal {
+
+// one frame goes through these in order, each stage runs on its own thread
+struct AnimationStages {
+    // iterates the keyframe into a field of the animation's size
+    std::function<void(const FractalKeyframe& key, EscapeField& field)> compute;
+
+    // turns the field into the frame image
+    std::function<void(const FractalKeyframe& key, const EscapeField& field, bmp::Bmp& image)> colorize;
+
+    // output sink, frames arrive in order
+    std::function<void(int frame, const bmp::Bmp& image)> write;
+};
+
+struct AnimationStats {
+    int frames = 0;
+    double compute_seconds = 0.0; // time spent in each stage
+    double colorize_seconds = 0.0;
+    double write_seconds = 0.0;
+    double total_seconds = 0.0;
+};
+
+// compute -> colorize -> write pipeline over bounded queues: while frame i is written,
+// frame i + 1 is colorized and frame i + 2 iterated, so the cores don't idle on disk writes
+// memory stays at frames_in_flight fields and frame buffers, reused from frame to frame
+
+class AnimationRenderer {
+public:
+    AnimationRenderer(int width, int height, AnimationStages stages, int frames_in_flight = 2, FieldChannels channels = {});
+
+    // the first exception thrown by a stage stops the pipeline and is rethrown here
+    AnimationStats render(const std::vector<FractalKeyframe>& keyframes) const;
+
+private:
+    int m_width;
+    int m_height;
+    AnimationStages m_stages;
+    int m_frames_in_flight;
+    FieldChannels m_channels;
+};
+
+} // namespace iheay::fractal
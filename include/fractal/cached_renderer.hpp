@@ -0,0 +1,73 @@
+#pragma once // fractal/cached_renderer.hpp
+
+#include "rasterizer/pixeled_concept.hpp"
+#include "fractal/escape_field.hpp"
+#include "fractal/fractal_structures.hpp"
+#include "fractal/tile_cache.hpp"
+#include "fractal/tile_store.hpp"
+#include <memory>
+#include <string>
+
+namespace iheay::fractal {
+
+// tile_size^2 doubles = 512 KiB per tile, large enough that a 1080p view needs ~60 of them
+inline constexpr int default_cached_tile_size = 256;
+
+// side of a level-0 tile on the complex plane
+inline constexpr double cached_root_extent = 4.0;
+
+// serves viewports from a TileCache: pixels are laid on a fixed grid per quadtree level,
+// level L has step cached_root_extent / (tile_size * 2^L) and global pixel (X, Y) sits at X step - i Y step
+// a viewport takes the coarsest level at least as fine as its own step and samples it nearest-neighbour,
+// only tiles missing from the cache (and the optional TileStore) are iterated, in parallel with each other
+// Renderer is a FractalRenderer; tiles go through its explicit-mapping render_field, i.e. double precision
+
+template <typename Renderer>
+class CachedRenderer {
+public:
+    struct Stats {
+        int level = 0;
+        long tiles = 0;    // tiles the last viewport touched
+        long loaded = 0;   // of those, missing from the cache but found in the store
+        long rendered = 0; // missing from both
+    };
+
+    // formula names the iteration, Renderers sharing a cache must agree on it
+    CachedRenderer(Renderer renderer, const std::string& formula, std::shared_ptr<TileCache> cache, int tile_size = default_cached_tile_size);
+
+    // fills the whole field with the viewport, in ViewportMapping::from layout
+    void render_field(EscapeField& field, const Viewport& viewport);
+
+    template <raster::PixeledImage Image>
+    void render(Image& image, const Viewport& viewport);
+
+    // optional second level behind the cache: misses are looked up on disk
+    // and freshly rendered tiles are written there, the store's tile size must match
+    void set_store(std::shared_ptr<TileStore> store);
+
+    // quadtree level used for a pixel step
+    int level_for(double pixel_step) const;
+
+    // pixel step of a level
+    double level_step(int level) const;
+
+    // the part of the plane tile (level, tx, ty) covers
+    ViewportMapping tile_mapping(int level, int64_t tx, int64_t ty) const;
+
+    TileCache& cache() { return *m_cache; }
+    const TileCache& cache() const { return *m_cache; }
+
+    Stats last_stats() const { return m_stats; }
+
+private:
+    Renderer m_renderer;
+    uint64_t m_formula;
+    std::shared_ptr<TileCache> m_cache;
+    std::shared_ptr<TileStore> m_store;
+    int m_tile_size;
+    Stats m_stats;
+};
+
+} // namespace iheay::fractal
+
+#include "inl/cached_renderer.inl"
@@ -0,0 +1,81 @@
+#pragma once // fractal/escape_field.hpp
+
+#include "rasterizer/pixeled_concept.hpp"
+#include "fractal/escape_time.hpp"
+#include "fractal/fractal_structures.hpp"
+#include <cmath>
+#include <vector>
+
+namespace iheay::fractal {
+
+// optional per-pixel data next to mu, meaningless for interior pixels (mu == max_iter)
+struct FieldChannels {
+    bool final_z = false;    // |z| where the loop stopped, not available with perturbation or subdivision
+    bool derivative = false; // |dz / dpixel|, scalar kernel only, see FractalRenderer::tracks_derivative
+    bool distance = false;   // exterior distance estimate in complex-plane units, same requirements as derivative,
+                             // accurate with a large escape radius, e.g. 1e3
+};
+
+// iteration result of a whole image, so colorization can be redone without iterating
+
+class EscapeField {
+public:
+    EscapeField(int width, int height, FieldChannels channels = {});
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    FieldChannels channels() const { return m_channels; }
+
+    // max_iter of the render that filled the field, colorizers need it
+    int max_iter() const { return m_max_iter; }
+    void set_max_iter(int max_iter) { m_max_iter = max_iter; }
+
+    double mu(int x, int y) const { return m_mu[index(x, y)]; }
+    double final_z(int x, int y) const { return m_final_z[index(x, y)]; }
+    double derivative(int x, int y) const { return m_derivative[index(x, y)]; }
+    double distance(int x, int y) const { return m_distance[index(x, y)]; }
+
+    // writes mu and whichever channels are enabled
+    void store(int x, int y, const Escape& escape) {
+        const size_t i = index(x, y);
+
+        m_mu[i] = escape.mu;
+        if (m_channels.final_z)
+            m_final_z[i] = std::hypot(escape.z.real(), escape.z.imag());
+        if (m_channels.derivative)
+            m_derivative[i] = std::hypot(escape.dz.real(), escape.dz.imag());
+        if (m_channels.distance)
+            m_distance[i] = escape.distance;
+    }
+
+    // mu alone, the other channels keep their values
+    void set_mu(int x, int y, double mu) { m_mu[index(x, y)] = mu; }
+
+    const std::vector<double>& mu_data() const { return m_mu; }
+
+    // copies the width x height block at (from_x, from_y) of source to (to_x, to_y),
+    // both fields must have the same channels
+    void copy_region(const EscapeField& source, int from_x, int from_y, int to_x, int to_y, int width, int height);
+
+private:
+    size_t index(int x, int y) const { return static_cast<size_t>(y) * m_width + x; }
+
+private:
+    int m_width;
+    int m_height;
+    FieldChannels m_channels;
+    int m_max_iter = 0;
+
+    std::vector<double> m_mu;
+    std::vector<double> m_final_z;
+    std::vector<double> m_derivative;
+    std::vector<double> m_distance;
+};
+
+// parallel colorization of a finished field, image must have the field's size
+template <ColorizerConcept Colorizer, raster::PixeledImage Image>
+void colorize(const EscapeField& field, Image& image, const Colorizer& colorizer);
+
+} // namespace iheay::fractal
+
+#include "inl/escape_field.inl"
@@ -0,0 +1,79 @@
+#pragma once // fractal/escape_time.hpp
+
+#include "math/complex.hpp"
+#include <cmath>
+
+namespace iheay::fractal {
+
+// where the iteration loop stopped and the smooth count derived from it
+// z and dz (dz / dpixel) are only filled by the paths that track them, distance only with dz, see EscapeField
+struct Escape {
+    int iter;
+    double mu;
+    math::Complex z = math::Complex::Zero();
+    math::Complex dz = math::Complex::Zero();
+    double distance = 0.0;
+    bool settled = false; // interior known from the cardioid check, not iterated
+    int cycle_iter = 0;   // where the periodicity check ended an interior orbit, 0 when it didn't
+};
+
+// smooth iteration count, shared by every kernel so their outputs stay comparable
+// pixels that never escaped get exactly max_iter
+
+inline double calc_mu(math::Complex z, double iter, int max_iter) {
+    double mu = iter;
+
+    if (iter < max_iter) {
+        double zr = z.real();
+        double zi = z.imag();
+        double log_zn = std::log(zr * zr + zi * zi) / 2.0;
+        double nu = std::log(log_zn / std::log(2.0)) / std::log(2.0);
+        mu = iter + 1 - nu;
+    }
+
+    return mu;
+}
+
+// exterior distance estimate G / |G'| = |z| ln|z| / |dz|, in units of the pixel coordinate
+// with G = ln|z| / 2^iter the Green's function; exact in the limit of a large escape radius,
+// the true distance is between about half and twice of it near the set, 0 for interior pixels
+
+inline double distance_estimate(math::Complex z, math::Complex dz, int iter, int max_iter) {
+    if (iter >= max_iter)
+        return 0.0;
+
+    const double abs_z = std::hypot(z.real(), z.imag());
+    const double abs_dz = std::hypot(dz.real(), dz.imag());
+
+    if (abs_dz == 0.0)
+        return INFINITY;
+    return abs_z * std::log(abs_z) / abs_dz;
+}
+
+// what the Koebe 1/4 theorem guarantees of the true distance, sinh G / (2 e^G |G'|):
+// no point of the set lies closer to the pixel than this
+inline double distance_lower_bound(double estimate, math::Complex z, int iter) {
+    const double green = std::log(std::hypot(z.real(), z.imag())) / std::exp2(iter);
+
+    if (!(green > 0.0))
+        return estimate / 2;
+    return estimate * -std::expm1(-2 * green) / (4 * green);
+}
+
+// analytic interior tests for z -> z^2 + c, T is double or math::DoubleDouble
+// written with > only so both scalar types work
+
+template <typename T>
+bool in_main_cardioid(const T& x, const T& y) {
+    const T xq = x - T(0.25);
+    const T q = xq * xq + y * y;
+    return !(q * (q + xq) > T(0.25) * (y * y));
+}
+
+template <typename T>
+bool in_period2_bulb(const T& x, const T& y) {
+    const T xb = x + T(1.0);
+    return !(xb * xb + y * y > T(0.0625));
+}
+
+} // namespace iheay::fractal
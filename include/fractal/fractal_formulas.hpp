@@ -0,0 +1,73 @@
+#pragma once // fractal/fractal_formulas.hpp
+
+#include "math/complex.hpp"
+#include <concepts>
+
+// built-in functors for FractalRenderer
+// being concrete types, they are fully inlined into the iteration loop
+// they are templates over the complex type, so they also run in double-double
+
+namespace iheay::fractal::formulas {
+
+// z -> z^2 + c
+struct Quadratic {
+    using generic_complex_tag = void;
+
+    template <typename C>
+    [[nodiscard]] constexpr C operator()(const C& z, const C& c) const noexcept {
+        return z * z + c;
+    }
+};
+
+// pixel -> pixel
+struct Identity {
+    using generic_complex_tag = void;
+
+    template <typename C>
+    [[nodiscard]] constexpr C operator()(const C& pixel) const noexcept {
+        return pixel;
+    }
+};
+
+// pixel -> 0
+struct Zero {
+    using generic_complex_tag = void;
+
+    template <typename C>
+    [[nodiscard]] constexpr C operator()(const C&) const noexcept {
+        return C::Zero();
+    }
+};
+
+// pixel -> value, e.g. fixed c of a Julia set
+struct Constant {
+    using generic_complex_tag = void;
+
+    math::Complex value;
+
+    template <typename C>
+    [[nodiscard]] constexpr C operator()(const C&) const noexcept {
+        return C(value);
+    }
+};
+
+// functor combinations that special kernels recognize
+
+template <typename Iterate, typename Init, typename Param>
+inline constexpr bool is_mandelbrot_v =
+    std::same_as<Iterate, Quadratic> && std::same_as<Init, Zero> && std::same_as<Param, Identity>;
+
+template <typename Iterate, typename Init, typename Param>
+inline constexpr bool is_julia_v =
+    std::same_as<Iterate, Quadratic> && std::same_as<Init, Identity> && std::same_as<Param, Constant>;
+
+// d functor(pixel) / d pixel, for pixel functors where it is a constant
+
+template <typename F>
+inline constexpr bool has_constant_derivative_v =
+    std::same_as<F, Identity> || std::same_as<F, Zero> || std::same_as<F, Constant>;
+
+template <typename F>
+inline constexpr double constant_derivative_v = std::same_as<F, Identity> ? 1.0 : 0.0;
+
+} // namespace iheay::fractal::formulas
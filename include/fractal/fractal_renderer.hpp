@@ -2,32 +2,201 @@
 
 #include "rasterizer/pixeled_concept.hpp"
 #include "fractal/fractal_structures.hpp"
+#include "fractal/fractal_formulas.hpp"
+#include "fractal/escape_field.hpp"
+#include "fractal/escape_time.hpp"
+#include "fractal/iteration_state.hpp"
+#include "fractal/pixel_average.hpp"
+#include "fractal/render_stats.hpp"
+#include "fractal/simd/quadratic_kernel.hpp"
 #include "math/complex.hpp"
+#include "math/double_double.hpp"
 
 namespace iheay::fractal {
 
-template <ColorizerConcept Colorizer>
+// gathered orbits of one resumable batch, see inl/fractal_renderer.inl
+struct ResumeBatch;
+
+// Iterate, Init and Param default to std::function wrappers;
+// concrete functor types let the compiler inline the whole iteration loop
+
+template <
+    ColorizerConcept Colorizer,
+    IterationConcept Iterate = IterationFunc,
+    InitialConcept Init = InitialFunc,
+    ParamConcept Param = ParamFunc
+>
 class FractalRenderer {
 public:
     FractalRenderer(
         FractalConfig config,
         Viewport viewport,
-        IterationFunc iterate,
-        InitialFunc init,
-        ParamFunc param,
-        Colorizer colorizer
+        Iterate iterate,
+        Init init,
+        Param param,
+        Colorizer colorizer,
+        RenderOptions options = {}
     );
 
     template <raster::PixeledImage Image>
     void render(Image& image) const;
 
+    // render() followed by jittered re-sampling of the pixels whose mu steps by more than
+    // options.threshold to a neighbour; the base sample is averaged in, perturbation frames stay as rendered
+    template <raster::PixeledImage Image>
+        requires AveragePixel<typename Colorizer::pixel_type>
+    AntialiasStats render_antialiased(Image& image, const AntialiasOptions& options = {}) const;
+
+    // same from a field render_field already filled at the image's size, e.g. on another thread
+    template <raster::PixeledImage Image>
+        requires AveragePixel<typename Colorizer::pixel_type>
+    AntialiasStats render_antialiased(const EscapeField& base, Image& image, const AntialiasOptions& options = {}) const;
+
+    // exterior distance estimation: colorizer gets each pixel's distance to the set in pixels,
+    // pixels inside a disk proven to be exterior are filled with their bound instead of iterated
+    template <raster::PixeledImage Image, DistanceColorizerConcept DistanceColorizer>
+    DistanceStats render_distance(Image& image, const DistanceColorizer& colorizer, const DistanceOptions& options = {}) const;
+
+    // iteration only: fills the field at its own size without colorizing,
+    // so the palette can change later through colorize()
+    void render_field(EscapeField& field) const;
+
+    // render / render_field that also fill stats with per-tile counts, per-thread busy time
+    // and phase timings, see fractal/render_stats.hpp; the plain overloads carry no instrumentation
+    template <raster::PixeledImage Image>
+    void render(Image& image, RenderStats& stats) const;
+
+    void render_field(EscapeField& field, RenderStats& stats) const;
+
+    // same for a part of a larger frame: field pixel (0, 0) sits at mapping.pixel(0, 0)
+    // always runs in double precision, the deep paths are laid out by the viewport only
+    void render_field(EscapeField& field, const ViewportMapping& mapping) const;
+
+    // progressive deepening: fills the field like render_field and keeps the orbits still bounded at max_iter
+    // in state, a later call with a larger max_iter on the same field and state only continues those;
+    // mu and final_z in double precision, a state of another frame or of a deeper pass is dropped
+    ResumeStats render_field(EscapeField& field, IterationState& state) const;
+
+    // mu of a width x height grid of arbitrary points, point_at(x, y) gives the pixel coordinate of each
+    // and sink(x, y, escape) takes the result; double precision, scalar or vector kernel as configured,
+    // pixel_step is the sample spacing the cycle detection tolerance follows
+    template <typename PointAt, typename Sink>
+    void render_points(int width, int height, double pixel_step, PointAt point_at, Sink sink) const;
+
+    // colorizes a field produced by render_field with this renderer's colorizer
+    template <raster::PixeledImage Image>
+    void colorize(const EscapeField& field, Image& image) const;
+
+    const FractalConfig& config() const { return m_config; }
+
+    // what the functor types allow beyond the generic double loop
+    static constexpr bool supports_simd = std::same_as<Iterate, formulas::Quadratic>;
+
+    static constexpr bool supports_perturbation =
+        formulas::is_mandelbrot_v<Iterate, Init, Param> || formulas::is_julia_v<Iterate, Init, Param>;
+
+    static constexpr bool supports_double_double =
+        GenericComplexFunctor<Iterate> && GenericComplexFunctor<Init> && GenericComplexFunctor<Param>;
+
+    // FieldChannels::derivative / distance need pixel functors of known derivative and
+    // z^2 + c, built in, or a RenderOptions::derivative functor for other iterations
+    static constexpr bool supports_derivative =
+        formulas::has_constant_derivative_v<Init> && formulas::has_constant_derivative_v<Param>;
+
+    bool tracks_derivative() const {
+        return supports_derivative && (std::same_as<Iterate, formulas::Quadratic> || m_options.derivative != nullptr);
+    }
+
+private:
+    // Precision::Auto resolved for this image, limited to what the functors support
+    Precision resolve_precision(const ViewportMapping& mapping) const;
+
+    // squared thresholds shared by every kernel of one render
+    struct EscapeLimits {
+        double escape_radius_sq;
+        double cycle_tolerance_sq; // 0 when cycle detection is off
+    };
+
+    EscapeLimits escape_limits(const ViewportMapping& mapping) const;
+
+    // RenderOptions::pool or the shared one
+    utils::WorkStealingPool& pool() const;
+
+    // viewport center for the double-double path, RenderOptions::deep_center when given
+    math::DoubleDoubleComplex double_double_center() const;
+
+    // c inside the main cardioid or the period-2 bulb, built-in Mandelbrot only
+    template <typename Cx>
+    static bool known_interior(const Cx& c);
+
+    // Cx is math::Complex or math::DoubleDoubleComplex,
+    // Derivative also tracks dz / dpixel and the distance estimate, see tracks_derivative
+    template <typename Cx, bool Derivative = false>
+    Escape escape(const Cx& pixel, const EscapeLimits& limits) const;
+
+    // every path hands each pixel's Escape to sink(x, y, escape)
+    // explicit_mapping limits the choice to the double precision paths
+    template <typename Sink>
+    void render_escapes(const ViewportMapping& mapping, int width, int height, FieldChannels channels, bool explicit_mapping, Sink& sink) const;
+
+    // render_escapes over the whole viewport through a CountingSink, stats left disabled when compiled out
+    template <typename Sink>
+    void render_counted(int width, int height, FieldChannels channels, Sink& sink, RenderStats& stats) const;
+
+    template <typename Cx, bool Derivative, typename PixelAt, typename Sink>
+    void render_pixels(int width, int height, const EscapeLimits& limits, bool subdivide, PixelAt pixel_at, Sink& sink) const;
+
+    template <typename Cx, typename PixelAt, typename Sink>
+    void render_subdivided(int width, int height, const EscapeLimits& limits, PixelAt pixel_at, Sink& sink) const;
+
+    template <bool Derivative, typename Sink>
+    void render_double_double(int width, int height, const ViewportMapping& mapping, const EscapeLimits& limits, bool subdivide, Sink& sink) const;
+
+    // T is double, or float for Precision::Float
+    template <typename T, typename PixelAt, typename Sink>
+    void render_simd(int width, int height, PixelAt pixel_at, const EscapeLimits& limits, Sink& sink) const;
+
+    // pixels [x0, x1) of row y, buffers and slot hold at least x1 - x0 entries
+    template <typename T, typename PixelAt, typename Sink>
+    void render_simd_row(
+        PixelAt& pixel_at,
+        const EscapeLimits& limits,
+        int y, int x0, int x1,
+        simd::BasicQuadraticBuffers<T>& buffers,
+        std::vector<int>& slot,
+        Sink& sink
+    ) const;
+
+    // render_simd<float> followed by a double re-run of the pixels float can't be trusted with
+    template <typename Sink>
+    void render_float(int width, int height, const ViewportMapping& mapping, const EscapeLimits& limits, Sink& sink) const;
+
+    template <typename Sink>
+    void render_perturbation(int width, int height, Sink& sink) const;
+
+    // the escape loop from iteration `iter` with the periodicity check's saved point, true when that check ended it
+    bool continue_orbit(math::Complex& z, math::Complex& saved, int& iter, const math::Complex& c, const EscapeLimits& limits) const;
+
+    // orbits [first, first + count) of a resumable pass, entries of `source`, or pixel indices when it is null;
+    // stores what finishes into the field and appends what is still running to `kept`
+    long resume_orbits(
+        const IterationState* source,
+        long first, int count,
+        const ViewportMapping& mapping,
+        const EscapeLimits& limits,
+        EscapeField& field,
+        ResumeBatch& batch,
+        IterationState& kept
+    ) const;
+
 private:
     FractalConfig m_config;
     Viewport m_viewport;
-    IterationFunc m_iterate;
-    InitialFunc m_init;
-    ParamFunc m_param;
+    Iterate m_iterate;
+    Init m_init;
+    Param m_param;
     Colorizer m_colorizer;
+    RenderOptions m_options;
 };
     
 } // namespace iheay::fractal
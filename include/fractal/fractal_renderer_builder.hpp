@@ -2,15 +2,29 @@
 
 #include "math/complex.hpp"
 #include "fractal/fractal_renderer.hpp"
+#include "fractal/fractal_formulas.hpp"
 
 namespace iheay::fractal {
 
-template <ColorizerConcept Colorizer>
+template <
+    ColorizerConcept Colorizer,
+    IterationConcept Iterate = IterationFunc,
+    InitialConcept Init = InitialFunc,
+    ParamConcept Param = ParamFunc
+>
 class FractalRendererBuilder {
 public:
-    static FractalRendererBuilder get_builder();
+    // z^2 + c with built-in functors, see fractal/fractal_formulas.hpp
+    static FractalRendererBuilder<Colorizer, formulas::Quadratic, formulas::Identity, formulas::Zero> get_builder();
 
-    FractalRenderer<Colorizer> build() const;
+    // erases concrete functor types, e.g. into the std::function fallback
+    template <IterationConcept OtherIterate, InitialConcept OtherInit, ParamConcept OtherParam>
+    requires std::constructible_from<Iterate, OtherIterate>
+          && std::constructible_from<Init, OtherInit>
+          && std::constructible_from<Param, OtherParam>
+    FractalRendererBuilder(const FractalRendererBuilder<Colorizer, OtherIterate, OtherInit, OtherParam>& other);
+
+    FractalRenderer<Colorizer, Iterate, Init, Param> build() const;
 
     FractalRendererBuilder& set_viewport(Viewport);
     FractalRendererBuilder& set_viewport_width(double);
@@ -19,29 +33,72 @@ public:
     FractalRendererBuilder& set_max_iter(int);
     FractalRendererBuilder& set_escape_radius(double);
 
-    FractalRendererBuilder& set_iteration_func(IterationFunc iterate);
-    FractalRendererBuilder& set_initial_func(InitialFunc initial);
-    FractalRendererBuilder& set_param_func(ParamFunc param);
+    // functor setters modify the builder in place when the functor type is unchanged,
+    // otherwise they return a new builder by value, parameterized by the given functor type,
+    // and leave *this as it was; so always use the result, chained or assigned
+
+    template <IterationConcept F>
+    [[nodiscard]] decltype(auto) set_iteration_func(F iterate);
+
+    // derivative of a custom iteration for the derivative / distance channels, see DerivativeFunc
+    FractalRendererBuilder& set_derivative_func(DerivativeFunc derivative);
+
+    template <InitialConcept F>
+    [[nodiscard]] decltype(auto) set_initial_func(F initial);
+
+    template <ParamConcept F>
+    [[nodiscard]] decltype(auto) set_param_func(F param);
 
     FractalRendererBuilder& set_colorizer(Colorizer);
 
+    // Kernel::Simd requires formulas::Quadratic as the iteration functor
+    FractalRendererBuilder& set_kernel(Kernel);
+
+    // Precision::Auto by default, explicit choices are checked against the functor types in build()
+    FractalRendererBuilder& set_precision(Precision);
+
+    // Strategy::Subdivision trades exactness in uniform bands for far fewer iterated pixels
+    FractalRendererBuilder& set_strategy(Strategy);
+
+    // stops bounded orbits early; cardioid / bulb pixels of the built-in Mandelbrot are skipped regardless
+    FractalRendererBuilder& set_cycle_detection(bool);
+
+    // Schedule::WorkStealing balances tiles of uneven cost, on `pool` or the shared pool
+    FractalRendererBuilder& set_schedule(Schedule);
+    FractalRendererBuilder& set_thread_pool(std::shared_ptr<utils::WorkStealingPool> pool);
+
+    // center given with more digits than a double holds, reset by set_viewport_center
+    FractalRendererBuilder& set_deep_center(DeepCenter);
+
 private:
+    template <ColorizerConcept, IterationConcept, InitialConcept, ParamConcept>
+    friend class FractalRendererBuilder;
+
     FractalRendererBuilder(
         FractalConfig config,
         Viewport viewport,
-        IterationFunc iterate,
-        InitialFunc init,
-        ParamFunc param,
-        Colorizer colorizer
+        Iterate iterate,
+        Init init,
+        Param param,
+        Colorizer colorizer,
+        RenderOptions options = {}
     );
 
+    template <IterationConcept NewIterate, InitialConcept NewInit, ParamConcept NewParam>
+    FractalRendererBuilder<Colorizer, NewIterate, NewInit, NewParam> rebind(
+        NewIterate iterate,
+        NewInit init,
+        NewParam param
+    ) const;
+
 private:
     FractalConfig m_config;
     Viewport m_viewport;
-    IterationFunc m_iterate;
-    InitialFunc m_init;
-    ParamFunc m_param;
+    Iterate m_iterate;
+    Init m_init;
+    Param m_param;
     Colorizer m_colorizer;
+    RenderOptions m_options;
 };
 
 } // namespace iheay::fractal
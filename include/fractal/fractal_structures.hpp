@@ -1,7 +1,15 @@
 #pragma once // fractal/fractal_structures.hpp
 
 #include "math/complex.hpp"
+#include "math/big_float.hpp"
 #include <functional>
+#include <concepts>
+#include <memory>
+#include <optional>
+
+namespace iheay::utils {
+class WorkStealingPool;
+}
 
 namespace iheay::fractal {
 
@@ -12,6 +20,44 @@ requires(Colorizer c, double mu, int max_iter) {
     { c(mu, max_iter) } -> std::same_as<typename Colorizer::pixel_type>;
 };
 
+// render_distance colorizers get the exterior distance in pixels, 0 for interior pixels
+template <typename Colorizer>
+concept DistanceColorizerConcept =
+requires(Colorizer c, double distance) {
+    typename Colorizer::pixel_type;
+    { c(distance) } -> std::same_as<typename Colorizer::pixel_type>;
+};
+
+// the renderer calls these functors on every iteration of every pixel,
+// so concrete types (lambdas, fractal::formulas) are preferred over std::function
+
+template <typename Iterate>
+concept IterationConcept =
+std::copy_constructible<Iterate> &&
+requires(const Iterate f, const math::Complex& z, const math::Complex& c) {
+    { f(z, c) } -> std::convertible_to<math::Complex>;
+};
+
+template <typename Initial>
+concept InitialConcept =
+std::copy_constructible<Initial> &&
+requires(const Initial f, const math::Complex& pixel) {
+    { f(pixel) } -> std::convertible_to<math::Complex>;
+};
+
+template <typename Param>
+concept ParamConcept =
+std::copy_constructible<Param> &&
+requires(const Param f, const math::Complex& pixel) {
+    { f(pixel) } -> std::convertible_to<math::Complex>;
+};
+
+// functors written as templates over the complex type declare `using generic_complex_tag = void;`
+// only those are run with math::DoubleDoubleComplex, see Precision::DoubleDouble
+
+template <typename F>
+concept GenericComplexFunctor = requires { typename F::generic_complex_tag; };
+
 struct FractalConfig {
     int max_iter;
     double escape_radius;
@@ -22,10 +68,116 @@ struct Viewport {
     math::Complex center;
 };
 
+// maps pixel (x, y) of an image onto the complex plane covered by a viewport
+struct ViewportMapping {
+    double real_min;
+    double imag_max;
+    double real_step;
+    double imag_step;
+
+    [[nodiscard]] static ViewportMapping from(const Viewport& viewport, int width, int height) noexcept {
+        const double viewport_height = viewport.width * height / width;
+
+        return {
+            viewport.center.real() - viewport.width / 2,
+            viewport.center.imag() + viewport_height / 2,
+            viewport.width / (width  - 1),
+            viewport_height / (height - 1)
+        };
+    }
+
+    [[nodiscard]] math::Complex pixel(int x, int y) const noexcept {
+        return math::Complex::Algebraic(
+            real_min + x * real_step,
+            imag_max - y * imag_step
+        );
+    }
+
+    bool operator==(const ViewportMapping&) const = default;
+};
+
+enum class Kernel {
+    Scalar, // one pixel at a time, any formula
+    Simd    // AVX2 / AVX-512 lanes, built-in formulas::Quadratic only
+};
+
+enum class Precision {
+    Auto,         // picked per render from the pixel step and max_iter, see select_precision
+    Float,        // single precision vector kernel, pixels it can't resolve re-run in double; Kernel::Simd only
+    Double,       // plain math::Complex arithmetic
+    DoubleDouble, // math::DoubleDoubleComplex, functors satisfying GenericComplexFunctor only
+    Perturbation  // BigFloat reference orbit + double deltas, built-in Mandelbrot / Julia only
+};
+
+enum class Strategy {
+    PerPixel,   // every pixel goes through the iteration loop
+    Subdivision // Mariani–Silver, uniform rectangles are filled from their borders;
+                // scalar double / double-double only, perturbation ignores it
+};
+
+enum class Schedule {
+    Static,      // OpenMP static split of rows
+    WorkStealing // Morton-ordered tiles on a utils::WorkStealingPool
+};
+
+// viewport center with more digits than Viewport::center holds
+struct DeepCenter {
+    math::BigFloat real;
+    math::BigFloat imag;
+};
+
+// d iterate(z, c) / d pixel from z and the derivatives dz, dc of z and c by the pixel,
+// tracked next to custom iteration functors; z^2 + c has it built in
+using DerivativeFunc = std::function<math::Complex(const math::Complex& z, const math::Complex& dz, const math::Complex& dc)>;
+
+struct RenderOptions {
+    Kernel kernel = Kernel::Scalar;
+    Precision precision = Precision::Auto;
+    Strategy strategy = Strategy::PerPixel;
+    bool cycle_detection = false; // periodicity check, tolerance follows the pixel step
+    Schedule schedule = Schedule::Static;
+    std::shared_ptr<utils::WorkStealingPool> pool; // null means WorkStealingPool::shared()
+    std::optional<DeepCenter> deep_center;
+    DerivativeFunc derivative; // for FieldChannels::derivative / distance with custom iteration functors
+};
+
+// edge-adaptive supersampling, see FractalRenderer::render_antialiased
+struct AntialiasOptions {
+    double threshold = 1.0;     // mu difference to a 4-neighbour that makes a pixel an edge
+    int samples = 8;            // jittered samples per refined pixel, on top of its base sample
+    double sample_budget = 1.0; // extra samples per frame, in multiples of its pixel count
+    double boundary_distance = 0.0; // also refine pixels whose distance estimate is below this many pixels, 0 = off
+};
+
+struct AntialiasStats {
+    long edges = 0;   // pixels over the threshold
+    long refined = 0; // of those, re-sampled within the budget, strongest edges first
+    long samples = 0; // extra samples cast
+};
+
+// FractalRenderer::render_distance
+struct DistanceOptions {
+    double skip_distance = 4.0; // pixels proven farther than this from the set are not iterated, 0 iterates all
+};
+
+struct DistanceStats {
+    long iterated = 0; // pixels that went through the loop
+    long skipped = 0;  // pixels inside an exterior disk of an iterated one
+};
+
+// FractalRenderer::render_field with an IterationState
+struct ResumeStats {
+    bool resumed = false; // continued the state's orbits rather than starting the frame over
+    long iterated = 0;    // orbits this pass advanced
+    long running = 0;     // of those, still bounded at max_iter and kept for the next pass
+};
+
+// type-erased fallbacks, used when the formula is only known at runtime
+
 using IterationFunc = std::function<math::Complex(const math::Complex& z, const math::Complex& c)>;
 
 using InitialFunc = std::function<math::Complex(const math::Complex& pixel)>;
 
 using ParamFunc = std::function<math::Complex(const math::Complex& pixel)>;
 
-} // namespace iheay::fractal
\ No newline at end of file
+} // namespace iheay::fractal
@@ -0,0 +1,62 @@
+#pragma once // fractal/incremental_renderer.hpp
+
+#include "rasterizer/pixeled_concept.hpp"
+#include "fractal/escape_field.hpp"
+#include "fractal/fractal_structures.hpp"
+#include <optional>
+
+namespace iheay::fractal {
+
+// keeps the last escape field of an interactive view together with its mapping;
+// pans by whole pixels and canvas resizes only iterate the newly exposed strips,
+// the overlap is copied from the previous field
+// Renderer is a FractalRenderer, its own viewport is only used for the first frame
+
+template <typename Renderer>
+class IncrementalRenderer {
+public:
+    struct Stats {
+        long computed = 0; // pixels iterated by the last update
+        long copied = 0;   // pixels taken over from the previous field
+    };
+
+    IncrementalRenderer(Renderer renderer, Viewport viewport, FieldChannels channels = {});
+
+    // the top-left corner and the pixel step stay fixed, so growing the window only adds strips
+    void resize(int width, int height);
+
+    // moves the view by whole pixels, positive dx shows more on the right, positive dy more below
+    void pan(int dx, int dy);
+
+    // general case: reuses the overlap when the step matches and the shift is whole pixels
+    void set_mapping(const ViewportMapping& mapping, int width, int height);
+
+    template <raster::PixeledImage Image>
+    void render(Image& image) const;
+
+    // requires at least one resize / set_mapping
+    const EscapeField& field() const;
+    const ViewportMapping& mapping() const { return m_mapping; }
+
+    // the viewport the current field covers, in the Viewport convention (center + real width)
+    Viewport viewport() const;
+
+    Stats last_stats() const { return m_stats; }
+
+private:
+    // renders a strip of the new frame into `field`, pixel (x0, y0) of the frame
+    void render_strip(EscapeField& field, const ViewportMapping& mapping, int x0, int y0, int width, int height);
+
+private:
+    Renderer m_renderer;
+    Viewport m_initial_viewport;
+    FieldChannels m_channels;
+
+    std::optional<EscapeField> m_field;
+    ViewportMapping m_mapping {};
+    Stats m_stats;
+};
+
+} // namespace iheay::fractal
+
+#include "inl/incremental_renderer.inl"
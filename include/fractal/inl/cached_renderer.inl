@@ -0,0 +1,183 @@
+// fractal/inl/cached_renderer.inl
+
+#include "fractal/precision_selector.hpp"
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+#include <vector>
+
+namespace iheay::fractal {
+
+// floor(value / divisor) for negative grid coordinates too
+inline int64_t cached_floor_div(int64_t value, int64_t divisor) {
+    const int64_t q = value / divisor;
+    return (value % divisor != 0 && value < 0) ? q - 1 : q;
+}
+
+template <typename Renderer>
+CachedRenderer<Renderer>::CachedRenderer(Renderer renderer, const std::string& formula, std::shared_ptr<TileCache> cache, int tile_size)
+: m_renderer(std::move(renderer))
+, m_formula(formula_hash(formula))
+, m_cache(std::move(cache))
+, m_tile_size(tile_size) {
+    if (!m_cache)
+        throw std::runtime_error("CachedRenderer needs a tile cache");
+    if (tile_size <= 0)
+        throw std::runtime_error("Tile size must be positive");
+}
+
+template <typename Renderer>
+void CachedRenderer<Renderer>::set_store(std::shared_ptr<TileStore> store) {
+    if (store && store->tile_size() != m_tile_size)
+        throw std::runtime_error("Tile store size does not match the cached renderer");
+
+    m_store = std::move(store);
+}
+
+template <typename Renderer>
+int CachedRenderer<Renderer>::level_for(double pixel_step) const {
+    if (!(pixel_step > 0))
+        throw std::runtime_error("Pixel step must be positive");
+
+    // a hair below the exact power of two still picks that level
+    const double level = std::ceil(std::log2(level_step(0) / pixel_step) - 1e-9);
+    return level > 0 ? static_cast<int>(level) : 0;
+}
+
+template <typename Renderer>
+double CachedRenderer<Renderer>::level_step(int level) const {
+    return std::ldexp(cached_root_extent / m_tile_size, -level);
+}
+
+template <typename Renderer>
+ViewportMapping CachedRenderer<Renderer>::tile_mapping(int level, int64_t tx, int64_t ty) const {
+    const double step = level_step(level);
+
+    return {
+        static_cast<double>(tx * m_tile_size) * step,
+        -static_cast<double>(ty * m_tile_size) * step,
+        step,
+        step
+    };
+}
+
+template <typename Renderer>
+void CachedRenderer<Renderer>::render_field(EscapeField& field, const Viewport& viewport) {
+    const FieldChannels channels = field.channels();
+    if (channels.final_z || channels.derivative || channels.distance)
+        throw std::runtime_error("Cached tiles only hold mu, extra field channels are not available");
+
+    const int width = field.width();
+    const int height = field.height();
+    const ViewportMapping mapping = ViewportMapping::from(viewport, width, height);
+
+    const int level = level_for(std::min(mapping.real_step, mapping.imag_step));
+    const double step = level_step(level);
+
+    const Precision precision = select_precision(viewport, step, m_renderer.config().max_iter);
+    if (precision == Precision::DoubleDouble || precision == Precision::Perturbation)
+        throw std::runtime_error("Viewport is too deep for the tile cache, tiles are rendered in double precision");
+
+    const FractalConfig& config = m_renderer.config();
+    const int64_t tile_size = m_tile_size;
+
+    // global grid pixel nearest to a point of the plane
+    auto grid_x = [&](double real) { return static_cast<int64_t>(std::floor(real / step + 0.5)); };
+    auto grid_y = [&](double imag) { return static_cast<int64_t>(std::floor(-imag / step + 0.5)); };
+
+    const int64_t tx0 = cached_floor_div(grid_x(mapping.real_min), tile_size);
+    const int64_t tx1 = cached_floor_div(grid_x(mapping.real_min + (width - 1) * mapping.real_step), tile_size);
+    const int64_t ty0 = cached_floor_div(grid_y(mapping.imag_max), tile_size);
+    const int64_t ty1 = cached_floor_div(grid_y(mapping.imag_max - (height - 1) * mapping.imag_step), tile_size);
+
+    const int64_t columns = tx1 - tx0 + 1;
+    const int64_t rows = ty1 - ty0 + 1;
+
+    auto key_of = [&](int64_t index) {
+        return TileKey { m_formula, level, tx0 + index % columns, ty0 + index / columns, config.max_iter, config.escape_radius };
+    };
+
+    std::vector<CachedTile> tiles(columns * rows);
+    std::vector<int64_t> missing;
+
+    long loaded = 0;
+
+    for (int64_t i = 0; i < columns * rows; ++i) {
+        const TileKey key = key_of(i);
+
+        tiles[i] = m_cache->find(key);
+        if (tiles[i])
+            continue;
+
+        if (m_store) {
+            // the mapping stays open in the cache, mu is sampled from its pages
+            if (std::optional<MappedTile> stored = m_store->find(key)) {
+                tiles[i].mapped = std::make_shared<const MappedTile>(std::move(*stored));
+                m_cache->insert(key, tiles[i].mapped);
+                ++loaded;
+                continue;
+            }
+        }
+
+        missing.push_back(i);
+    }
+
+    // one tile per thread, the renderer's own loops run inside it
+    std::exception_ptr error;
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (size_t m = 0; m < missing.size(); ++m) {
+        try {
+            const TileKey key = key_of(missing[m]);
+
+            auto tile = std::make_shared<EscapeField>(m_tile_size, m_tile_size);
+            m_renderer.render_field(*tile, tile_mapping(level, key.tx, key.ty));
+            tiles[missing[m]].field = std::move(tile);
+        } catch (...) {
+            #pragma omp critical
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+
+    for (int64_t i : missing) {
+        m_cache->insert(key_of(i), tiles[i].field);
+        if (m_store)
+            m_store->insert(key_of(i), *tiles[i].field);
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (int y = 0; y < height; ++y) {
+        const int64_t gy = grid_y(mapping.imag_max - y * mapping.imag_step);
+        const int64_t ty = cached_floor_div(gy, tile_size);
+
+        for (int x = 0; x < width; ++x) {
+            const int64_t gx = grid_x(mapping.real_min + x * mapping.real_step);
+            const int64_t tx = cached_floor_div(gx, tile_size);
+
+            const CachedTile& tile = tiles[(ty - ty0) * columns + (tx - tx0)];
+            const int lx = static_cast<int>(gx - tx * tile_size);
+            const int ly = static_cast<int>(gy - ty * tile_size);
+
+            Escape escape {};
+            escape.mu = tile.field ? tile.field->mu(lx, ly) : tile.mapped->mu(lx, ly);
+            field.store(x, y, escape);
+        }
+    }
+
+    field.set_max_iter(config.max_iter);
+    m_stats = { level, columns * rows, loaded, static_cast<long>(missing.size()) };
+}
+
+template <typename Renderer>
+template <raster::PixeledImage Image>
+void CachedRenderer<Renderer>::render(Image& image, const Viewport& viewport) {
+    EscapeField field(image.width(), image.height());
+    render_field(field, viewport);
+    m_renderer.colorize(field, image);
+}
+
+} // namespace iheay::fractal
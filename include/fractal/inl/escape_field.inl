@@ -0,0 +1,73 @@
+// fractal/inl/escape_field.inl
+
+#include "utils/trace.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace iheay::fractal {
+
+inline EscapeField::EscapeField(int width, int height, FieldChannels channels)
+: m_width(width)
+, m_height(height)
+, m_channels(channels) {
+    if (width <= 0 || height <= 0)
+        throw std::runtime_error("Invalid escape field size");
+
+    const size_t size = static_cast<size_t>(width) * height;
+
+    m_mu.assign(size, 0.0);
+    if (channels.final_z)
+        m_final_z.assign(size, 0.0);
+    if (channels.derivative)
+        m_derivative.assign(size, 0.0);
+    if (channels.distance)
+        m_distance.assign(size, 0.0);
+}
+
+inline void EscapeField::copy_region(const EscapeField& source, int from_x, int from_y, int to_x, int to_y, int width, int height) {
+    if (source.m_channels.final_z != m_channels.final_z || source.m_channels.derivative != m_channels.derivative ||
+        source.m_channels.distance != m_channels.distance)
+        throw std::runtime_error("Escape field channels do not match");
+
+    if (width <= 0 || height <= 0)
+        return;
+
+    if (from_x < 0 || from_y < 0 || from_x + width > source.m_width || from_y + height > source.m_height ||
+        to_x < 0 || to_y < 0 || to_x + width > m_width || to_y + height > m_height)
+        throw std::runtime_error("Escape field region out of bounds");
+
+    auto copy_rows = [&](const std::vector<double>& from, std::vector<double>& to) {
+        if (from.empty())
+            return;
+
+        #pragma omp parallel for schedule(static)
+        for (int row = 0; row < height; ++row) {
+            const auto begin = from.begin() + source.index(from_x, from_y + row);
+            std::copy(begin, begin + width, to.begin() + index(to_x, to_y + row));
+        }
+    };
+
+    copy_rows(source.m_mu, m_mu);
+    copy_rows(source.m_final_z, m_final_z);
+    copy_rows(source.m_derivative, m_derivative);
+    copy_rows(source.m_distance, m_distance);
+}
+
+template <ColorizerConcept Colorizer, raster::PixeledImage Image>
+void colorize(const EscapeField& field, Image& image, const Colorizer& colorizer) {
+    if (image.width() != field.width() || image.height() != field.height())
+        throw std::runtime_error("Image size does not match the escape field");
+
+    TRACE_SCOPE("colorize", {"width", field.width()}, {"height", field.height()});
+
+    const int max_iter = field.max_iter();
+
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (int y = 0; y < field.height(); ++y) {
+        for (int x = 0; x < field.width(); ++x) {
+            image.set_pixel(x, y, colorizer(field.mu(x, y), max_iter));
+        }
+    }
+}
+
+} // namespace iheay::fractal
@@ -1,102 +1,583 @@
 // fractal/inl/fractal_renderer.inl
 
+#include "fractal/escape_time.hpp"
+#include "fractal/perturbation.hpp"
+#include "fractal/precision_selector.hpp"
+#include "fractal/simd/quadratic_kernel.hpp"
+#include "fractal/subdivision.hpp"
+#include "fractal/tiles.hpp"
+#include "math/double_double.hpp"
 #include "utils/logger.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
 #include <omp.h>
 
 namespace iheay::fractal {
 
 // constructor
 
-template <ColorizerConcept Colorizer>
-FractalRenderer<Colorizer>::FractalRenderer(
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRenderer<Colorizer, Iterate, Init, Param>::FractalRenderer(
     FractalConfig config,
     Viewport viewport,
-    IterationFunc iterate,
-    InitialFunc init,
-    ParamFunc param,
-    Colorizer colorizer
+    Iterate iterate,
+    Init init,
+    Param param,
+    Colorizer colorizer,
+    RenderOptions options
 )
 : m_config(config)
 , m_viewport(viewport)
-, m_iterate(iterate)
-, m_init(init)
-, m_param(param)
-, m_colorizer(colorizer) {}
-
-// local static helpers
-
-static inline math::Complex pixel_to_complex(
-    int x, int y,
-    double real_min, double imag_max,
-    double real_step, double imag_step
-) {
-    return math::Complex::Algebraic(
-        real_min + x * real_step,
-        imag_max - y * imag_step
-    );
+, m_iterate(std::move(iterate))
+, m_init(std::move(init))
+, m_param(std::move(param))
+, m_colorizer(std::move(colorizer))
+, m_options(std::move(options)) {}
+
+// rendering
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <raster::PixeledImage Image>
+void FractalRenderer<Colorizer, Iterate, Init, Param>::render(Image& image) const {
+    auto sink = [&](int x, int y, const Escape& escape) {
+        image.set_pixel(x, y, m_colorizer(escape.mu, m_config.max_iter));
+    };
+
+    const ViewportMapping mapping = ViewportMapping::from(m_viewport, image.width(), image.height());
+    render_escapes(mapping, image.width(), image.height(), FieldChannels {}, false, sink);
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+void FractalRenderer<Colorizer, Iterate, Init, Param>::render_field(EscapeField& field) const {
+    field.set_max_iter(m_config.max_iter);
+
+    auto sink = [&](int x, int y, const Escape& escape) {
+        field.store(x, y, escape);
+    };
+
+    const ViewportMapping mapping = ViewportMapping::from(m_viewport, field.width(), field.height());
+    render_escapes(mapping, field.width(), field.height(), field.channels(), false, sink);
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <raster::PixeledImage Image>
+void FractalRenderer<Colorizer, Iterate, Init, Param>::render(Image& image, RenderStats& stats) const {
+    auto sink = [&](int x, int y, const Escape& escape) {
+        image.set_pixel(x, y, m_colorizer(escape.mu, m_config.max_iter));
+    };
+
+    render_counted(image.width(), image.height(), FieldChannels {}, sink, stats);
 }
 
-static double calc_mu(math::Complex z, double iter, int max_iter) {
-    double mu = iter;
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+void FractalRenderer<Colorizer, Iterate, Init, Param>::render_field(EscapeField& field, RenderStats& stats) const {
+    field.set_max_iter(m_config.max_iter);
+
+    auto sink = [&](int x, int y, const Escape& escape) {
+        field.store(x, y, escape);
+    };
+
+    render_counted(field.width(), field.height(), field.channels(), sink, stats);
+}
 
-    if (iter < max_iter) {
-        double zr = z.real();
-        double zi = z.imag();
-        double log_zn = std::log(zr * zr + zi * zi) / 2.0;
-        double nu = std::log(log_zn / std::log(2.0)) / std::log(2.0);
-        mu = iter + 1 - nu;
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <typename Sink>
+void FractalRenderer<Colorizer, Iterate, Init, Param>::render_counted(int width, int height, FieldChannels channels, Sink& sink, RenderStats& stats) const {
+    const ViewportMapping mapping = ViewportMapping::from(m_viewport, width, height);
+
+    if constexpr (render_stats_enabled) {
+        StatsCollector collector(width, height, m_config.max_iter);
+        CountingSink<Sink> counting { sink, collector };
+
+        render_escapes(mapping, width, height, channels, false, counting);
+        stats = collector.finish();
+    } else {
+        stats = {};
+        render_escapes(mapping, width, height, channels, false, sink);
     }
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+void FractalRenderer<Colorizer, Iterate, Init, Param>::render_field(EscapeField& field, const ViewportMapping& mapping) const {
+    field.set_max_iter(m_config.max_iter);
+
+    auto sink = [&](int x, int y, const Escape& escape) {
+        field.store(x, y, escape);
+    };
 
-    return mu;
+    render_escapes(mapping, field.width(), field.height(), field.channels(), true, sink);
 }
 
-// rendering
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <typename PointAt, typename Sink>
+void FractalRenderer<Colorizer, Iterate, Init, Param>::render_points(int width, int height, double pixel_step, PointAt point_at, Sink sink) const {
+    const EscapeLimits limits = escape_limits(ViewportMapping { 0.0, 0.0, pixel_step, pixel_step });
+
+    if constexpr (supports_simd) {
+        if (m_options.kernel == Kernel::Simd) {
+            render_simd<double>(width, height, point_at, limits, sink);
+            return;
+        }
+    }
+
+    render_pixels<math::Complex, false>(width, height, limits, false, point_at, sink);
+}
 
-template <ColorizerConcept Colorizer>
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
 template <raster::PixeledImage Image>
-void FractalRenderer<Colorizer>::render(Image& image) const {
+void FractalRenderer<Colorizer, Iterate, Init, Param>::colorize(const EscapeField& field, Image& image) const {
+    fractal::colorize(field, image, m_colorizer);
+}
+
+// per-pixel rotation of the sample pattern, the same pixel gets the same jitter in every frame
+inline uint32_t antialias_seed(int x, int y) {
+    uint32_t h = static_cast<uint32_t>(x) * 0x9e3779b1u ^ static_cast<uint32_t>(y) * 0x85ebca77u;
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    h *= 0x846ca68bu;
+    h ^= h >> 16;
+    return h;
+}
+
+// R2 low-discrepancy sequence, evenly spread sub-pixel offsets for any sample count
+inline constexpr double antialias_r2_x = 0.7548776662466927;
+inline constexpr double antialias_r2_y = 0.5698402909980532;
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <raster::PixeledImage Image>
+    requires AveragePixel<typename Colorizer::pixel_type>
+AntialiasStats FractalRenderer<Colorizer, Iterate, Init, Param>::render_antialiased(Image& image, const AntialiasOptions& options) const {
+    // the distance channel also catches thin filaments whose mu hardly steps
+    EscapeField base(image.width(), image.height(), FieldChannels { false, false, options.boundary_distance > 0 });
+    render_field(base);
+    return render_antialiased(base, image, options);
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <raster::PixeledImage Image>
+    requires AveragePixel<typename Colorizer::pixel_type>
+AntialiasStats FractalRenderer<Colorizer, Iterate, Init, Param>::render_antialiased(const EscapeField& base, Image& image, const AntialiasOptions& options) const {
+    if (options.samples <= 0 || options.threshold < 0 || options.sample_budget < 0 || options.boundary_distance < 0)
+        throw std::runtime_error("Invalid antialiasing options");
+
+    const bool boundary = options.boundary_distance > 0;
+    if (boundary && !base.channels().distance)
+        throw std::runtime_error("Antialiasing by boundary distance requires a field with the distance channel");
+
+    const int width = image.width();
+    const int height = image.height();
+    const ViewportMapping mapping = ViewportMapping::from(m_viewport, width, height);
+    const double step = std::min(mapping.real_step, mapping.imag_step);
+
+    fractal::colorize(base, image, m_colorizer);
+
+    struct Edge {
+        int x;
+        int y;
+        double contrast;
+    };
+
+    // largest mu step to a 4-neighbour
+    std::vector<Edge> edges;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const double mu = base.mu(x, y);
+            double contrast = 0.0;
+
+            if (x > 0)          contrast = std::max(contrast, std::abs(mu - base.mu(x - 1, y)));
+            if (x + 1 < width)  contrast = std::max(contrast, std::abs(mu - base.mu(x + 1, y)));
+            if (y > 0)          contrast = std::max(contrast, std::abs(mu - base.mu(x, y - 1)));
+            if (y + 1 < height) contrast = std::max(contrast, std::abs(mu - base.mu(x, y + 1)));
+
+            bool near = false;
+            if (boundary) {
+                const double distance = base.distance(x, y) / step;
+                near = distance > 0 && distance < options.boundary_distance;
+                if (near)
+                    contrast = std::max(contrast, options.threshold * options.boundary_distance / distance);
+            }
+
+            if (contrast > options.threshold || near)
+                edges.push_back({ x, y, contrast });
+        }
+    }
+
+    AntialiasStats stats;
+    stats.edges = static_cast<long>(edges.size());
+
+    const Precision precision = resolve_precision(mapping);
+
+    if (precision == Precision::Perturbation) {
+        LOG_WARN("Perturbation frames are not antialiased, {} edge pixels left as rendered", stats.edges);
+        return stats;
+    }
+
+    const size_t budget = static_cast<size_t>(options.sample_budget * width * height / options.samples);
+    if (edges.size() > budget) {
+        std::nth_element(edges.begin(), edges.begin() + budget, edges.end(), [](const Edge& a, const Edge& b) {
+            return a.contrast > b.contrast;
+        });
+        edges.resize(budget);
+    }
+
+    const EscapeLimits limits = escape_limits(mapping);
+    const int refined = static_cast<int>(edges.size());
+    const int samples = options.samples;
+
+    // same layout as the base frame, at fractional pixel coordinates
+    const math::DoubleDoubleComplex center = double_double_center();
+    const double half_width = m_viewport.width / 2;
+    const double half_height = mapping.imag_step * (height - 1) / 2;
+
+    auto sample_at = [&](double fx, double fy) {
+        if constexpr (supports_double_double) {
+            if (precision == Precision::DoubleDouble) {
+                const math::Complex offset(fx * mapping.real_step - half_width, half_height - fy * mapping.imag_step);
+                return escape<math::DoubleDoubleComplex>(center + math::DoubleDoubleComplex(offset), limits);
+            }
+        }
+
+        return escape<math::Complex>(math::Complex::Algebraic(
+            mapping.real_min + fx * mapping.real_step,
+            mapping.imag_max - fy * mapping.imag_step
+        ), limits);
+    };
+
+    // sample s of an edge pixel, a rotated R2 point inside the pixel footprint
+    auto sample_point = [&](const Edge& edge, int s, double& fx, double& fy) {
+        const uint32_t seed = antialias_seed(edge.x, edge.y);
+        const double ox = (seed & 0xffff) / 65536.0 + s * antialias_r2_x;
+        const double oy = (seed >> 16) / 65536.0 + s * antialias_r2_y;
+
+        fx = edge.x + (ox - std::floor(ox)) - 0.5;
+        fy = edge.y + (oy - std::floor(oy)) - 0.5;
+    };
+
+    bool vectorized = false;
+    if constexpr (supports_simd)
+        vectorized = m_options.kernel == Kernel::Simd && (precision == Precision::Double || precision == Precision::Float);
+
+    // edges go in blocks, so the vector kernel gets full lanes of samples
+    const int block = 32;
+    const int blocks = (refined + block - 1) / block;
+
+    #pragma omp parallel
+    {
+        std::vector<double> mu(static_cast<size_t>(block) * samples);
+        simd::QuadraticBuffers buffers(vectorized ? block * samples : 0);
+        std::vector<int> slot(vectorized ? block * samples : 0);
+
+        #pragma omp for schedule(dynamic)
+        for (int b = 0; b < blocks; ++b) {
+            const int first = b * block;
+            const int last = std::min(refined, first + block);
+
+            if (vectorized) {
+                int count = 0;
+
+                for (int i = first; i < last; ++i) {
+                    for (int s = 0; s < samples; ++s) {
+                        const int k = (i - first) * samples + s;
+
+                        double fx, fy;
+                        sample_point(edges[i], s + 1, fx, fy);
+
+                        const math::Complex pixel = math::Complex::Algebraic(
+                            mapping.real_min + fx * mapping.real_step,
+                            mapping.imag_max - fy * mapping.imag_step
+                        );
+                        const math::Complex z = m_init(pixel);
+                        const math::Complex c = m_param(pixel);
+
+                        if (known_interior(c)) {
+                            slot[k] = -1;
+                            continue;
+                        }
+
+                        slot[k] = count;
+                        buffers.z_real[count] = z.real();
+                        buffers.z_imag[count] = z.imag();
+                        buffers.c_real[count] = c.real();
+                        buffers.c_imag[count] = c.imag();
+                        ++count;
+                    }
+                }
+
+                simd::iterate_quadratic(buffers.span(count), m_config.max_iter, limits.escape_radius_sq, limits.cycle_tolerance_sq);
+
+                for (int k = 0; k < (last - first) * samples; ++k) {
+                    const int i = slot[k];
+                    mu[k] = i < 0
+                        ? static_cast<double>(m_config.max_iter)
+                        : calc_mu(math::Complex::Algebraic(buffers.out_real[i], buffers.out_imag[i]), buffers.iter[i], m_config.max_iter);
+                }
+            } else {
+                for (int i = first; i < last; ++i) {
+                    for (int s = 0; s < samples; ++s) {
+                        double fx, fy;
+                        sample_point(edges[i], s + 1, fx, fy);
+                        mu[(i - first) * samples + s] = sample_at(fx, fy).mu;
+                    }
+                }
+            }
+
+            for (int i = first; i < last; ++i) {
+                const Edge& edge = edges[i];
+
+                PixelAverage<typename Colorizer::pixel_type> average;
+                average.add(m_colorizer(base.mu(edge.x, edge.y), m_config.max_iter));
+
+                for (int s = 0; s < samples; ++s)
+                    average.add(m_colorizer(mu[(i - first) * samples + s], m_config.max_iter));
+
+                image.set_pixel(edge.x, edge.y, average.result());
+            }
+        }
+    }
+
+    stats.refined = refined;
+    stats.samples = static_cast<long>(refined) * samples;
+
+    LOG_INFO("Antialiasing refined {} of {} edge pixels with {} extra samples", stats.refined, stats.edges, stats.samples);
+    return stats;
+}
+
+// distance estimates are computed on a grid of cells this many pixels wide first,
+// cells inside a corner's exterior disk are filled from the disk instead of iterated
+inline constexpr int distance_cell = 8;
+
+// the estimate converges with the escape radius, mu isn't shown so any radius will do
+inline constexpr double distance_escape_radius = 1e3;
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <raster::PixeledImage Image, DistanceColorizerConcept DistanceColorizer>
+DistanceStats FractalRenderer<Colorizer, Iterate, Init, Param>::render_distance(Image& image, const DistanceColorizer& colorizer, const DistanceOptions& options) const {
+    if (!tracks_derivative())
+        throw std::runtime_error("Distance estimation requires built-in pixel functors and formulas::Quadratic or a derivative func");
+
+    if (options.skip_distance < 0)
+        throw std::runtime_error("Invalid distance options");
+
+    volatile double time_start = omp_get_wtime();
+
+    const int width = image.width();
+    const int height = image.height();
+    const ViewportMapping mapping = ViewportMapping::from(m_viewport, width, height);
+    const Precision precision = resolve_precision(mapping);
+
+    if (precision == Precision::Perturbation)
+        throw std::runtime_error("Perturbation only produces mu, distance estimation is not available");
+
+    EscapeLimits limits = escape_limits(mapping);
+    limits.escape_radius_sq = std::max(limits.escape_radius_sq, distance_escape_radius * distance_escape_radius);
+
+    const double step = std::min(mapping.real_step, mapping.imag_step);
+
+    const math::DoubleDoubleComplex center = double_double_center();
+    const double half_width = m_viewport.width / 2;
+    const double half_height = mapping.imag_step * (height - 1) / 2;
+
+    // estimate and Koebe lower bound of one pixel, in pixels
+    struct Distance {
+        double estimate;
+        double bound;
+    };
+
+    auto distance_at = [&](int x, int y) {
+        auto measure = [&](const Escape& escape) {
+            return Distance { escape.distance / step, distance_lower_bound(escape.distance, escape.z, escape.iter) / step };
+        };
+
+        if constexpr (supports_double_double) {
+            if (precision == Precision::DoubleDouble) {
+                const math::Complex offset(x * mapping.real_step - half_width, half_height - y * mapping.imag_step);
+                return measure(escape<math::DoubleDoubleComplex, true>(center + math::DoubleDoubleComplex(offset), limits));
+            }
+        }
+
+        return measure(escape<math::Complex, true>(mapping.pixel(x, y), limits));
+    };
+
+    // grid nodes sit every distance_cell pixels, plus the last row and column
+    const int cells_x = std::max(1, (width - 1 + distance_cell - 1) / distance_cell);
+    const int cells_y = std::max(1, (height - 1 + distance_cell - 1) / distance_cell);
+    auto node_x = [&](int i) { return std::min(i * distance_cell, width - 1); };
+    auto node_y = [&](int j) { return std::min(j * distance_cell, height - 1); };
+
+    std::vector<Distance> nodes(static_cast<size_t>(cells_x + 1) * (cells_y + 1));
+
+    #pragma omp parallel for collapse(2) schedule(dynamic)
+    for (int j = 0; j <= cells_y; ++j) {
+        for (int i = 0; i <= cells_x; ++i) {
+            nodes[j * (cells_x + 1) + i] = distance_at(node_x(i), node_y(j));
+        }
+    }
+
+    // a cell is skipped when one corner's disk covers it with skip_distance to spare
+    std::vector<char> skipped_cells(static_cast<size_t>(cells_x) * cells_y, 0);
+
+    if (options.skip_distance > 0) {
+        for (int j = 0; j < cells_y; ++j) {
+            for (int i = 0; i < cells_x; ++i) {
+                const double diagonal = std::hypot(node_x(i + 1) - node_x(i), node_y(j + 1) - node_y(j));
+
+                for (int corner = 0; corner < 4; ++corner) {
+                    const Distance& node = nodes[(j + corner / 2) * (cells_x + 1) + i + corner % 2];
+                    if (node.bound - diagonal >= options.skip_distance)
+                        skipped_cells[j * cells_x + i] = 1;
+                }
+            }
+        }
+    }
+
+    long iterated = 0;
+    long skipped = 0;
+
+    // every pixel belongs to the cell whose top-left corner is at or before it
+    #pragma omp parallel for schedule(dynamic) reduction(+ : iterated, skipped)
+    for (int y = 0; y < height; ++y) {
+        const int j = std::min(y / distance_cell, cells_y - 1);
+        const bool node_row = y % distance_cell == 0 || y == height - 1;
+
+        for (int x = 0; x < width; ++x) {
+            const int i = std::min(x / distance_cell, cells_x - 1);
+            double distance;
+
+            if (node_row && (x % distance_cell == 0 || x == width - 1)) {
+                const int ni = x == width - 1 ? cells_x : x / distance_cell;
+                const int nj = y == height - 1 ? cells_y : y / distance_cell;
+                distance = nodes[nj * (cells_x + 1) + ni].estimate;
+                ++iterated;
+            } else if (skipped_cells[j * cells_x + i]) {
+                // the bound any corner disk gives this pixel
+                distance = 0.0;
+                for (int corner = 0; corner < 4; ++corner) {
+                    const int ci = i + corner % 2;
+                    const int cj = j + corner / 2;
+                    const double bound = nodes[cj * (cells_x + 1) + ci].bound;
+                    distance = std::max(distance, bound - std::hypot(x - node_x(ci), y - node_y(cj)));
+                }
+                ++skipped;
+            } else {
+                distance = distance_at(x, y).estimate;
+                ++iterated;
+            }
+
+            image.set_pixel(x, y, colorizer(distance));
+        }
+    }
+
+    volatile double time_end = omp_get_wtime();
+
+    LOG_INFO("Distance estimation iterated {} of {} pixels in {:.3f} seconds", iterated, iterated + skipped, time_end - time_start);
+    return { iterated, skipped };
+}
+
+// picks the path for this image; channels beyond mu rule out the paths that can't fill them
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <typename Sink>
+void FractalRenderer<Colorizer, Iterate, Init, Param>::render_escapes(
+    const ViewportMapping& mapping,
+    int width, int height,
+    FieldChannels channels,
+    bool explicit_mapping,
+    Sink& sink
+) const {
     LOG_INFO("Starting fractal rendering: {}x{}, max_iter={}, escape_radius={:.2f}",
-        image.width(), image.height(),
+        width, height,
         m_config.max_iter, m_config.escape_radius
     );
 
+    TRACE_SCOPE("render", {"width", width}, {"height", height});
+
     volatile double time_start = omp_get_wtime();
 
-    const double viewport_height = m_viewport.width * image.height() / image.width();
+    const EscapeLimits limits = escape_limits(mapping);
+    Precision precision = resolve_precision(mapping);
 
-    const double vp_min_real = m_viewport.center.real() - m_viewport.width / 2;
-    const double vp_max_imag = m_viewport.center.imag() + viewport_height / 2;
+    if (explicit_mapping && (precision == Precision::DoubleDouble || precision == Precision::Perturbation)) {
+        LOG_WARN("Partial frames are rendered in double precision only");
+        precision = Precision::Double;
+    }
 
-    const double real_step = m_viewport.width / (image.width()  - 1);
-    const double imag_step = viewport_height / (image.height() - 1);
+    // the distance estimate comes out of the derivative loop
+    const bool derivative = channels.derivative || channels.distance;
 
-    const double escape_radius_sq = m_config.escape_radius * m_config.escape_radius;
+    if (derivative && !tracks_derivative())
+        throw std::runtime_error("Derivative channels require built-in pixel functors and formulas::Quadratic or a derivative func");
 
-    #pragma omp parallel for collapse(2) schedule(static)
-    for (int y = 0; y < image.height(); ++y) {
-        for (int x = 0; x < image.width(); ++x) {
+    if ((channels.final_z || derivative) && precision == Precision::Perturbation)
+        throw std::runtime_error("Perturbation only produces mu, extra field channels are not available");
 
-            math::Complex pixel = pixel_to_complex(x, y, vp_min_real, vp_max_imag, real_step, imag_step);
+    // filled pixels have no orbit, so subdivision is only used for plain mu
+    const bool subdivide = m_options.strategy == Strategy::Subdivision && !channels.final_z && !derivative;
 
-            math::Complex z = m_init(pixel);
-            math::Complex c = m_param(pixel);
+    // every path is a trace scope and, with a counting sink, a phase of the stats, named after it;
+    // subdivision and perturbation run loops of their own that report no busy time
+    switch (precision) {
+        case Precision::Perturbation:
+            if constexpr (supports_perturbation) {
+                [[maybe_unused]] const auto phase = stats_phase(sink, "perturbation", false);
+                TRACE_SCOPE("perturbation");
+                render_perturbation(width, height, sink);
+            }
+            break;
 
-            int iter = 0;
-            while (iter < m_config.max_iter) {
-                const double zr = z.real();
-                const double zi = z.imag();
+        case Precision::DoubleDouble:
+            if constexpr (supports_double_double) {
+                if (derivative) {
+                    [[maybe_unused]] const auto phase = stats_phase(sink, "double-double derivative", true);
+                    TRACE_SCOPE("double-double derivative");
+                    render_double_double<true>(width, height, mapping, limits, false, sink);
+                } else {
+                    [[maybe_unused]] const auto phase = stats_phase(sink, subdivide ? "double-double subdivision" : "double-double", !subdivide);
+                    TRACE_SCOPE(subdivide ? "double-double subdivision" : "double-double");
+                    render_double_double<false>(width, height, mapping, limits, subdivide, sink);
+                }
+            }
+            break;
 
-                if (zr * zr + zi * zi > escape_radius_sq) {
+        case Precision::Float:
+            if constexpr (supports_simd) {
+                if (m_options.kernel == Kernel::Simd && !subdivide && !derivative) {
+                    [[maybe_unused]] const auto phase = stats_phase(sink, "simd float", true);
+                    TRACE_SCOPE("simd float");
+                    render_float(width, height, mapping, limits, sink);
                     break;
                 }
+            }
+            [[fallthrough]];
+
+        default: {
+            auto pixel_at = [&](int x, int y) { return mapping.pixel(x, y); };
 
-                z = m_iterate(z, c);
-                ++iter;
+            if (derivative) {
+                [[maybe_unused]] const auto phase = stats_phase(sink, "double derivative", true);
+                TRACE_SCOPE("double derivative");
+                render_pixels<math::Complex, true>(width, height, limits, false, pixel_at, sink);
+                break;
             }
 
-            double mu = calc_mu(z, iter, m_config.max_iter);
+            if constexpr (supports_simd) {
+                if (m_options.kernel == Kernel::Simd && !subdivide) {
+                    [[maybe_unused]] const auto phase = stats_phase(sink, "simd double", true);
+                    TRACE_SCOPE("simd double");
+                    render_simd<double>(width, height, pixel_at, limits, sink);
+                    break;
+                }
+            }
 
-            image.set_pixel(x, y, m_colorizer(mu, m_config.max_iter));
+            [[maybe_unused]] const auto phase = stats_phase(sink, subdivide ? "double subdivision" : "double", !subdivide);
+            TRACE_SCOPE(subdivide ? "double subdivision" : "double");
+            render_pixels<math::Complex, false>(width, height, limits, subdivide, pixel_at, sink);
+            break;
         }
     }
 
@@ -105,4 +586,724 @@ void FractalRenderer<Colorizer>::render(Image& image) const {
     LOG_INFO("Fractal rendering completed in {:.3f} seconds", time_end - time_start);
 }
 
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+Precision FractalRenderer<Colorizer, Iterate, Init, Param>::resolve_precision(const ViewportMapping& mapping) const {
+    if (m_options.precision != Precision::Auto)
+        return m_options.precision;
+
+    Precision precision = select_precision(m_viewport, std::min(mapping.real_step, mapping.imag_step), m_config.max_iter);
+
+    // only the vector kernel has a float variant
+    if (precision == Precision::Float && !(supports_simd && m_options.kernel == Kernel::Simd))
+        precision = Precision::Double;
+
+    if (precision == Precision::Perturbation && !supports_perturbation)
+        precision = Precision::DoubleDouble;
+
+    if (precision == Precision::DoubleDouble && !supports_double_double) {
+        LOG_WARN("Viewport is too deep for double, but the functors can't run in double-double");
+        precision = Precision::Double;
+    }
+
+    return precision;
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+utils::WorkStealingPool& FractalRenderer<Colorizer, Iterate, Init, Param>::pool() const {
+    return m_options.pool ? *m_options.pool : utils::WorkStealingPool::shared();
+}
+
+// an orbit coming back closer than this many pixels is taken as periodic
+inline constexpr double cycle_tolerance_pixels = 1e-3;
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+auto FractalRenderer<Colorizer, Iterate, Init, Param>::escape_limits(const ViewportMapping& mapping) const -> EscapeLimits {
+    EscapeLimits limits { m_config.escape_radius * m_config.escape_radius, 0.0 };
+
+    if (m_options.cycle_detection) {
+        const double tolerance = std::min(mapping.real_step, mapping.imag_step) * cycle_tolerance_pixels;
+        limits.cycle_tolerance_sq = tolerance * tolerance;
+    }
+
+    return limits;
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <typename Cx>
+bool FractalRenderer<Colorizer, Iterate, Init, Param>::known_interior(const Cx& c) {
+    if constexpr (formulas::is_mandelbrot_v<Iterate, Init, Param>) {
+        return in_main_cardioid(c.real(), c.imag()) || in_period2_bulb(c.real(), c.imag());
+    } else {
+        return false;
+    }
+}
+
+// one pixel of the generic loop, identical for every complex type
+// the periodicity check is Brent's: the orbit is compared with a point saved at iterations 1, 2, 4, ...
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <typename Cx, bool Derivative>
+Escape FractalRenderer<Colorizer, Iterate, Init, Param>::escape(const Cx& pixel, const EscapeLimits& limits) const {
+    Cx z = m_init(pixel);
+    Cx c = m_param(pixel);
+
+    if (known_interior(c))
+        return { m_config.max_iter, static_cast<double>(m_config.max_iter), math::Complex(z), math::Complex::Zero(), 0.0, true };
+
+    // dz / dpixel, starting from the derivatives of m_init and m_param
+    math::Complex dz = math::Complex::Zero();
+    math::Complex dc = math::Complex::Zero();
+    if constexpr (Derivative) {
+        dz = math::Complex(formulas::constant_derivative_v<Init>, 0.0);
+        dc = math::Complex(formulas::constant_derivative_v<Param>, 0.0);
+    }
+
+    Cx saved = z;
+    int save_at = 1;
+
+    int iter = 0;
+    int cycle_iter = 0;
+    while (iter < m_config.max_iter) {
+        const math::Complex zd(z);
+        const double zr = zd.real();
+        const double zi = zd.imag();
+
+        if (zr * zr + zi * zi > limits.escape_radius_sq) {
+            break;
+        }
+
+        // z^2 + c inlined, custom iterations through their derivative func
+        if constexpr (Derivative) {
+            if constexpr (std::same_as<Iterate, formulas::Quadratic>)
+                dz = 2.0 * zd * dz + dc;
+            else
+                dz = m_options.derivative(zd, dz, dc);
+        }
+
+        z = m_iterate(z, c);
+        ++iter;
+
+        if (limits.cycle_tolerance_sq > 0) {
+            const math::Complex d(z - saved);
+
+            if (d.real() * d.real() + d.imag() * d.imag() < limits.cycle_tolerance_sq) {
+                cycle_iter = iter;
+                iter = m_config.max_iter;
+                break;
+            }
+
+            if (iter == save_at) {
+                saved = z;
+                save_at *= 2;
+            }
+        }
+    }
+
+    const math::Complex zd(z);
+    Escape result { iter, calc_mu(zd, iter, m_config.max_iter), zd, dz };
+    result.cycle_iter = cycle_iter;
+
+    if constexpr (Derivative)
+        result.distance = distance_estimate(zd, dz, iter, m_config.max_iter);
+    return result;
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <typename Cx, bool Derivative, typename PixelAt, typename Sink>
+void FractalRenderer<Colorizer, Iterate, Init, Param>::render_pixels(int width, int height, const EscapeLimits& limits, bool subdivide, PixelAt pixel_at, Sink& sink) const {
+    if constexpr (!Derivative) {
+        if (subdivide) {
+            render_subdivided<Cx>(width, height, limits, pixel_at, sink);
+            return;
+        }
+    }
+
+    if (m_options.schedule == Schedule::WorkStealing) {
+        const std::vector<Tile> tiles = morton_tiles(width, height);
+
+        pool().run(static_cast<int>(tiles.size()), [&](int t, int) {
+            TRACE_SCOPE("tile", {"tile", t});
+            const double start = stats_clock(sink);
+            const Tile& tile = tiles[t];
+            for (int y = tile.y0; y < tile.y1; ++y) {
+                stats_row(sink, y, tile.x0, tile.x1, [&](int x) { return escape<Cx, Derivative>(pixel_at(x, y), limits); });
+            }
+            stats_busy(sink, start);
+        });
+        return;
+    }
+
+    #pragma omp parallel
+    {
+        TRACE_SCOPE("rows");
+        const double start = stats_clock(sink);
+
+        #pragma omp for schedule(static) nowait
+        for (int y = 0; y < height; ++y) {
+            stats_row(sink, y, 0, width, [&](int x) { return escape<Cx, Derivative>(pixel_at(x, y), limits); });
+        }
+
+        stats_busy(sink, start);
+    }
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <typename Cx, typename PixelAt, typename Sink>
+void FractalRenderer<Colorizer, Iterate, Init, Param>::render_subdivided(int width, int height, const EscapeLimits& limits, PixelAt pixel_at, Sink& sink) const {
+    std::vector<double> mu;
+    const subdivision::Stats stats = subdivision::render(width, height, m_config.max_iter,
+        [&](int x, int y) { return escape<Cx>(pixel_at(x, y), limits); },
+        mu
+    );
+
+    LOG_INFO("Subdivision iterated {} of {} pixels", stats.computed, stats.computed + stats.filled);
+
+    #pragma omp parallel for schedule(static)
+    for (int y = 0; y < height; ++y) {
+        stats_row(sink, y, 0, width, [&](int x) {
+            const double value = mu[y * width + x];
+            return Escape { static_cast<int>(value), value };
+        });
+    }
+}
+
+// whole rows (or tile rows) go through the vectorized kernel, z0 and c still come from m_init / m_param
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <typename T, typename PixelAt, typename Sink>
+void FractalRenderer<Colorizer, Iterate, Init, Param>::render_simd(int width, int height, PixelAt pixel_at, const EscapeLimits& limits, Sink& sink) const {
+    if (m_options.schedule == Schedule::WorkStealing) {
+        utils::WorkStealingPool& workers = pool();
+        const std::vector<Tile> tiles = morton_tiles(width, height);
+
+        std::vector<simd::BasicQuadraticBuffers<T>> buffers(workers.thread_count(), simd::BasicQuadraticBuffers<T>(default_tile_size));
+        std::vector<std::vector<int>> slots(workers.thread_count(), std::vector<int>(default_tile_size));
+
+        workers.run(static_cast<int>(tiles.size()), [&](int t, int worker) {
+            TRACE_SCOPE("tile", {"tile", t});
+            const double start = stats_clock(sink);
+            const Tile& tile = tiles[t];
+            for (int y = tile.y0; y < tile.y1; ++y)
+                render_simd_row(pixel_at, limits, y, tile.x0, tile.x1, buffers[worker], slots[worker], sink);
+            stats_busy(sink, start);
+        });
+        return;
+    }
+
+    #pragma omp parallel
+    {
+        TRACE_SCOPE("rows");
+        const double start = stats_clock(sink);
+        simd::BasicQuadraticBuffers<T> buffers(width);
+        std::vector<int> slot(width);
+
+        #pragma omp for schedule(static) nowait
+        for (int y = 0; y < height; ++y)
+            render_simd_row(pixel_at, limits, y, 0, width, buffers, slot, sink);
+
+        stats_busy(sink, start);
+    }
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <typename T, typename PixelAt, typename Sink>
+void FractalRenderer<Colorizer, Iterate, Init, Param>::render_simd_row(
+    PixelAt& pixel_at,
+    const EscapeLimits& limits,
+    int y, int x0, int x1,
+    simd::BasicQuadraticBuffers<T>& buffers,
+    std::vector<int>& slot,
+    Sink& sink
+) const {
+    // lane slot of every pixel, negative for pixels known to be interior: -1 - the next pixel's lane
+    int count = 0;
+
+    for (int x = x0; x < x1; ++x) {
+        const math::Complex pixel = pixel_at(x, y);
+        const math::Complex z = m_init(pixel);
+        const math::Complex c = m_param(pixel);
+
+        if (known_interior(c)) {
+            slot[x - x0] = -1 - count;
+            continue;
+        }
+
+        slot[x - x0] = count;
+        buffers.z_real[count] = static_cast<T>(z.real());
+        buffers.z_imag[count] = static_cast<T>(z.imag());
+        buffers.c_real[count] = static_cast<T>(c.real());
+        buffers.c_imag[count] = static_cast<T>(c.imag());
+        ++count;
+    }
+
+    simd::iterate_quadratic(buffers.span(count), m_config.max_iter, limits.escape_radius_sq, limits.cycle_tolerance_sq);
+
+    // counted from the lanes in loops of their own, the loop below calls out for the logs of calc_mu
+    const int* cycle_iter = limits.cycle_tolerance_sq > 0 ? buffers.cycle_iter.data() : nullptr;
+    stats_lanes(sink, y, x0, x1, slot.data(), count, buffers.iter.data(), cycle_iter);
+    auto& target = stats_target(sink);
+
+    for (int x = x0; x < x1; ++x) {
+        Escape escape { m_config.max_iter, static_cast<double>(m_config.max_iter) };
+
+        if (const int i = slot[x - x0]; i >= 0) {
+            escape.iter = buffers.iter[i];
+            escape.z = math::Complex::Algebraic(buffers.out_real[i], buffers.out_imag[i]);
+            escape.mu = calc_mu(escape.z, escape.iter, m_config.max_iter);
+            escape.cycle_iter = buffers.cycle_iter[i];
+        } else {
+            escape.settled = true;
+        }
+
+        target(x, y, escape);
+    }
+}
+
+// rows at a time plus one halo row on each side, the check needs the 4-neighbours
+inline constexpr int float_strip_rows = 32;
+
+// a float pixel is kept while its rounding error, about mu times the mu step to its 4-neighbours,
+// stays within float_iterations, or when it lies inside an interior region;
+// the rest, mostly boundary pixels, is iterated again in double
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <typename Sink>
+void FractalRenderer<Colorizer, Iterate, Init, Param>::render_float(int width, int height, const ViewportMapping& mapping, const EscapeLimits& limits, Sink& sink) const {
+    const double budget = float_iterations(m_viewport, std::min(mapping.real_step, mapping.imag_step));
+    const double interior_mu = m_config.max_iter;
+    const int strips = (height + float_strip_rows - 1) / float_strip_rows;
+
+    struct Scratch {
+        explicit Scratch(int width)
+            : lanes(width), slot(width), fallback(width)
+            , escapes(static_cast<size_t>(float_strip_rows + 2) * width), mu(escapes.size()) {}
+
+        simd::QuadraticBuffersF lanes;
+        std::vector<int> slot;
+        simd::QuadraticBuffers fallback;
+        std::vector<Escape> escapes; // strip rows with their halo
+        std::vector<double> mu;      // escapes[i].mu packed for the neighbour check
+        std::vector<int> rerun;
+    };
+
+    std::atomic<long> reruns = 0;
+    auto pixel_at = [&](int x, int y) { return mapping.pixel(x, y); };
+
+    auto render_strip = [&](int s, Scratch& scratch) {
+        const int y0 = s * float_strip_rows;
+        const int y1 = std::min(height, y0 + float_strip_rows);
+        const int top = std::max(0, y0 - 1);
+        const int bottom = std::min(height, y1 + 1);
+
+        auto index = [&](int x, int y) { return static_cast<size_t>(y - top) * width + x; };
+        auto store = [&](int x, int y, const Escape& escape) {
+            scratch.escapes[index(x, y)] = escape;
+            scratch.mu[index(x, y)] = escape.mu;
+        };
+
+        for (int y = top; y < bottom; ++y)
+            render_simd_row(pixel_at, limits, y, 0, width, scratch.lanes, scratch.slot, store);
+
+        scratch.rerun.clear();
+        for (int y = y0; y < y1; ++y) {
+            const double* row = scratch.mu.data() + index(0, y);
+            const double* above = y > top ? row - width : row;
+            const double* below = y + 1 < bottom ? row + width : row;
+
+            for (int x = 0; x < width; ++x) {
+                const double mu = row[x];
+                const double left = row[x > 0 ? x - 1 : x];
+                const double right = row[x + 1 < width ? x + 1 : x];
+
+                const double gradient = std::max(
+                    std::max(std::abs(mu - left), std::abs(mu - right)),
+                    std::max(std::abs(mu - above[x]), std::abs(mu - below[x]))
+                );
+
+                const bool trusted = mu >= interior_mu ? gradient == 0.0 : mu * (1.0 + gradient) <= budget;
+                if (!trusted)
+                    scratch.rerun.push_back(static_cast<int>(index(x, y)));
+            }
+        }
+
+        // the halo rows are not rewritten, the next strip owns them
+        simd::QuadraticBuffers& fallback = scratch.fallback;
+
+        for (size_t first = 0; first < scratch.rerun.size(); first += width) {
+            const int count = static_cast<int>(std::min(scratch.rerun.size() - first, static_cast<size_t>(width)));
+
+            for (int k = 0; k < count; ++k) {
+                const int i = scratch.rerun[first + k];
+                const math::Complex pixel = mapping.pixel(i % width, top + i / width);
+                const math::Complex z = m_init(pixel);
+                const math::Complex c = m_param(pixel);
+
+                fallback.z_real[k] = z.real();
+                fallback.z_imag[k] = z.imag();
+                fallback.c_real[k] = c.real();
+                fallback.c_imag[k] = c.imag();
+            }
+
+            simd::iterate_quadratic(fallback.span(count), m_config.max_iter, limits.escape_radius_sq, limits.cycle_tolerance_sq);
+
+            for (int k = 0; k < count; ++k) {
+                Escape& escape = scratch.escapes[scratch.rerun[first + k]];
+                escape.iter = fallback.iter[k];
+                escape.z = math::Complex::Algebraic(fallback.out_real[k], fallback.out_imag[k]);
+                escape.mu = calc_mu(escape.z, escape.iter, m_config.max_iter);
+                escape.cycle_iter = fallback.cycle_iter[k];
+                escape.settled = false;
+            }
+        }
+
+        reruns += static_cast<long>(scratch.rerun.size());
+
+        for (int y = y0; y < y1; ++y)
+            stats_row(sink, y, 0, width, [&](int x) -> const Escape& { return scratch.escapes[index(x, y)]; });
+    };
+
+    if (m_options.schedule == Schedule::WorkStealing) {
+        utils::WorkStealingPool& workers = pool();
+        std::vector<Scratch> scratch(workers.thread_count(), Scratch(width));
+
+        workers.run(strips, [&](int s, int worker) {
+            TRACE_SCOPE("strip", {"strip", s});
+            const double start = stats_clock(sink);
+            render_strip(s, scratch[worker]);
+            stats_busy(sink, start);
+        });
+    } else {
+        #pragma omp parallel
+        {
+            TRACE_SCOPE("strips");
+            const double start = stats_clock(sink);
+            Scratch scratch(width);
+
+            #pragma omp for schedule(dynamic) nowait
+            for (int s = 0; s < strips; ++s)
+                render_strip(s, scratch);
+
+            stats_busy(sink, start);
+        }
+    }
+
+    LOG_INFO("Float kernel left {} of {} pixels to double", reruns.load(), static_cast<long>(width) * height);
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+math::DoubleDoubleComplex FractalRenderer<Colorizer, Iterate, Init, Param>::double_double_center() const {
+    auto to_double_double = [](const math::BigFloat& v) {
+        const double hi = v.to_double();
+        const double lo = (v - math::BigFloat(hi, v.precision_bits())).to_double();
+        return math::DoubleDouble::Sum(hi, lo);
+    };
+
+    if (!m_options.deep_center)
+        return math::DoubleDoubleComplex(m_viewport.center);
+
+    return math::DoubleDoubleComplex(
+        to_double_double(m_options.deep_center->real),
+        to_double_double(m_options.deep_center->imag)
+    );
+}
+
+// mid-depth zoom: pixels are the center plus a small offset, summed exactly in double-double
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <bool Derivative, typename Sink>
+void FractalRenderer<Colorizer, Iterate, Init, Param>::render_double_double(int width, int height, const ViewportMapping& mapping, const EscapeLimits& limits, bool subdivide, Sink& sink) const {
+    const math::DoubleDoubleComplex center = double_double_center();
+
+    const double half_width = m_viewport.width / 2;
+    const double half_height = mapping.imag_step * (height - 1) / 2;
+
+    render_pixels<math::DoubleDoubleComplex, Derivative>(width, height, limits, subdivide, [&](int x, int y) {
+        const math::Complex offset(x * mapping.real_step - half_width, half_height - y * mapping.imag_step);
+        return center + math::DoubleDoubleComplex(offset);
+    }, sink);
+}
+
+// deep zoom, the perturbation engine computes mu and we only pass it on
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <typename Sink>
+void FractalRenderer<Colorizer, Iterate, Init, Param>::render_perturbation(int width, int height, Sink& sink) const {
+    perturbation::Params params {
+        perturbation::Family::Mandelbrot,
+        m_options.deep_center.value_or(DeepCenter {
+            math::BigFloat(m_viewport.center.real()),
+            math::BigFloat(m_viewport.center.imag())
+        }),
+        math::Complex::Zero(),
+        m_viewport.width,
+        m_config
+    };
+
+    if constexpr (formulas::is_julia_v<Iterate, Init, Param>) {
+        params.family = perturbation::Family::Julia;
+        params.julia_c = m_param.value;
+    }
+
+    std::vector<double> mu;
+    const perturbation::Report report = perturbation::render(params, width, height, mu);
+
+    LOG_INFO("Perturbation used {} reference orbits", report.references);
+
+    #pragma omp parallel for schedule(static)
+    for (int y = 0; y < height; ++y) {
+        stats_row(sink, y, 0, width, [&](int x) {
+            const double value = mu[y * width + x];
+            return Escape { static_cast<int>(value), value };
+        });
+    }
+}
+
+// resumable deepening
+
+// orbits per batch of a resumable pass
+inline constexpr int resume_batch_size = 1024;
+
+struct ResumeBatch {
+    explicit ResumeBatch(int capacity)
+    : orbits(capacity), pixel(capacity)
+    , saved_real(capacity), saved_imag(capacity)
+    , out_saved_real(capacity), out_saved_imag(capacity)
+    , cycled(capacity) {}
+
+    simd::QuadraticBuffers orbits;
+    std::vector<int> pixel;
+    std::vector<double> saved_real, saved_imag;
+    std::vector<double> out_saved_real, out_saved_imag;
+    std::vector<unsigned char> cycled;
+};
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+ResumeStats FractalRenderer<Colorizer, Iterate, Init, Param>::render_field(EscapeField& field, IterationState& state) const {
+    if (field.channels().derivative || field.channels().distance)
+        throw std::runtime_error("Resumable passes only fill mu and final_z");
+
+    const int width = field.width();
+    const int height = field.height();
+    const ViewportMapping mapping = ViewportMapping::from(m_viewport, width, height);
+    const EscapeLimits limits = escape_limits(mapping);
+
+    const Precision precision = resolve_precision(mapping);
+    if (precision == Precision::DoubleDouble || precision == Precision::Perturbation)
+        LOG_WARN("Resumable passes are rendered in double precision only");
+
+    volatile double time_start = omp_get_wtime();
+
+    FormulaIdentity formula = formula_identity(m_iterate, m_init, m_param);
+
+    ResumeStats stats;
+    stats.resumed = state.max_iter > 0 && state.max_iter <= m_config.max_iter
+        && state.width == width && state.height == height && state.mapping == mapping
+        && state.escape_radius_sq == limits.escape_radius_sq && state.cycle_tolerance_sq == limits.cycle_tolerance_sq
+        && state.formula == formula;
+
+    // pixels an earlier pass proved interior stay interior at the new max_iter
+    if (stats.resumed && state.max_iter < m_config.max_iter) {
+        const double previous = state.max_iter;
+
+        #pragma omp parallel for collapse(2) schedule(static)
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                if (field.mu(x, y) == previous)
+                    field.set_mu(x, y, m_config.max_iter);
+    }
+
+    field.set_max_iter(m_config.max_iter);
+
+    const IterationState* source = stats.resumed ? &state : nullptr;
+    const long orbits = stats.resumed ? state.running() : static_cast<long>(width) * height;
+    const int batches = static_cast<int>((orbits + resume_batch_size - 1) / resume_batch_size);
+
+    std::vector<IterationState> kept(batches);
+    std::vector<long> iterated(batches);
+
+    auto run = [&](int b, ResumeBatch& batch) {
+        const long first = static_cast<long>(b) * resume_batch_size;
+        const int count = static_cast<int>(std::min<long>(resume_batch_size, orbits - first));
+        iterated[b] = resume_orbits(source, first, count, mapping, limits, field, batch, kept[b]);
+    };
+
+    if (m_options.schedule == Schedule::WorkStealing) {
+        utils::WorkStealingPool& workers = pool();
+        std::vector<ResumeBatch> buffers(workers.thread_count(), ResumeBatch(resume_batch_size));
+
+        workers.run(batches, [&](int b, int worker) { run(b, buffers[worker]); });
+    } else {
+        #pragma omp parallel
+        {
+            ResumeBatch batch(resume_batch_size);
+
+            #pragma omp for schedule(dynamic)
+            for (int b = 0; b < batches; ++b)
+                run(b, batch);
+        }
+    }
+
+    const int from = stats.resumed ? state.max_iter : 0;
+
+    IterationState next;
+    next.width = width;
+    next.height = height;
+    next.mapping = mapping;
+    next.escape_radius_sq = limits.escape_radius_sq;
+    next.cycle_tolerance_sq = limits.cycle_tolerance_sq;
+    next.formula = std::move(formula);
+    next.max_iter = m_config.max_iter;
+
+    for (int b = 0; b < batches; ++b) {
+        stats.iterated += iterated[b];
+        next.pixel.insert(next.pixel.end(), kept[b].pixel.begin(), kept[b].pixel.end());
+        next.z_real.insert(next.z_real.end(), kept[b].z_real.begin(), kept[b].z_real.end());
+        next.z_imag.insert(next.z_imag.end(), kept[b].z_imag.begin(), kept[b].z_imag.end());
+        next.saved_real.insert(next.saved_real.end(), kept[b].saved_real.begin(), kept[b].saved_real.end());
+        next.saved_imag.insert(next.saved_imag.end(), kept[b].saved_imag.begin(), kept[b].saved_imag.end());
+    }
+
+    stats.running = next.running();
+    state = std::move(next);
+
+    volatile double time_end = omp_get_wtime();
+
+    LOG_INFO("Resumable pass: {} orbits from iteration {} to {}, {} still running ({} KiB), {:.3f} seconds",
+        stats.iterated, from, m_config.max_iter, stats.running, state.bytes() / 1024, time_end - time_start);
+
+    return stats;
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+long FractalRenderer<Colorizer, Iterate, Init, Param>::resume_orbits(
+    const IterationState* source,
+    long first, int count,
+    const ViewportMapping& mapping,
+    const EscapeLimits& limits,
+    EscapeField& field,
+    ResumeBatch& batch,
+    IterationState& kept
+) const {
+    const int width = field.width();
+    const int max_iter = m_config.max_iter;
+    const int from = source ? source->max_iter : 0;
+
+    // gather, a fresh pass starts every pixel from m_init and settles the analytic interior right away
+    int n = 0;
+    for (int i = 0; i < count; ++i) {
+        const long entry = first + i;
+        const int index = source ? source->pixel[entry] : static_cast<int>(entry);
+        const int x = index % width;
+        const int y = index / width;
+
+        const math::Complex pixel = mapping.pixel(x, y);
+        const math::Complex c = m_param(pixel);
+        math::Complex z;
+        math::Complex saved;
+
+        if (source) {
+            z = math::Complex::Algebraic(source->z_real[entry], source->z_imag[entry]);
+            saved = math::Complex::Algebraic(source->saved_real[entry], source->saved_imag[entry]);
+        } else {
+            z = m_init(pixel);
+            saved = z;
+
+            if (known_interior(c)) {
+                field.store(x, y, Escape { max_iter, static_cast<double>(max_iter), z });
+                continue;
+            }
+        }
+
+        batch.pixel[n] = index;
+        batch.orbits.z_real[n] = z.real();
+        batch.orbits.z_imag[n] = z.imag();
+        batch.orbits.c_real[n] = c.real();
+        batch.orbits.c_imag[n] = c.imag();
+        batch.saved_real[n] = saved.real();
+        batch.saved_imag[n] = saved.imag();
+        ++n;
+    }
+
+    bool vectorized = false;
+    if constexpr (supports_simd) {
+        if (m_options.kernel == Kernel::Simd) {
+            simd::QuadraticSpan span = batch.orbits.span(n);
+            span.start_iter = from;
+            span.saved_real = batch.saved_real.data();
+            span.saved_imag = batch.saved_imag.data();
+            span.out_saved_real = batch.out_saved_real.data();
+            span.out_saved_imag = batch.out_saved_imag.data();
+            span.cycled = batch.cycled.data();
+
+            simd::iterate_quadratic(span, max_iter, limits.escape_radius_sq, limits.cycle_tolerance_sq);
+            vectorized = true;
+        }
+    }
+
+    if (!vectorized) {
+        for (int i = 0; i < n; ++i) {
+            math::Complex z = math::Complex::Algebraic(batch.orbits.z_real[i], batch.orbits.z_imag[i]);
+            math::Complex saved = math::Complex::Algebraic(batch.saved_real[i], batch.saved_imag[i]);
+            const math::Complex c = math::Complex::Algebraic(batch.orbits.c_real[i], batch.orbits.c_imag[i]);
+
+            int iter = from;
+            batch.cycled[i] = continue_orbit(z, saved, iter, c, limits);
+
+            batch.orbits.out_real[i] = z.real();
+            batch.orbits.out_imag[i] = z.imag();
+            batch.orbits.iter[i] = iter;
+            batch.out_saved_real[i] = saved.real();
+            batch.out_saved_imag[i] = saved.imag();
+        }
+    }
+
+    // scatter, only orbits that neither escaped nor cycled go on to the next pass
+    for (int i = 0; i < n; ++i) {
+        const int x = batch.pixel[i] % width;
+        const int y = batch.pixel[i] / width;
+        const int iter = batch.orbits.iter[i];
+        const math::Complex z = math::Complex::Algebraic(batch.orbits.out_real[i], batch.orbits.out_imag[i]);
+
+        field.store(x, y, Escape { iter, calc_mu(z, iter, max_iter), z });
+
+        if (iter >= max_iter && !batch.cycled[i])
+            kept.push_back(batch.pixel[i], z.real(), z.imag(), batch.out_saved_real[i], batch.out_saved_imag[i]);
+    }
+
+    return n;
+}
+
+// the loop of escape() without the derivative, picked up at any iteration
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+bool FractalRenderer<Colorizer, Iterate, Init, Param>::continue_orbit(
+    math::Complex& z,
+    math::Complex& saved,
+    int& iter,
+    const math::Complex& c,
+    const EscapeLimits& limits
+) const {
+    int save_at = 1;
+    while (save_at <= iter)
+        save_at *= 2;
+
+    while (iter < m_config.max_iter) {
+        if (z.real() * z.real() + z.imag() * z.imag() > limits.escape_radius_sq)
+            return false;
+
+        z = m_iterate(z, c);
+        ++iter;
+
+        if (limits.cycle_tolerance_sq > 0) {
+            const math::Complex d = z - saved;
+
+            if (d.real() * d.real() + d.imag() * d.imag() < limits.cycle_tolerance_sq) {
+                iter = m_config.max_iter;
+                return true;
+            }
+
+            if (iter == save_at) {
+                saved = z;
+                save_at *= 2;
+            }
+        }
+    }
+
+    return false;
+}
+
 } // namespace iheay::fractal
@@ -8,119 +8,256 @@ namespace iheay::fractal {
 // private constructor
 
 
-template <ColorizerConcept Colorizer>
-FractalRendererBuilder<Colorizer>::FractalRendererBuilder(
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::FractalRendererBuilder(
     FractalConfig config,
     Viewport viewport,
-    IterationFunc iterate,
-    InitialFunc init,
-    ParamFunc param,
-    Colorizer colorizer
+    Iterate iterate,
+    Init init,
+    Param param,
+    Colorizer colorizer,
+    RenderOptions options
 )
 : m_config(config)
 , m_viewport(viewport)
-, m_iterate(iterate)
-, m_init(init)
-, m_param(param)
-, m_colorizer(colorizer) {}
+, m_iterate(std::move(iterate))
+, m_init(std::move(init))
+, m_param(std::move(param))
+, m_colorizer(std::move(colorizer))
+, m_options(options) {}
+
+// converting constructor
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <IterationConcept OtherIterate, InitialConcept OtherInit, ParamConcept OtherParam>
+requires std::constructible_from<Iterate, OtherIterate>
+      && std::constructible_from<Init, OtherInit>
+      && std::constructible_from<Param, OtherParam>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::FractalRendererBuilder(
+    const FractalRendererBuilder<Colorizer, OtherIterate, OtherInit, OtherParam>& other
+)
+: m_config(other.m_config)
+, m_viewport(other.m_viewport)
+, m_iterate(other.m_iterate)
+, m_init(other.m_init)
+, m_param(other.m_param)
+, m_colorizer(other.m_colorizer)
+, m_options(other.m_options) {}
 
 // getting builder with initial values for parameters
 
-template <ColorizerConcept Colorizer>
-FractalRendererBuilder<Colorizer> FractalRendererBuilder<Colorizer>::get_builder() {
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRendererBuilder<Colorizer, formulas::Quadratic, formulas::Identity, formulas::Zero>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::get_builder() {
 
-    return FractalRendererBuilder<Colorizer>(
+    return FractalRendererBuilder<Colorizer, formulas::Quadratic, formulas::Identity, formulas::Zero>(
         {300, 2},
         {3, 0},
-        [](const math::Complex& z, const math::Complex& c) { return z * z + c; },
-        [](const math::Complex& pixel) { return pixel; },
-        [](const math::Complex&) { return math::Complex::Zero(); },
+        formulas::Quadratic{},
+        formulas::Identity{},
+        formulas::Zero{},
         Colorizer{}
     );
 }
 
 // ---------------- build ----------------
 
-template <ColorizerConcept Colorizer>
-FractalRenderer<Colorizer> FractalRendererBuilder<Colorizer>::build() const {
-    return FractalRenderer<Colorizer>(
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRenderer<Colorizer, Iterate, Init, Param>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::build() const {
+    using Renderer = FractalRenderer<Colorizer, Iterate, Init, Param>;
+
+    if (m_options.kernel == Kernel::Simd && !Renderer::supports_simd)
+        throw std::runtime_error("SIMD kernel requires formulas::Quadratic iteration");
+
+    if (m_options.precision == Precision::Float && m_options.kernel != Kernel::Simd)
+        throw std::runtime_error("Float precision requires the SIMD kernel");
+
+    if (m_options.precision == Precision::Float && m_config.max_iter >= (1 << 24))
+        throw std::runtime_error("Float precision counts iterations only below 2^24");
+
+    if (m_options.precision == Precision::Perturbation && !Renderer::supports_perturbation)
+        throw std::runtime_error("Perturbation requires built-in Mandelbrot or Julia functors");
+
+    if (m_options.precision == Precision::DoubleDouble && !Renderer::supports_double_double)
+        throw std::runtime_error("Double-double requires functors satisfying GenericComplexFunctor");
+
+    return Renderer(
         m_config,
         m_viewport,
         m_iterate,
         m_init,
         m_param,
-        m_colorizer
+        m_colorizer,
+        m_options
     );
 }
 
 // setting parameters
 
-template <ColorizerConcept Colorizer>
-FractalRendererBuilder<Colorizer>&
-FractalRendererBuilder<Colorizer>::set_viewport(Viewport vp) {
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>&
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::set_viewport(Viewport vp) {
     return set_viewport_width(vp.width).set_viewport_center(vp.center);
 }
 
-template <ColorizerConcept Colorizer>
-FractalRendererBuilder<Colorizer>&
-FractalRendererBuilder<Colorizer>::set_viewport_width(double width) {
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>&
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::set_viewport_width(double width) {
     if (width <= 0)
         throw std::runtime_error("Invalid viewport width");
     m_viewport.width = width;
     return *this;
 }
 
-template <ColorizerConcept Colorizer>
-FractalRendererBuilder<Colorizer>&
-FractalRendererBuilder<Colorizer>::set_viewport_center(math::Complex center) {
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>&
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::set_viewport_center(math::Complex center) {
     m_viewport.center = center;
+    m_options.deep_center.reset();
     return *this;
 }
 
-template <ColorizerConcept Colorizer>
-FractalRendererBuilder<Colorizer>&
-FractalRendererBuilder<Colorizer>::set_max_iter(int max_iter) {
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>&
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::set_max_iter(int max_iter) {
     if (max_iter <= 0)
         throw std::runtime_error("Invalid max_iter");
     m_config.max_iter = max_iter;
     return *this;
 }
 
-template <ColorizerConcept Colorizer>
-FractalRendererBuilder<Colorizer>&
-FractalRendererBuilder<Colorizer>::set_escape_radius(double escape_radius) {
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>&
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::set_escape_radius(double escape_radius) {
     if (escape_radius <= 0)
         throw std::runtime_error("Invalid escape_radius");
     m_config.escape_radius = escape_radius;
     return *this;
 }
 
-template <ColorizerConcept Colorizer>
-FractalRendererBuilder<Colorizer>&
-FractalRendererBuilder<Colorizer>::set_iteration_func(IterationFunc iterate) {
-    m_iterate = std::move(iterate);
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <IterationConcept F>
+decltype(auto)
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::set_iteration_func(F iterate) {
+    if constexpr (std::same_as<F, Iterate>) {
+        m_iterate = std::move(iterate);
+        return *this;
+    } else {
+        return rebind(std::move(iterate), m_init, m_param);
+    }
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>&
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::set_derivative_func(DerivativeFunc derivative) {
+    m_options.derivative = std::move(derivative);
+    return *this;
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <InitialConcept F>
+decltype(auto)
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::set_initial_func(F init) {
+    if constexpr (std::same_as<F, Init>) {
+        m_init = std::move(init);
+        return *this;
+    } else {
+        return rebind(m_iterate, std::move(init), m_param);
+    }
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <ParamConcept F>
+decltype(auto)
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::set_param_func(F param) {
+    if constexpr (std::same_as<F, Param>) {
+        m_param = std::move(param);
+        return *this;
+    } else {
+        return rebind(m_iterate, m_init, std::move(param));
+    }
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>&
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::set_colorizer(Colorizer colorizer) {
+    m_colorizer = std::move(colorizer);
     return *this;
 }
 
-template <ColorizerConcept Colorizer>
-FractalRendererBuilder<Colorizer>&
-FractalRendererBuilder<Colorizer>::set_initial_func(InitialFunc init) {
-    m_init = std::move(init);
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>&
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::set_kernel(Kernel kernel) {
+    m_options.kernel = kernel;
     return *this;
 }
 
-template <ColorizerConcept Colorizer>
-FractalRendererBuilder<Colorizer>&
-FractalRendererBuilder<Colorizer>::set_param_func(ParamFunc param) {
-    m_param = std::move(param);
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>&
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::set_precision(Precision precision) {
+    m_options.precision = precision;
     return *this;
 }
 
-template <ColorizerConcept Colorizer>
-FractalRendererBuilder<Colorizer>&
-FractalRendererBuilder<Colorizer>::set_colorizer(Colorizer colorizer) {
-    m_colorizer = std::move(colorizer);
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>&
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::set_strategy(Strategy strategy) {
+    m_options.strategy = strategy;
     return *this;
 }
 
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>&
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::set_cycle_detection(bool enabled) {
+    m_options.cycle_detection = enabled;
+    return *this;
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>&
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::set_schedule(Schedule schedule) {
+    m_options.schedule = schedule;
+    return *this;
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>&
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::set_thread_pool(std::shared_ptr<utils::WorkStealingPool> pool) {
+    if (!pool)
+        throw std::runtime_error("Thread pool must not be null");
+
+    m_options.pool = std::move(pool);
+    return *this;
+}
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>&
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::set_deep_center(DeepCenter center) {
+    m_viewport.center = math::Complex::Algebraic(center.real.to_double(), center.imag.to_double());
+    m_options.deep_center = std::move(center);
+    return *this;
+}
+
+// changing functor types
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+template <IterationConcept NewIterate, InitialConcept NewInit, ParamConcept NewParam>
+FractalRendererBuilder<Colorizer, NewIterate, NewInit, NewParam>
+FractalRendererBuilder<Colorizer, Iterate, Init, Param>::rebind(
+    NewIterate iterate,
+    NewInit init,
+    NewParam param
+) const {
+    return FractalRendererBuilder<Colorizer, NewIterate, NewInit, NewParam>(
+        m_config,
+        m_viewport,
+        std::move(iterate),
+        std::move(init),
+        std::move(param),
+        m_colorizer,
+        m_options
+    );
+}
+
 } // namespace iheay::fractal
@@ -0,0 +1,143 @@
+// fractal/inl/incremental_renderer.inl
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace iheay::fractal {
+
+// a shift within this fraction of a pixel counts as whole pixels
+inline constexpr double incremental_pixel_tolerance = 1e-6;
+
+template <typename Renderer>
+IncrementalRenderer<Renderer>::IncrementalRenderer(Renderer renderer, Viewport viewport, FieldChannels channels)
+: m_renderer(std::move(renderer))
+, m_initial_viewport(viewport)
+, m_channels(channels) {}
+
+template <typename Renderer>
+void IncrementalRenderer<Renderer>::resize(int width, int height) {
+    if (!m_field) {
+        set_mapping(ViewportMapping::from(m_initial_viewport, width, height), width, height);
+        return;
+    }
+
+    set_mapping(m_mapping, width, height);
+}
+
+template <typename Renderer>
+void IncrementalRenderer<Renderer>::pan(int dx, int dy) {
+    const EscapeField& current = field();
+
+    ViewportMapping moved = m_mapping;
+    moved.real_min += dx * m_mapping.real_step;
+    moved.imag_max -= dy * m_mapping.imag_step;
+
+    set_mapping(moved, current.width(), current.height());
+}
+
+template <typename Renderer>
+void IncrementalRenderer<Renderer>::set_mapping(const ViewportMapping& mapping, int width, int height) {
+    if (width <= 0 || height <= 0)
+        throw std::runtime_error("Invalid canvas size");
+
+    EscapeField next(width, height, m_channels);
+    m_stats = {};
+
+    // position of the old frame's pixel (0, 0) inside the new frame
+    int offset_x = 0;
+    int offset_y = 0;
+    bool reusable = false;
+
+    if (m_field) {
+        const double shift_x = (m_mapping.real_min - mapping.real_min) / mapping.real_step;
+        const double shift_y = (mapping.imag_max - m_mapping.imag_max) / mapping.imag_step;
+
+        reusable =
+            m_mapping.real_step == mapping.real_step &&
+            m_mapping.imag_step == mapping.imag_step &&
+            std::abs(shift_x - std::round(shift_x)) < incremental_pixel_tolerance &&
+            std::abs(shift_y - std::round(shift_y)) < incremental_pixel_tolerance &&
+            std::abs(shift_x) < width + m_field->width() &&
+            std::abs(shift_y) < height + m_field->height();
+
+        offset_x = static_cast<int>(std::round(shift_x));
+        offset_y = static_cast<int>(std::round(shift_y));
+    }
+
+    // overlap of the old frame with the new one, in new pixel coordinates
+    int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+    if (reusable) {
+        x0 = std::clamp(offset_x, 0, width);
+        y0 = std::clamp(offset_y, 0, height);
+        x1 = std::clamp(offset_x + m_field->width(), 0, width);
+        y1 = std::clamp(offset_y + m_field->height(), 0, height);
+    }
+
+    if (x0 < x1 && y0 < y1) {
+        next.copy_region(*m_field, x0 - offset_x, y0 - offset_y, x0, y0, x1 - x0, y1 - y0);
+        m_stats.copied = static_cast<long>(x1 - x0) * (y1 - y0);
+
+        // bands above and below the overlap span the full width, left and right ones only its rows
+        render_strip(next, mapping, 0, 0, width, y0);
+        render_strip(next, mapping, 0, y1, width, height - y1);
+        render_strip(next, mapping, 0, y0, x0, y1 - y0);
+        render_strip(next, mapping, x1, y0, width - x1, y1 - y0);
+    } else {
+        render_strip(next, mapping, 0, 0, width, height);
+    }
+
+    // a pure copy renders nothing, so max_iter comes from the old field
+    if (m_stats.computed == 0)
+        next.set_max_iter(m_field->max_iter());
+
+    m_field = std::move(next);
+    m_mapping = mapping;
+}
+
+template <typename Renderer>
+void IncrementalRenderer<Renderer>::render_strip(EscapeField& field, const ViewportMapping& mapping, int x0, int y0, int width, int height) {
+    if (width <= 0 || height <= 0)
+        return;
+
+    ViewportMapping strip_mapping = mapping;
+    strip_mapping.real_min = mapping.real_min + x0 * mapping.real_step;
+    strip_mapping.imag_max = mapping.imag_max - y0 * mapping.imag_step;
+
+    EscapeField strip(width, height, m_channels);
+    m_renderer.render_field(strip, strip_mapping);
+
+    field.copy_region(strip, 0, 0, x0, y0, width, height);
+    field.set_max_iter(strip.max_iter());
+
+    m_stats.computed += static_cast<long>(width) * height;
+}
+
+template <typename Renderer>
+template <raster::PixeledImage Image>
+void IncrementalRenderer<Renderer>::render(Image& image) const {
+    m_renderer.colorize(field(), image);
+}
+
+template <typename Renderer>
+const EscapeField& IncrementalRenderer<Renderer>::field() const {
+    if (!m_field)
+        throw std::runtime_error("IncrementalRenderer has no frame yet, call resize first");
+
+    return *m_field;
+}
+
+template <typename Renderer>
+Viewport IncrementalRenderer<Renderer>::viewport() const {
+    const EscapeField& current = field();
+
+    const double real_width = m_mapping.real_step * (current.width() - 1);
+    const double imag_height = m_mapping.imag_step * (current.height() - 1);
+
+    return {
+        real_width,
+        math::Complex::Algebraic(m_mapping.real_min + real_width / 2, m_mapping.imag_max - imag_height / 2)
+    };
+}
+
+} // namespace iheay::fractal
@@ -0,0 +1,80 @@
+// fractal/inl/render_stats.inl
+
+#include <algorithm>
+#include <omp.h>
+
+namespace iheay::fractal {
+
+// the empty stand-in of StatsCollector::Phase for sinks that don't count
+struct NoStatsPhase {};
+
+template <typename Sink, typename EscapeAt>
+void StatsCollector::count_row(Sink& sink, int y, int x0, int x1, EscapeAt escape_at) {
+    for (int a = x0; a < x1;) {
+        const int b = std::min(x1, (a / default_tile_size + 1) * default_tile_size);
+
+        // a local the sink never sees, so the sums stay in registers
+        PixelSums sums;
+        sums.pixels = b - a;
+        for (int x = a; x < b; ++x) {
+            const Escape& escape = escape_at(x);
+            sums.iterations += escape.iter;
+            sums.interior += escape.iter >= m_max_iter;
+            sums.settled += escape.settled;
+            sums.cycled += escape.cycle_iter > 0;
+            sums.cycle_iterations += escape.cycle_iter;
+            sink(x, y, escape);
+        }
+
+        add(a / default_tile_size, y, sums);
+        a = b;
+    }
+}
+
+template <typename Sink>
+double stats_clock(const Sink&) {
+    if constexpr (is_counting_sink_v<Sink>)
+        return omp_get_wtime();
+    else
+        return 0.0;
+}
+
+template <typename Sink>
+void stats_busy(const Sink& sink, double start) {
+    if constexpr (is_counting_sink_v<Sink>)
+        sink.collector.busy(omp_get_wtime() - start);
+}
+
+template <typename Sink>
+auto stats_phase(const Sink& sink, const char* name, bool timed_threads) {
+    if constexpr (is_counting_sink_v<Sink>)
+        return StatsCollector::Phase(sink.collector, name, timed_threads);
+    else
+        return NoStatsPhase {};
+}
+
+template <typename Sink, typename EscapeAt>
+void stats_row(Sink& sink, int y, int x0, int x1, EscapeAt escape_at) {
+    if constexpr (is_counting_sink_v<Sink>) {
+        sink.collector.count_row(sink.sink, y, x0, x1, escape_at);
+    } else {
+        for (int x = x0; x < x1; ++x)
+            sink(x, y, escape_at(x));
+    }
+}
+
+template <typename Sink>
+void stats_lanes(const Sink& sink, int y, int x0, int x1, const int* slot, int lanes, const int* iter, const int* cycle_iter) {
+    if constexpr (is_counting_sink_v<Sink>)
+        sink.collector.count_lanes(y, x0, x1, slot, lanes, iter, cycle_iter);
+}
+
+template <typename Sink>
+auto& stats_target(Sink& sink) {
+    if constexpr (is_counting_sink_v<Sink>)
+        return sink.sink;
+    else
+        return sink;
+}
+
+} // namespace iheay::fractal
@@ -0,0 +1,173 @@
+// fractal/inl/subdivision.inl
+
+#include <atomic>
+#include <omp.h>
+
+namespace iheay::fractal::subdivision {
+
+namespace detail {
+
+// rectangles smaller than this are iterated pixel by pixel
+inline constexpr int min_side = 6;
+
+// below this area a rectangle is not worth a separate task
+inline constexpr long task_area = 64 * 64;
+
+template <typename Eval>
+class Subdivider {
+public:
+    Subdivider(int width, int height, int max_iter, Eval& eval, std::vector<double>& mu)
+    : m_width(width)
+    , m_max_iter(max_iter)
+    , m_eval(eval)
+    , m_mu(mu)
+    , m_iter(static_cast<size_t>(width) * height) {}
+
+    // border pixels of [x0, x1] x [y0, y1] must be computed already
+    void split(int x0, int y0, int x1, int y1) {
+        if (x1 - x0 < min_side || y1 - y0 < min_side) {
+            for (int y = y0 + 1; y < y1; ++y)
+                for (int x = x0 + 1; x < x1; ++x)
+                    compute(x, y);
+            return;
+        }
+
+        const int iter = uniform_border(x0, y0, x1, y1);
+
+        if (iter == m_max_iter) {
+            fill_interior(x0, y0, x1, y1);
+            return;
+        }
+
+        if (iter >= 0) {
+            fill_band(x0, y0, x1, y1);
+            return;
+        }
+
+        const int mx = (x0 + x1) / 2;
+        const int my = (y0 + y1) / 2;
+
+        for (int x = x0 + 1; x < x1; ++x)
+            compute(x, my);
+        for (int y = y0 + 1; y < y1; ++y)
+            if (y != my)
+                compute(mx, y);
+
+        const bool spawn = static_cast<long>(x1 - x0) * (y1 - y0) > task_area;
+
+        #pragma omp task if(spawn)
+        split(x0, y0, mx, my);
+        #pragma omp task if(spawn)
+        split(mx, y0, x1, my);
+        #pragma omp task if(spawn)
+        split(x0, my, mx, y1);
+        #pragma omp task if(spawn)
+        split(mx, my, x1, y1);
+    }
+
+    void compute(int x, int y) {
+        const Escape escape = m_eval(x, y);
+        m_mu[index(x, y)] = escape.mu;
+        m_iter[index(x, y)] = escape.iter;
+    }
+
+    // every pixel is either computed or filled exactly once
+    Stats stats() const {
+        const long filled = m_filled;
+        return { static_cast<long>(m_iter.size()) - filled, filled };
+    }
+
+private:
+    size_t index(int x, int y) const { return static_cast<size_t>(y) * m_width + x; }
+
+    // iteration count shared by the whole border, or -1
+    int uniform_border(int x0, int y0, int x1, int y1) const {
+        const int iter = m_iter[index(x0, y0)];
+
+        for (int x = x0; x <= x1; ++x)
+            if (m_iter[index(x, y0)] != iter || m_iter[index(x, y1)] != iter)
+                return -1;
+        for (int y = y0; y <= y1; ++y)
+            if (m_iter[index(x0, y)] != iter || m_iter[index(x1, y)] != iter)
+                return -1;
+
+        return iter;
+    }
+
+    void fill_interior(int x0, int y0, int x1, int y1) {
+        for (int y = y0 + 1; y < y1; ++y)
+            for (int x = x0 + 1; x < x1; ++x)
+                m_mu[index(x, y)] = m_max_iter;
+
+        m_filled += static_cast<long>(x1 - x0 - 1) * (y1 - y0 - 1);
+    }
+
+    // Coons patch over the four border lines, stays inside the band for smooth borders
+    void fill_band(int x0, int y0, int x1, int y1) {
+        const double top_left = m_mu[index(x0, y0)];
+        const double top_right = m_mu[index(x1, y0)];
+        const double bottom_left = m_mu[index(x0, y1)];
+        const double bottom_right = m_mu[index(x1, y1)];
+
+        for (int y = y0 + 1; y < y1; ++y) {
+            const double v = static_cast<double>(y - y0) / (y1 - y0);
+            const double left = m_mu[index(x0, y)];
+            const double right = m_mu[index(x1, y)];
+
+            for (int x = x0 + 1; x < x1; ++x) {
+                const double u = static_cast<double>(x - x0) / (x1 - x0);
+                const double top = m_mu[index(x, y0)];
+                const double bottom = m_mu[index(x, y1)];
+
+                const double corners =
+                    (1 - u) * (1 - v) * top_left + u * (1 - v) * top_right +
+                    (1 - u) * v * bottom_left + u * v * bottom_right;
+
+                m_mu[index(x, y)] = (1 - v) * top + v * bottom + (1 - u) * left + u * right - corners;
+            }
+        }
+
+        m_filled += static_cast<long>(x1 - x0 - 1) * (y1 - y0 - 1);
+    }
+
+private:
+    int m_width;
+    int m_max_iter;
+    Eval& m_eval;
+    std::vector<double>& m_mu;
+    std::vector<int> m_iter;
+
+    std::atomic<long> m_filled = 0;
+};
+
+} // namespace detail
+
+template <typename Eval>
+Stats render(int width, int height, int max_iter, Eval eval, std::vector<double>& mu) {
+    mu.assign(static_cast<size_t>(width) * height, 0.0);
+
+    detail::Subdivider<Eval> subdivider(width, height, max_iter, eval, mu);
+
+    #pragma omp parallel
+    {
+        #pragma omp single
+        {
+            for (int x = 0; x < width; ++x) {
+                subdivider.compute(x, 0);
+                if (height > 1)
+                    subdivider.compute(x, height - 1);
+            }
+            for (int y = 1; y < height - 1; ++y) {
+                subdivider.compute(0, y);
+                if (width > 1)
+                    subdivider.compute(width - 1, y);
+            }
+
+            subdivider.split(0, 0, width - 1, height - 1);
+        }
+    }
+
+    return subdivider.stats();
+}
+
+} // namespace iheay::fractal::subdivision
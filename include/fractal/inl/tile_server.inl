@@ -0,0 +1,12 @@
+// fractal/inl/tile_server.inl
+
+namespace iheay::fractal {
+
+template <typename Renderer>
+void TileServer::add_formula(const std::string& name, const Renderer& renderer) {
+    add_formula(name, renderer.config(), [renderer](const ViewportMapping& mapping, EscapeField& field) {
+        renderer.render_field(field, mapping);
+    });
+}
+
+} // namespace iheay::fractal
@@ -0,0 +1,110 @@
+// fractal/inl/zoom_video.inl
+
+#include "utils/logger.hpp"
+#include "utils/trace.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <omp.h>
+
+namespace iheay::fractal {
+
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+    requires std::same_as<typename Colorizer::pixel_type, bmp::BgrPixel>
+ZoomVideoStats render_zoom_video(
+    FractalRendererBuilder<Colorizer, Iterate, Init, Param> builder,
+    const FractalKeyframe& start,
+    const FractalKeyframe& end,
+    const ZoomVideoOptions& options,
+    std::function<void(int frame, const bmp::Bmp& image)> write
+) {
+    if (options.frames < 2)
+        throw std::runtime_error("Zoom video needs at least two frames");
+
+    const math::Complex center = end.viewport.center;
+    if (start.viewport.center != center)
+        LOG_WARN("Zoom video stays on the end keyframe's center, the start center is not followed");
+
+    std::vector<FractalKeyframe> keyframes;
+    int max_iter = 0;
+
+    for (int i = 0; i < options.frames; ++i) {
+        FractalKeyframe key = interpolate(start, end, static_cast<double>(i) / (options.frames - 1));
+        key.viewport.center = center;
+        max_iter = std::max(max_iter, key.config.max_iter);
+        keyframes.push_back(key);
+    }
+
+    const double max_width = std::max(start.viewport.width, end.viewport.width);
+    const double min_width = std::min(start.viewport.width, end.viewport.width);
+
+    const auto renderer = builder.build(); // colorizes the frames, field max_iter decides
+
+    // a radius shows up from the corners of the frame whose corner it is down to a quarter pixel,
+    // or frame_inner_radius pixels, of the center of a wider one, the deepest of those sets max_iter of its rows;
+    // frames are laid out as in ViewportMapping, step is their horizontal pixel step
+    auto rows_max_iter = [&](double inner_radius, double outer_radius, int frame_inner_radius) {
+        const double half_diagonal = (options.width - 1) / 2.0 * std::hypot(1.0, static_cast<double>(options.height) / options.width);
+        const double innermost = frame_inner_radius > 0 ? frame_inner_radius : 0.25;
+        int rows_iter = 0;
+
+        for (const FractalKeyframe& key : keyframes) {
+            const double step = key.viewport.width / (options.width - 1);
+            if (step * half_diagonal * 1.01 >= inner_radius && step * innermost <= outer_radius * 1.01)
+                rows_iter = std::max(rows_iter, key.config.max_iter);
+        }
+        return rows_iter > 0 ? rows_iter : max_iter;
+    };
+
+    ZoomVideoStats stats;
+
+    ZoomStrip strip(center, max_width, min_width, options.width, options.height, options.oversample, options.inner_radius,
+        [&](long first_row, int rows, float* mu) {
+            TRACE_SCOPE("zoom strip", {"first_row", first_row}, {"rows", rows});
+            const double time_start = omp_get_wtime();
+            const int width = strip.width();
+
+            auto band_builder = builder;
+            const auto band_renderer = band_builder.set_max_iter(rows_max_iter(strip.radius(first_row + rows - 1), strip.radius(first_row), strip.inner_radius())).build();
+
+            band_renderer.render_points(width, rows, strip.sample_step(first_row + rows - 1),
+                [&](int x, int y) { return strip.point(x, first_row + y); },
+                [&](int x, int y, const Escape& escape) { mu[static_cast<size_t>(y) * width + x] = static_cast<float>(escape.mu); }
+            );
+
+            stats.strip_seconds += omp_get_wtime() - time_start;
+        }
+    );
+
+    AnimationStages stages {
+        [&](const FractalKeyframe& key, EscapeField& field) {
+            const Tile inner = strip.resample(key.viewport, key.config.max_iter, field);
+            if (inner.width() == 0 || inner.height() == 0)
+                return;
+
+            // the center, where the strip rows would be far denser than the pixels
+            const ViewportMapping mapping = ViewportMapping::from(key.viewport, options.width, options.height);
+
+            auto frame_builder = builder;
+            frame_builder.set_max_iter(key.config.max_iter).build().render_points(inner.width(), inner.height(), mapping.real_step,
+                [&](int x, int y) { return mapping.pixel(inner.x0 + x, inner.y0 + y); },
+                [&](int x, int y, const Escape& escape) { field.store(inner.x0 + x, inner.y0 + y, escape); }
+            );
+        },
+        [&](const FractalKeyframe&, const EscapeField& field, bmp::Bmp& image) {
+            renderer.colorize(field, image);
+        },
+        std::move(write)
+    };
+
+    stats.animation = AnimationRenderer(options.width, options.height, stages, options.frames_in_flight).render(keyframes);
+    stats.strip_width = strip.width();
+    stats.strip_rows = strip.rows();
+    stats.samples = strip.iterated_rows() * strip.width();
+
+    LOG_INFO("Zoom video iterated a {}x{} strip, {:.1f} samples per frame pixel",
+        stats.strip_width, stats.strip_rows, static_cast<double>(stats.samples) / options.frames / options.width / options.height);
+
+    return stats;
+}
+
+} // namespace iheay::fractal
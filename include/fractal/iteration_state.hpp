@@ -0,0 +1,81 @@
+#pragma once // fractal/iteration_state.hpp
+
+#include "fractal/fractal_structures.hpp"
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+namespace iheay::fractal {
+
+// the formula of a renderer: the types of its functors and the values they carry, so Julia sets
+// of different c differ; functors that aren't trivially copyable compare by type only,
+// padding in a functor at worst makes equal formulas differ
+struct FormulaIdentity {
+    const std::type_info* types = nullptr;
+    std::vector<std::byte> values;
+
+    bool operator==(const FormulaIdentity& other) const {
+        return types && other.types && *types == *other.types && values == other.values;
+    }
+};
+
+template <typename Iterate, typename Init, typename Param>
+FormulaIdentity formula_identity(const Iterate& iterate, const Init& init, const Param& param) {
+    FormulaIdentity identity { &typeid(void (*)(Iterate, Init, Param)), {} };
+
+    auto append = [&]<typename F>(const F& functor) {
+        if constexpr (std::is_trivially_copyable_v<F> && !std::is_empty_v<F>) {
+            const size_t offset = identity.values.size();
+            identity.values.resize(offset + sizeof(F));
+            std::memcpy(identity.values.data() + offset, &functor, sizeof(F));
+        }
+    };
+
+    append(iterate);
+    append(init);
+    append(param);
+    return identity;
+}
+
+// orbits a resumable render_field pass left bounded at max_iter, so a deeper pass continues them
+// instead of starting the frame over; escaped pixels and pixels proven interior are final and not kept
+
+struct IterationState {
+    // the frame the orbits belong to, a pass on any other frame starts from scratch
+    int width = 0;
+    int height = 0;
+    ViewportMapping mapping {};
+    double escape_radius_sq = 0.0;
+    double cycle_tolerance_sq = 0.0;
+
+    FormulaIdentity formula; // a pass of another formula on the same frame starts over too
+
+    int max_iter = 0; // iterations every kept orbit has done, 0 before the first pass
+
+    // one entry per orbit, in pixel order
+    std::vector<int> pixel; // y * width + x
+    std::vector<double> z_real;
+    std::vector<double> z_imag;
+    std::vector<double> saved_real; // point the periodicity check compares the orbit with
+    std::vector<double> saved_imag;
+
+    long running() const { return static_cast<long>(pixel.size()); }
+
+    size_t bytes() const { return pixel.size() * (sizeof(int) + 4 * sizeof(double)); }
+
+    void clear() {
+        *this = IterationState {};
+    }
+
+    void push_back(int index, double zr, double zi, double sr, double si) {
+        pixel.push_back(index);
+        z_real.push_back(zr);
+        z_imag.push_back(zi);
+        saved_real.push_back(sr);
+        saved_imag.push_back(si);
+    }
+};
+
+} // namespace iheay::fractal
@@ -0,0 +1,48 @@
+#pragma once // fractal/palettes.hpp
+
+#include "bmp/bmp_structs.hpp"
+#include <cmath>
+#include <cstdint>
+
+// colorizers of the smooth iteration count shared by the tools and examples,
+// interior pixels (mu >= max_iter) are black
+
+namespace iheay::fractal::palettes {
+
+// dark blue through orange to dark red, shift rotates the palette along mu / max_iter
+struct Fire {
+    using pixel_type = bmp::BgrPixel;
+
+    double shift = 0;
+
+    bmp::BgrPixel operator()(double mu, int max_iter) const {
+        if (mu >= max_iter)
+            return {0, 0, 0};
+
+        double t = std::fmod(mu / max_iter + shift, 1.0);
+
+        uint8_t r = static_cast<uint8_t>(9  * (1 - t) * t * t * t * 255);
+        uint8_t g = static_cast<uint8_t>(15 * (1 - t) * (1 - t) * t * t * 255);
+        uint8_t b = static_cast<uint8_t>(8.5 * (1 - t) * (1 - t) * (1 - t) * t * 255);
+
+        return {b, g, r};
+    }
+};
+
+// brightness grows with the square root of mu, so the low counts far from the set stay visible
+struct Gray {
+    using pixel_type = bmp::BgrPixel;
+
+    bmp::BgrPixel operator()(double mu, int max_iter) const {
+        if (mu >= max_iter)
+            return {0, 0, 0};
+
+        const uint8_t v = static_cast<uint8_t>(255.0 * std::sqrt(mu / max_iter));
+        return {v, v, v};
+    }
+};
+
+inline bmp::BgrPixel fire(double mu, int max_iter) { return Fire {}(mu, max_iter); }
+inline bmp::BgrPixel gray(double mu, int max_iter) { return Gray {}(mu, max_iter); }
+
+} // namespace iheay::fractal::palettes
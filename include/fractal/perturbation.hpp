@@ -0,0 +1,42 @@
+#pragma once // fractal/perturbation.hpp
+
+#include "fractal/fractal_structures.hpp"
+#include "math/big_float.hpp"
+#include <vector>
+
+// deep zoom engine for z -> z^2 + c
+// one reference orbit Z_n is iterated in BigFloat, every pixel only iterates
+// its offset d_n = z_n - Z_n in double: d_{n+1} = 2 Z_n d_n + d_n^2 + dc
+// pixels where the offset loses precision (|Z_n + d_n| << |Z_n|) are detected
+// as glitched and recomputed against an extra reference placed among them;
+// those still glitched when max_references runs out are iterated directly,
+// in DoubleDouble where it resolves the pixels and BigFloat past that
+
+namespace iheay::fractal::perturbation {
+
+enum class Family {
+    Mandelbrot, // z0 = 0, c = pixel
+    Julia       // z0 = pixel, c = julia_c
+};
+
+struct Params {
+    Family family;
+    DeepCenter center;
+    math::Complex julia_c;
+    double width;
+    FractalConfig config;
+    int max_references = 32;
+};
+
+struct Report {
+    int references;      // reference orbits computed
+    int glitched_pixels; // pixels still glitched when max_references ran out, iterated directly
+};
+
+// bits of BigFloat precision needed to resolve pixels of the given size
+int precision_for(double pixel_size) noexcept;
+
+// row-major smooth mu of a width x height image, in the same units as calc_mu
+Report render(const Params& params, int width, int height, std::vector<double>& mu);
+
+} // namespace iheay::fractal::perturbation
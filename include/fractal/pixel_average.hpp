@@ -0,0 +1,55 @@
+#pragma once // fractal/pixel_average.hpp
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+namespace iheay::fractal {
+
+// colorizer outputs that can be averaged over several samples:
+// arithmetic pixels directly, structs made of 8-bit channels (bmp::BgrPixel, raylib Color) byte by byte
+
+template <typename Pixel>
+concept AveragePixel =
+    std::is_arithmetic_v<Pixel> ||
+    (std::is_trivially_copyable_v<Pixel> && alignof(Pixel) == 1 && std::has_unique_object_representations_v<Pixel>);
+
+template <AveragePixel Pixel>
+class PixelAverage {
+public:
+    void add(const Pixel& pixel) {
+        if constexpr (std::is_arithmetic_v<Pixel>) {
+            m_sum[0] += static_cast<double>(pixel);
+        } else {
+            unsigned char bytes[sizeof(Pixel)];
+            std::memcpy(bytes, &pixel, sizeof(Pixel));
+            for (size_t i = 0; i < sizeof(Pixel); ++i)
+                m_sum[i] += bytes[i];
+        }
+        ++m_count;
+    }
+
+    // requires at least one add()
+    Pixel result() const {
+        if constexpr (std::is_floating_point_v<Pixel>) {
+            return static_cast<Pixel>(m_sum[0] / m_count);
+        } else if constexpr (std::is_arithmetic_v<Pixel>) {
+            return static_cast<Pixel>(std::round(m_sum[0] / m_count));
+        } else {
+            unsigned char bytes[sizeof(Pixel)];
+            for (size_t i = 0; i < sizeof(Pixel); ++i)
+                bytes[i] = static_cast<unsigned char>(std::round(m_sum[i] / m_count));
+
+            Pixel pixel;
+            std::memcpy(&pixel, bytes, sizeof(Pixel));
+            return pixel;
+        }
+    }
+
+private:
+    std::array<double, std::is_arithmetic_v<Pixel> ? 1 : sizeof(Pixel)> m_sum {};
+    int m_count = 0;
+};
+
+} // namespace iheay::fractal
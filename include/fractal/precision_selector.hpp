@@ -0,0 +1,16 @@
+#pragma once // fractal/precision_selector.hpp
+
+#include "fractal/fractal_structures.hpp"
+
+namespace iheay::fractal {
+
+// cheapest arithmetic that still resolves pixel_step around the viewport center:
+// Float for long orbits when float_iterations leaves most exterior pixels in float,
+// Double down to ~1e-13 relative steps, DoubleDouble down to ~1e-28, Perturbation below
+Precision select_precision(const Viewport& viewport, double pixel_step, int max_iter);
+
+// budget of iterations x mu step to the neighbouring pixels within which float rounding stays invisible;
+// Precision::Float re-runs in double the pixels over it, see FractalRenderer::render_float
+int float_iterations(const Viewport& viewport, double pixel_step);
+
+} // namespace iheay::fractal
@@ -0,0 +1,88 @@
+#pragma once // fractal/render_farm.hpp
+
+#include "fractal/animation_plan.hpp"
+#include "fractal/escape_field.hpp"
+#include "fractal/fractal_animation.hpp"
+#include "fractal/tiles.hpp"
+#include <functional>
+#include <vector>
+
+namespace iheay::fractal {
+
+// one unit of farm work: a region of a frame, the whole frame for animation jobs
+struct FarmJob {
+    int id = 0;        // index in the job list handed to RenderFarm::run
+    int frame = 0;
+    FractalKeyframe key;
+    int frame_width = 0;
+    int frame_height = 0;
+    Tile region {};
+    double cost = 0.0; // estimate in any unit, jobs go out most expensive first
+
+    // field pixel (0, 0) of the region, for FractalRenderer::render_field(field, mapping)
+    ViewportMapping mapping() const;
+};
+
+// runs in a worker process, field has the region's size
+using FarmWorkFunc = std::function<void(const FarmJob& job, EscapeField& field)>;
+
+// runs in the coordinator as results arrive, in no particular order
+using FarmResultFunc = std::function<void(const FarmJob& job, const EscapeField& field)>;
+
+struct FarmOptions {
+    int workers = 4;
+    int max_attempts = 3; // a job whose worker died this many times stops the run
+};
+
+struct FarmStats {
+    long jobs = 0;
+    long reassigned = 0; // jobs handed out again after their worker died
+    int respawned = 0;   // workers started in place of dead ones
+    double seconds = 0.0;
+};
+
+// coordinator of forked worker processes, each connected by a unix socket pair
+// jobs are handed out one at a time, most expensive first, to whichever worker is idle;
+// a worker that dies mid-job (killed, crashed, threw) is replaced and its job given to the next idle one
+// workers are single-threaded copies of this process: the work function is inherited, not sent,
+// and renders in it must use Schedule::Static, pools of the coordinator don't survive fork
+// POSIX only, the constructor throws elsewhere
+
+class RenderFarm {
+public:
+    RenderFarm(FarmWorkFunc work, FarmOptions options = {});
+    ~RenderFarm();
+
+    RenderFarm(const RenderFarm&) = delete;
+    RenderFarm& operator=(const RenderFarm&) = delete;
+
+    // returns once every job's field went through on_result;
+    // an exception from on_result or a job out of attempts stops the run and is rethrown
+    FarmStats run(std::vector<FarmJob> jobs, const FarmResultFunc& on_result);
+
+    std::vector<int> worker_pids() const;
+
+private:
+    struct Worker {
+        int pid = -1;
+        int fd = -1;
+        int job = -1; // index into the running job list, -1 when idle
+    };
+
+    void spawn(Worker& worker);
+    void bury(Worker& worker);
+
+private:
+    FarmWorkFunc m_work;
+    FarmOptions m_options;
+    std::vector<Worker> m_workers;
+};
+
+// one job per planned frame at width x height, cost is the plan's predicted time
+std::vector<FarmJob> frame_jobs(const AnimationPlan& plan, int width, int height);
+
+// tile_size squares covering one frame, cost is the iteration count of the part of the preview
+// (the same keyframe rendered at any smaller size) each tile covers
+std::vector<FarmJob> tile_jobs(const FractalKeyframe& key, int width, int height, int tile_size, const EscapeField& preview);
+
+} // namespace iheay::fractal
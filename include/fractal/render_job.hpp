@@ -0,0 +1,61 @@
+#pragma once // fractal/render_job.hpp
+
+#include "fractal/fractal_animation.hpp"
+#include <istream>
+#include <string>
+#include <vector>
+
+// job files of the headless iheay_render: sections of `key = value` lines, one per job
+//
+//     # comments run to the end of the line
+//     [job]
+//     formula = julia            # mandelbrot (default) or julia
+//     julia_c = -0.8 0.156
+//     center = 0 0               # real imag
+//     view_width = 3
+//     max_iter = 500             # or auto, planned per frame from previews
+//     escape_radius = 2
+//     size = 1920x1080
+//     supersampling = 3          # edge pixels averaged from 3 x 3 samples, 1 = off
+//     cycle_detection = true
+//     output = out/julia.bmp
+//
+// frames = n > 1 turns the job into a zoom towards end_center / end_view_width / end_julia_c /
+// end_max_iter (each defaults to its start value) and output into a std::format pattern
+// taking the frame index, e.g. out/zoom_{:04}.bmp
+
+namespace iheay::fractal {
+
+enum class JobFormula {
+    Mandelbrot,
+    Julia // c from the keyframe's julia_c
+};
+
+struct RenderJob {
+    int line = 0; // of the [job] header, for messages
+    JobFormula formula = JobFormula::Mandelbrot;
+    FractalKeyframe start { { 3.0, math::Complex::Algebraic(-0.75, 0.0) }, { 500, 2.0 }, math::Complex::Zero() };
+    FractalKeyframe end = start; // animations only
+    bool auto_max_iter = false;  // max_iter = auto, see plan_animation
+    int width = 1920;
+    int height = 1080;
+    int supersampling = 1;
+    bool cycle_detection = true;
+    int frames = 1;
+    std::string output;
+
+    bool animated() const { return frames > 1; }
+
+    // file of frame i, output itself for stills
+    std::string output_path(int frame) const;
+
+    // frame i of the zoom: viewport by interpolate(), max_iter linear between start and end
+    FractalKeyframe keyframe(int frame) const;
+};
+
+// throws std::runtime_error naming the line of the first malformed entry
+std::vector<RenderJob> parse_jobs(std::istream& input);
+
+std::vector<RenderJob> load_jobs(const std::string& path);
+
+} // namespace iheay::fractal
@@ -0,0 +1,221 @@
+#pragma once // fractal/render_stats.hpp
+
+#include "fractal/escape_time.hpp"
+#include "fractal/tiles.hpp"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace iheay::fractal {
+
+// builds defining IHEAY_DISABLE_RENDER_STATS (cmake -DIHEAY_RENDER_STATS=OFF) compile the instrumentation out:
+// the stats overloads of FractalRenderer render as usual and leave RenderStats::enabled false
+#ifdef IHEAY_DISABLE_RENDER_STATS
+inline constexpr bool render_stats_enabled = false;
+#else
+inline constexpr bool render_stats_enabled = true;
+#endif
+
+// pixels of a frame or a tile; iterations are Escape::iter of the escaped pixels, interior_iterations
+// Escape::cycle_iter of the interior pixels the periodicity check ended and max_iter of the other ones
+// but the settled; subdivision and perturbation pass only mu on, so their interior pixels count max_iter
+struct PixelCounts {
+    long escaped = 0;
+    long interior = 0;
+    long iterations = 0;
+    long interior_iterations = 0;
+
+    long pixels() const { return escaped + interior; }
+
+    // every iteration run, escaped and interior pixels alike: what an iterations per second rate divides
+    long total_iterations() const { return iterations + interior_iterations; }
+
+    PixelCounts& operator+=(const PixelCounts& other) {
+        escaped += other.escaped;
+        interior += other.interior;
+        iterations += other.iterations;
+        interior_iterations += other.interior_iterations;
+        return *this;
+    }
+};
+
+struct ThreadStats {
+    long pixels = 0;
+    double busy_seconds = 0.0; // inside its share of the parallel loops
+    double idle_seconds = 0.0; // rest of those loops' wall time: waiting for work or at the barrier
+};
+
+struct PhaseStats {
+    std::string name;
+    double wall_seconds = 0.0;
+    double cpu_seconds = 0.0; // process CPU time, every thread of it
+};
+
+// FractalRenderer::render / render_field with a RenderStats
+struct RenderStats {
+    bool enabled = false;
+    int width = 0;
+    int height = 0;
+
+    PixelCounts total;
+
+    // row-major grid of tile_size squares, edge tiles clipped
+    int tile_size = default_tile_size;
+    int tiles_x = 0;
+    int tiles_y = 0;
+    std::vector<PixelCounts> tiles;
+
+    // one entry per thread that took part, in no particular order; subdivision and perturbation
+    // iterate in loops of their own and report pixels without busy time
+    std::vector<ThreadStats> threads;
+
+    // the render path, named after its kernel, and the passes around it
+    std::vector<PhaseStats> phases;
+
+    double wall_seconds = 0.0;
+    double cpu_seconds = 0.0;
+
+    const PixelCounts& tile(int tx, int ty) const { return tiles[static_cast<size_t>(ty) * tiles_x + tx]; }
+
+    // busy share of the threads' time in the timed loops, 0 when none were timed
+    double utilization() const;
+};
+
+// gathers one render's stats: every thread counts into its own slot, found through a thread_local
+// cache, and finish() merges the slots; FractalRenderer wraps its sink in a CountingSink, the render
+// loops count a row at a time in locals (count_row(), count_lanes() for the SIMD rows) and add the
+// sums to the slot once per row of a tile, and time themselves through stats_busy()
+class StatsCollector {
+public:
+    StatsCollector(int width, int height, int max_iter);
+
+    StatsCollector(const StatsCollector&) = delete;
+    StatsCollector& operator=(const StatsCollector&) = delete;
+
+    // what a loop sums over the pixels of one row of a tile; iterations has max_iter
+    // for each interior pixel, add() takes it back out
+    struct PixelSums {
+        long pixels = 0;
+        long iterations = 0;
+        long interior = 0;
+        long settled = 0;
+        long cycled = 0;
+        long cycle_iterations = 0;
+    };
+
+    // a row segment [x0, x1) of y out of the SIMD lanes, counted per tile in loops of their own:
+    // slot[x - x0] is the lane of pixel x, or -1 - the next pixel's lane for a settled one, iter and
+    // cycle_iter the outputs of the first `lanes` lanes, cycle_iter null when the periodicity check was off
+    void count_lanes(int y, int x0, int x1, const int* slot, int lanes, const int* iter, const int* cycle_iter);
+
+    // a row segment [x0, x1) of y whose pixels are known already: passes escape_at(x) of each one to sink,
+    // summing them per tile in locals on the way
+    template <typename Sink, typename EscapeAt>
+    void count_row(Sink& sink, int y, int x0, int x1, EscapeAt escape_at);
+
+    // seconds the calling thread spent on its share of a timed parallel loop
+    void busy(double seconds) { local().busy_seconds += seconds; }
+
+    // wall and CPU time from construction to destruction, kept as a phase of the stats;
+    // timed_threads marks the loops whose threads report busy time, their wall time bounds the idle time
+    class Phase {
+    public:
+        Phase(StatsCollector& collector, std::string name, bool timed_threads);
+        ~Phase();
+
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+
+    private:
+        StatsCollector& m_collector;
+        std::string m_name;
+        bool m_timed_threads;
+        double m_wall_start;
+        double m_cpu_start;
+    };
+
+    RenderStats finish() const;
+
+private:
+    struct Slot {
+        std::vector<PixelCounts> tiles;
+        double busy_seconds = 0.0;
+    };
+
+    Slot& local() {
+        thread_local uint64_t cached_id = 0;
+        thread_local Slot* cached = nullptr;
+
+        if (cached_id != m_id) {
+            cached = &add_slot();
+            cached_id = m_id;
+        }
+        return *cached;
+    }
+
+    Slot& add_slot();
+
+    // the sums go by value, their address never escapes the loops and they can stay in registers
+    void add(unsigned tx, int y, PixelSums sums);
+
+    uint64_t m_id; // unique per collector, a new one at a freed one's address doesn't hit stale caches
+    int m_width;
+    int m_height;
+    int m_max_iter;
+    unsigned m_tiles_x;
+    int m_tiles_y;
+
+    double m_wall_start;
+    double m_cpu_start;
+    double m_timed_seconds = 0.0;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<Slot>> m_slots;
+    std::vector<PhaseStats> m_phases;
+};
+
+// a render sink whose pixels get counted; it has no call operator, the render loops pass their pixels
+// through stats_row() or count them with stats_lanes(), so none of them can skip the counting
+template <typename Sink>
+struct CountingSink {
+    Sink& sink;
+    StatsCollector& collector;
+};
+
+template <typename Sink>
+inline constexpr bool is_counting_sink_v = false;
+
+template <typename Sink>
+inline constexpr bool is_counting_sink_v<CountingSink<Sink>> = true;
+
+// what the render paths call around their loops, nothing at all unless the sink counts
+
+// start of the calling thread's share of a loop
+template <typename Sink>
+double stats_clock(const Sink& sink);
+
+template <typename Sink>
+void stats_busy(const Sink& sink, double start);
+
+// a StatsCollector::Phase for the rest of the scope, or an empty object
+template <typename Sink>
+auto stats_phase(const Sink& sink, const char* name, bool timed_threads);
+
+// how a loop passes a row segment [x0, x1) of y to the sink: escape_at(x) for each x,
+// counted with StatsCollector::count_row() on the way when the sink counts
+template <typename Sink, typename EscapeAt>
+void stats_row(Sink& sink, int y, int x0, int x1, EscapeAt escape_at);
+
+// what the SIMD rows use instead: StatsCollector::count_lanes, then the pixels go to stats_target(),
+// the sink behind a counting sink
+template <typename Sink>
+void stats_lanes(const Sink& sink, int y, int x0, int x1, const int* slot, int lanes, const int* iter, const int* cycle_iter);
+
+template <typename Sink>
+auto& stats_target(Sink& sink);
+
+} // namespace iheay::fractal
+
+#include "inl/render_stats.inl"
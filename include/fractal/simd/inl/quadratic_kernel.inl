@@ -0,0 +1,165 @@
+// fractal/simd/inl/quadratic_kernel.inl
+
+// generic lane-refill loop shared by the per-isa translation units
+// Ops wraps the intrinsics of one instruction set and element type:
+//   scalar, vec, mask, lanes, set1, load, store, add, sub, mul,
+//   cmp_gt, cmp_ge, cmp_lt, cmp_eq, mask_or, blend, bits
+
+#include "fractal/simd/quadratic_kernel.hpp"
+#include <algorithm>
+
+namespace iheay::fractal::simd {
+
+// DetectCycles adds the same Brent check as FractalRenderer::escape: the orbit is compared
+// with a copy saved at iterations 1, 2, 4, ...; a lane that comes back within the tolerance
+// jumps past max_iter, so resumed spans can tell it from a lane that merely ran out of iterations
+// the iteration count is kept in lanes of Ops::scalar too, exact up to 2^24 for float
+template <typename Ops, bool DetectCycles>
+void iterate_quadratic_lanes(const BasicQuadraticSpan<typename Ops::scalar>& span, int max_iter, double escape_radius_sq, double cycle_tolerance_sq) {
+    using T = typename Ops::scalar;
+    using vec = typename Ops::vec;
+    constexpr int N = Ops::lanes;
+
+    alignas(64) T zr[N];
+    alignas(64) T zi[N];
+    alignas(64) T cr[N];
+    alignas(64) T ci[N];
+    alignas(64) T it[N];
+    alignas(64) T sr[N];
+    alignas(64) T si[N];
+    alignas(64) T save_at[N];
+    int pixel[N];
+
+    unsigned active = 0;
+    int next = 0;
+
+    // the periodicity check saves at iterations 1, 2, 4, ..., the next save after start_iter
+    T first_save = T(1);
+    while (first_save <= T(span.start_iter))
+        first_save *= T(2);
+
+    // puts the next pending pixel into the lane or switches the lane off
+    auto refill = [&](int lane) {
+        if (next < span.count) {
+            pixel[lane] = next;
+            zr[lane] = span.z_real[next];
+            zi[lane] = span.z_imag[next];
+            cr[lane] = span.c_real[next];
+            ci[lane] = span.c_imag[next];
+            active |= 1u << lane;
+            ++next;
+        } else {
+            zr[lane] = zi[lane] = cr[lane] = ci[lane] = T(0);
+            active &= ~(1u << lane);
+        }
+        it[lane] = T(span.start_iter);
+        sr[lane] = span.saved_real && (active & (1u << lane)) ? span.saved_real[pixel[lane]] : zr[lane];
+        si[lane] = span.saved_imag && (active & (1u << lane)) ? span.saved_imag[pixel[lane]] : zi[lane];
+        save_at[lane] = first_save;
+    };
+
+    for (int lane = 0; lane < N; ++lane)
+        refill(lane);
+
+    vec vzr = Ops::load(zr);
+    vec vzi = Ops::load(zi);
+    vec vcr = Ops::load(cr);
+    vec vci = Ops::load(ci);
+    vec vit = Ops::load(it);
+    vec vsr = Ops::load(sr);
+    vec vsi = Ops::load(si);
+    vec vsave_at = Ops::load(save_at);
+
+    const vec radius = Ops::set1(static_cast<T>(escape_radius_sq));
+    const vec limit = Ops::set1(static_cast<T>(max_iter));
+    const vec cycled_offset = Ops::set1(static_cast<T>(max_iter) + T(1));
+    const vec one = Ops::set1(T(1));
+    const vec two = Ops::set1(T(2));
+    const vec tolerance = Ops::set1(static_cast<T>(cycle_tolerance_sq));
+
+    while (active) {
+        const vec zr2 = Ops::mul(vzr, vzr);
+        const vec zi2 = Ops::mul(vzi, vzi);
+
+        // same order of checks as the scalar loop: escape first, then the iteration limit
+        const auto done = Ops::mask_or(
+            Ops::cmp_gt(Ops::add(zr2, zi2), radius),
+            Ops::cmp_ge(vit, limit)
+        );
+
+        unsigned finished = Ops::bits(done) & active;
+
+        if (finished) {
+            Ops::store(zr, vzr);
+            Ops::store(zi, vzi);
+            Ops::store(cr, vcr);
+            Ops::store(ci, vci);
+            Ops::store(it, vit);
+            if constexpr (DetectCycles) {
+                Ops::store(sr, vsr);
+                Ops::store(si, vsi);
+                Ops::store(save_at, vsave_at);
+            }
+
+            for (int lane = 0; lane < N; ++lane) {
+                if (!(finished & (1u << lane)))
+                    continue;
+
+                const int p = pixel[lane];
+                const int iter = static_cast<int>(it[lane]);
+                span.out_real[p] = zr[lane];
+                span.out_imag[p] = zi[lane];
+                span.iter[p] = std::min(iter, max_iter);
+
+                if (span.cycle_iter)
+                    span.cycle_iter[p] = iter > max_iter ? iter - (max_iter + 1) : 0;
+                if (span.cycled)
+                    span.cycled[p] = iter > max_iter;
+                if (span.out_saved_real) {
+                    span.out_saved_real[p] = sr[lane];
+                    span.out_saved_imag[p] = si[lane];
+                }
+
+                refill(lane);
+            }
+
+            vzr = Ops::load(zr);
+            vzi = Ops::load(zi);
+            vcr = Ops::load(cr);
+            vci = Ops::load(ci);
+            vit = Ops::load(it);
+            if constexpr (DetectCycles) {
+                vsr = Ops::load(sr);
+                vsi = Ops::load(si);
+                vsave_at = Ops::load(save_at);
+            }
+
+            // refilled lanes have to pass the escape check before their first step
+            continue;
+        }
+
+        // (zr*zr - zi*zi) + cr and (zr*zi + zi*zr) + ci, exactly as Complex computes z * z + c
+        const vec zrzi = Ops::mul(vzr, vzi);
+
+        vzr = Ops::add(Ops::sub(zr2, zi2), vcr);
+        vzi = Ops::add(Ops::add(zrzi, zrzi), vci);
+        vit = Ops::add(vit, one);
+
+        if constexpr (DetectCycles) {
+            const vec dr = Ops::sub(vzr, vsr);
+            const vec di = Ops::sub(vzi, vsi);
+
+            // a cycled lane finishes on the next pass through the iteration limit check,
+            // past max_iter by the iteration it stopped at plus one
+            const auto cycled = Ops::cmp_lt(Ops::add(Ops::mul(dr, dr), Ops::mul(di, di)), tolerance);
+            vit = Ops::blend(cycled, vit, Ops::add(vit, cycled_offset));
+
+            const auto save = Ops::cmp_eq(vit, vsave_at);
+            vsr = Ops::blend(save, vsr, vzr);
+            vsi = Ops::blend(save, vsi, vzi);
+            vsave_at = Ops::blend(save, vsave_at, Ops::mul(vsave_at, two));
+        }
+    }
+}
+
+} // namespace iheay::fractal::simd
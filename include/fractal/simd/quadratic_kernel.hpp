@@ -0,0 +1,85 @@
+#pragma once // fractal/simd/quadratic_kernel.hpp
+
+#include <vector>
+
+// vectorized escape-time loop for z -> z^2 + c
+// AVX2 and AVX-512 variants are compiled in separate translation units
+// with their own instruction set flags and chosen at runtime
+
+namespace iheay::fractal::simd {
+
+enum class Isa {
+    Scalar,
+    Avx2,   // 4 doubles / 8 floats per register
+    Avx512  // 8 doubles / 16 floats per register
+};
+
+// the widest instruction set that is both compiled in and supported by the cpu
+Isa detect_isa() noexcept;
+
+// lanes per register for doubles, or floats when single_precision is set
+int lane_count(Isa isa, bool single_precision = false) noexcept;
+
+// structure-of-arrays view of `count` pixels, T is double or float
+// in double the iteration matches the scalar renderer bit for bit,
+// so out_real / out_imag / iter are exactly what its loop would produce;
+// float runs the same loop with twice the lanes per register
+template <typename T>
+struct BasicQuadraticSpan {
+    const T* z_real;
+    const T* z_imag;
+    const T* c_real;
+    const T* c_imag;
+
+    T* out_real;
+    T* out_imag;
+    int* iter;
+
+    int count;
+
+    // optional, where the periodicity check ended a pixel (iter is max_iter then), 0 for the others
+    int* cycle_iter = nullptr;
+
+    // resuming orbits, all optional: every pixel starts at iteration start_iter with the periodicity
+    // check's saved point at saved_real / saved_imag (z when null), out_saved_real / out_saved_imag get
+    // that point where the loop stopped and cycled flags the pixels the periodicity check ended
+    int start_iter = 0;
+    const T* saved_real = nullptr;
+    const T* saved_imag = nullptr;
+    T* out_saved_real = nullptr;
+    T* out_saved_imag = nullptr;
+    unsigned char* cycled = nullptr;
+};
+
+using QuadraticSpan = BasicQuadraticSpan<double>;
+using QuadraticSpanF = BasicQuadraticSpan<float>;
+
+// owning storage behind a span of up to `capacity` pixels
+template <typename T>
+struct BasicQuadraticBuffers {
+    explicit BasicQuadraticBuffers(int capacity);
+
+    BasicQuadraticSpan<T> span(int count);
+
+    std::vector<T> z_real, z_imag, c_real, c_imag;
+    std::vector<T> out_real, out_imag;
+    std::vector<int> iter;
+    std::vector<int> cycle_iter;
+};
+
+using QuadraticBuffers = BasicQuadraticBuffers<double>;
+using QuadraticBuffersF = BasicQuadraticBuffers<float>;
+
+// cycle_tolerance_sq > 0 enables periodicity detection: a pixel whose orbit returns within
+// sqrt(cycle_tolerance_sq) of a saved point is reported as interior, iter == max_iter
+void iterate_quadratic(const QuadraticSpan& span, int max_iter, double escape_radius_sq, Isa isa, double cycle_tolerance_sq = 0.0);
+
+void iterate_quadratic(const QuadraticSpan& span, int max_iter, double escape_radius_sq, double cycle_tolerance_sq = 0.0);
+
+// single precision, max_iter must stay below 2^24 where float stops counting exactly,
+// cycle_iter may be one off past 2^23
+void iterate_quadratic(const QuadraticSpanF& span, int max_iter, double escape_radius_sq, Isa isa, double cycle_tolerance_sq = 0.0);
+
+void iterate_quadratic(const QuadraticSpanF& span, int max_iter, double escape_radius_sq, double cycle_tolerance_sq = 0.0);
+
+} // namespace iheay::fractal::simd
@@ -0,0 +1,24 @@
+#pragma once // fractal/subdivision.hpp
+
+#include "fractal/escape_time.hpp"
+#include <vector>
+
+namespace iheay::fractal::subdivision {
+
+// Mariani–Silver: only rectangle borders are iterated, a rectangle whose whole border
+// never escaped is filled as interior, one whose border escaped on the same iteration
+// gets mu interpolated from the border, anything else is split in four
+
+struct Stats {
+    long computed = 0; // pixels that went through the iteration loop
+    long filled = 0;   // pixels written without iterating
+};
+
+// eval(x, y) -> fractal::Escape, called at most once per pixel and from several threads;
+// mu is resized to width * height
+template <typename Eval>
+Stats render(int width, int height, int max_iter, Eval eval, std::vector<double>& mu);
+
+} // namespace iheay::fractal::subdivision
+
+#include "inl/subdivision.inl"
@@ -0,0 +1,102 @@
+#pragma once // fractal/tile_cache.hpp
+
+#include "fractal/escape_field.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace iheay::fractal {
+
+// one square tile of the quadtree over the complex plane:
+// level L halves the pixel step of level L - 1, so tile (L, tx, ty) covers
+// the four tiles (L + 1, 2 tx + i, 2 ty + j), see CachedRenderer for the layout
+struct TileKey {
+    uint64_t formula; // formula_hash() of the formula name the tile was rendered with
+    int level;
+    int64_t tx;
+    int64_t ty;
+    // FractalConfig of the render, both change mu
+    int max_iter;
+    double escape_radius;
+
+    bool operator==(const TileKey&) const = default;
+};
+
+// FNV-1a 64 of the name: fixed by definition, so keys of stored tiles stay valid across builds and toolchains
+uint64_t formula_hash(std::string_view name) noexcept;
+
+struct TileKeyHash {
+    size_t operator()(const TileKey& key) const noexcept;
+};
+
+class MappedTile; // fractal/tile_store.hpp
+
+// a field rendered in this process, or a stored tile whose mu is read in place from its mapping;
+// a tile found in the cache has exactly one of them set
+struct CachedTile {
+    std::shared_ptr<const EscapeField> field;
+    std::shared_ptr<const MappedTile> mapped;
+
+    explicit operator bool() const { return field || mapped; }
+};
+
+// LRU cache of rendered tiles bounded by the bytes their fields hold
+// thread-safe; tiles are shared, so an evicted tile stays valid for whoever still reads it
+
+class TileCache {
+public:
+    struct Stats {
+        long hits = 0;
+        long misses = 0;
+        long evictions = 0;
+        size_t bytes = 0; // currently held
+        size_t tiles = 0;
+    };
+
+    explicit TileCache(size_t byte_budget);
+
+    // counts a hit or a miss, a hit becomes the most recently used tile
+    CachedTile find(const TileKey& key);
+
+    // evicts least recently used tiles until the new one fits;
+    // a tile larger than the whole budget is not kept
+    void insert(const TileKey& key, std::shared_ptr<const EscapeField> tile);
+    void insert(const TileKey& key, std::shared_ptr<const MappedTile> tile);
+
+    void clear();
+
+    size_t byte_budget() const { return m_byte_budget; }
+
+    Stats stats() const;
+
+    // zeroes hits, misses and evictions, the held bytes stay
+    void reset_stats();
+
+    // memory a tile is charged for, a mapped one by the pages it maps
+    static size_t tile_bytes(const EscapeField& tile);
+    static size_t tile_bytes(const MappedTile& tile);
+
+private:
+    struct Entry {
+        TileKey key;
+        CachedTile tile;
+        size_t bytes;
+    };
+
+    void insert(const TileKey& key, CachedTile tile, size_t bytes);
+    void evict_last();
+
+private:
+    size_t m_byte_budget;
+
+    mutable std::mutex m_mutex;
+    std::list<Entry> m_lru; // front is the most recently used
+    std::unordered_map<TileKey, std::list<Entry>::iterator, TileKeyHash> m_index;
+    Stats m_stats;
+};
+
+} // namespace iheay::fractal
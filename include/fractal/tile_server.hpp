@@ -0,0 +1,200 @@
+#pragma once // fractal/tile_server.hpp
+
+#include "bmp/bmp_structs.hpp"
+#include "fractal/escape_field.hpp"
+#include "fractal/fractal_structures.hpp"
+#include "fractal/tile_cache.hpp"
+#include <compare>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace iheay::fractal {
+
+// wire protocol over a unix stream socket, one text line per request and per response header:
+//     <id> <visible|prefetch> <formula> <palette> <level> <tx> <ty>
+//     <id> OK <width> <height>   followed by width * height BGR triples, top row first
+//     <id> ERR <message>
+// ids are the client's own and come back as given, responses arrive in completion order
+// tiles lie on the CachedRenderer quadtree: level L has pixel step cached_root_extent / (tile_size * 2^L)
+// and tile (L, tx, ty) starts at global pixel (tx * tile_size, ty * tile_size) of that level;
+// tx and ty must lie in [-2^(L+4), 2^(L+4)), sixteen root extents around the origin
+
+struct TileRequest {
+    uint64_t id = 0;
+    bool prefetch = false; // served after every queued visible tile
+    std::string formula;
+    std::string palette;
+    int level = 0;
+    int64_t tx = 0;
+    int64_t ty = 0;
+};
+
+struct TileResponse {
+    uint64_t id = 0;
+    std::string error; // empty on success
+    int width = 0;
+    int height = 0;
+    std::vector<bmp::BgrPixel> pixels;
+};
+
+// fills a tile_size x tile_size field with the part of the plane the mapping gives
+using TileFieldFunc = std::function<void(const ViewportMapping& mapping, EscapeField& field)>;
+
+using TilePalette = std::function<bmp::BgrPixel(double mu, int max_iter)>;
+
+struct TileServerOptions {
+    int workers = 2;        // tiles rendered at once
+    int tile_size = 256;    // at most 2048
+    int queue_limit = 256;  // renders waiting for a worker, requests beyond it get ERR busy
+    size_t cache_bytes = size_t(256) << 20;
+    size_t output_limit = size_t(64) << 20; // responses a client hasn't read yet, beyond it the connection is closed
+};
+
+struct TileServerStats {
+    long requests = 0;
+    long cache_hits = 0;
+    long coalesced = 0; // requests that joined a render of the same tile already queued or running
+    long rendered = 0;
+    long dropped = 0;   // queued renders abandoned because every client waiting for them disconnected
+    long refused = 0;   // turned away by a full queue
+    long failed = 0;    // renders that threw, their clients get ERR
+    long overflowed = 0; // connections closed with more than output_limit of responses unread
+};
+
+// serves colorized tiles to any number of local clients: one thread polls the sockets and never
+// blocks on a slow reader, a bounded set of single-threaded workers renders fields into a TileCache
+// shared by all palettes and colorizes every response, cache hits included;
+// requests for a tile that is queued or rendering wait for that render instead of starting another,
+// a visible request promotes a queued prefetch of the same tile
+// POSIX only, start() throws elsewhere
+
+class TileServer {
+public:
+    // a stale socket file at socket_path is replaced on start()
+    TileServer(std::string socket_path, TileServerOptions options = {});
+    ~TileServer();
+
+    TileServer(const TileServer&) = delete;
+    TileServer& operator=(const TileServer&) = delete;
+
+    // formulas and palettes are registered before start(), names must not contain whitespace
+    // a FractalRenderer is used through its explicit-mapping render_field, i.e. double precision
+    template <typename Renderer>
+    void add_formula(const std::string& name, const Renderer& renderer);
+
+    // config goes into the cache key, it must match what render puts into the field
+    void add_formula(const std::string& name, FractalConfig config, TileFieldFunc render);
+
+    void add_palette(const std::string& name, TilePalette palette);
+
+    void start();
+
+    // closes every connection, queued renders are abandoned and running ones finished first
+    void stop();
+
+    ViewportMapping tile_mapping(int level, int64_t tx, int64_t ty) const;
+
+    TileServerStats stats() const;
+
+    TileCache& cache() { return m_cache; }
+
+    const std::string& socket_path() const { return m_socket_path; }
+
+private:
+    struct Formula {
+        FractalConfig config;
+        TileFieldFunc render;
+        uint64_t hash; // TileKey::formula, as CachedRenderer computes it
+    };
+
+    // queue order: visible before prefetch, then arrival
+    struct Slot {
+        int rank;
+        uint64_t sequence;
+
+        auto operator<=>(const Slot&) const = default;
+    };
+
+    // see tile_server.cpp
+    struct Connection;
+    struct Pending;
+    struct Waiter;
+    struct Hit;
+
+    void io_loop();
+    void worker_loop();
+
+    void handle_line(const std::shared_ptr<Connection>& connection, const std::string& line);
+
+    // forgets the connection's waiters, renders nobody waits for anymore leave the queue
+    void disconnect(const std::shared_ptr<Connection>& connection);
+
+    void respond(const std::vector<Waiter>& waiters, const EscapeField* field, const std::string& error);
+
+    // queues message behind the connection's unsent output and sends what the socket takes now
+    void send(Connection& connection, const std::string& message);
+
+    // makes io_loop poll again, with the current output and stop state
+    void wake();
+
+private:
+    std::string m_socket_path;
+    TileServerOptions m_options;
+    std::unordered_map<std::string, Formula> m_formulas;
+    std::unordered_map<std::string, TilePalette> m_palettes;
+    TileCache m_cache;
+
+    int m_listen_fd = -1;
+    int m_wake_fds[2] = { -1, -1 }; // written once by stop() to end io_loop
+    std::thread m_io;
+    std::vector<std::thread> m_workers;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_ready;
+    bool m_stopping = false;
+    uint64_t m_sequence = 0;
+    std::map<Slot, std::shared_ptr<Pending>> m_queue;
+    std::unordered_map<TileKey, std::shared_ptr<Pending>, TileKeyHash> m_pending; // queued or rendering
+    std::list<Hit> m_hits; // served before the render queue
+    TileServerStats m_stats;
+};
+
+// blocking client of one connection, requests may be pipelined ahead of their responses
+
+class TileClient {
+public:
+    explicit TileClient(const std::string& socket_path);
+    ~TileClient();
+
+    TileClient(const TileClient&) = delete;
+    TileClient& operator=(const TileClient&) = delete;
+
+    void send(const TileRequest& request);
+
+    // the next response to arrive, throws once the server closed the connection
+    TileResponse receive();
+
+private:
+    // appends whatever arrives next to m_input
+    void receive_more();
+
+    std::string read_line();
+    std::string read_bytes(size_t size);
+
+private:
+    int m_fd = -1;
+    std::string m_input; // received past the last consumed byte
+};
+
+} // namespace iheay::fractal
+
+#include "inl/tile_server.inl"
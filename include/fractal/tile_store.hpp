@@ -0,0 +1,87 @@
+#pragma once // fractal/tile_store.hpp
+
+#include "fractal/escape_field.hpp"
+#include "fractal/tile_cache.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+namespace iheay::fractal {
+
+// read-only mapping of one stored tile, mu is read straight from the page cache
+// move-only, the mapping is released with the object
+
+class MappedTile {
+public:
+    MappedTile(MappedTile&& other) noexcept;
+    MappedTile& operator=(MappedTile&& other) noexcept;
+    ~MappedTile();
+
+    MappedTile(const MappedTile&) = delete;
+    MappedTile& operator=(const MappedTile&) = delete;
+
+    int size() const { return m_size; }
+
+    float mu(int x, int y) const { return m_mu[static_cast<size_t>(y) * m_size + x]; }
+    const float* mu_data() const { return m_mu; }
+
+    // widens the values into a field of the tile's size
+    EscapeField to_field() const;
+
+private:
+    friend class TileStore;
+
+    MappedTile(void* base, size_t length, const float* mu, int size, int max_iter);
+
+private:
+    void* m_base = nullptr;
+    size_t m_length = 0;
+    const float* m_mu = nullptr;
+    int m_size = 0;
+    int m_max_iter = 0;
+};
+
+// directory of fixed-layout tile files: a header repeating the TileKey, then tile_size^2 floats of mu
+// the path of a tile is derived from its key (level / formula_maxiter_radius_tx_ty.tile),
+// so the directory tree is the index and a lookup is one open + mmap
+// a tile is written to a temporary file, flushed and renamed into place: readers in any process
+// see either the whole tile or none, and a crash only leaves temporaries behind
+// files are never modified in place, so existing mappings stay valid while the writer replaces tiles
+// POSIX only, the constructor throws elsewhere
+
+class TileStore {
+public:
+    struct Stats {
+        long hits = 0;
+        long misses = 0;
+        long writes = 0;
+    };
+
+    // creates the directory if needed
+    TileStore(std::filesystem::path directory, int tile_size);
+
+    int tile_size() const { return m_tile_size; }
+    const std::filesystem::path& directory() const { return m_directory; }
+
+    // nothing when the tile is absent or its file does not match the key and layout
+    std::optional<MappedTile> find(const TileKey& key) const;
+
+    // the field must be tile_size x tile_size, mu is narrowed to float
+    void insert(const TileKey& key, const EscapeField& tile);
+
+    Stats stats() const;
+
+    std::filesystem::path tile_path(const TileKey& key) const;
+
+private:
+    std::filesystem::path m_directory;
+    int m_tile_size;
+
+    mutable std::atomic<long> m_hits = 0;
+    mutable std::atomic<long> m_misses = 0;
+    std::atomic<long> m_writes = 0;
+};
+
+} // namespace iheay::fractal
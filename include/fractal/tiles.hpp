@@ -0,0 +1,25 @@
+#pragma once // fractal/tiles.hpp
+
+#include <vector>
+
+namespace iheay::fractal {
+
+// half-open pixel rectangle [x0, x1) x [y0, y1)
+struct Tile {
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+
+    int width() const { return x1 - x0; }
+    int height() const { return y1 - y0; }
+};
+
+// 64x64 doubles of mu plus the pixel rows stay well inside L2
+inline constexpr int default_tile_size = 64;
+
+// tiles covering width x height in Morton (Z-order) of their grid positions,
+// so consecutive tiles are neighbours in the image; edge tiles are clipped
+std::vector<Tile> morton_tiles(int width, int height, int tile_size = default_tile_size);
+
+} // namespace iheay::fractal
@@ -0,0 +1,166 @@
+#pragma once // fractal/zoom_video.hpp
+
+#include "bmp/bmp.hpp"
+#include "fractal/animation_renderer.hpp"
+#include "fractal/escape_field.hpp"
+#include "fractal/fractal_animation.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/tiles.hpp"
+#include "math/complex.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace iheay::fractal {
+
+// exponential map of a zoom into `center`: sample (column j, row k) sits at
+// center + exp(r_top - k * step + i * j * step) with step = 2 pi / width, so one row per
+// radius and square samples at every scale; a frame of any width within the zoom is
+// resampled from the rows covering its radii instead of iterated
+
+class ZoomStrip {
+public:
+    // fills rows [first_row, first_row + rows) of mu, width() values per row, see point()
+    using RowFunc = std::function<void(long first_row, int rows, float* mu)>;
+
+    // frames of frame_width x frame_height pixels whose viewport widths lie in [min_width, max_width];
+    // oversample scales the angular resolution, 1 matches the pixel step at the corners of every frame;
+    // pixels less than inner_radius pixels (at most an eighth of the frame) across and down from the center
+    // are left to the caller, which spares the strip its deepest rows, 0 resamples every pixel
+    ZoomStrip(
+        math::Complex center,
+        double max_width,
+        double min_width,
+        int frame_width,
+        int frame_height,
+        double oversample,
+        int inner_radius,
+        RowFunc rows
+    );
+
+    int width() const { return m_width; }
+    long rows() const { return m_rows; }
+    math::Complex center() const { return m_center; }
+    int inner_radius() const { return m_inner_radius; }
+
+    // plane coordinate of a sample, the distance of its row from center() and the spacing of its samples
+    math::Complex point(int column, long row) const;
+    double radius(long row) const;
+    double sample_step(long row) const { return radius(row) * m_step; }
+
+    // mu of a frame centered on center(), mu at or above max_iter counts as interior;
+    // the rows it needs are iterated on first use, a window of them is kept for the next frames;
+    // returns the tile around the center left out, see inner_radius
+    Tile resample(const Viewport& viewport, int max_iter, EscapeField& field);
+
+    // rows that went through RowFunc so far, more than rows() if the window had to go back
+    long iterated_rows() const { return m_iterated_rows; }
+
+private:
+    // makes rows [top, bottom] resident
+    void ensure(long top, long bottom);
+
+    // radius in frame pixels below which no pixel is resampled
+    double innermost_pixels() const;
+    Tile inner_tile(const ViewportMapping& mapping) const;
+
+    // rows resident for one frame and the ring slot of the first
+    struct Window {
+        long top;
+        long bottom;
+        long top_slot;
+        double interior; // the frame's max_iter
+    };
+
+    // mu at fractional row u and column v, rows clamped to the window
+    double sample(double u, double v, const Window& window) const;
+
+    // bilinear blend of four neighbouring samples, fu and fv toward the lower row and the next column,
+    // mu at or above interior is not blended
+    static float mix(float upper0, float upper1, float lower0, float lower1, float fu, float fv, double interior);
+
+    // every pixel of a centered frame of unit step, in raster order: its row counted from the radius 1,
+    // the weight of the next column and the column_cell of both, the same for every centered frame
+    struct FramePixel {
+        float row;
+        float column_weight;
+        uint32_t column0;
+        uint32_t column1;
+    };
+
+    void build_pixel_table();
+
+private:
+    math::Complex m_center;
+    int m_frame_width;
+    int m_frame_height;
+    int m_inner_radius;
+    int m_width;
+    long m_rows;
+    double m_step;  // radial and angular, in log-radius units
+    double m_r_top; // log of the largest radius
+    std::vector<math::Complex> m_directions; // unit vector of every column
+    RowFunc m_render_rows;
+
+    // the window is stored in BLOCK x BLOCK tiles of samples, the pixels of a small part of a frame
+    // read a few tiles of it instead of a page per strip row
+    static constexpr int BLOCK = 16;
+
+    // index in m_ring of a sample is row_cell of its slot plus column_cell of its column
+    size_t row_cell(size_t slot) const {
+        return (slot / BLOCK * m_block_columns * BLOCK + slot % BLOCK) * BLOCK;
+    }
+    static size_t column_cell(size_t column) {
+        return column / BLOCK * BLOCK * BLOCK + column % BLOCK;
+    }
+
+    // slot of row k of the window, without a division per pixel
+    size_t slot(long k, const Window& window) const {
+        const long slot = window.top_slot + (k - window.top);
+        return slot < m_capacity ? slot : slot - m_capacity;
+    }
+
+    long m_capacity;                 // rows the window holds, one frame's worth
+    int m_block_columns;             // tiles across a row
+    std::vector<float> m_ring;       // row k lives at slot k % m_capacity
+    std::vector<long> m_ring_rows;   // row held by each slot, -1 when empty
+    std::vector<float> m_row_buffer; // rows from RowFunc on their way into the tiles
+    long m_iterated_rows = 0;
+
+    std::vector<FramePixel> m_pixels; // filled by the first centered frame
+};
+
+struct ZoomVideoOptions {
+    int width = 1920;
+    int height = 1080;
+    int frames = 300;
+    double oversample = 1.0;  // see ZoomStrip
+    int frames_in_flight = 2; // see AnimationRenderer
+    int inner_radius = 32;    // see ZoomStrip, the tile it leaves out is iterated directly
+};
+
+struct ZoomVideoStats {
+    int strip_width = 0;
+    long strip_rows = 0;
+    long samples = 0;            // points iterated for the whole video
+    double strip_seconds = 0.0;  // iterating them
+    AnimationStats animation;    // compute_seconds covers strip iteration and resampling
+};
+
+// zoom from start to end through frames interpolated like fractal::interpolate, but kept centered
+// on end's center; the strip is iterated once in double precision, each band of rows with the largest
+// max_iter of the frames that show it, and every frame is resampled from it, but for the tile around
+// the center that is iterated directly, and colorized with the builder's colorizer
+template <ColorizerConcept Colorizer, IterationConcept Iterate, InitialConcept Init, ParamConcept Param>
+    requires std::same_as<typename Colorizer::pixel_type, bmp::BgrPixel>
+ZoomVideoStats render_zoom_video(
+    FractalRendererBuilder<Colorizer, Iterate, Init, Param> builder,
+    const FractalKeyframe& start,
+    const FractalKeyframe& end,
+    const ZoomVideoOptions& options,
+    std::function<void(int frame, const bmp::Bmp& image)> write
+);
+
+} // namespace iheay::fractal
+
+#include "inl/zoom_video.inl"
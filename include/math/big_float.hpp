@@ -0,0 +1,60 @@
+#pragma once // math/big_float.hpp
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace iheay::math {
+
+// arbitrary precision binary floating point number: (-1)^sign * mantissa * 2^exponent
+// used where double runs out of digits, e.g. deep zoom centers and reference orbits
+// precision is fixed per value, results take the larger precision of the operands
+
+class BigFloat {
+public:
+    // constructors and fabrics
+
+    BigFloat() : BigFloat(0.0) {}
+
+    explicit BigFloat(double value, int precision_bits = 128);
+
+    // accepts "-0.743643887037158704752191506114774", "1.5e-40" etc.
+    [[nodiscard]] static BigFloat from_string(std::string_view text, int precision_bits);
+
+    // properties
+
+    [[nodiscard]] int precision_bits() const noexcept { return static_cast<int>(m_limbs.size()) * 32; }
+    [[nodiscard]] bool is_zero() const noexcept { return m_limbs.back() == 0; }
+    [[nodiscard]] bool is_negative() const noexcept { return m_negative; }
+
+    [[nodiscard]] double to_double() const noexcept;
+
+    [[nodiscard]] BigFloat with_precision(int precision_bits) const;
+
+    // arithmetic operators
+
+    [[nodiscard]] BigFloat operator-() const;
+
+    [[nodiscard]] BigFloat operator+(const BigFloat& o) const;
+    [[nodiscard]] BigFloat operator-(const BigFloat& o) const;
+    [[nodiscard]] BigFloat operator*(const BigFloat& o) const;
+
+    // exact multiplication by 2^power
+    [[nodiscard]] BigFloat mul_pow2(int power) const;
+
+    BigFloat& operator+=(const BigFloat& o) { *this = *this + o; return *this; }
+    BigFloat& operator-=(const BigFloat& o) { *this = *this - o; return *this; }
+    BigFloat& operator*=(const BigFloat& o) { *this = *this * o; return *this; }
+
+private:
+    BigFloat(bool negative, std::vector<uint32_t> magnitude, int64_t exponent, size_t limbs);
+
+    static BigFloat add(const BigFloat& a, const BigFloat& b, bool negate_b);
+
+private:
+    bool m_negative = false;
+    int64_t m_exponent = 0;          // value = mantissa * 2^m_exponent
+    std::vector<uint32_t> m_limbs;   // little-endian, top bit of the last limb set unless zero
+};
+
+} // namespace iheay::math
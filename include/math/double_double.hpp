@@ -0,0 +1,171 @@
+#pragma once // math/double_double.hpp
+
+#include "math/complex.hpp"
+#include <cmath>
+
+namespace iheay::math {
+
+// unevaluated sum hi + lo of two doubles, about 106 bits of mantissa
+// built on error-free transforms, so every operation is a handful of double ops
+
+class DoubleDouble {
+public:
+    // constructors
+
+    constexpr DoubleDouble() noexcept : m_hi(0.0), m_lo(0.0) {}
+
+    constexpr DoubleDouble(double value) noexcept : m_hi(value), m_lo(0.0) {}
+
+    // exact sum of two arbitrary doubles
+    [[nodiscard]] static constexpr DoubleDouble Sum(double a, double b) noexcept {
+        double err = 0.0;
+        const double s = two_sum(a, b, err);
+        return DoubleDouble(s, err);
+    }
+
+    // exact product of two arbitrary doubles
+    [[nodiscard]] static DoubleDouble Product(double a, double b) noexcept {
+        double err = 0.0;
+        const double p = two_prod(a, b, err);
+        return DoubleDouble(p, err);
+    }
+
+    // properties
+
+    [[nodiscard]] constexpr double hi() const noexcept { return m_hi; }
+    [[nodiscard]] constexpr double lo() const noexcept { return m_lo; }
+    [[nodiscard]] constexpr double to_double() const noexcept { return m_hi + m_lo; }
+
+    // arithmetic operators
+
+    [[nodiscard]] constexpr DoubleDouble operator-() const noexcept { return DoubleDouble(-m_hi, -m_lo); }
+
+    [[nodiscard]] constexpr DoubleDouble operator+(const DoubleDouble& o) const noexcept {
+        double e1 = 0.0, e2 = 0.0;
+        double s = two_sum(m_hi, o.m_hi, e1);
+        const double t = two_sum(m_lo, o.m_lo, e2);
+        e1 += t;
+        s = quick_two_sum(s, e1, e1);
+        e1 += e2;
+        s = quick_two_sum(s, e1, e1);
+        return DoubleDouble(s, e1);
+    }
+
+    [[nodiscard]] constexpr DoubleDouble operator-(const DoubleDouble& o) const noexcept { return *this + (-o); }
+
+    [[nodiscard]] DoubleDouble operator*(const DoubleDouble& o) const noexcept {
+        double err = 0.0;
+        const double p = two_prod(m_hi, o.m_hi, err);
+        err += m_hi * o.m_lo + m_lo * o.m_hi;
+        const double hi = quick_two_sum(p, err, err);
+        return DoubleDouble(hi, err);
+    }
+
+    DoubleDouble& operator+=(const DoubleDouble& o) noexcept { *this = *this + o; return *this; }
+    DoubleDouble& operator-=(const DoubleDouble& o) noexcept { *this = *this - o; return *this; }
+    DoubleDouble& operator*=(const DoubleDouble& o) noexcept { *this = *this * o; return *this; }
+
+    // comparison
+
+    [[nodiscard]] constexpr bool operator==(const DoubleDouble& o) const noexcept { return m_hi == o.m_hi && m_lo == o.m_lo; }
+    [[nodiscard]] constexpr bool operator<(const DoubleDouble& o) const noexcept { return m_hi < o.m_hi || (m_hi == o.m_hi && m_lo < o.m_lo); }
+    [[nodiscard]] constexpr bool operator>(const DoubleDouble& o) const noexcept { return o < *this; }
+
+private:
+    constexpr DoubleDouble(double hi, double lo) noexcept : m_hi(hi), m_lo(lo) {}
+
+    // error-free transforms: result + err == exact value
+
+    static constexpr double two_sum(double a, double b, double& err) noexcept {
+        const double s = a + b;
+        const double bb = s - a;
+        err = (a - (s - bb)) + (b - bb);
+        return s;
+    }
+
+    // requires |a| >= |b|
+    static constexpr double quick_two_sum(double a, double b, double& err) noexcept {
+        const double s = a + b;
+        err = b - (s - a);
+        return s;
+    }
+
+    static double two_prod(double a, double b, double& err) noexcept {
+        const double p = a * b;
+#if defined(__FMA__) || defined(_MSC_VER)
+        err = std::fma(a, b, -p);
+#else
+        // without a hardware fma std::fma is a library call, Dekker's split is exact and cheaper
+        auto split = [](double v, double& hi, double& lo) {
+            constexpr double SPLITTER = 134217729.0; // 2^27 + 1
+            const double t = SPLITTER * v;
+            hi = t - (t - v);
+            lo = v - hi;
+        };
+        double a_hi = 0.0, a_lo = 0.0, b_hi = 0.0, b_lo = 0.0;
+        split(a, a_hi, a_lo);
+        split(b, b_hi, b_lo);
+        err = ((a_hi * b_hi - p) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo;
+#endif
+        return p;
+    }
+
+private:
+    double m_hi;
+    double m_lo;
+};
+
+// complex number over DoubleDouble, mirrors the parts of Complex the renderer uses
+
+class DoubleDoubleComplex {
+public:
+    // constructors and fabrics
+
+    constexpr DoubleDoubleComplex() noexcept = default;
+
+    constexpr DoubleDoubleComplex(DoubleDouble real, DoubleDouble imag) noexcept : m_real(real), m_imag(imag) {}
+
+    constexpr explicit DoubleDoubleComplex(const Complex& c) noexcept : m_real(c.real()), m_imag(c.imag()) {}
+
+    [[nodiscard]] static constexpr DoubleDoubleComplex Zero() noexcept { return DoubleDoubleComplex(); }
+
+    [[nodiscard]] static constexpr DoubleDoubleComplex Algebraic(DoubleDouble real, DoubleDouble imag) noexcept {
+        return DoubleDoubleComplex(real, imag);
+    }
+
+    // properties
+
+    [[nodiscard]] constexpr DoubleDouble real() const noexcept { return m_real; }
+    [[nodiscard]] constexpr DoubleDouble imag() const noexcept { return m_imag; }
+
+    // rounds both parts to double
+    [[nodiscard]] constexpr explicit operator Complex() const noexcept {
+        return Complex(m_real.to_double(), m_imag.to_double());
+    }
+
+    // arithmetic operators
+
+    [[nodiscard]] constexpr DoubleDoubleComplex operator-() const noexcept { return DoubleDoubleComplex(-m_real, -m_imag); }
+
+    [[nodiscard]] constexpr DoubleDoubleComplex operator+(const DoubleDoubleComplex& o) const noexcept {
+        return DoubleDoubleComplex(m_real + o.m_real, m_imag + o.m_imag);
+    }
+
+    [[nodiscard]] constexpr DoubleDoubleComplex operator-(const DoubleDoubleComplex& o) const noexcept {
+        return *this + (-o);
+    }
+
+    [[nodiscard]] DoubleDoubleComplex operator*(const DoubleDoubleComplex& o) const noexcept {
+        return DoubleDoubleComplex(m_real * o.m_real - m_imag * o.m_imag, m_real * o.m_imag + m_imag * o.m_real);
+    }
+
+    DoubleDoubleComplex& operator+=(const DoubleDoubleComplex& o) noexcept { *this = *this + o; return *this; }
+    DoubleDoubleComplex& operator-=(const DoubleDoubleComplex& o) noexcept { *this = *this - o; return *this; }
+    DoubleDoubleComplex& operator*=(const DoubleDoubleComplex& o) noexcept { *this = *this * o; return *this; }
+
+private:
+    DoubleDouble m_real;
+    DoubleDouble m_imag;
+};
+
+} // namespace iheay::math
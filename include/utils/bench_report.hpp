@@ -0,0 +1,49 @@
+#pragma once // utils/bench_report.hpp
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace iheay::utils {
+
+// one measured run of iheay_bench: a scene at one size on one thread count
+struct BenchResult {
+    std::string scene;
+    int width = 0;
+    int height = 0;
+    int threads = 0;
+    double seconds = 0.0;                // best of the repeats
+    double mpixels_per_second = 0.0;
+    double giterations_per_second = 0.0; // 0 for scenes without an escape-time loop and without render stats
+    double efficiency = 0.0;             // speedup over the fewest threads measured, divided by the thread ratio
+    long peak_rss_kb = 0;
+
+    // scene, size and threads, what a baseline is matched on
+    std::string key() const;
+};
+
+// tab-separated, one result per line under a '#' comment naming the columns;
+// comment and blank lines are skipped on reading, so a report can carry notes about the host
+void write_results(std::ostream& out, const std::vector<BenchResult>& results);
+
+// throws std::runtime_error naming the line of a malformed record
+std::vector<BenchResult> read_results(std::istream& in);
+std::vector<BenchResult> load_results(const std::string& path);
+
+struct BenchRegression {
+    BenchResult baseline;
+    BenchResult current;
+    double slowdown; // 1 - current / baseline throughput
+};
+
+struct BenchComparison {
+    int compared = 0; // results found in both reports
+    std::vector<BenchRegression> regressions;
+};
+
+// a result regresses when its Mpixels/s falls more than `threshold` (0.1 = 10%) below the baseline;
+// results missing from either side are not compared
+BenchComparison compare_results(const std::vector<BenchResult>& baseline, const std::vector<BenchResult>& current, double threshold);
+
+} // namespace iheay::utils
@@ -1,5 +1,6 @@
 #pragma once // utils/logger.hpp
 
+#include <atomic>
 #include <iostream>
 #include <mutex>
 #include <chrono>
@@ -22,12 +23,18 @@
 
 namespace iheay::utils {
 
-enum class LogLevel { Info, Warn, Debug, Error };
+enum class LogLevel { Info, Warn, Debug, Error, Off };
 
 class Logger {
 public:
     Logger() = delete;
 
+    // messages less severe than level are dropped before they are formatted, Off drops all;
+    // everything is printed until then, programs timing their own work raise it first
+    static void set_level(LogLevel level) { m_level.store(severity(level), std::memory_order_relaxed); }
+
+    static bool enabled(LogLevel level) { return severity(level) >= m_level.load(std::memory_order_relaxed); }
+
     template<typename... Args>
     static void info(std::format_string<Args...> fmt, Args&&... args) {
         log(LogLevel::Info, fmt, std::forward<Args>(args)...);
@@ -50,9 +57,25 @@ public:
 
 private:
     static inline std::mutex m_mutex;
+    static inline std::atomic<int> m_level = 0;
+
+    // the enumerators aren't in order of severity
+    static int severity(LogLevel level) {
+        switch(level) {
+            case LogLevel::Debug: return 0;
+            case LogLevel::Info: return 1;
+            case LogLevel::Warn: return 2;
+            case LogLevel::Error: return 3;
+            case LogLevel::Off: break;
+        }
+        return 4;
+    }
 
     template<typename... Args>
     static void log(LogLevel level, std::format_string<Args...> fmt, Args&&... args) {
+        if (!enabled(level))
+            return;
+
         const char* color = "\033[0m";
         std::string tag;
 
@@ -61,6 +84,7 @@ private:
             case LogLevel::Warn: color = "\033[33m"; tag = "WARN"; break;    // yellow
             case LogLevel::Debug: color = "\033[36m"; tag = "DEBUG"; break;  // cyan
             case LogLevel::Error: color = "\033[31m"; tag = "ERROR"; break;  // red
+            case LogLevel::Off: break;
         }
 
         auto now = std::chrono::system_clock::now();
@@ -0,0 +1,70 @@
+#pragma once // utils/thread_pool.hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace iheay::utils {
+
+// fixed set of workers with one deque each; a worker pops its own deque from the front
+// and steals from the back of the others once it runs dry
+// the threads live as long as the pool, so one pool serves any number of run() calls
+
+class WorkStealingPool {
+public:
+    // 0 means omp_get_max_threads(), the calling thread counts as one of them
+    explicit WorkStealingPool(int threads = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int thread_count() const { return static_cast<int>(m_queues.size()); }
+
+    // calls task(index, worker) for every index in [0, count) and returns when all are done
+    // indices are dealt out in contiguous blocks, so neighbours start on the same worker
+    // the first exception thrown by a task is rethrown here; run() must not be nested
+    void run(int count, const std::function<void(int task, int worker)>& task);
+
+    // tasks taken from another worker's deque during the last run()
+    long last_steals() const { return m_steals; }
+
+    // process-wide pool, created on first use
+    static WorkStealingPool& shared();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<int> tasks;
+    };
+
+    void worker_loop(int worker);
+    void drain(int worker);
+    bool pop_own(int worker, int& task);
+    bool steal(int worker, int& task);
+
+private:
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_run_mutex; // one run() at a time
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    unsigned long m_generation = 0;
+    int m_busy = 0;
+    bool m_stop = false;
+
+    const std::function<void(int, int)>* m_task = nullptr;
+    std::exception_ptr m_error;
+    std::atomic<long> m_steals = 0;
+};
+
+} // namespace iheay::utils
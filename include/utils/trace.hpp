@@ -0,0 +1,99 @@
+#pragma once // utils/trace.hpp
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// timeline of scoped events, written as Chrome Trace Event JSON (chrome://tracing, ui.perfetto.dev)
+//
+//     TRACE_SCOPE("bmp save", {"width", w}, {"height", h});
+//
+// records the rest of the enclosing scope on the calling thread, with up to two integer args
+// builds defining IHEAY_DISABLE_TRACING (cmake -DIHEAY_TRACING=OFF) compile the scopes out;
+// otherwise a scope costs one relaxed load while Trace is disabled at runtime
+#ifndef IHEAY_DISABLE_TRACING
+    #define TRACE_SCOPE(name, ...) iheay::utils::TraceScope IHEAY_TRACE_VARIABLE(__LINE__) (name, ##__VA_ARGS__)
+    #define TRACE_THREAD_NAME(name) iheay::utils::Trace::set_thread_name(name)
+#else
+    // never runs, but keeps the arguments used
+    #define TRACE_SCOPE(name, ...) do { if (false) (void)iheay::utils::TraceScope(name, ##__VA_ARGS__); } while (0)
+    #define TRACE_THREAD_NAME(name) do { if (false) iheay::utils::Trace::set_thread_name(name); } while (0)
+#endif
+
+#define IHEAY_TRACE_JOIN(a, b) a##b
+#define IHEAY_TRACE_VARIABLE(line) IHEAY_TRACE_JOIN(trace_scope_, line)
+
+namespace iheay::utils {
+
+// unset when name is null
+struct TraceArg {
+    const char* name = nullptr;
+    int64_t value = 0;
+};
+
+// events go into per-thread buffers the recording thread appends to without locks;
+// buffers outlive their threads, so the events of finished workers are still written out
+class Trace {
+public:
+    Trace() = delete;
+
+    static void enable() { m_enabled.store(true, std::memory_order_relaxed); }
+    static void disable() { m_enabled.store(false, std::memory_order_relaxed); }
+    static bool enabled() { return m_enabled.load(std::memory_order_relaxed); }
+
+    // shown for the calling thread's row of the timeline, also when set before tracing is enabled
+    static void set_thread_name(const std::string& name);
+
+    // the calls below may run while other threads record, they see what was appended so far
+
+    static size_t event_count();
+
+    // drops the recorded events, names and thread ids stay
+    static void clear();
+
+    // timestamps are steady_clock microseconds, so traces of processes on one machine line up
+    static void write_json(std::ostream& out);
+    static void save(const std::string& path);
+
+    // steady_clock nanoseconds, what events are stamped with
+    static int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // name must outlive the trace, TRACE_SCOPE passes string literals
+    static void record(const char* name, int64_t start, int64_t end, const TraceArg& first, const TraceArg& second);
+
+private:
+    static inline std::atomic<bool> m_enabled = false;
+};
+
+// one complete event from construction to destruction, if Trace was enabled at construction
+class TraceScope {
+public:
+    explicit TraceScope(const char* name, TraceArg first = {}, TraceArg second = {})
+    : m_name(Trace::enabled() ? name : nullptr) {
+        if (m_name) {
+            m_first = first;
+            m_second = second;
+            m_start = Trace::now();
+        }
+    }
+
+    ~TraceScope() {
+        if (m_name)
+            Trace::record(m_name, m_start, Trace::now(), m_first, m_second);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name;
+    TraceArg m_first;
+    TraceArg m_second;
+    int64_t m_start = 0;
+};
+
+} // namespace iheay::utils
@@ -0,0 +1,387 @@
+#include "bmp/bmp.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/palettes.hpp"
+#include "fractal/render_stats.hpp"
+#include "math/ray.hpp"
+#include "math/vec3.hpp"
+#include "ray_tracing/objects/sphere.hpp"
+#include "utils/bench_report.hpp"
+#include "utils/logger.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <omp.h>
+
+#if !defined(_WIN32)
+    #include <sys/resource.h>
+#endif
+
+using namespace iheay;
+using namespace iheay::bmp;
+using namespace iheay::math;
+using namespace iheay::fractal;
+using namespace iheay::ray_tracing;
+
+// end-to-end benchmark: iheay_bench [options]
+// renders a fixed catalogue of scenes at every size and thread count asked for and writes a
+// tab-separated report (see utils/bench_report.hpp) to stdout or --output; given --baseline, the
+// results are compared against an earlier report and the exit code is 1 if any got slower than
+// --threshold allows. progress goes to stderr
+
+struct Scene {
+    std::string name;
+    bool escape_time; // whether there is a field and iterations to count
+    std::function<void(EscapeField& field, Bmp& image)> render;
+    std::function<long(EscapeField& field)> iterations; // of one render, from RenderStats; escape-time scenes only
+};
+
+struct Size {
+    int width;
+    int height;
+};
+
+struct Arguments {
+    std::vector<Size> sizes { { 640, 360 }, { 1280, 720 } };
+    std::vector<int> threads; // empty means 1, 2, 4, ... up to omp_get_max_threads()
+    int repeat = 3;
+    std::vector<std::string> scenes; // empty means all
+    std::string output;
+    std::string baseline;
+    double threshold = 0.1;
+};
+
+// ---------------- scenes ----------------
+
+template <typename Renderer>
+static Scene escape_time_scene(std::string name, Renderer renderer) {
+    return { std::move(name), true, [renderer](EscapeField& field, Bmp& image) {
+        renderer.render_field(field);
+        renderer.colorize(field, image);
+    }, [renderer](EscapeField& field) {
+        RenderStats stats;
+        renderer.render_field(field, stats);
+        return stats.total.total_iterations();
+    } };
+}
+
+static BgrPixel vec3_to_pixel(const Vec3& vec) {
+    const Vec3 vec_norm = vec.normalized();
+    return {
+        static_cast<uint8_t>(255.999 * vec_norm.z()),
+        static_cast<uint8_t>(255.999 * vec_norm.y()),
+        static_cast<uint8_t>(255.999 * vec_norm.x())
+    };
+}
+
+// the sphere over a sky gradient of src/main.cpp, with the same camera
+static void render_sphere(Bmp& image) {
+    const int width = image.width();
+    const int height = image.height();
+
+    const objects::Sphere sphere({ 0, 0, -1 }, 0.5);
+
+    const double viewport_height = 2.0;
+    const double viewport_width = viewport_height * width / height;
+
+    const double focal_length = 1.0;
+    const Vec3 camera_center = Vec3(0, 0, 0);
+
+    const Vec3 viewport_u = Vec3(viewport_width, 0, 0);
+    const Vec3 viewport_v = Vec3(0, viewport_height, 0);
+
+    const Vec3 pixel_delta_u = viewport_u / width;
+    const Vec3 pixel_delta_v = viewport_v / height;
+
+    const Vec3 viewport_upper_left = camera_center - Vec3(0, 0, focal_length) - viewport_u / 2 - viewport_v / 2;
+    const Vec3 pixel_00_loc = viewport_upper_left + (pixel_delta_u + pixel_delta_v) / 2;
+
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (int i = 0; i < width; ++i) {
+        for (int j = 0; j < height; ++j) {
+            const Vec3 pixel_center = pixel_00_loc + i * pixel_delta_u + j * pixel_delta_v;
+            const Ray ray(camera_center, pixel_center - camera_center);
+
+            Vec3 color;
+            if (const std::optional<HitRecord> rec = sphere.hit(ray, 0, 100000000)) {
+                color = 0.5 * (rec->normal + Vec3(1, 1, 1));
+            } else {
+                const double a = (ray.direction().normalized().y() + 1) / 2;
+                color = (1 - a) * Vec3(1, 1, 1) + a * Vec3(0.5, 0.7, 1);
+            }
+
+            image.set_pixel(i, height - 1 - j, vec3_to_pixel(color));
+        }
+    }
+}
+
+// every fractal scene renders the way iheay_app does: vector kernel, cycle detection, automatic precision
+static std::vector<Scene> catalogue() {
+    auto common = FractalRendererBuilder<palettes::Fire>::get_builder();
+    common
+        .set_kernel(Kernel::Simd)
+        .set_cycle_detection(true);
+
+    const auto mandelbrot = common.set_initial_func(formulas::Zero {}).set_param_func(formulas::Identity {});
+
+    const auto view = [](auto builder, Viewport viewport, int max_iter) {
+        return builder.set_viewport(viewport).set_max_iter(max_iter).build();
+    };
+
+    std::vector<Scene> scenes;
+
+    // the whole set, the opening view of iheay_app
+    scenes.push_back(escape_time_scene("mandelbrot_shallow",
+        view(mandelbrot, { 3.0, Complex::Algebraic(-0.75, 0.0) }, 300)));
+
+    // a Misiurewicz point of the seahorse valley, zoomed past what a plain double loop resolves;
+    // unlike a minibrot's surroundings the orbits there stay short as the view deepens
+    scenes.push_back(escape_time_scene("seahorse_deep",
+        view(mandelbrot, { 3e-11, Complex::Algebraic(-0.77568377, 0.13646737) }, 4000)));
+
+    // the Julia set of usage_examples/draw_julia_set.cpp
+    scenes.push_back(escape_time_scene("julia",
+        view(common.set_param_func(formulas::Constant { Complex::Algebraic(-0.8, 0.156) }), { 3.0, Complex::Zero() }, 300)));
+
+    // around the period-3 bulb, mostly bounded orbits outside the cardioid shortcut
+    scenes.push_back(escape_time_scene("interior_bulb",
+        view(mandelbrot, { 0.25, Complex::Algebraic(-0.1226, 0.7449) }, 5000)));
+
+    scenes.push_back({ "sphere", false, [](EscapeField&, Bmp& image) { render_sphere(image); }, nullptr });
+
+    return scenes;
+}
+
+// ---------------- measurement ----------------
+
+// the peak resident set of the process, reset before each run where the kernel allows it (Linux);
+// elsewhere it is the peak of the whole process so far, and 0 on Windows, where it isn't measured
+static void reset_peak_rss() {
+#if defined(__linux__)
+    std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+static long peak_rss_kb() {
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0)
+            return std::stol(line.substr(6));
+    }
+#endif
+
+#if defined(_WIN32)
+    return 0;
+#else
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    #if defined(__APPLE__)
+        return usage.ru_maxrss / 1024; // bytes there
+    #else
+        return usage.ru_maxrss;
+    #endif
+#endif
+}
+
+static utils::BenchResult run(const Scene& scene, Size size, int threads, int repeat) {
+    omp_set_num_threads(threads);
+    reset_peak_rss();
+
+    EscapeField field(scene.escape_time ? size.width : 1, scene.escape_time ? size.height : 1);
+    Bmp image = Bmp::empty(size.width, size.height);
+
+    // a first render off the clock touches every page and warms the caches
+    scene.render(field, image);
+
+    double best = 0.0;
+    for (int i = 0; i < repeat; ++i) {
+        const double start = omp_get_wtime();
+        scene.render(field, image);
+        const double seconds = omp_get_wtime() - start;
+
+        if (i == 0 || seconds < best)
+            best = seconds;
+    }
+
+    // counted in a render of its own, the timed ones stay plain; 0 when the stats are compiled out
+    const double iterations = scene.escape_time ? static_cast<double>(scene.iterations(field)) : 0.0;
+
+    utils::BenchResult result;
+    result.scene = scene.name;
+    result.width = size.width;
+    result.height = size.height;
+    result.threads = threads;
+    result.seconds = best;
+    result.mpixels_per_second = static_cast<double>(size.width) * size.height / best * 1e-6;
+    result.giterations_per_second = iterations / best * 1e-9;
+    result.peak_rss_kb = peak_rss_kb();
+    return result;
+}
+
+// ---------------- arguments ----------------
+
+static void print_usage() {
+    std::cerr << "usage: iheay_bench [--size WxH]... [--threads N]... [--repeat N] [--scene NAME]...\n"
+                 "                   [--output FILE] [--baseline FILE] [--threshold F]\n"
+                 "  --size WxH          frame size, repeatable, default 640x360 and 1280x720\n"
+                 "  --threads N         thread count, repeatable, default powers of two up to one per core\n"
+                 "  --repeat N          timed renders per run after a warm-up one, the best counts, default 3\n"
+                 "  --scene NAME        only this scene, repeatable\n"
+                 "  --output FILE       write the report here instead of stdout\n"
+                 "  --baseline FILE     compare against an earlier report, exit code 1 on regressions\n"
+                 "  --threshold F       allowed Mpixels/s loss against the baseline, default 0.1 (10%)\n"
+                 "scenes:";
+    for (const Scene& scene : catalogue())
+        std::cerr << ' ' << scene.name;
+    std::cerr << '\n';
+}
+
+template <typename T>
+static bool parse_number(const char* text, T& out) {
+    const auto [end, error] = std::from_chars(text, text + std::strlen(text), out);
+    return error == std::errc{} && *end == '\0';
+}
+
+static bool parse_size(const std::string& text, Size& size) {
+    const size_t x = text.find('x');
+    return x != std::string::npos
+        && parse_number(text.substr(0, x).c_str(), size.width)
+        && parse_number(text.substr(x + 1).c_str(), size.height)
+        && size.width > 0 && size.height > 0;
+}
+
+static bool parse_arguments(int argc, char** argv, Arguments& args) {
+    bool default_sizes = true;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string option = argv[i];
+        if (i + 1 >= argc)
+            return false;
+        const char* value = argv[++i];
+
+        if (option == "--size") {
+            Size size {};
+            if (!parse_size(value, size))
+                return false;
+            if (default_sizes)
+                args.sizes.clear();
+            default_sizes = false;
+            args.sizes.push_back(size);
+        } else if (option == "--threads") {
+            int threads = 0;
+            if (!parse_number(value, threads) || threads < 1)
+                return false;
+            args.threads.push_back(threads);
+        } else if (option == "--repeat") {
+            if (!parse_number(value, args.repeat) || args.repeat < 1)
+                return false;
+        } else if (option == "--scene") {
+            args.scenes.push_back(value);
+        } else if (option == "--output") {
+            args.output = value;
+        } else if (option == "--baseline") {
+            args.baseline = value;
+        } else if (option == "--threshold") {
+            if (!parse_number(value, args.threshold) || args.threshold < 0.0)
+                return false;
+        } else {
+            return false;
+        }
+    }
+
+    if (args.threads.empty()) {
+        const int max_threads = omp_get_max_threads();
+        for (int threads = 1; threads < max_threads; threads *= 2)
+            args.threads.push_back(threads);
+        args.threads.push_back(max_threads);
+    }
+    std::sort(args.threads.begin(), args.threads.end());
+    args.threads.erase(std::unique(args.threads.begin(), args.threads.end()), args.threads.end());
+
+    return true;
+}
+
+int main(int argc, char** argv) {
+    // the renderer logs every frame, which would time the console and the logger mutex
+    utils::Logger::set_level(utils::LogLevel::Error);
+
+    Arguments args;
+    if (!parse_arguments(argc, argv, args)) {
+        print_usage();
+        return 2;
+    }
+
+    std::vector<Scene> scenes = catalogue();
+    for (const std::string& name : args.scenes) {
+        if (std::none_of(scenes.begin(), scenes.end(), [&](const Scene& scene) { return scene.name == name; })) {
+            std::cerr << "iheay_bench: unknown scene " << name << '\n';
+            return 2;
+        }
+    }
+    if (!args.scenes.empty()) {
+        std::erase_if(scenes, [&](const Scene& scene) {
+            return std::find(args.scenes.begin(), args.scenes.end(), scene.name) == args.scenes.end();
+        });
+    }
+
+    // a missing or broken baseline shouldn't only show up after the whole run
+    std::vector<utils::BenchResult> baseline;
+    if (!args.baseline.empty()) {
+        try {
+            baseline = utils::load_results(args.baseline);
+        } catch (const std::exception& e) {
+            std::cerr << "iheay_bench: " << e.what() << '\n';
+            return 2;
+        }
+    }
+
+    std::vector<utils::BenchResult> results;
+    for (const Scene& scene : scenes) {
+        for (const Size size : args.sizes) {
+            const size_t first = results.size();
+
+            for (int threads : args.threads) {
+                results.push_back(run(scene, size, threads, args.repeat));
+
+                // against the fewest threads of this scene and size
+                utils::BenchResult& result = results.back();
+                const utils::BenchResult& base = results[first];
+                result.efficiency = base.seconds * base.threads / (result.seconds * result.threads);
+
+                std::fprintf(stderr, "%-20s %5dx%-5d %3d threads %9.4f s %9.2f Mpixels/s %7.3f Giterations/s %5.1f%% efficiency %8.1f MB peak\n",
+                    scene.name.c_str(), size.width, size.height, threads, result.seconds, result.mpixels_per_second,
+                    result.giterations_per_second, 100.0 * result.efficiency, result.peak_rss_kb / 1024.0);
+            }
+        }
+    }
+
+    if (args.output.empty()) {
+        utils::write_results(std::cout, results);
+    } else {
+        std::ofstream file(args.output);
+        utils::write_results(file, results);
+        if (!file) {
+            std::cerr << "iheay_bench: can't write " << args.output << '\n';
+            return 2;
+        }
+    }
+
+    if (args.baseline.empty())
+        return 0;
+
+    const utils::BenchComparison comparison = utils::compare_results(baseline, results, args.threshold);
+    for (const utils::BenchRegression& regression : comparison.regressions) {
+        std::fprintf(stderr, "regression: %s %.2f -> %.2f Mpixels/s (%.1f%% slower)\n",
+            regression.current.key().c_str(), regression.baseline.mpixels_per_second,
+            regression.current.mpixels_per_second, 100.0 * regression.slowdown);
+    }
+    std::fprintf(stderr, "%d results compared with %s, %zu regressions beyond %.1f%%\n",
+        comparison.compared, args.baseline.c_str(), comparison.regressions.size(), 100.0 * args.threshold);
+
+    return comparison.regressions.empty() ? 0 : 1;
+}
@@ -1,5 +1,6 @@
 #include "bmp/io/bmp_io.hpp"
 #include "utils/logger.hpp"
+#include "utils/trace.hpp"
 
 #include <fstream>
 #include <stdexcept>
@@ -20,6 +21,8 @@ static constexpr int row_size_bytes(int width) noexcept {
 // image loading
 
 Bmp io::load(const std::string& path) {
+    TRACE_SCOPE("bmp load");
+
     std::ifstream file(path, std::ios::binary);
     if (!file) throw std::runtime_error("Cannot open file: " + path);
 
@@ -77,6 +80,8 @@ Bmp io::load(const std::string& path) {
 // image saving
 
 void io::save(const Bmp& bmp, const std::string& path) {
+    TRACE_SCOPE("bmp save", {"width", bmp.width()}, {"height", bmp.height()});
+
     std::ofstream file(path, std::ios::binary);
     if (!file) throw std::runtime_error("Cannot create file: " + path);
 
@@ -0,0 +1,235 @@
+#include "bmp/bmp.hpp"
+#include "bmp/io/bmp_io.hpp"
+#include "fractal/animation_plan.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/palettes.hpp"
+#include "fractal/render_job.hpp"
+#include "fractal/render_stats.hpp"
+#include "utils/logger.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/trace.hpp"
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <omp.h>
+
+using namespace iheay;
+using namespace iheay::bmp;
+using namespace iheay::fractal;
+
+namespace fs = std::filesystem;
+
+// headless batch renderer: iheay_render [--threads N] [--force] [--trace FILE] JOB_FILE...
+// runs every job of the files in order on one shared pool; a frame whose output already exists
+// is skipped unless --force is given, so rerunning an interrupted batch picks up where it stopped
+
+struct Arguments {
+    int threads = 0; // 0 means omp_get_max_threads()
+    bool force = false;
+    std::string trace; // Chrome trace of the whole batch, none when empty
+    std::vector<std::string> job_files;
+};
+
+struct JobTotals {
+    int frames = 0;
+    int skipped = 0;
+    double pixels = 0.0;
+    double iterations = 0.0; // every one run; both from RenderStats, 0 when it is compiled out
+    double interior = 0.0;   // pixels still bounded at max_iter
+    double seconds = 0.0;
+};
+
+static void print_usage() {
+    std::cerr << "usage: iheay_render [--threads N] [--force] [--trace FILE] JOB_FILE...\n"
+                 "  --threads N   worker threads of the shared pool, default one per core\n"
+                 "  --force       render frames whose output already exists\n"
+                 "  --trace FILE  write a Chrome trace (chrome://tracing, ui.perfetto.dev) of the run\n"
+                 "job file format: see include/fractal/render_job.hpp\n";
+}
+
+static bool parse_arguments(int argc, char** argv, Arguments& args) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--force") == 0) {
+            args.force = true;
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            args.trace = argv[++i];
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            const char* value = argv[++i];
+            const auto [end, error] = std::from_chars(value, value + std::strlen(value), args.threads);
+            if (error != std::errc{} || *end != '\0' || args.threads < 1)
+                return false;
+        } else if (argv[i][0] == '-') {
+            return false;
+        } else {
+            args.job_files.push_back(argv[i]);
+        }
+    }
+    return !args.job_files.empty();
+}
+
+// writes next to the target and renames, an interrupted save never looks like a finished frame
+static void save_frame(const Bmp& image, const fs::path& path) {
+    if (path.has_parent_path())
+        fs::create_directories(path.parent_path());
+
+    fs::path partial = path;
+    partial += ".partial";
+
+    io::save(image, partial.string());
+    fs::rename(partial, path);
+}
+
+// make_renderer(key) builds the renderer of one frame
+template <typename MakeRenderer>
+static JobTotals run_frames(const RenderJob& job, bool force, const MakeRenderer& make_renderer) {
+    JobTotals totals;
+
+    std::vector<int> pending;
+    for (int frame = 0; frame < job.frames; ++frame) {
+        if (!force && fs::exists(job.output_path(frame)))
+            ++totals.skipped;
+        else
+            pending.push_back(frame);
+    }
+    if (pending.empty())
+        return totals;
+
+    std::vector<FractalKeyframe> keys;
+    for (int frame = 0; frame < job.frames; ++frame)
+        keys.push_back(job.keyframe(frame));
+
+    // previews of every frame, skipped ones included, so the smoothing sees the same neighbours on a rerun
+    if (job.auto_max_iter) {
+        keys = plan_animation(keys, job.width, job.height, [&](const FractalKeyframe& key, EscapeField& field) {
+            make_renderer(key).render_field(field);
+        }).keyframes();
+    }
+
+    const int samples = job.supersampling * job.supersampling - 1;
+    const AntialiasOptions antialias { 1.0, samples, static_cast<double>(samples) };
+
+    EscapeField field(job.width, job.height);
+    Bmp image = Bmp::empty(job.width, job.height);
+
+    const double start = omp_get_wtime();
+
+    for (int frame : pending) {
+        TRACE_SCOPE("frame", {"frame", frame});
+        const auto renderer = make_renderer(keys[frame]);
+
+        RenderStats stats;
+        renderer.render_field(field, stats);
+        if (samples > 0)
+            renderer.render_antialiased(field, image, antialias);
+        else
+            renderer.colorize(field, image);
+
+        save_frame(image, job.output_path(frame));
+
+        ++totals.frames;
+        totals.pixels += static_cast<double>(job.width) * job.height;
+        totals.iterations += static_cast<double>(stats.total.total_iterations());
+        totals.interior += static_cast<double>(stats.total.interior);
+    }
+
+    totals.seconds = omp_get_wtime() - start;
+    return totals;
+}
+
+static JobTotals run_job(const RenderJob& job, bool force, const std::shared_ptr<utils::WorkStealingPool>& pool) {
+    auto common = FractalRendererBuilder<palettes::Fire>::get_builder();
+    common
+        .set_kernel(Kernel::Simd)
+        .set_cycle_detection(job.cycle_detection)
+        .set_schedule(Schedule::WorkStealing)
+        .set_thread_pool(pool);
+
+    const auto with_key = [](auto& builder, const FractalKeyframe& key) -> auto& {
+        return builder
+            .set_viewport(key.viewport)
+            .set_max_iter(key.config.max_iter)
+            .set_escape_radius(key.config.escape_radius);
+    };
+
+    if (job.formula == JobFormula::Julia) {
+        return run_frames(job, force, [&](const FractalKeyframe& key) {
+            auto builder = common;
+            return with_key(builder, key).set_param_func(formulas::Constant { key.julia_c }).build();
+        });
+    }
+
+    const auto mandelbrot = common.set_initial_func(formulas::Zero {}).set_param_func(formulas::Identity {});
+    return run_frames(job, force, [&](const FractalKeyframe& key) {
+        auto builder = mandelbrot;
+        return with_key(builder, key).build();
+    });
+}
+
+int main(int argc, char** argv) {
+    Arguments args;
+    if (!parse_arguments(argc, argv, args)) {
+        print_usage();
+        return 2;
+    }
+
+    // every job file is read before the first render, a typo in the last one shouldn't cost a night
+    std::vector<std::pair<std::string, RenderJob>> jobs;
+    try {
+        for (const std::string& path : args.job_files)
+            for (RenderJob& job : load_jobs(path))
+                jobs.emplace_back(path, std::move(job));
+    } catch (const std::exception& e) {
+        LOG_ERROR("{}", e.what());
+        return 2;
+    }
+
+    if (!args.trace.empty())
+        utils::Trace::enable();
+
+    const auto pool = std::make_shared<utils::WorkStealingPool>(args.threads);
+    LOG_INFO("{} jobs on {} threads", jobs.size(), pool->thread_count());
+
+    int failed = 0;
+    for (const auto& [path, job] : jobs) {
+        const std::string name = std::format("{}:{} ({})", path, job.line, job.output);
+
+        try {
+            const JobTotals totals = run_job(job, args.force, pool);
+
+            if (totals.frames == 0) {
+                LOG_INFO("{}: skipped, output exists", name);
+                continue;
+            }
+
+            if (render_stats_enabled) {
+                LOG_INFO("{}: {} frames ({} skipped) in {:.2f} s, {:.2f} Mpixels/s, {:.3f} Giterations/s, {:.1f}% interior",
+                    name, totals.frames, totals.skipped, totals.seconds,
+                    totals.pixels / totals.seconds * 1e-6, totals.iterations / totals.seconds * 1e-9,
+                    100.0 * totals.interior / totals.pixels);
+            } else {
+                LOG_INFO("{}: {} frames ({} skipped) in {:.2f} s, {:.2f} Mpixels/s",
+                    name, totals.frames, totals.skipped, totals.seconds, totals.pixels / totals.seconds * 1e-6);
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR("{}: {}", name, e.what());
+            ++failed;
+        }
+    }
+
+    if (!args.trace.empty()) {
+        try {
+            utils::Trace::save(args.trace);
+        } catch (const std::exception& e) {
+            LOG_ERROR("{}", e.what());
+            return 2;
+        }
+    }
+
+    if (failed > 0) {
+        LOG_ERROR("{} of {} jobs failed", failed, jobs.size());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include "fractal/animation_plan.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <omp.h>
+
+using namespace iheay::fractal;
+
+// local static helpers
+
+static void validate(int width, int height, const PreviewFunc& preview, const PlanOptions& options) {
+    if (width <= 0 || height <= 0)
+        throw std::runtime_error("Animation plan: frame size must be positive");
+    if (options.preview_width <= 0 || options.preview_height <= 0)
+        throw std::runtime_error("Animation plan: preview size must be positive");
+    if (options.min_max_iter <= 0 || options.probe_max_iter < options.min_max_iter)
+        throw std::runtime_error("Animation plan: need 0 < min_max_iter <= probe_max_iter");
+    if (options.escape_tolerance < 0.0 || options.escape_tolerance >= 1.0)
+        throw std::runtime_error("Animation plan: escape_tolerance must be in [0, 1)");
+    if (options.smoothing < 0)
+        throw std::runtime_error("Animation plan: smoothing must not be negative");
+    if (!preview)
+        throw std::runtime_error("Animation plan: preview function is required");
+}
+
+// smallest max_iter that leaves at most `allowed` of the escaped mu values at or above it
+static int needed_max_iter(std::vector<double>& escaped, long allowed, const PlanOptions& options) {
+    if (static_cast<long>(escaped.size()) <= allowed)
+        return options.min_max_iter;
+
+    const auto last_kept = escaped.end() - allowed - 1;
+    std::nth_element(escaped.begin(), last_kept, escaped.end());
+
+    const int needed = static_cast<int>(*last_kept) + 1;
+    return std::clamp(needed, options.min_max_iter, options.probe_max_iter);
+}
+
+std::vector<FractalKeyframe> AnimationPlan::keyframes() const {
+    std::vector<FractalKeyframe> keys;
+    keys.reserve(frames.size());
+    for (const FramePlan& frame : frames)
+        keys.push_back(frame.key);
+    return keys;
+}
+
+double AnimationPlan::remaining_seconds(const std::vector<int>& finished, double elapsed) const {
+    // unknown and repeated indices count nothing
+    std::vector<bool> counted(frames.size());
+
+    double predicted_done = 0.0;
+    for (int frame : finished) {
+        if (frame < 0 || frame >= static_cast<int>(frames.size()) || counted[frame])
+            continue;
+        counted[frame] = true;
+        predicted_done += frames[frame].seconds;
+    }
+
+    const double left = seconds - predicted_done;
+    if (predicted_done <= 0.0 || elapsed <= 0.0)
+        return left;
+    return left * elapsed / predicted_done;
+}
+
+AnimationPlan iheay::fractal::plan_animation(
+    const std::vector<FractalKeyframe>& keyframes,
+    int width,
+    int height,
+    const PreviewFunc& preview,
+    const PlanOptions& options
+) {
+    validate(width, height, preview, options);
+
+    const int count = static_cast<int>(keyframes.size());
+    const long pixels = static_cast<long>(options.preview_width) * options.preview_height;
+    const long allowed = static_cast<long>(options.escape_tolerance * pixels);
+
+    AnimationPlan plan;
+    plan.frames.resize(count);
+
+    std::vector<int> needed(count);
+    EscapeField field(options.preview_width, options.preview_height);
+
+    double preview_seconds = 0.0;
+    std::vector<double> escaped;
+    escaped.reserve(pixels);
+
+    for (int i = 0; i < count; ++i) {
+        FractalKeyframe probe = keyframes[i];
+        probe.config.max_iter = options.probe_max_iter;
+
+        const double start = omp_get_wtime();
+        preview(probe, field);
+        preview_seconds += omp_get_wtime() - start;
+
+        escaped.clear();
+        for (double mu : field.mu_data())
+            if (mu < options.probe_max_iter)
+                escaped.push_back(mu);
+
+        plan.frames[i].interior = 1.0 - static_cast<double>(escaped.size()) / pixels;
+        needed[i] = needed_max_iter(escaped, allowed, options);
+    }
+
+    const double scale = static_cast<double>(width) * height / pixels;
+
+    for (int i = 0; i < count; ++i) {
+        const int from = std::max(0, i - options.smoothing);
+        const int to = std::min(count, i + options.smoothing + 1);
+
+        FramePlan& frame = plan.frames[i];
+        frame.key = keyframes[i];
+        frame.key.config.max_iter = *std::max_element(needed.begin() + from, needed.begin() + to);
+
+        // timed again at the planned budget, interior pixels cost whatever the caller's cycle detection lets them
+        const double start = omp_get_wtime();
+        preview(frame.key, field);
+        const double seconds = omp_get_wtime() - start;
+
+        preview_seconds += seconds;
+        frame.seconds = seconds * scale;
+        plan.seconds += frame.seconds;
+    }
+
+    if (count > 0) {
+        const auto [lowest, highest] = std::minmax_element(plan.frames.begin(), plan.frames.end(),
+            [](const FramePlan& a, const FramePlan& b) { return a.key.config.max_iter < b.key.config.max_iter; });
+        LOG_INFO("Animation plan: {} frames, max_iter {}..{}, predicted {:.1f} seconds at {}x{} (previews took {:.3f})",
+            count, lowest->key.config.max_iter, highest->key.config.max_iter, plan.seconds, width, height, preview_seconds);
+    }
+
+    return plan;
+}
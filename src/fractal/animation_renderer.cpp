@@ -0,0 +1,218 @@
+#include "fractal/animation_renderer.hpp"
+#include "utils/logger.hpp"
+#include "utils/trace.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <omp.h>
+
+using namespace iheay::fractal;
+
+// local static helpers
+
+namespace {
+
+// blocking FIFO of at most `capacity` entries
+// close() lets the consumer drain what is left, abort() drops it and wakes everyone
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : m_capacity(capacity) {}
+
+    // false once the queue is aborted
+    bool push(T value) {
+        std::unique_lock lock(m_mutex);
+        m_not_full.wait(lock, [&] { return m_queue.size() < m_capacity || m_aborted; });
+        if (m_aborted)
+            return false;
+
+        m_queue.push_back(std::move(value));
+        m_not_empty.notify_one();
+        return true;
+    }
+
+    // false once the queue is closed and drained, or aborted
+    bool pop(T& value) {
+        std::unique_lock lock(m_mutex);
+        m_not_empty.wait(lock, [&] { return !m_queue.empty() || m_closed || m_aborted; });
+        if (m_aborted || m_queue.empty())
+            return false;
+
+        value = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_not_full.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard lock(m_mutex);
+        m_closed = true;
+        m_not_empty.notify_all();
+    }
+
+    void abort() {
+        std::lock_guard lock(m_mutex);
+        m_aborted = true;
+        m_not_empty.notify_all();
+        m_not_full.notify_all();
+    }
+
+private:
+    size_t m_capacity;
+    std::deque<T> m_queue;
+    std::mutex m_mutex;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    bool m_closed = false;
+    bool m_aborted = false;
+};
+
+// a frame and the buffer slot holding it
+struct Job {
+    int frame;
+    int slot;
+};
+
+} // namespace
+
+// construction
+
+AnimationRenderer::AnimationRenderer(int width, int height, AnimationStages stages, int frames_in_flight, FieldChannels channels)
+: m_width(width)
+, m_height(height)
+, m_stages(std::move(stages))
+, m_frames_in_flight(frames_in_flight)
+, m_channels(channels) {
+    if (width <= 0 || height <= 0 || frames_in_flight <= 0)
+        throw std::runtime_error("Invalid animation size or frames in flight");
+
+    if (!m_stages.compute || !m_stages.colorize || !m_stages.write)
+        throw std::runtime_error("Animation stages must all be set");
+}
+
+// rendering
+
+AnimationStats AnimationRenderer::render(const std::vector<FractalKeyframe>& keyframes) const {
+    volatile double time_start = omp_get_wtime();
+
+    const int count = static_cast<int>(keyframes.size());
+    TRACE_SCOPE("animation", {"frames", count});
+    const int slots = m_frames_in_flight;
+
+    // the only frame buffers of the whole run, handed from stage to stage by slot
+    std::vector<EscapeField> fields;
+    std::vector<bmp::Bmp> images;
+    fields.reserve(slots);
+    images.reserve(slots);
+
+    BoundedQueue<int> free_fields(slots);
+    BoundedQueue<int> free_images(slots);
+    BoundedQueue<Job> computed(slots);
+    BoundedQueue<Job> colorized(slots);
+
+    for (int s = 0; s < slots; ++s) {
+        fields.emplace_back(m_width, m_height, m_channels);
+        images.push_back(bmp::Bmp::empty(m_width, m_height));
+        free_fields.push(s);
+        free_images.push(s);
+    }
+
+    AnimationStats stats;
+    stats.frames = count;
+
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    // keeps the first exception and unblocks every stage
+    auto fail = [&] {
+        {
+            std::lock_guard lock(error_mutex);
+            if (!error)
+                error = std::current_exception();
+        }
+        free_fields.abort();
+        free_images.abort();
+        computed.abort();
+        colorized.abort();
+    };
+
+    // frame scopes cover the stage alone, the gaps between them on a stage's row are waits on the queues
+    std::thread colorizer([&] {
+        TRACE_THREAD_NAME("animation colorize");
+        try {
+            Job job;
+            int image;
+            while (computed.pop(job) && free_images.pop(image)) {
+                {
+                    TRACE_SCOPE("colorize frame", {"frame", job.frame});
+                    const double start = omp_get_wtime();
+                    m_stages.colorize(keyframes[job.frame], fields[job.slot], images[image]);
+                    stats.colorize_seconds += omp_get_wtime() - start;
+                }
+
+                free_fields.push(job.slot);
+                if (!colorized.push({ job.frame, image }))
+                    break;
+            }
+            colorized.close();
+        } catch (...) {
+            fail();
+        }
+    });
+
+    std::thread writer([&] {
+        TRACE_THREAD_NAME("animation write");
+        try {
+            Job job;
+            while (colorized.pop(job)) {
+                {
+                    TRACE_SCOPE("write frame", {"frame", job.frame});
+                    const double start = omp_get_wtime();
+                    m_stages.write(job.frame, images[job.slot]);
+                    stats.write_seconds += omp_get_wtime() - start;
+                }
+
+                free_images.push(job.slot);
+            }
+        } catch (...) {
+            fail();
+        }
+    });
+
+    // iteration stays on the calling thread
+    try {
+        int slot;
+        for (int frame = 0; frame < count && free_fields.pop(slot); ++frame) {
+            {
+                TRACE_SCOPE("compute frame", {"frame", frame});
+                const double start = omp_get_wtime();
+                m_stages.compute(keyframes[frame], fields[slot]);
+                stats.compute_seconds += omp_get_wtime() - start;
+            }
+
+            if (!computed.push({ frame, slot }))
+                break;
+        }
+        computed.close();
+    } catch (...) {
+        fail();
+    }
+
+    colorizer.join();
+    writer.join();
+
+    if (error)
+        std::rethrow_exception(error);
+
+    volatile double time_end = omp_get_wtime();
+    stats.total_seconds = time_end - time_start;
+
+    LOG_INFO("Animation of {} frames finished in {:.3f} seconds (compute {:.3f}, colorize {:.3f}, write {:.3f})",
+        count, stats.total_seconds, stats.compute_seconds, stats.colorize_seconds, stats.write_seconds);
+
+    return stats;
+}
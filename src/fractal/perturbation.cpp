@@ -0,0 +1,250 @@
+#include "fractal/perturbation.hpp"
+#include "fractal/escape_time.hpp"
+#include "fractal/precision_selector.hpp"
+#include "math/double_double.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+using namespace iheay::fractal;
+using namespace iheay::math;
+
+// Pauldelbrot's criterion: |Z_n + d_n| < 1e-3 |Z_n| means d_n lost its significant digits
+static constexpr double GLITCH_TOLERANCE_SQ = 1e-6;
+
+// local static helpers
+
+namespace {
+
+struct PixelOutcome {
+    double mu;
+    bool glitched;
+    double glitch_ratio; // |z|^2 / |Z|^2 when glitched, lower is closer to the glitch center
+};
+
+} // namespace
+
+// Z_0 .. Z_k, where k is either max_iter or the first escaped index
+static std::vector<Complex> reference_orbit(BigFloat zr, BigFloat zi, const BigFloat& cr, const BigFloat& ci, const FractalConfig& config) {
+    const double escape_radius_sq = config.escape_radius * config.escape_radius;
+
+    std::vector<Complex> orbit;
+    orbit.reserve(config.max_iter + 1);
+
+    for (int n = 0; n <= config.max_iter; ++n) {
+        const double re = zr.to_double();
+        const double im = zi.to_double();
+        orbit.push_back(Complex::Algebraic(re, im));
+
+        if (re * re + im * im > escape_radius_sq || n == config.max_iter)
+            break;
+
+        const BigFloat re2 = zr * zr;
+        const BigFloat im2 = zi * zi;
+        const BigFloat cross = zr * zi;
+
+        zr = re2 - im2 + cr;
+        zi = cross.mul_pow2(1) + ci;
+    }
+
+    return orbit;
+}
+
+static PixelOutcome iterate_delta(
+    const std::vector<Complex>& orbit,
+    Complex d0, Complex dc,
+    const FractalConfig& config
+) {
+    const double escape_radius_sq = config.escape_radius * config.escape_radius;
+    const int orbit_size = static_cast<int>(orbit.size());
+
+    double dr = d0.real();
+    double di = d0.imag();
+    const double dcr = dc.real();
+    const double dci = dc.imag();
+
+    int iter = 0;
+    double zr = 0.0;
+    double zi = 0.0;
+
+    while (true) {
+        // the reference escaped before this pixel did, its orbit can't describe the pixel
+        if (iter >= orbit_size)
+            return { 0.0, true, std::numeric_limits<double>::infinity() };
+
+        const double Zr = orbit[iter].real();
+        const double Zi = orbit[iter].imag();
+
+        zr = Zr + dr;
+        zi = Zi + di;
+
+        const double z_sq = zr * zr + zi * zi;
+        if (z_sq > escape_radius_sq || iter >= config.max_iter)
+            break;
+
+        const double Z_sq = Zr * Zr + Zi * Zi;
+        if (z_sq < GLITCH_TOLERANCE_SQ * Z_sq)
+            return { 0.0, true, z_sq / Z_sq };
+
+        const double next_dr = 2.0 * (Zr * dr - Zi * di) + (dr * dr - di * di) + dcr;
+        const double next_di = 2.0 * (Zr * di + Zi * dr) + 2.0 * dr * di + dci;
+
+        dr = next_dr;
+        di = next_di;
+        ++iter;
+    }
+
+    return { calc_mu(Complex::Algebraic(zr, zi), iter, config.max_iter), false, 0.0 };
+}
+
+// z -> z^2 + c straight in DoubleDouble or BigFloat, for the pixels no reference could describe
+template <typename Real>
+static double direct_mu(Real zr, Real zi, const Real& cr, const Real& ci, const FractalConfig& config) {
+    const double escape_radius_sq = config.escape_radius * config.escape_radius;
+
+    for (int iter = 0;; ++iter) {
+        const double re = zr.to_double();
+        const double im = zi.to_double();
+
+        if (re * re + im * im > escape_radius_sq || iter >= config.max_iter)
+            return calc_mu(Complex::Algebraic(re, im), iter, config.max_iter);
+
+        const Real re2 = zr * zr;
+        const Real im2 = zi * zi;
+        const Real cross = zr * zi;
+
+        zr = re2 - im2 + cr;
+        zi = cross + cross + ci;
+    }
+}
+
+// nearest DoubleDouble, enough of a BigFloat for the views DoubleDouble resolves
+static DoubleDouble to_double_double(const BigFloat& value) {
+    const double hi = value.to_double();
+    return DoubleDouble::Sum(hi, (value - BigFloat(hi, value.precision_bits())).to_double());
+}
+
+// precision
+
+int perturbation::precision_for(double pixel_size) noexcept {
+    // digits down to the pixel size, plus a double's worth below it
+    const int pixel_bits = pixel_size > 0 ? std::max(0, -std::ilogb(pixel_size)) : 0;
+    return pixel_bits + 64;
+}
+
+// rendering
+
+perturbation::Report perturbation::render(const Params& params, int width, int height, std::vector<double>& mu) {
+    if (width < 2 || height < 2)
+        throw std::runtime_error("Perturbation rendering needs at least 2x2 pixels");
+    if (params.max_references <= 0)
+        throw std::runtime_error("Invalid max_references");
+
+    const double viewport_height = params.width * height / width;
+    const double real_step = params.width / (width - 1);
+    const double imag_step = viewport_height / (height - 1);
+
+    const int precision = precision_for(std::min(real_step, imag_step));
+    const BigFloat center_real = params.center.real.with_precision(precision);
+    const BigFloat center_imag = params.center.imag.with_precision(precision);
+
+    // pixel offset from the center, small enough to be exact in double
+    auto offset = [&](int index) {
+        const int x = index % width;
+        const int y = index / width;
+        return Complex::Algebraic(x * real_step - params.width / 2, viewport_height / 2 - y * imag_step);
+    };
+
+    mu.assign(static_cast<size_t>(width) * height, 0.0);
+    std::vector<double> glitch_ratio(mu.size(), 0.0);
+
+    std::vector<int> pending(mu.size());
+    for (size_t i = 0; i < pending.size(); ++i)
+        pending[i] = static_cast<int>(i);
+
+    Report report { 0, 0 };
+    Complex ref_offset = Complex::Zero();
+
+    while (!pending.empty() && report.references < params.max_references) {
+        // next reference goes to the deepest point of the remaining glitches
+        if (report.references > 0) {
+            const auto best = std::min_element(pending.begin(), pending.end(), [&](int a, int b) {
+                return glitch_ratio[a] < glitch_ratio[b];
+            });
+            ref_offset = offset(*best);
+        }
+
+        const BigFloat ref_real = center_real + BigFloat(ref_offset.real(), precision);
+        const BigFloat ref_imag = center_imag + BigFloat(ref_offset.imag(), precision);
+
+        const std::vector<Complex> orbit = params.family == Family::Mandelbrot
+            ? reference_orbit(BigFloat(0.0, precision), BigFloat(0.0, precision), ref_real, ref_imag, params.config)
+            : reference_orbit(ref_real, ref_imag,
+                BigFloat(params.julia_c.real(), precision), BigFloat(params.julia_c.imag(), precision), params.config);
+
+        ++report.references;
+
+        std::vector<char> glitched(pending.size(), 0);
+
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (int i = 0; i < static_cast<int>(pending.size()); ++i) {
+            const int index = pending[i];
+            const Complex delta = offset(index) - ref_offset;
+
+            const PixelOutcome outcome = params.family == Family::Mandelbrot
+                ? iterate_delta(orbit, Complex::Zero(), delta, params.config)
+                : iterate_delta(orbit, delta, Complex::Zero(), params.config);
+
+            mu[index] = outcome.mu;
+            glitch_ratio[index] = outcome.glitch_ratio;
+            glitched[i] = outcome.glitched;
+        }
+
+        std::vector<int> still_pending;
+        for (size_t i = 0; i < pending.size(); ++i) {
+            if (glitched[i])
+                still_pending.push_back(pending[i]);
+        }
+        pending = std::move(still_pending);
+    }
+
+    report.glitched_pixels = static_cast<int>(pending.size());
+
+    if (report.glitched_pixels > 0) {
+        LOG_DEBUG("Perturbation: iterating {} pixels directly after {} references",
+            report.glitched_pixels, report.references);
+
+        const Viewport viewport { params.width, Complex::Algebraic(center_real.to_double(), center_imag.to_double()) };
+        const bool double_double = select_precision(viewport, std::min(real_step, imag_step), params.config.max_iter) != Precision::Perturbation;
+
+        const BigFloat julia_real(params.julia_c.real(), precision);
+        const BigFloat julia_imag(params.julia_c.imag(), precision);
+
+        // few pixels each costing a whole orbit, so one at a time
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int i = 0; i < static_cast<int>(pending.size()); ++i) {
+            const int index = pending[i];
+            const Complex pixel = offset(index);
+
+            const BigFloat real = center_real + BigFloat(pixel.real(), precision);
+            const BigFloat imag = center_imag + BigFloat(pixel.imag(), precision);
+
+            // (z0, c) of the family
+            const bool mandelbrot = params.family == Family::Mandelbrot;
+            const BigFloat zero(0.0, precision);
+            const BigFloat& z0r = mandelbrot ? zero : real;
+            const BigFloat& z0i = mandelbrot ? zero : imag;
+            const BigFloat& cr = mandelbrot ? real : julia_real;
+            const BigFloat& ci = mandelbrot ? imag : julia_imag;
+
+            mu[index] = double_double
+                ? direct_mu(to_double_double(z0r), to_double_double(z0i), to_double_double(cr), to_double_double(ci), params.config)
+                : direct_mu(z0r, z0i, cr, ci, params.config);
+        }
+    }
+
+    return report;
+}
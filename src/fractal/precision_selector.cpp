@@ -0,0 +1,53 @@
+#include "fractal/precision_selector.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace iheay::fractal;
+
+// smallest pixel step relative to the coordinate magnitude each precision handles
+// leaves some hundreds of ulps per pixel for the error the orbit accumulates
+static constexpr double DOUBLE_MIN_RELATIVE_STEP = 1e-13;
+static constexpr double DOUBLE_DOUBLE_MIN_RELATIVE_STEP = 1e-28;
+
+// float rounds coordinates to 2^-24 and every iteration adds as much again, amplified like dmu / dc;
+// keeping the error a small fraction of one pixel step bounds iterations x mu step per pixel,
+// the tolerance is tuned so float frames match double ones on shallow views
+static constexpr double FLOAT_EPSILON = 1.0 / (1 << 24);
+static constexpr double FLOAT_PIXEL_TOLERANCE = 5e-3;
+
+// below this nearly every exterior pixel would be re-run in double
+static constexpr int FLOAT_MIN_ITERATIONS = 32;
+
+// shorter frames spend their time around the kernel rather than in it,
+// float lanes only pay for the neighbour check and the re-runs past this, see bench_precision
+static constexpr int FLOAT_MIN_MAX_ITER = 5000;
+
+// float lanes count iterations exactly only up to 2^24
+static constexpr int FLOAT_MAX_ITER = 1 << 24;
+
+// local static helpers
+
+static double coordinate_scale(const Viewport& viewport) {
+    return std::max({ 1.0, std::abs(viewport.center.real()), std::abs(viewport.center.imag()) });
+}
+
+// selection
+
+int iheay::fractal::float_iterations(const Viewport& viewport, double pixel_step) {
+    const double iterations = FLOAT_PIXEL_TOLERANCE * pixel_step / (FLOAT_EPSILON * coordinate_scale(viewport));
+    return static_cast<int>(std::min(iterations, static_cast<double>(FLOAT_MAX_ITER - 1)));
+}
+
+Precision iheay::fractal::select_precision(const Viewport& viewport, double pixel_step, int max_iter) {
+    const double relative_step = pixel_step / coordinate_scale(viewport);
+
+    if (max_iter >= FLOAT_MIN_MAX_ITER && max_iter < FLOAT_MAX_ITER && float_iterations(viewport, pixel_step) >= FLOAT_MIN_ITERATIONS)
+        return Precision::Float;
+
+    if (relative_step > DOUBLE_MIN_RELATIVE_STEP)
+        return Precision::Double;
+    if (relative_step > DOUBLE_DOUBLE_MIN_RELATIVE_STEP)
+        return Precision::DoubleDouble;
+    return Precision::Perturbation;
+}
@@ -0,0 +1,400 @@
+#include "fractal/render_farm.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <format>
+#include <stdexcept>
+#include <omp.h>
+
+#if !defined(_WIN32)
+    #include <poll.h>
+    #include <signal.h>
+    #include <sys/socket.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
+
+using namespace iheay::fractal;
+using namespace iheay::math;
+
+// local static helpers
+
+// native byte order and layout, both ends are the same binary
+struct JobMessage {
+    int32_t id;
+    int32_t frame;
+    int32_t frame_width;
+    int32_t frame_height;
+    int32_t x0, y0, x1, y1;
+    int32_t max_iter;
+    int32_t reserved;
+    double escape_radius;
+    double viewport_width;
+    double center_real;
+    double center_imag;
+    double julia_real;
+    double julia_imag;
+};
+
+// followed by width * height doubles of mu
+struct ResultHeader {
+    int32_t id;
+    int32_t width;
+    int32_t height;
+    int32_t max_iter;
+};
+
+static JobMessage to_message(const FarmJob& job) {
+    return {
+        job.id, job.frame, job.frame_width, job.frame_height,
+        job.region.x0, job.region.y0, job.region.x1, job.region.y1,
+        job.key.config.max_iter, 0, job.key.config.escape_radius,
+        job.key.viewport.width, job.key.viewport.center.real(), job.key.viewport.center.imag(),
+        job.key.julia_c.real(), job.key.julia_c.imag()
+    };
+}
+
+static FarmJob from_message(const JobMessage& message) {
+    FarmJob job;
+    job.id = message.id;
+    job.frame = message.frame;
+    job.frame_width = message.frame_width;
+    job.frame_height = message.frame_height;
+    job.region = { message.x0, message.y0, message.x1, message.y1 };
+    job.key.viewport = { message.viewport_width, Complex::Algebraic(message.center_real, message.center_imag) };
+    job.key.config = { message.max_iter, message.escape_radius };
+    job.key.julia_c = Complex::Algebraic(message.julia_real, message.julia_imag);
+    return job;
+}
+
+#if !defined(_WIN32)
+
+// false once the other end is gone
+static bool send_all(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t sent = ::send(fd, bytes, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent <= 0)
+            return false;
+        bytes += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+static bool receive_all(int fd, void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        const ssize_t received = ::recv(fd, bytes, size, 0);
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received <= 0)
+            return false;
+        bytes += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+// body of a worker process: jobs in, fields out, until the coordinator closes its end
+// nothing may unwind past it, the stack below belongs to the coordinator's copy
+[[noreturn]] static void worker_loop(int fd, const FarmWorkFunc& work) {
+    omp_set_num_threads(1);
+
+    JobMessage message {};
+    while (receive_all(fd, &message, sizeof(message))) {
+        const FarmJob job = from_message(message);
+
+        try {
+            EscapeField field(job.region.width(), job.region.height());
+            work(job, field);
+
+            const ResultHeader header { job.id, field.width(), field.height(), field.max_iter() };
+            if (!send_all(fd, &header, sizeof(header)) ||
+                !send_all(fd, field.mu_data().data(), field.mu_data().size() * sizeof(double)))
+                break;
+        } catch (const std::exception& error) {
+            LOG_WARN("Render farm worker {} failed on job {}: {}", ::getpid(), job.id, error.what());
+            ::_exit(1);
+        } catch (...) {
+            ::_exit(1);
+        }
+    }
+
+    ::_exit(0);
+}
+
+// the field of the job the worker had, nothing when the worker died before finishing it
+static bool receive_result(int fd, const FarmJob& job, EscapeField& field) {
+    ResultHeader header {};
+    if (!receive_all(fd, &header, sizeof(header)))
+        return false;
+
+    if (header.id != job.id || header.width != job.region.width() || header.height != job.region.height())
+        return false;
+
+    std::vector<double> mu(static_cast<size_t>(header.width) * header.height);
+    if (!receive_all(fd, mu.data(), mu.size() * sizeof(double)))
+        return false;
+
+    field = EscapeField(header.width, header.height);
+    field.set_max_iter(header.max_iter);
+    for (int y = 0; y < header.height; ++y)
+        for (int x = 0; x < header.width; ++x)
+            field.set_mu(x, y, mu[static_cast<size_t>(y) * header.width + x]);
+    return true;
+}
+
+#endif
+
+ViewportMapping FarmJob::mapping() const {
+    ViewportMapping mapping = ViewportMapping::from(key.viewport, frame_width, frame_height);
+    mapping.real_min += region.x0 * mapping.real_step;
+    mapping.imag_max -= region.y0 * mapping.imag_step;
+    return mapping;
+}
+
+// farm
+
+RenderFarm::RenderFarm(FarmWorkFunc work, FarmOptions options)
+: m_work(std::move(work))
+, m_options(options) {
+#if defined(_WIN32)
+    throw std::runtime_error("RenderFarm requires a POSIX system");
+#else
+    if (!m_work)
+        throw std::runtime_error("Render farm: work function is required");
+    if (m_options.workers <= 0 || m_options.max_attempts <= 0)
+        throw std::runtime_error("Render farm: workers and max_attempts must be positive");
+
+    m_workers.resize(m_options.workers);
+    for (Worker& worker : m_workers)
+        spawn(worker);
+#endif
+}
+
+RenderFarm::~RenderFarm() {
+#if !defined(_WIN32)
+    // a closed socket is the workers' signal to exit
+    for (Worker& worker : m_workers)
+        if (worker.fd >= 0)
+            ::close(worker.fd);
+
+    for (Worker& worker : m_workers)
+        if (worker.pid > 0)
+            ::waitpid(worker.pid, nullptr, 0);
+#endif
+}
+
+std::vector<int> RenderFarm::worker_pids() const {
+    std::vector<int> pids;
+    for (const Worker& worker : m_workers)
+        pids.push_back(worker.pid);
+    return pids;
+}
+
+void RenderFarm::spawn(Worker& worker) {
+#if !defined(_WIN32)
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+        throw std::runtime_error("Render farm: failed to create a socket pair");
+
+    const pid_t pid = ::fork();
+    if (pid < 0) {
+        ::close(fds[0]);
+        ::close(fds[1]);
+        throw std::runtime_error("Render farm: failed to fork a worker");
+    }
+
+    if (pid == 0) {
+        // other workers only see end of input once every copy of the coordinator's ends is closed
+        for (const Worker& other : m_workers)
+            if (other.fd >= 0)
+                ::close(other.fd);
+        ::close(fds[0]);
+
+        worker_loop(fds[1], m_work);
+    }
+
+    ::close(fds[1]);
+    worker = { pid, fds[0], -1 };
+#else
+    (void)worker;
+#endif
+}
+
+void RenderFarm::bury(Worker& worker) {
+#if !defined(_WIN32)
+    ::kill(worker.pid, SIGKILL);
+    ::waitpid(worker.pid, nullptr, 0);
+    ::close(worker.fd);
+#endif
+    worker = {};
+}
+
+FarmStats RenderFarm::run(std::vector<FarmJob> jobs, const FarmResultFunc& on_result) {
+    FarmStats stats;
+    stats.jobs = static_cast<long>(jobs.size());
+
+#if !defined(_WIN32)
+    const double time_start = omp_get_wtime();
+
+    for (size_t i = 0; i < jobs.size(); ++i)
+        jobs[i].id = static_cast<int>(i);
+
+    // longest first, so the last jobs to finish are short ones
+    std::vector<int> order(jobs.size());
+    for (size_t i = 0; i < jobs.size(); ++i)
+        order[i] = static_cast<int>(i);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return jobs[a].cost > jobs[b].cost; });
+
+    std::deque<int> pending(order.begin(), order.end());
+    std::vector<int> attempts(jobs.size(), 0);
+    long finished = 0;
+
+    // replaces the worker, its job goes back to the front of the queue
+    auto fail = [&](Worker& worker) {
+        const int job = worker.job;
+        bury(worker);
+        spawn(worker);
+        ++stats.respawned;
+
+        if (job < 0)
+            return;
+
+        if (++attempts[job] >= m_options.max_attempts)
+            throw std::runtime_error(std::format("Render farm: job {} lost {} workers, giving up", job, attempts[job]));
+
+        LOG_WARN("Render farm: worker died on job {}, reassigning", job);
+        pending.push_front(job);
+        ++stats.reassigned;
+    };
+
+    try {
+        std::vector<pollfd> polled;
+        std::vector<int> polled_worker;
+        EscapeField field(1, 1);
+
+        while (finished < stats.jobs) {
+            for (Worker& worker : m_workers) {
+                while (worker.job < 0 && !pending.empty()) {
+                    const int job = pending.front();
+                    pending.pop_front();
+
+                    const JobMessage message = to_message(jobs[job]);
+                    worker.job = job;
+                    if (!send_all(worker.fd, &message, sizeof(message)))
+                        fail(worker);
+                }
+            }
+
+            polled.clear();
+            polled_worker.clear();
+            for (size_t w = 0; w < m_workers.size(); ++w) {
+                if (m_workers[w].job >= 0) {
+                    polled.push_back({ m_workers[w].fd, POLLIN, 0 });
+                    polled_worker.push_back(static_cast<int>(w));
+                }
+            }
+
+            if (::poll(polled.data(), polled.size(), -1) < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw std::runtime_error("Render farm: poll failed");
+            }
+
+            for (size_t p = 0; p < polled.size(); ++p) {
+                if (polled[p].revents == 0)
+                    continue;
+
+                Worker& worker = m_workers[polled_worker[p]];
+                const FarmJob& job = jobs[worker.job];
+
+                if (!receive_result(worker.fd, job, field)) {
+                    fail(worker);
+                    continue;
+                }
+
+                worker.job = -1;
+                ++finished;
+                on_result(job, field);
+            }
+        }
+    } catch (...) {
+        // busy workers would answer into the next run, they are replaced instead
+        for (Worker& worker : m_workers) {
+            if (worker.job >= 0) {
+                bury(worker);
+                spawn(worker);
+            }
+        }
+        throw;
+    }
+
+    stats.seconds = omp_get_wtime() - time_start;
+
+    LOG_INFO("Render farm: {} jobs on {} workers in {:.3f} seconds, {} reassigned",
+        stats.jobs, m_workers.size(), stats.seconds, stats.reassigned);
+#else
+    (void)on_result;
+#endif
+
+    return stats;
+}
+
+// jobs
+
+std::vector<FarmJob> iheay::fractal::frame_jobs(const AnimationPlan& plan, int width, int height) {
+    std::vector<FarmJob> jobs;
+    jobs.reserve(plan.frames.size());
+
+    for (size_t i = 0; i < plan.frames.size(); ++i) {
+        FarmJob job;
+        job.id = static_cast<int>(i);
+        job.frame = static_cast<int>(i);
+        job.key = plan.frames[i].key;
+        job.frame_width = width;
+        job.frame_height = height;
+        job.region = { 0, 0, width, height };
+        job.cost = plan.frames[i].seconds;
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+std::vector<FarmJob> iheay::fractal::tile_jobs(const FractalKeyframe& key, int width, int height, int tile_size, const EscapeField& preview) {
+    const std::vector<Tile> tiles = morton_tiles(width, height, tile_size);
+    const int columns = (width + tile_size - 1) / tile_size;
+
+    // grid position -> index in the Morton list
+    std::vector<int> tile_at(tiles.size());
+    for (size_t t = 0; t < tiles.size(); ++t)
+        tile_at[(tiles[t].y0 / tile_size) * columns + tiles[t].x0 / tile_size] = static_cast<int>(t);
+
+    std::vector<FarmJob> jobs(tiles.size());
+    for (size_t t = 0; t < tiles.size(); ++t) {
+        jobs[t].id = static_cast<int>(t);
+        jobs[t].key = key;
+        jobs[t].frame_width = width;
+        jobs[t].frame_height = height;
+        jobs[t].region = tiles[t];
+    }
+
+    // every preview pixel adds its iterations to the tile under its center
+    const double max_iter = preview.max_iter();
+    for (int py = 0; py < preview.height(); ++py) {
+        const int y = std::min(height - 1, static_cast<int>((py + 0.5) * height / preview.height()));
+        for (int px = 0; px < preview.width(); ++px) {
+            const int x = std::min(width - 1, static_cast<int>((px + 0.5) * width / preview.width()));
+            jobs[tile_at[(y / tile_size) * columns + x / tile_size]].cost += std::min(preview.mu(px, py), max_iter) + 1.0;
+        }
+    }
+
+    return jobs;
+}
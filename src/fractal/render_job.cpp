@@ -0,0 +1,221 @@
+#include "fractal/render_job.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+
+using namespace iheay::fractal;
+using namespace iheay::math;
+
+// local static helpers
+
+[[noreturn]] static void fail(int line, const std::string& message) {
+    throw std::runtime_error(std::format("Job file: line {}: {}", line, message));
+}
+
+static std::string trim(const std::string& text) {
+    const size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos)
+        return {};
+    const size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+static double parse_double(const std::string& value, int line, const std::string& key) {
+    double out = 0.0;
+    const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), out);
+    if (error != std::errc{} || end != value.data() + value.size())
+        fail(line, std::format("{}: '{}' is not a number", key, value));
+    return out;
+}
+
+static int parse_int(const std::string& value, int line, const std::string& key) {
+    int out = 0;
+    const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), out);
+    if (error != std::errc{} || end != value.data() + value.size())
+        fail(line, std::format("{}: '{}' is not an integer", key, value));
+    return out;
+}
+
+static bool parse_bool(const std::string& value, int line, const std::string& key) {
+    if (value == "true")
+        return true;
+    if (value == "false")
+        return false;
+    fail(line, std::format("{}: expected true or false, got '{}'", key, value));
+}
+
+// "real imag", a comma may stand in for the space
+static Complex parse_complex(std::string value, int line, const std::string& key) {
+    for (char& ch : value)
+        if (ch == ',')
+            ch = ' ';
+
+    std::istringstream parts(value);
+    std::string real, imag, extra;
+    if (!(parts >> real >> imag) || (parts >> extra))
+        fail(line, std::format("{}: expected two numbers, got '{}'", key, value));
+
+    return Complex::Algebraic(parse_double(real, line, key), parse_double(imag, line, key));
+}
+
+// a job while its section is read, end_* keys fall back to the start values once it is complete
+struct PendingJob {
+    RenderJob job;
+    std::optional<Complex> end_center;
+    std::optional<double> end_width;
+    std::optional<int> end_max_iter;
+    std::optional<Complex> end_julia_c;
+};
+
+static void set_key(PendingJob& pending, const std::string& key, const std::string& value, int line) {
+    RenderJob& job = pending.job;
+
+    if (key == "formula") {
+        if (value == "mandelbrot")
+            job.formula = JobFormula::Mandelbrot;
+        else if (value == "julia")
+            job.formula = JobFormula::Julia;
+        else
+            fail(line, std::format("unknown formula '{}'", value));
+    } else if (key == "julia_c") {
+        job.start.julia_c = parse_complex(value, line, key);
+    } else if (key == "center") {
+        job.start.viewport.center = parse_complex(value, line, key);
+    } else if (key == "view_width") {
+        job.start.viewport.width = parse_double(value, line, key);
+    } else if (key == "max_iter") {
+        job.auto_max_iter = value == "auto";
+        if (!job.auto_max_iter)
+            job.start.config.max_iter = parse_int(value, line, key);
+    } else if (key == "escape_radius") {
+        job.start.config.escape_radius = parse_double(value, line, key);
+    } else if (key == "size") {
+        const size_t x = value.find('x');
+        if (x == std::string::npos)
+            fail(line, std::format("size: expected WIDTHxHEIGHT, got '{}'", value));
+        job.width = parse_int(value.substr(0, x), line, key);
+        job.height = parse_int(value.substr(x + 1), line, key);
+    } else if (key == "supersampling") {
+        job.supersampling = parse_int(value, line, key);
+    } else if (key == "cycle_detection") {
+        job.cycle_detection = parse_bool(value, line, key);
+    } else if (key == "frames") {
+        job.frames = parse_int(value, line, key);
+    } else if (key == "output") {
+        job.output = value;
+    } else if (key == "end_center") {
+        pending.end_center = parse_complex(value, line, key);
+    } else if (key == "end_view_width") {
+        pending.end_width = parse_double(value, line, key);
+    } else if (key == "end_max_iter") {
+        pending.end_max_iter = parse_int(value, line, key);
+    } else if (key == "end_julia_c") {
+        pending.end_julia_c = parse_complex(value, line, key);
+    } else {
+        fail(line, std::format("unknown key '{}'", key));
+    }
+}
+
+static RenderJob finish(const PendingJob& pending) {
+    RenderJob job = pending.job;
+    const int line = job.line;
+
+    job.end = job.start;
+    job.end.viewport.center = pending.end_center.value_or(job.start.viewport.center);
+    job.end.viewport.width = pending.end_width.value_or(job.start.viewport.width);
+    job.end.config.max_iter = pending.end_max_iter.value_or(job.start.config.max_iter);
+    job.end.julia_c = pending.end_julia_c.value_or(job.start.julia_c);
+
+    if (job.output.empty())
+        fail(line, "job has no output");
+    if (job.width < 2 || job.height < 2)
+        fail(line, "size must be at least 2x2");
+    if (job.start.viewport.width <= 0.0 || job.end.viewport.width <= 0.0)
+        fail(line, "view_width must be positive");
+    if (job.start.config.max_iter <= 0 || job.end.config.max_iter <= 0)
+        fail(line, "max_iter must be positive");
+    if (job.start.config.escape_radius <= 0.0)
+        fail(line, "escape_radius must be positive");
+    if (job.supersampling < 1 || job.supersampling > 16)
+        fail(line, "supersampling must be in [1, 16]");
+    if (job.frames < 1)
+        fail(line, "frames must be positive");
+
+    if (job.animated()) {
+        std::string first, second;
+        try {
+            first = job.output_path(0);
+            second = job.output_path(1);
+        } catch (const std::format_error& e) {
+            fail(line, std::format("output '{}' is not a frame pattern: {}", job.output, e.what()));
+        }
+        if (first == second)
+            fail(line, std::format("output '{}' must contain the frame index, e.g. {{:04}}", job.output));
+    }
+
+    return job;
+}
+
+std::string RenderJob::output_path(int frame) const {
+    if (!animated())
+        return output;
+    return std::vformat(output, std::make_format_args(frame));
+}
+
+FractalKeyframe RenderJob::keyframe(int frame) const {
+    if (!animated())
+        return start;
+
+    const double t = static_cast<double>(frame) / (frames - 1);
+
+    FractalKeyframe key = interpolate(start, end, t);
+    key.config.max_iter = static_cast<int>(std::lround(start.config.max_iter * (1.0 - t) + end.config.max_iter * t));
+    return key;
+}
+
+std::vector<RenderJob> iheay::fractal::parse_jobs(std::istream& input) {
+    std::vector<RenderJob> jobs;
+    std::optional<PendingJob> pending;
+
+    std::string text;
+    for (int line = 1; std::getline(input, text); ++line) {
+        text = trim(text.substr(0, text.find('#')));
+        if (text.empty())
+            continue;
+
+        if (text.front() == '[') {
+            if (text != "[job]")
+                fail(line, std::format("unknown section '{}'", text));
+            if (pending)
+                jobs.push_back(finish(*pending));
+            pending.emplace();
+            pending->job.line = line;
+            continue;
+        }
+
+        const size_t equals = text.find('=');
+        if (equals == std::string::npos)
+            fail(line, std::format("expected key = value, got '{}'", text));
+        if (!pending)
+            fail(line, "key outside of a [job] section");
+
+        set_key(*pending, trim(text.substr(0, equals)), trim(text.substr(equals + 1)), line);
+    }
+
+    if (pending)
+        jobs.push_back(finish(*pending));
+
+    return jobs;
+}
+
+std::vector<RenderJob> iheay::fractal::load_jobs(const std::string& path) {
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error(std::format("Job file: can't open {}", path));
+    return parse_jobs(file);
+}
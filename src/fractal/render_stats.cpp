@@ -0,0 +1,174 @@
+#include "fractal/render_stats.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <limits>
+#include <omp.h>
+#include <stdexcept>
+
+using namespace iheay::fractal;
+
+// local static helpers
+
+static double cpu_seconds() {
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+}
+
+static uint64_t next_collector_id() {
+    static std::atomic<uint64_t> next = 1;
+    return next++;
+}
+
+// one tile row of lanes into the sums, in loops the compiler vectorizes
+template <typename Sum>
+static void sum_lanes(StatsCollector::PixelSums& sums, const int* iter, const int* cycle_iter, int count, int max_iter) {
+    Sum iterations = 0;
+    Sum interior = 0;
+    for (int i = 0; i < count; ++i) {
+        iterations += iter[i];
+        interior += iter[i] >= max_iter;
+    }
+    sums.iterations += iterations;
+    sums.interior += interior;
+
+    if (cycle_iter) {
+        Sum cycled = 0;
+        Sum cycle_iterations = 0;
+        for (int i = 0; i < count; ++i) {
+            cycled += cycle_iter[i] > 0;
+            cycle_iterations += cycle_iter[i];
+        }
+        sums.cycled += cycled;
+        sums.cycle_iterations += cycle_iterations;
+    }
+}
+
+// ---------------- RenderStats ----------------
+
+double RenderStats::utilization() const {
+    double busy = 0.0;
+    double total = 0.0;
+    for (const ThreadStats& thread : threads) {
+        busy += thread.busy_seconds;
+        total += thread.busy_seconds + thread.idle_seconds;
+    }
+    return total > 0.0 ? busy / total : 0.0;
+}
+
+// ---------------- StatsCollector ----------------
+
+StatsCollector::StatsCollector(int width, int height, int max_iter)
+: m_id(next_collector_id())
+, m_width(width)
+, m_height(height)
+, m_max_iter(max_iter)
+, m_tiles_x((width + default_tile_size - 1) / default_tile_size)
+, m_tiles_y((height + default_tile_size - 1) / default_tile_size)
+, m_wall_start(omp_get_wtime())
+, m_cpu_start(cpu_seconds()) {
+    if (width <= 0 || height <= 0)
+        throw std::runtime_error("Invalid render stats size");
+}
+
+StatsCollector::Slot& StatsCollector::add_slot() {
+    auto slot = std::make_unique<Slot>();
+    slot->tiles.resize(static_cast<size_t>(m_tiles_x) * m_tiles_y);
+
+    std::lock_guard lock(m_mutex);
+    m_slots.push_back(std::move(slot));
+    return *m_slots.back();
+}
+
+void StatsCollector::add(unsigned tx, int y, PixelSums sums) {
+    const long unsettled = sums.interior - sums.settled - sums.cycled;
+
+    PixelCounts& tile = local().tiles[static_cast<size_t>(y / default_tile_size) * m_tiles_x + tx];
+    tile.escaped += sums.pixels - sums.interior;
+    tile.interior += sums.interior;
+    tile.iterations += sums.iterations - sums.interior * m_max_iter;
+    tile.interior_iterations += unsettled * m_max_iter + sums.cycle_iterations;
+}
+
+void StatsCollector::count_lanes(int y, int x0, int x1, const int* slot, int lanes, const int* iter, const int* cycle_iter) {
+    // the lanes run in x order, each tile's pixels hold the range from the lane at its left edge on
+    auto lane_at = [&](int x) {
+        if (x == x1)
+            return lanes;
+        const int s = slot[x - x0];
+        return s >= 0 ? s : -1 - s;
+    };
+
+    // a tile row's iterations fit in an int up to here, the vector loops over ints run twice as wide
+    const bool int_sums = m_max_iter <= std::numeric_limits<int>::max() / default_tile_size;
+
+    for (int a = x0; a < x1;) {
+        const int b = std::min(x1, (a / default_tile_size + 1) * default_tile_size);
+        const int first = lane_at(a);
+        const int end = lane_at(b);
+
+        PixelSums sums;
+        sums.pixels = b - a;
+        sums.settled = sums.pixels - (end - first);
+        sums.interior = sums.settled;
+        sums.iterations = sums.settled * m_max_iter;
+
+        if (int_sums)
+            sum_lanes<int>(sums, iter + first, cycle_iter ? cycle_iter + first : nullptr, end - first, m_max_iter);
+        else
+            sum_lanes<long>(sums, iter + first, cycle_iter ? cycle_iter + first : nullptr, end - first, m_max_iter);
+
+        add(a / default_tile_size, y, sums);
+        a = b;
+    }
+}
+
+StatsCollector::Phase::Phase(StatsCollector& collector, std::string name, bool timed_threads)
+: m_collector(collector)
+, m_name(std::move(name))
+, m_timed_threads(timed_threads)
+, m_wall_start(omp_get_wtime())
+, m_cpu_start(cpu_seconds()) {}
+
+StatsCollector::Phase::~Phase() {
+    const PhaseStats phase { std::move(m_name), omp_get_wtime() - m_wall_start, cpu_seconds() - m_cpu_start };
+
+    std::lock_guard lock(m_collector.m_mutex);
+    if (m_timed_threads)
+        m_collector.m_timed_seconds += phase.wall_seconds;
+    m_collector.m_phases.push_back(phase);
+}
+
+RenderStats StatsCollector::finish() const {
+    RenderStats stats;
+    stats.enabled = true;
+    stats.width = m_width;
+    stats.height = m_height;
+    stats.tiles_x = m_tiles_x;
+    stats.tiles_y = m_tiles_y;
+    stats.tiles.resize(static_cast<size_t>(m_tiles_x) * m_tiles_y);
+
+    std::lock_guard lock(m_mutex);
+
+    for (const auto& slot : m_slots) {
+        ThreadStats thread;
+        thread.busy_seconds = slot->busy_seconds;
+        thread.idle_seconds = std::max(0.0, m_timed_seconds - slot->busy_seconds);
+
+        for (size_t i = 0; i < stats.tiles.size(); ++i) {
+            stats.tiles[i] += slot->tiles[i];
+            thread.pixels += slot->tiles[i].pixels();
+        }
+
+        // threads that only timed a loop they found no work in still count as idle
+        stats.threads.push_back(thread);
+    }
+
+    for (const PixelCounts& tile : stats.tiles)
+        stats.total += tile;
+
+    stats.phases = m_phases;
+    stats.wall_seconds = omp_get_wtime() - m_wall_start;
+    stats.cpu_seconds = cpu_seconds() - m_cpu_start;
+    return stats;
+}
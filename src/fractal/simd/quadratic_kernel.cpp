@@ -0,0 +1,168 @@
+#include "fractal/simd/quadratic_kernel.hpp"
+
+using namespace iheay::fractal;
+
+// per-isa entry points, defined only when CMake compiled them with their flags
+
+namespace iheay::fractal::simd {
+
+#if defined(IHEAY_SIMD_KERNELS)
+void iterate_quadratic_avx2(const QuadraticSpan& span, int max_iter, double escape_radius_sq, double cycle_tolerance_sq);
+void iterate_quadratic_avx512(const QuadraticSpan& span, int max_iter, double escape_radius_sq, double cycle_tolerance_sq);
+void iterate_quadratic_avx2(const QuadraticSpanF& span, int max_iter, double escape_radius_sq, double cycle_tolerance_sq);
+void iterate_quadratic_avx512(const QuadraticSpanF& span, int max_iter, double escape_radius_sq, double cycle_tolerance_sq);
+#endif
+
+} // namespace iheay::fractal::simd
+
+// local static helpers
+
+// reference loop, identical to the one in FractalRenderer::render when T is double
+template <typename T>
+static void iterate_quadratic_scalar(const simd::BasicQuadraticSpan<T>& span, int max_iter, double escape_radius_sq, double cycle_tolerance_sq) {
+    const T radius = static_cast<T>(escape_radius_sq);
+    const T tolerance = static_cast<T>(cycle_tolerance_sq);
+
+    int first_save = 1;
+    while (first_save <= span.start_iter)
+        first_save *= 2;
+
+    for (int i = 0; i < span.count; ++i) {
+        T zr = span.z_real[i];
+        T zi = span.z_imag[i];
+        const T cr = span.c_real[i];
+        const T ci = span.c_imag[i];
+
+        T saved_zr = span.saved_real ? span.saved_real[i] : zr;
+        T saved_zi = span.saved_imag ? span.saved_imag[i] : zi;
+        int save_at = first_save;
+        int cycle_iter = 0;
+
+        int iter = span.start_iter;
+        while (iter < max_iter) {
+            if (zr * zr + zi * zi > radius)
+                break;
+
+            const T next_zr = zr * zr - zi * zi + cr;
+            zi = zr * zi + zi * zr + ci;
+            zr = next_zr;
+            ++iter;
+
+            if (cycle_tolerance_sq > 0) {
+                const T dr = zr - saved_zr;
+                const T di = zi - saved_zi;
+
+                if (dr * dr + di * di < tolerance) {
+                    cycle_iter = iter;
+                    iter = max_iter;
+                    break;
+                }
+
+                if (iter == save_at) {
+                    saved_zr = zr;
+                    saved_zi = zi;
+                    save_at *= 2;
+                }
+            }
+        }
+
+        span.out_real[i] = zr;
+        span.out_imag[i] = zi;
+        span.iter[i] = iter;
+
+        if (span.cycle_iter)
+            span.cycle_iter[i] = cycle_iter;
+        if (span.cycled)
+            span.cycled[i] = cycle_iter > 0;
+        if (span.out_saved_real) {
+            span.out_saved_real[i] = saved_zr;
+            span.out_saved_imag[i] = saved_zi;
+        }
+    }
+}
+
+static simd::Isa detect_isa_uncached() noexcept {
+#if defined(IHEAY_SIMD_KERNELS) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return simd::Isa::Avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return simd::Isa::Avx2;
+#endif
+    return simd::Isa::Scalar;
+}
+
+// isa detection
+
+simd::Isa simd::detect_isa() noexcept {
+    static const Isa isa = detect_isa_uncached();
+    return isa;
+}
+
+int simd::lane_count(Isa isa, bool single_precision) noexcept {
+    const int factor = single_precision ? 2 : 1;
+
+    switch (isa) {
+        case Isa::Avx512: return 8 * factor;
+        case Isa::Avx2: return 4 * factor;
+        case Isa::Scalar: return 1;
+    }
+    return 1;
+}
+
+// buffers
+
+template <typename T>
+simd::BasicQuadraticBuffers<T>::BasicQuadraticBuffers(int capacity)
+: z_real(capacity), z_imag(capacity), c_real(capacity), c_imag(capacity)
+, out_real(capacity), out_imag(capacity)
+, iter(capacity), cycle_iter(capacity) {}
+
+template <typename T>
+simd::BasicQuadraticSpan<T> simd::BasicQuadraticBuffers<T>::span(int count) {
+    return {
+        z_real.data(), z_imag.data(), c_real.data(), c_imag.data(),
+        out_real.data(), out_imag.data(), iter.data(),
+        count, cycle_iter.data()
+    };
+}
+
+template struct simd::BasicQuadraticBuffers<double>;
+template struct simd::BasicQuadraticBuffers<float>;
+
+// iteration
+
+void simd::iterate_quadratic(const QuadraticSpan& span, int max_iter, double escape_radius_sq, Isa isa, double cycle_tolerance_sq) {
+    // never run instructions the cpu does not have
+    if (static_cast<int>(isa) > static_cast<int>(detect_isa()))
+        isa = detect_isa();
+
+    switch (isa) {
+#if defined(IHEAY_SIMD_KERNELS)
+        case Isa::Avx512: iterate_quadratic_avx512(span, max_iter, escape_radius_sq, cycle_tolerance_sq); return;
+        case Isa::Avx2: iterate_quadratic_avx2(span, max_iter, escape_radius_sq, cycle_tolerance_sq); return;
+#endif
+        default: iterate_quadratic_scalar(span, max_iter, escape_radius_sq, cycle_tolerance_sq); return;
+    }
+}
+
+void simd::iterate_quadratic(const QuadraticSpan& span, int max_iter, double escape_radius_sq, double cycle_tolerance_sq) {
+    iterate_quadratic(span, max_iter, escape_radius_sq, detect_isa(), cycle_tolerance_sq);
+}
+
+void simd::iterate_quadratic(const QuadraticSpanF& span, int max_iter, double escape_radius_sq, Isa isa, double cycle_tolerance_sq) {
+    if (static_cast<int>(isa) > static_cast<int>(detect_isa()))
+        isa = detect_isa();
+
+    switch (isa) {
+#if defined(IHEAY_SIMD_KERNELS)
+        case Isa::Avx512: iterate_quadratic_avx512(span, max_iter, escape_radius_sq, cycle_tolerance_sq); return;
+        case Isa::Avx2: iterate_quadratic_avx2(span, max_iter, escape_radius_sq, cycle_tolerance_sq); return;
+#endif
+        default: iterate_quadratic_scalar(span, max_iter, escape_radius_sq, cycle_tolerance_sq); return;
+    }
+}
+
+void simd::iterate_quadratic(const QuadraticSpanF& span, int max_iter, double escape_radius_sq, double cycle_tolerance_sq) {
+    iterate_quadratic(span, max_iter, escape_radius_sq, detect_isa(), cycle_tolerance_sq);
+}
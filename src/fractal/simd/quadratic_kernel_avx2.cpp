@@ -0,0 +1,79 @@
+// compiled with -mavx2, see CMakeLists.txt
+
+#include "fractal/simd/inl/quadratic_kernel.inl"
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+namespace iheay::fractal::simd {
+
+namespace {
+
+struct Avx2Ops {
+    using scalar = double;
+    using vec = __m256d;
+    using mask = __m256d;
+
+    static constexpr int lanes = 4;
+
+    static vec set1(double v) { return _mm256_set1_pd(v); }
+    static vec load(const double* p) { return _mm256_load_pd(p); }
+    static void store(double* p, vec v) { _mm256_store_pd(p, v); }
+
+    static vec add(vec a, vec b) { return _mm256_add_pd(a, b); }
+    static vec sub(vec a, vec b) { return _mm256_sub_pd(a, b); }
+    static vec mul(vec a, vec b) { return _mm256_mul_pd(a, b); }
+
+    static mask cmp_gt(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static mask cmp_ge(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+    static mask cmp_lt(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static mask cmp_eq(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    static mask mask_or(mask a, mask b) { return _mm256_or_pd(a, b); }
+    static vec blend(mask m, vec a, vec b) { return _mm256_blendv_pd(a, b, m); }
+    static unsigned bits(mask m) { return static_cast<unsigned>(_mm256_movemask_pd(m)); }
+};
+
+struct Avx2FloatOps {
+    using scalar = float;
+    using vec = __m256;
+    using mask = __m256;
+
+    static constexpr int lanes = 8;
+
+    static vec set1(float v) { return _mm256_set1_ps(v); }
+    static vec load(const float* p) { return _mm256_load_ps(p); }
+    static void store(float* p, vec v) { _mm256_store_ps(p, v); }
+
+    static vec add(vec a, vec b) { return _mm256_add_ps(a, b); }
+    static vec sub(vec a, vec b) { return _mm256_sub_ps(a, b); }
+    static vec mul(vec a, vec b) { return _mm256_mul_ps(a, b); }
+
+    static mask cmp_gt(vec a, vec b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static mask cmp_ge(vec a, vec b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static mask cmp_lt(vec a, vec b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static mask cmp_eq(vec a, vec b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static mask mask_or(mask a, mask b) { return _mm256_or_ps(a, b); }
+    static vec blend(mask m, vec a, vec b) { return _mm256_blendv_ps(a, b, m); }
+    static unsigned bits(mask m) { return static_cast<unsigned>(_mm256_movemask_ps(m)); }
+};
+
+} // namespace
+
+void iterate_quadratic_avx2(const QuadraticSpan& span, int max_iter, double escape_radius_sq, double cycle_tolerance_sq) {
+    if (cycle_tolerance_sq > 0)
+        iterate_quadratic_lanes<Avx2Ops, true>(span, max_iter, escape_radius_sq, cycle_tolerance_sq);
+    else
+        iterate_quadratic_lanes<Avx2Ops, false>(span, max_iter, escape_radius_sq, 0.0);
+}
+
+void iterate_quadratic_avx2(const QuadraticSpanF& span, int max_iter, double escape_radius_sq, double cycle_tolerance_sq) {
+    if (cycle_tolerance_sq > 0)
+        iterate_quadratic_lanes<Avx2FloatOps, true>(span, max_iter, escape_radius_sq, cycle_tolerance_sq);
+    else
+        iterate_quadratic_lanes<Avx2FloatOps, false>(span, max_iter, escape_radius_sq, 0.0);
+}
+
+} // namespace iheay::fractal::simd
+
+#endif
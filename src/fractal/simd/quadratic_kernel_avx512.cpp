@@ -0,0 +1,79 @@
+// compiled with -mavx512f, see CMakeLists.txt
+
+#include "fractal/simd/inl/quadratic_kernel.inl"
+
+#if defined(__AVX512F__)
+
+#include <immintrin.h>
+
+namespace iheay::fractal::simd {
+
+namespace {
+
+struct Avx512Ops {
+    using scalar = double;
+    using vec = __m512d;
+    using mask = __mmask8;
+
+    static constexpr int lanes = 8;
+
+    static vec set1(double v) { return _mm512_set1_pd(v); }
+    static vec load(const double* p) { return _mm512_load_pd(p); }
+    static void store(double* p, vec v) { _mm512_store_pd(p, v); }
+
+    static vec add(vec a, vec b) { return _mm512_add_pd(a, b); }
+    static vec sub(vec a, vec b) { return _mm512_sub_pd(a, b); }
+    static vec mul(vec a, vec b) { return _mm512_mul_pd(a, b); }
+
+    static mask cmp_gt(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    static mask cmp_ge(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ); }
+    static mask cmp_lt(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static mask cmp_eq(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+    static mask mask_or(mask a, mask b) { return static_cast<mask>(a | b); }
+    static vec blend(mask m, vec a, vec b) { return _mm512_mask_blend_pd(m, a, b); }
+    static unsigned bits(mask m) { return static_cast<unsigned>(m); }
+};
+
+struct Avx512FloatOps {
+    using scalar = float;
+    using vec = __m512;
+    using mask = __mmask16;
+
+    static constexpr int lanes = 16;
+
+    static vec set1(float v) { return _mm512_set1_ps(v); }
+    static vec load(const float* p) { return _mm512_load_ps(p); }
+    static void store(float* p, vec v) { _mm512_store_ps(p, v); }
+
+    static vec add(vec a, vec b) { return _mm512_add_ps(a, b); }
+    static vec sub(vec a, vec b) { return _mm512_sub_ps(a, b); }
+    static vec mul(vec a, vec b) { return _mm512_mul_ps(a, b); }
+
+    static mask cmp_gt(vec a, vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static mask cmp_ge(vec a, vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+    static mask cmp_lt(vec a, vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static mask cmp_eq(vec a, vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+    static mask mask_or(mask a, mask b) { return static_cast<mask>(a | b); }
+    static vec blend(mask m, vec a, vec b) { return _mm512_mask_blend_ps(m, a, b); }
+    static unsigned bits(mask m) { return static_cast<unsigned>(m); }
+};
+
+} // namespace
+
+void iterate_quadratic_avx512(const QuadraticSpan& span, int max_iter, double escape_radius_sq, double cycle_tolerance_sq) {
+    if (cycle_tolerance_sq > 0)
+        iterate_quadratic_lanes<Avx512Ops, true>(span, max_iter, escape_radius_sq, cycle_tolerance_sq);
+    else
+        iterate_quadratic_lanes<Avx512Ops, false>(span, max_iter, escape_radius_sq, 0.0);
+}
+
+void iterate_quadratic_avx512(const QuadraticSpanF& span, int max_iter, double escape_radius_sq, double cycle_tolerance_sq) {
+    if (cycle_tolerance_sq > 0)
+        iterate_quadratic_lanes<Avx512FloatOps, true>(span, max_iter, escape_radius_sq, cycle_tolerance_sq);
+    else
+        iterate_quadratic_lanes<Avx512FloatOps, false>(span, max_iter, escape_radius_sq, 0.0);
+}
+
+} // namespace iheay::fractal::simd
+
+#endif
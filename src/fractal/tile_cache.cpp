@@ -0,0 +1,139 @@
+#include "fractal/tile_cache.hpp"
+#include "fractal/tile_store.hpp"
+
+#include <bit>
+#include <stdexcept>
+
+using namespace iheay::fractal;
+
+// local static helpers
+
+static void hash_combine(size_t& seed, uint64_t value) {
+    seed ^= std::hash<uint64_t>{}(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
+// key hashing
+
+uint64_t iheay::fractal::formula_hash(std::string_view name) noexcept {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (unsigned char c : name) {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+size_t TileKeyHash::operator()(const TileKey& key) const noexcept {
+    size_t seed = 0;
+    hash_combine(seed, key.formula);
+    hash_combine(seed, static_cast<uint64_t>(key.level));
+    hash_combine(seed, static_cast<uint64_t>(key.tx));
+    hash_combine(seed, static_cast<uint64_t>(key.ty));
+    hash_combine(seed, static_cast<uint64_t>(key.max_iter));
+    hash_combine(seed, std::bit_cast<uint64_t>(key.escape_radius));
+    return seed;
+}
+
+// cache
+
+TileCache::TileCache(size_t byte_budget)
+: m_byte_budget(byte_budget) {
+    if (byte_budget == 0)
+        throw std::runtime_error("Tile cache budget must be positive");
+}
+
+CachedTile TileCache::find(const TileKey& key) {
+    std::lock_guard lock(m_mutex);
+
+    const auto it = m_index.find(key);
+    if (it == m_index.end()) {
+        ++m_stats.misses;
+        return {};
+    }
+
+    ++m_stats.hits;
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->tile;
+}
+
+void TileCache::insert(const TileKey& key, std::shared_ptr<const EscapeField> tile) {
+    if (!tile)
+        throw std::runtime_error("Tile cache can't hold a null tile");
+
+    const size_t bytes = tile_bytes(*tile);
+    insert(key, CachedTile { std::move(tile), nullptr }, bytes);
+}
+
+void TileCache::insert(const TileKey& key, std::shared_ptr<const MappedTile> tile) {
+    if (!tile)
+        throw std::runtime_error("Tile cache can't hold a null tile");
+
+    const size_t bytes = tile_bytes(*tile);
+    insert(key, CachedTile { nullptr, std::move(tile) }, bytes);
+}
+
+void TileCache::insert(const TileKey& key, CachedTile tile, size_t bytes) {
+    std::lock_guard lock(m_mutex);
+
+    // two callers may render the same missing tile, the later one replaces it
+    if (const auto it = m_index.find(key); it != m_index.end()) {
+        m_stats.bytes -= it->second->bytes;
+        m_lru.erase(it->second);
+        m_index.erase(it);
+    }
+
+    if (bytes > m_byte_budget)
+        return;
+
+    while (m_stats.bytes + bytes > m_byte_budget)
+        evict_last();
+
+    m_lru.push_front({ key, std::move(tile), bytes });
+    m_index.emplace(key, m_lru.begin());
+    m_stats.bytes += bytes;
+}
+
+void TileCache::evict_last() {
+    const Entry& last = m_lru.back();
+
+    m_stats.bytes -= last.bytes;
+    ++m_stats.evictions;
+    m_index.erase(last.key);
+    m_lru.pop_back();
+}
+
+void TileCache::clear() {
+    std::lock_guard lock(m_mutex);
+
+    m_lru.clear();
+    m_index.clear();
+    m_stats.bytes = 0;
+}
+
+TileCache::Stats TileCache::stats() const {
+    std::lock_guard lock(m_mutex);
+
+    Stats stats = m_stats;
+    stats.tiles = m_index.size();
+    return stats;
+}
+
+void TileCache::reset_stats() {
+    std::lock_guard lock(m_mutex);
+
+    m_stats.hits = 0;
+    m_stats.misses = 0;
+    m_stats.evictions = 0;
+}
+
+size_t TileCache::tile_bytes(const EscapeField& tile) {
+    const size_t pixels = static_cast<size_t>(tile.width()) * tile.height();
+    const FieldChannels channels = tile.channels();
+    const size_t planes = 1 + channels.final_z + channels.derivative + channels.distance;
+
+    return sizeof(EscapeField) + pixels * planes * sizeof(double);
+}
+
+size_t TileCache::tile_bytes(const MappedTile& tile) {
+    return sizeof(MappedTile) + static_cast<size_t>(tile.size()) * tile.size() * sizeof(float);
+}
@@ -0,0 +1,730 @@
+#include "fractal/tile_server.hpp"
+#include "fractal/cached_renderer.hpp"
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <omp.h>
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+using namespace iheay::bmp;
+using namespace iheay::fractal;
+
+// deeper levels step below what double pixel coordinates resolve
+static constexpr int max_tile_level = 48;
+
+// tiles of level L are served within 2^(L + tile_range_bits) of the origin, i.e. 16 root extents
+// either way, far past where the formulas escape; with tile sizes up to max_tile_size,
+// tx * tile_size stays below 2^63 at every level
+static constexpr int tile_range_bits = 4;
+static constexpr int max_tile_size = 2048;
+
+// a client that sends this much without a newline is not speaking the protocol
+static constexpr size_t max_request_line = 1024;
+
+struct TileServer::Connection {
+    explicit Connection(int fd) : fd(fd) {}
+
+    ~Connection() {
+#if !defined(_WIN32)
+        ::close(fd);
+#endif
+    }
+
+    int fd; // non-blocking
+    std::mutex write_mutex;     // guards output, responses from several threads must not interleave
+    std::string output;         // not yet taken by the socket, the io thread sends it once writable
+    std::atomic<bool> open = true;
+    std::string input;          // io thread only
+};
+
+struct TileServer::Waiter {
+    std::shared_ptr<Connection> connection;
+    uint64_t id;
+    const TilePalette* palette;
+};
+
+// a cached tile still to be colorized and sent, by a worker rather than the io thread
+struct TileServer::Hit {
+    Waiter waiter;
+    std::shared_ptr<const EscapeField> field;
+};
+
+struct TileServer::Pending {
+    TileKey key;
+    const Formula* formula;
+    Slot slot;
+    bool rendering = false;
+    std::vector<Waiter> waiters;
+};
+
+// local static helpers
+
+static bool valid_name(const std::string& name) {
+    return !name.empty() && std::none_of(name.begin(), name.end(), [](unsigned char ch) { return std::isspace(ch); });
+}
+
+static bool parse_request(const std::string& line, TileRequest& request) {
+    std::istringstream words(line);
+    std::string kind, extra;
+
+    if (!(words >> request.id >> kind >> request.formula >> request.palette >> request.level >> request.tx >> request.ty))
+        return false;
+    if (words >> extra)
+        return false;
+
+    if (kind != "visible" && kind != "prefetch")
+        return false;
+    request.prefetch = kind == "prefetch";
+    return true;
+}
+
+static std::string error_message(uint64_t id, const std::string& message) {
+    return std::format("{} ERR {}\n", id, message);
+}
+
+static std::string tile_header(uint64_t id, const EscapeField& field) {
+    return std::format("{} OK {} {}\n", id, field.width(), field.height());
+}
+
+// body of a successful response
+static std::string tile_pixels(const EscapeField& field, const TilePalette& palette) {
+    std::string pixels(field.mu_data().size() * 3, '\0');
+
+    char* out = pixels.data();
+    for (double mu : field.mu_data()) {
+        const BgrPixel pixel = palette(mu, field.max_iter());
+        *out++ = static_cast<char>(pixel.b);
+        *out++ = static_cast<char>(pixel.g);
+        *out++ = static_cast<char>(pixel.r);
+    }
+    return pixels;
+}
+
+#if !defined(_WIN32)
+
+// false once the other end is gone
+static bool send_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        const ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent <= 0)
+            return false;
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+// sends what the socket takes without blocking and drops it from output, false once the other end is gone
+static bool send_some(int fd, std::string& output) {
+    size_t sent_total = 0;
+    while (sent_total < output.size()) {
+        const ssize_t sent = ::send(fd, output.data() + sent_total, output.size() - sent_total, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if (sent <= 0)
+            return false;
+        sent_total += static_cast<size_t>(sent);
+    }
+    output.erase(0, sent_total);
+    return true;
+}
+
+static bool set_non_blocking(int fd) {
+    const int flags = ::fcntl(fd, F_GETFL);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static sockaddr_un socket_address(const std::string& path) {
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+        throw std::runtime_error(std::format("Tile server: socket path '{}' is empty or too long", path));
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+#endif
+
+// server
+
+TileServer::TileServer(std::string socket_path, TileServerOptions options)
+: m_socket_path(std::move(socket_path))
+, m_options(options)
+, m_cache(options.cache_bytes) {
+    if (m_options.workers <= 0 || m_options.tile_size <= 1 || m_options.queue_limit <= 0 || m_options.output_limit == 0)
+        throw std::runtime_error("Tile server: workers, queue_limit, output_limit and tile_size must be positive");
+    if (m_options.tile_size > max_tile_size)
+        throw std::runtime_error(std::format("Tile server: tile_size can be at most {}", max_tile_size));
+}
+
+TileServer::~TileServer() {
+    stop();
+}
+
+void TileServer::add_formula(const std::string& name, FractalConfig config, TileFieldFunc render) {
+    if (!valid_name(name))
+        throw std::runtime_error(std::format("Tile server: invalid formula name '{}'", name));
+    if (!render)
+        throw std::runtime_error("Tile server: formula needs a render function");
+    if (m_io.joinable())
+        throw std::runtime_error("Tile server: formulas are added before start()");
+
+    m_formulas[name] = { config, std::move(render), formula_hash(name) };
+}
+
+void TileServer::add_palette(const std::string& name, TilePalette palette) {
+    if (!valid_name(name))
+        throw std::runtime_error(std::format("Tile server: invalid palette name '{}'", name));
+    if (!palette)
+        throw std::runtime_error("Tile server: palette function is required");
+    if (m_io.joinable())
+        throw std::runtime_error("Tile server: palettes are added before start()");
+
+    m_palettes[name] = std::move(palette);
+}
+
+ViewportMapping TileServer::tile_mapping(int level, int64_t tx, int64_t ty) const {
+    const double step = std::ldexp(cached_root_extent / m_options.tile_size, -level);
+
+    return {
+        static_cast<double>(tx * m_options.tile_size) * step,
+        -static_cast<double>(ty * m_options.tile_size) * step,
+        step,
+        step
+    };
+}
+
+TileServerStats TileServer::stats() const {
+    std::lock_guard lock(m_mutex);
+    return m_stats;
+}
+
+void TileServer::start() {
+#if defined(_WIN32)
+    throw std::runtime_error("TileServer requires a POSIX system");
+#else
+    if (m_io.joinable())
+        throw std::runtime_error("Tile server: already started");
+
+    const sockaddr_un address = socket_address(m_socket_path);
+
+    m_listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listen_fd < 0)
+        throw std::runtime_error("Tile server: failed to create a socket");
+
+    ::unlink(m_socket_path.c_str());
+    if (::bind(m_listen_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(m_listen_fd, SOMAXCONN) != 0 ||
+        ::pipe(m_wake_fds) != 0 ||
+        !set_non_blocking(m_wake_fds[0]) || !set_non_blocking(m_wake_fds[1])) {
+        const std::string reason = std::strerror(errno);
+        ::close(m_listen_fd);
+        m_listen_fd = -1;
+        throw std::runtime_error(std::format("Tile server: can't listen on {}: {}", m_socket_path, reason));
+    }
+
+    m_stopping = false;
+    m_io = std::thread(&TileServer::io_loop, this);
+    for (int i = 0; i < m_options.workers; ++i)
+        m_workers.emplace_back(&TileServer::worker_loop, this);
+
+    LOG_INFO("Tile server: listening on {} with {} workers, {}x{} tiles",
+        m_socket_path, m_options.workers, m_options.tile_size, m_options.tile_size);
+#endif
+}
+
+void TileServer::stop() {
+#if !defined(_WIN32)
+    if (!m_io.joinable())
+        return;
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_ready.notify_all();
+    wake();
+
+    m_io.join();
+    for (std::thread& worker : m_workers)
+        worker.join();
+    m_workers.clear();
+
+    // waiters hold the last references to their connections
+    m_queue.clear();
+    m_pending.clear();
+    m_hits.clear();
+
+    ::close(m_listen_fd);
+    ::close(m_wake_fds[0]);
+    ::close(m_wake_fds[1]);
+    m_listen_fd = m_wake_fds[0] = m_wake_fds[1] = -1;
+    ::unlink(m_socket_path.c_str());
+
+    const TileServerStats stats = this->stats();
+    LOG_INFO("Tile server: {} requests, {} cache hits, {} coalesced, {} rendered, {} dropped, {} refused, {} overflowed",
+        stats.requests, stats.cache_hits, stats.coalesced, stats.rendered, stats.dropped, stats.refused, stats.overflowed);
+#endif
+}
+
+void TileServer::io_loop() {
+#if !defined(_WIN32)
+    std::vector<std::shared_ptr<Connection>> connections;
+    std::vector<pollfd> polled;
+    char buffer[4096];
+
+    while (true) {
+        polled.clear();
+        polled.push_back({ m_wake_fds[0], POLLIN, 0 });
+        polled.push_back({ m_listen_fd, POLLIN, 0 });
+        for (const auto& connection : connections) {
+            std::lock_guard lock(connection->write_mutex);
+            polled.push_back({ connection->fd, static_cast<short>(connection->output.empty() ? POLLIN : POLLIN | POLLOUT), 0 });
+        }
+
+        if (::poll(polled.data(), polled.size(), -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            LOG_ERROR("Tile server: poll failed: {}", std::strerror(errno));
+            break;
+        }
+
+        // woken by stop(), or by a thread that left output behind or closed a connection
+        if (polled[0].revents != 0) {
+            char drained[64];
+            while (::read(m_wake_fds[0], drained, sizeof(drained)) > 0) {}
+
+            std::lock_guard lock(m_mutex);
+            if (m_stopping)
+                break;
+        }
+
+        const size_t polled_connections = connections.size();
+
+        if (polled[1].revents & POLLIN) {
+            const int fd = ::accept(m_listen_fd, nullptr, nullptr);
+            if (fd >= 0 && set_non_blocking(fd))
+                connections.push_back(std::make_shared<Connection>(fd));
+            else if (fd >= 0)
+                ::close(fd);
+        }
+
+        for (size_t c = 0; c < polled_connections; ++c) {
+            const short events = polled[c + 2].revents;
+            const std::shared_ptr<Connection>& connection = connections[c];
+
+            if (events & POLLOUT) {
+                std::lock_guard lock(connection->write_mutex);
+                if (!send_some(connection->fd, connection->output))
+                    connection->open = false;
+            }
+
+            if (!(events & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+
+            const ssize_t received = ::recv(connection->fd, buffer, sizeof(buffer), 0);
+            if (received < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+                continue;
+
+            if (received <= 0) {
+                connection->open = false;
+            } else {
+                connection->input.append(buffer, static_cast<size_t>(received));
+
+                size_t newline;
+                while (connection->open && (newline = connection->input.find('\n')) != std::string::npos) {
+                    const std::string line = connection->input.substr(0, newline);
+                    connection->input.erase(0, newline + 1);
+                    handle_line(connection, line);
+                }
+
+                if (connection->input.size() > max_request_line)
+                    connection->open = false;
+            }
+        }
+
+        // closed by the client, by a failed write of any thread, or for a runaway line
+        std::erase_if(connections, [&](const auto& connection) {
+            if (connection->open)
+                return false;
+            disconnect(connection);
+            return true;
+        });
+    }
+
+    for (const auto& connection : connections)
+        disconnect(connection);
+#endif
+}
+
+void TileServer::handle_line(const std::shared_ptr<Connection>& connection, const std::string& line) {
+#if !defined(_WIN32)
+    auto reply = [&](const std::string& message) { send(*connection, message); };
+
+    TileRequest request;
+    if (!parse_request(line, request)) {
+        reply(error_message(request.id, "malformed request"));
+        return;
+    }
+
+    const auto formula = m_formulas.find(request.formula);
+    const auto palette = m_palettes.find(request.palette);
+
+    if (formula == m_formulas.end()) {
+        reply(error_message(request.id, std::format("unknown formula {}", request.formula)));
+        return;
+    }
+    if (palette == m_palettes.end()) {
+        reply(error_message(request.id, std::format("unknown palette {}", request.palette)));
+        return;
+    }
+    if (request.level < 0 || request.level > max_tile_level) {
+        reply(error_message(request.id, std::format("level must be in [0, {}]", max_tile_level)));
+        return;
+    }
+
+    const int64_t range = int64_t(1) << (request.level + tile_range_bits);
+    if (request.tx < -range || request.tx >= range || request.ty < -range || request.ty >= range) {
+        reply(error_message(request.id, std::format("tx and ty must be in [{}, {}) at level {}", -range, range, request.level)));
+        return;
+    }
+
+    const FractalConfig& config = formula->second.config;
+    const TileKey key { formula->second.hash, request.level, request.tx, request.ty, config.max_iter, config.escape_radius };
+
+    {
+        // workers insert into the cache and leave m_pending under this lock, a tile is always in one of them
+        std::lock_guard lock(m_mutex);
+        ++m_stats.requests;
+
+        const Waiter waiter { connection, request.id, &palette->second };
+        const int rank = request.prefetch ? 1 : 0;
+
+        if (const auto pending = m_pending.find(key); pending != m_pending.end()) {
+            Pending& render = *pending->second;
+            render.waiters.push_back(waiter);
+            ++m_stats.coalesced;
+
+            if (!render.rendering && rank < render.slot.rank) {
+                m_queue.erase(render.slot);
+                render.slot.rank = rank;
+                m_queue.emplace(render.slot, pending->second);
+            }
+            return;
+        }
+
+        // only rendered fields go into the server's cache; colorizing one is left to a worker too
+        if (std::shared_ptr<const EscapeField> cached = m_cache.find(key).field) {
+            ++m_stats.cache_hits;
+            m_hits.push_back({ waiter, std::move(cached) });
+            m_ready.notify_one();
+            return;
+        }
+
+        if (static_cast<int>(m_queue.size()) >= m_options.queue_limit) {
+            ++m_stats.refused;
+        } else {
+            auto render = std::make_shared<Pending>();
+            render->key = key;
+            render->formula = &formula->second;
+            render->slot = { rank, m_sequence++ };
+            render->waiters.push_back(waiter);
+
+            m_queue.emplace(render->slot, render);
+            m_pending.emplace(key, std::move(render));
+            m_ready.notify_one();
+            return;
+        }
+    }
+
+    reply(error_message(request.id, "busy"));
+#else
+    (void)connection;
+    (void)line;
+#endif
+}
+
+void TileServer::disconnect(const std::shared_ptr<Connection>& connection) {
+#if !defined(_WIN32)
+    connection->open = false;
+    ::shutdown(connection->fd, SHUT_RDWR);
+
+    std::lock_guard lock(m_mutex);
+
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        Pending& render = *it->second;
+        std::erase_if(render.waiters, [&](const Waiter& waiter) { return waiter.connection == connection; });
+
+        // a running render still fills the cache
+        if (render.waiters.empty() && !render.rendering) {
+            m_queue.erase(render.slot);
+            it = m_pending.erase(it);
+            ++m_stats.dropped;
+        } else {
+            ++it;
+        }
+    }
+#else
+    (void)connection;
+#endif
+}
+
+void TileServer::worker_loop() {
+    // tiles run side by side, one thread each, so the pool bounds the threads too
+    omp_set_num_threads(1);
+
+    while (true) {
+        std::shared_ptr<Pending> render;
+        std::optional<Hit> hit;
+        {
+            std::unique_lock lock(m_mutex);
+            m_ready.wait(lock, [&] { return m_stopping || !m_hits.empty() || !m_queue.empty(); });
+            if (m_stopping)
+                return;
+
+            // cached tiles are only colorized, they go ahead of renders
+            if (!m_hits.empty()) {
+                hit = std::move(m_hits.front());
+                m_hits.pop_front();
+            } else {
+                render = m_queue.begin()->second;
+                m_queue.erase(m_queue.begin());
+                render->rendering = true;
+            }
+        }
+
+        if (hit) {
+            respond({ hit->waiter }, hit->field.get(), {});
+            continue;
+        }
+
+        std::shared_ptr<EscapeField> field;
+        std::string error;
+        try {
+            field = std::make_shared<EscapeField>(m_options.tile_size, m_options.tile_size);
+            render->formula->render(tile_mapping(render->key.level, render->key.tx, render->key.ty), *field);
+        } catch (const std::exception& e) {
+            error = e.what();
+            LOG_WARN("Tile server: tile {}/{}/{} failed: {}", render->key.level, render->key.tx, render->key.ty, e.what());
+        }
+
+        std::vector<Waiter> waiters;
+        {
+            std::lock_guard lock(m_mutex);
+            if (error.empty()) {
+                m_cache.insert(render->key, field);
+                ++m_stats.rendered;
+            } else {
+                ++m_stats.failed;
+            }
+
+            waiters = std::move(render->waiters);
+            m_pending.erase(render->key);
+        }
+
+        respond(waiters, error.empty() ? field.get() : nullptr, error);
+    }
+}
+
+void TileServer::respond(const std::vector<Waiter>& waiters, const EscapeField* field, const std::string& error) {
+#if !defined(_WIN32)
+    // colorized once per palette
+    std::vector<std::pair<const TilePalette*, std::string>> encoded;
+
+    for (const Waiter& waiter : waiters) {
+        if (!waiter.connection->open)
+            continue;
+
+        std::string message;
+        if (!field) {
+            message = error_message(waiter.id, error);
+        } else {
+            auto it = std::find_if(encoded.begin(), encoded.end(), [&](const auto& entry) { return entry.first == waiter.palette; });
+            if (it == encoded.end()) {
+                encoded.emplace_back(waiter.palette, tile_pixels(*field, *waiter.palette));
+                it = encoded.end() - 1;
+            }
+
+            message = tile_header(waiter.id, *field) + it->second;
+        }
+
+        send(*waiter.connection, message);
+    }
+#else
+    (void)waiters;
+    (void)field;
+    (void)error;
+#endif
+}
+
+void TileServer::send(Connection& connection, const std::string& message) {
+#if !defined(_WIN32)
+    bool wake_io = false;
+    bool overflowed = false;
+    {
+        std::lock_guard lock(connection.write_mutex);
+        if (!connection.open)
+            return;
+
+        const bool idle = connection.output.empty();
+        connection.output += message;
+
+        if (!send_some(connection.fd, connection.output)) {
+            connection.open = false;
+            wake_io = true;
+        } else if (connection.output.size() > m_options.output_limit) {
+            // a client this far behind on reading is dropped rather than buffered for
+            connection.open = false;
+            wake_io = overflowed = true;
+        } else {
+            // the io thread only polls for writability while output is left
+            wake_io = idle && !connection.output.empty();
+        }
+    }
+
+    if (overflowed) {
+        std::lock_guard lock(m_mutex);
+        ++m_stats.overflowed;
+    }
+    if (wake_io)
+        wake();
+#else
+    (void)connection;
+    (void)message;
+#endif
+}
+
+void TileServer::wake() {
+#if !defined(_WIN32)
+    // a full pipe already holds a wake-up
+    const char byte = 0;
+    [[maybe_unused]] const ssize_t written = ::write(m_wake_fds[1], &byte, 1);
+#endif
+}
+
+// client
+
+TileClient::TileClient(const std::string& socket_path) {
+#if defined(_WIN32)
+    (void)socket_path;
+    throw std::runtime_error("TileClient requires a POSIX system");
+#else
+    const sockaddr_un address = socket_address(socket_path);
+
+    m_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_fd < 0)
+        throw std::runtime_error("Tile client: failed to create a socket");
+
+    if (::connect(m_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        const std::string reason = std::strerror(errno);
+        ::close(m_fd);
+        throw std::runtime_error(std::format("Tile client: can't connect to {}: {}", socket_path, reason));
+    }
+#endif
+}
+
+TileClient::~TileClient() {
+#if !defined(_WIN32)
+    if (m_fd >= 0)
+        ::close(m_fd);
+#endif
+}
+
+void TileClient::send(const TileRequest& request) {
+#if !defined(_WIN32)
+    const std::string line = std::format("{} {} {} {} {} {} {}\n",
+        request.id, request.prefetch ? "prefetch" : "visible", request.formula, request.palette,
+        request.level, request.tx, request.ty);
+
+    if (!send_all(m_fd, line.data(), line.size()))
+        throw std::runtime_error("Tile client: server closed the connection");
+#else
+    (void)request;
+#endif
+}
+
+void TileClient::receive_more() {
+#if !defined(_WIN32)
+    char buffer[1 << 16];
+    while (true) {
+        const ssize_t received = ::recv(m_fd, buffer, sizeof(buffer), 0);
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received <= 0)
+            throw std::runtime_error("Tile client: server closed the connection");
+
+        m_input.append(buffer, static_cast<size_t>(received));
+        return;
+    }
+#endif
+}
+
+std::string TileClient::read_line() {
+    size_t newline;
+    while ((newline = m_input.find('\n')) == std::string::npos)
+        receive_more();
+
+    std::string line = m_input.substr(0, newline);
+    m_input.erase(0, newline + 1);
+    return line;
+}
+
+std::string TileClient::read_bytes(size_t size) {
+    while (m_input.size() < size)
+        receive_more();
+
+    std::string bytes = m_input.substr(0, size);
+    m_input.erase(0, size);
+    return bytes;
+}
+
+TileResponse TileClient::receive() {
+    std::istringstream header(read_line());
+
+    TileResponse response;
+    std::string status;
+    if (!(header >> response.id >> status))
+        throw std::runtime_error("Tile client: malformed response");
+
+    if (status == "ERR") {
+        std::getline(header >> std::ws, response.error);
+        if (response.error.empty())
+            response.error = "unknown error";
+        return response;
+    }
+
+    if (status != "OK" || !(header >> response.width >> response.height) || response.width <= 0 || response.height <= 0)
+        throw std::runtime_error("Tile client: malformed response");
+
+    const std::string bytes = read_bytes(static_cast<size_t>(response.width) * response.height * 3);
+
+    response.pixels.resize(static_cast<size_t>(response.width) * response.height);
+    for (size_t i = 0; i < response.pixels.size(); ++i) {
+        response.pixels[i] = {
+            static_cast<uint8_t>(bytes[3 * i]),
+            static_cast<uint8_t>(bytes[3 * i + 1]),
+            static_cast<uint8_t>(bytes[3 * i + 2])
+        };
+    }
+    return response;
+}
@@ -0,0 +1,273 @@
+#include "fractal/tile_store.hpp"
+
+#include <bit>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace iheay::fractal;
+
+// local static helpers
+
+static constexpr char TILE_MAGIC[8] = { 'I', 'H', 'T', 'I', 'L', 'E', '\0', '\0' };
+static constexpr uint32_t TILE_VERSION = 1;
+
+// native byte order, the store is not meant to move between machines
+struct TileFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t tile_size;
+    uint64_t formula;
+    int64_t tx;
+    int64_t ty;
+    int32_t level;
+    int32_t max_iter;
+    double escape_radius;
+};
+
+static TileFileHeader make_header(const TileKey& key, int tile_size) {
+    TileFileHeader header {};
+    std::memcpy(header.magic, TILE_MAGIC, sizeof(TILE_MAGIC));
+    header.version = TILE_VERSION;
+    header.tile_size = static_cast<uint32_t>(tile_size);
+    header.formula = key.formula;
+    header.tx = key.tx;
+    header.ty = key.ty;
+    header.level = key.level;
+    header.max_iter = key.max_iter;
+    header.escape_radius = key.escape_radius;
+    return header;
+}
+
+static bool same_header(const TileFileHeader& a, const TileFileHeader& b) {
+    return std::memcmp(a.magic, b.magic, sizeof(a.magic)) == 0 &&
+        a.version == b.version && a.tile_size == b.tile_size &&
+        a.formula == b.formula && a.tx == b.tx && a.ty == b.ty &&
+        a.level == b.level && a.max_iter == b.max_iter && a.escape_radius == b.escape_radius;
+}
+
+static size_t tile_file_size(int tile_size) {
+    return sizeof(TileFileHeader) + static_cast<size_t>(tile_size) * tile_size * sizeof(float);
+}
+
+#if !defined(_WIN32)
+
+// whole file mapped read-only, nullptr when it can't be opened
+static void* map_file(const std::filesystem::path& path, size_t& length) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat info {};
+    void* base = nullptr;
+
+    if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+        length = static_cast<size_t>(info.st_size);
+        base = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED)
+            base = nullptr;
+    }
+
+    // the mapping keeps the file alive on its own
+    ::close(fd);
+    return base;
+}
+
+static void unmap_file(void* base, size_t length) {
+    ::munmap(base, length);
+}
+
+static void write_all(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t written = ::write(fd, bytes, size);
+        if (written < 0)
+            throw std::runtime_error("Failed to write a tile file");
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+static void fsync_directory(const std::filesystem::path& directory) {
+    const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+    ::fsync(fd);
+    ::close(fd);
+}
+
+// temporary + fsync + rename, so the final path only ever holds a complete file
+static void write_file_atomically(const std::filesystem::path& path, const void* header, size_t header_size, const void* payload, size_t payload_size) {
+    static std::atomic<unsigned long> counter = 0;
+
+    std::filesystem::path temporary = path;
+    temporary += std::format(".{}.{}.tmp", ::getpid(), counter++);
+
+    const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw std::runtime_error("Failed to create a tile file: " + temporary.string());
+
+    try {
+        write_all(fd, header, header_size);
+        write_all(fd, payload, payload_size);
+        if (::fsync(fd) != 0)
+            throw std::runtime_error("Failed to flush a tile file");
+    } catch (...) {
+        ::close(fd);
+        ::unlink(temporary.c_str());
+        throw;
+    }
+
+    ::close(fd);
+
+    if (::rename(temporary.c_str(), path.c_str()) != 0) {
+        ::unlink(temporary.c_str());
+        throw std::runtime_error("Failed to publish a tile file: " + path.string());
+    }
+
+    fsync_directory(path.parent_path());
+}
+
+#else
+
+static void* map_file(const std::filesystem::path&, size_t&) { return nullptr; }
+
+static void unmap_file(void*, size_t) {}
+
+static void write_file_atomically(const std::filesystem::path&, const void*, size_t, const void*, size_t) {
+    throw std::runtime_error("TileStore requires a POSIX system");
+}
+
+#endif
+
+// mapped tile
+
+MappedTile::MappedTile(void* base, size_t length, const float* mu, int size, int max_iter)
+: m_base(base)
+, m_length(length)
+, m_mu(mu)
+, m_size(size)
+, m_max_iter(max_iter) {}
+
+MappedTile::MappedTile(MappedTile&& other) noexcept
+: m_base(std::exchange(other.m_base, nullptr))
+, m_length(std::exchange(other.m_length, 0))
+, m_mu(std::exchange(other.m_mu, nullptr))
+, m_size(std::exchange(other.m_size, 0))
+, m_max_iter(other.m_max_iter) {}
+
+MappedTile& MappedTile::operator=(MappedTile&& other) noexcept {
+    if (this != &other) {
+        if (m_base)
+            unmap_file(m_base, m_length);
+
+        m_base = std::exchange(other.m_base, nullptr);
+        m_length = std::exchange(other.m_length, 0);
+        m_mu = std::exchange(other.m_mu, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_max_iter = other.m_max_iter;
+    }
+    return *this;
+}
+
+MappedTile::~MappedTile() {
+    if (m_base)
+        unmap_file(m_base, m_length);
+}
+
+EscapeField MappedTile::to_field() const {
+    EscapeField field(m_size, m_size);
+    field.set_max_iter(m_max_iter);
+
+    Escape escape {};
+    for (int y = 0; y < m_size; ++y) {
+        for (int x = 0; x < m_size; ++x) {
+            escape.mu = mu(x, y);
+            field.store(x, y, escape);
+        }
+    }
+    return field;
+}
+
+// store
+
+TileStore::TileStore(std::filesystem::path directory, int tile_size)
+: m_directory(std::move(directory))
+, m_tile_size(tile_size) {
+#if defined(_WIN32)
+    throw std::runtime_error("TileStore requires a POSIX system");
+#endif
+
+    if (tile_size <= 0)
+        throw std::runtime_error("Tile size must be positive");
+
+    std::filesystem::create_directories(m_directory);
+}
+
+std::filesystem::path TileStore::tile_path(const TileKey& key) const {
+    return m_directory / std::format("L{}", key.level) / std::format("{:016x}_{}_{:016x}_{}_{}.tile",
+        key.formula,
+        key.max_iter,
+        std::bit_cast<uint64_t>(key.escape_radius),
+        key.tx,
+        key.ty
+    );
+}
+
+std::optional<MappedTile> TileStore::find(const TileKey& key) const {
+    size_t length = 0;
+    void* base = map_file(tile_path(key), length);
+
+    if (!base) {
+        ++m_misses;
+        return std::nullopt;
+    }
+
+    MappedTile tile(base, length, nullptr, 0, key.max_iter);
+
+    TileFileHeader header {};
+    if (length != tile_file_size(m_tile_size)) {
+        ++m_misses;
+        return std::nullopt;
+    }
+
+    std::memcpy(&header, base, sizeof(header));
+    if (!same_header(header, make_header(key, m_tile_size))) {
+        ++m_misses;
+        return std::nullopt;
+    }
+
+    tile.m_mu = reinterpret_cast<const float*>(static_cast<const char*>(base) + sizeof(TileFileHeader));
+    tile.m_size = m_tile_size;
+
+    ++m_hits;
+    return tile;
+}
+
+void TileStore::insert(const TileKey& key, const EscapeField& tile) {
+    if (tile.width() != m_tile_size || tile.height() != m_tile_size)
+        throw std::runtime_error("Tile size does not match the store");
+
+    const TileFileHeader header = make_header(key, m_tile_size);
+
+    std::vector<float> mu(tile.mu_data().begin(), tile.mu_data().end());
+
+    const std::filesystem::path path = tile_path(key);
+    std::filesystem::create_directories(path.parent_path());
+
+    write_file_atomically(path, &header, sizeof(header), mu.data(), mu.size() * sizeof(float));
+    ++m_writes;
+}
+
+TileStore::Stats TileStore::stats() const {
+    return { m_hits.load(), m_misses.load(), m_writes.load() };
+}
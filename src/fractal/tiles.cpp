@@ -0,0 +1,53 @@
+#include "fractal/tiles.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace iheay::fractal;
+
+// local static helpers
+
+// spreads the low 16 bits of v to the even bit positions
+static uint32_t spread_bits(uint32_t v) {
+    v &= 0x0000ffff;
+    v = (v | (v << 8)) & 0x00ff00ff;
+    v = (v | (v << 4)) & 0x0f0f0f0f;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+static uint32_t morton_code(int tx, int ty) {
+    return spread_bits(static_cast<uint32_t>(tx)) | (spread_bits(static_cast<uint32_t>(ty)) << 1);
+}
+
+// tiling
+
+std::vector<Tile> iheay::fractal::morton_tiles(int width, int height, int tile_size) {
+    if (tile_size <= 0)
+        throw std::runtime_error("Tile size must be positive");
+
+    const int columns = (width + tile_size - 1) / tile_size;
+    const int rows = (height + tile_size - 1) / tile_size;
+
+    std::vector<Tile> tiles;
+    tiles.reserve(static_cast<size_t>(columns) * rows);
+
+    for (int ty = 0; ty < rows; ++ty) {
+        for (int tx = 0; tx < columns; ++tx) {
+            tiles.push_back({
+                tx * tile_size,
+                ty * tile_size,
+                std::min(width, (tx + 1) * tile_size),
+                std::min(height, (ty + 1) * tile_size)
+            });
+        }
+    }
+
+    std::sort(tiles.begin(), tiles.end(), [tile_size](const Tile& a, const Tile& b) {
+        return morton_code(a.x0 / tile_size, a.y0 / tile_size) < morton_code(b.x0 / tile_size, b.y0 / tile_size);
+    });
+
+    return tiles;
+}
@@ -0,0 +1,280 @@
+#include "fractal/zoom_video.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+
+using namespace iheay::fractal;
+using namespace iheay::math;
+
+// local static helpers
+
+// half the diagonal of a frame in pixels of its horizontal step
+static double half_diagonal_pixels(int frame_width, int frame_height) {
+    return (frame_width - 1) / 2.0 * std::hypot(1.0, static_cast<double>(frame_height) / frame_width);
+}
+
+// construction
+
+ZoomStrip::ZoomStrip(
+    Complex center,
+    double max_width,
+    double min_width,
+    int frame_width,
+    int frame_height,
+    double oversample,
+    int inner_radius,
+    RowFunc rows
+)
+: m_center(center)
+, m_frame_width(frame_width)
+, m_frame_height(frame_height)
+, m_inner_radius(std::min(inner_radius, std::min(frame_width, frame_height) / 8))
+, m_render_rows(std::move(rows)) {
+    if (!(min_width > 0) || max_width < min_width || frame_width < 2 || frame_height < 2 || !(oversample > 0) || inner_radius < 0)
+        throw std::runtime_error("Invalid zoom strip geometry");
+
+    if (!m_render_rows)
+        throw std::runtime_error("Zoom strip needs a row function");
+
+    const double half_diagonal = half_diagonal_pixels(frame_width, frame_height);
+
+    // the circumference at a frame corner in that frame's pixels
+    m_width = std::max(8, static_cast<int>(std::ceil(oversample * 2 * std::numbers::pi * half_diagonal)));
+    m_step = 2 * std::numbers::pi / m_width;
+
+    // from the corner of the widest frame to a quarter pixel, or inner_radius, of the narrowest one
+    const double top = max_width / (frame_width - 1) * half_diagonal;
+    const double bottom = min_width / (frame_width - 1) * innermost_pixels();
+
+    m_r_top = std::log(top) + m_step;
+    m_rows = static_cast<long>(std::ceil((m_r_top - std::log(bottom)) / m_step)) + 2;
+
+    // one frame spans a quarter pixel, or inner_radius, to its corner
+    m_capacity = std::min(m_rows, static_cast<long>(std::ceil(std::log(half_diagonal / innermost_pixels()) / m_step)) + 4);
+    m_block_columns = (m_width + BLOCK - 1) / BLOCK;
+    m_ring.assign(static_cast<size_t>((m_capacity + BLOCK - 1) / BLOCK) * m_block_columns * BLOCK * BLOCK, 0.0f);
+    m_ring_rows.assign(m_capacity, -1);
+
+    m_directions.reserve(m_width);
+    for (int j = 0; j < m_width; ++j)
+        m_directions.push_back(Complex::Algebraic(std::cos(j * m_step), std::sin(j * m_step)));
+}
+
+// geometry
+
+Complex ZoomStrip::point(int column, long row) const {
+    return m_center + radius(row) * m_directions[column];
+}
+
+double ZoomStrip::radius(long row) const {
+    return std::exp(m_r_top - row * m_step);
+}
+
+double ZoomStrip::innermost_pixels() const {
+    return m_inner_radius > 0 ? m_inner_radius : 0.25;
+}
+
+Tile ZoomStrip::inner_tile(const ViewportMapping& mapping) const {
+    if (m_inner_radius == 0)
+        return { 0, 0, 0, 0 };
+
+    // center() in pixel coordinates, the tile holds the pixels less than inner_radius from it across and down
+    const double x = (m_center.real() - mapping.real_min) / mapping.real_step;
+    const double y = (mapping.imag_max - m_center.imag()) / mapping.imag_step;
+    const double radius_y = m_inner_radius * mapping.real_step / mapping.imag_step;
+
+    const int x0 = std::clamp(static_cast<int>(std::floor(x - m_inner_radius)) + 1, 0, m_frame_width);
+    const int y0 = std::clamp(static_cast<int>(std::floor(y - radius_y)) + 1, 0, m_frame_height);
+    const int x1 = std::clamp(static_cast<int>(std::ceil(x + m_inner_radius)), x0, m_frame_width);
+    const int y1 = std::clamp(static_cast<int>(std::ceil(y + radius_y)), y0, m_frame_height);
+
+    return { x0, y0, x1, y1 };
+}
+
+// rows
+
+void ZoomStrip::ensure(long top, long bottom) {
+    if (bottom - top + 1 > m_capacity)
+        throw std::runtime_error("Frame does not fit the zoom strip window");
+
+    long row = top;
+    while (row <= bottom) {
+        if (m_ring_rows[row % m_capacity] == row) {
+            ++row;
+            continue;
+        }
+
+        // a run of missing rows
+        long last = row;
+        while (last + 1 <= bottom && m_ring_rows[(last + 1) % m_capacity] != last + 1)
+            ++last;
+
+        const int count = static_cast<int>(last - row + 1);
+        m_row_buffer.resize(static_cast<size_t>(count) * m_width);
+        m_render_rows(row, count, m_row_buffer.data());
+
+        for (long k = row; k <= last; ++k) {
+            const long slot = k % m_capacity;
+            const float* mu = m_row_buffer.data() + static_cast<size_t>(k - row) * m_width;
+
+            for (int column = 0; column < m_width; column += BLOCK)
+                std::copy_n(mu + column, std::min(BLOCK, m_width - column), m_ring.data() + row_cell(slot) + column_cell(column));
+
+            m_ring_rows[slot] = k;
+        }
+
+        m_iterated_rows += count;
+        row = last + 1;
+    }
+}
+
+// resampling
+
+double ZoomStrip::sample(double u, double v, const Window& window) const {
+    if (v < 0)
+        v += m_width;
+
+    const int j0 = static_cast<int>(v) < m_width ? static_cast<int>(v) : 0;
+    const int j1 = j0 + 1 < m_width ? j0 + 1 : 0;
+    const float fv = static_cast<float>(v - std::floor(v));
+
+    u = std::clamp(u, static_cast<double>(window.top), static_cast<double>(window.bottom));
+
+    const long k0 = static_cast<long>(u);
+    const float fu = static_cast<float>(u - k0);
+
+    const size_t upper = row_cell(slot(k0, window));
+    const size_t lower = row_cell(slot(std::min(k0 + 1, window.bottom), window));
+
+    const float mu = mix(m_ring[upper + column_cell(j0)], m_ring[upper + column_cell(j1)],
+                         m_ring[lower + column_cell(j0)], m_ring[lower + column_cell(j1)], fu, fv, window.interior);
+    return std::min(static_cast<double>(mu), window.interior);
+}
+
+float ZoomStrip::mix(float upper0, float upper1, float lower0, float lower1, float fu, float fv, double interior) {
+    if (std::max({ upper0, upper1, lower0, lower1 }) >= interior) {
+        // no blending across the set boundary
+        return fu < 0.5f ? (fv < 0.5f ? upper0 : upper1) : (fv < 0.5f ? lower0 : lower1);
+    }
+
+    return (upper0 * (1 - fv) + upper1 * fv) * (1 - fu)
+         + (lower0 * (1 - fv) + lower1 * fv) * fu;
+}
+
+Tile ZoomStrip::resample(const Viewport& viewport, int max_iter, EscapeField& field) {
+    if (field.width() != m_frame_width || field.height() != m_frame_height)
+        throw std::runtime_error("Field size does not match the zoom strip frames");
+
+    const FieldChannels channels = field.channels();
+    if (channels.final_z || channels.derivative || channels.distance)
+        throw std::runtime_error("Zoom strip frames only carry mu");
+
+    const ViewportMapping mapping = ViewportMapping::from(viewport, m_frame_width, m_frame_height);
+    const Complex offset = viewport.center - m_center;
+
+    const double step = std::min(mapping.real_step, mapping.imag_step);
+    const double farthest = std::hypot(offset.real(), offset.imag())
+        + std::hypot(mapping.real_step * (m_frame_width - 1), mapping.imag_step * (m_frame_height - 1)) / 2;
+
+    const long top = std::clamp(static_cast<long>(std::floor((m_r_top - std::log(farthest)) / m_step)), 0L, m_rows - 1);
+    const long bottom = std::clamp(static_cast<long>(std::ceil((m_r_top - std::log(step * innermost_pixels())) / m_step)) + 1, top, m_rows - 1);
+
+    ensure(top, bottom);
+    field.set_max_iter(max_iter);
+
+    const Window window { top, bottom, top % m_capacity, static_cast<double>(max_iter) };
+
+    const Tile inner = inner_tile(mapping);
+
+    // the pixels of row y outside the inner tile, through span(y, x0, x1) for [x0, x1)
+    auto outside_inner = [&](int y, auto span) {
+        if (y >= inner.y0 && y < inner.y1) {
+            span(y, 0, inner.x0);
+            span(y, inner.x1, m_frame_width);
+        } else {
+            span(y, 0, m_frame_width);
+        }
+    };
+
+    if (offset == Complex::Zero()) {
+        // centered frames differ only by scale, which shifts every pixel by the same number of rows
+        if (m_pixels.empty())
+            build_pixel_table();
+
+        const double scale_rows = (m_r_top - std::log(mapping.real_step)) / m_step;
+
+        auto resample_span = [&](int y, int x0, int x1) {
+            const FramePixel* pixels = m_pixels.data() + static_cast<size_t>(y) * m_frame_width;
+            for (int x = x0; x < x1; ++x) {
+                const FramePixel& pixel = pixels[x];
+
+                const double u = std::clamp(scale_rows + pixel.row, static_cast<double>(top), static_cast<double>(bottom));
+                const long k0 = static_cast<long>(u);
+
+                const size_t upper = row_cell(slot(k0, window));
+                const size_t lower = row_cell(slot(std::min(k0 + 1, bottom), window));
+
+                const float mu = mix(m_ring[upper + pixel.column0], m_ring[upper + pixel.column1],
+                                     m_ring[lower + pixel.column0], m_ring[lower + pixel.column1],
+                                     static_cast<float>(u - k0), pixel.column_weight, window.interior);
+                field.set_mu(x, y, std::min(static_cast<double>(mu), window.interior));
+            }
+        };
+
+        // raster order, the field is written front to back and the strip rows of neighbouring pixels are close
+        #pragma omp parallel for schedule(static)
+        for (int y = 0; y < m_frame_height; ++y)
+            outside_inner(y, resample_span);
+
+        return inner;
+    }
+
+    auto resample_span = [&](int y, int x0, int x1) {
+        for (int x = x0; x < x1; ++x) {
+            const Complex d = mapping.pixel(x, y) - m_center;
+            const double radius_sq = d.real() * d.real() + d.imag() * d.imag();
+
+            const double u = radius_sq > 0 ? (m_r_top - std::log(radius_sq) / 2) / m_step : static_cast<double>(bottom);
+            const double v = std::atan2(d.imag(), d.real()) / m_step;
+
+            field.set_mu(x, y, sample(u, v, window));
+        }
+    };
+
+    #pragma omp parallel for schedule(static)
+    for (int y = 0; y < m_frame_height; ++y)
+        outside_inner(y, resample_span);
+
+    return inner;
+}
+
+void ZoomStrip::build_pixel_table() {
+    // a frame of horizontal step 1, pixels as in ViewportMapping
+    const double aspect = static_cast<double>(m_frame_height) / m_frame_width * (m_frame_width - 1) / (m_frame_height - 1);
+
+    m_pixels.reserve(static_cast<size_t>(m_frame_width) * m_frame_height);
+
+    for (int y = 0; y < m_frame_height; ++y) {
+        for (int x = 0; x < m_frame_width; ++x) {
+            const double dx = x - (m_frame_width - 1) / 2.0;
+            const double dy = ((m_frame_height - 1) / 2.0 - y) * aspect;
+            const double radius_sq = dx * dx + dy * dy;
+
+            double v = std::atan2(dy, dx) / m_step;
+            if (v < 0)
+                v += m_width;
+
+            const int j0 = static_cast<int>(v) < m_width ? static_cast<int>(v) : 0;
+            const int j1 = j0 + 1 < m_width ? j0 + 1 : 0;
+
+            m_pixels.push_back({
+                radius_sq > 0 ? static_cast<float>(-std::log(radius_sq) / 2 / m_step) : INFINITY,
+                static_cast<float>(v - std::floor(v)),
+                static_cast<uint32_t>(column_cell(j0)),
+                static_cast<uint32_t>(column_cell(j1))
+            });
+        }
+    }
+}
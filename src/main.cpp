@@ -2,6 +2,8 @@
 #include "bmp/io/bmp_io.hpp"
 #include "fractal/fractal_renderer.hpp"
 #include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/incremental_renderer.hpp"
+#include "fractal/palettes.hpp"
 #include "math/complex.hpp"
 #include "math/vec3.hpp"
 #include "math/ray.hpp"
@@ -91,31 +93,34 @@ struct Colorizer {
         if (mu >= max_iter)
             return {0, 0, 0};
 
-        double t = mu / max_iter;
-
-        uint8_t r = static_cast<uint8_t>(9  * (1 - t) * t * t * t * 255);
-        uint8_t g = static_cast<uint8_t>(15 * (1 - t) * (1 - t) * t * t * 255);
-        uint8_t b = static_cast<uint8_t>(8.5 * (1 - t) * (1 - t) * (1 - t) * t * 255);
-
-        return {r, g, b, 255};
+        const BgrPixel pixel = palettes::fire(mu, max_iter);
+        return {pixel.r, pixel.g, pixel.b, 255};
     }
 };
 
-void render_scene2(Texture2D &texture, int width, int height) {
-    static auto renderer = 
+// the escape field survives between frames, resizes and drags only iterate new strips
+auto& fractal_view() {
+    static IncrementalRenderer view(
         FractalRendererBuilder<Colorizer>
             ::get_builder()
-                .set_viewport_width(3)
-                .set_viewport_center(-0.75)
-                .set_initial_func( [](auto&) { return Complex::Zero(); } )
-                .set_param_func( [](auto& pixel) { return pixel; } )
-                .build();
+                .set_initial_func( formulas::Zero{} )
+                .set_param_func( formulas::Identity{} )
+                .set_kernel( Kernel::Simd )
+                .set_cycle_detection( true )
+                .build(),
+        Viewport { 3, -0.75 }
+    );
+    return view;
+}
 
-    Image img = GenImageColor(width, height, BLACK);
+void show_fractal_view(Texture2D &texture) {
+    const EscapeField& field = fractal_view().field();
+
+    Image img = GenImageColor(field.width(), field.height(), BLACK);
 
     adapters::RaylibImageAdapter adapter(img);
-    
-    renderer.render(adapter);
+
+    fractal_view().render(adapter);
 
     UnloadTexture(texture);
     texture = LoadTextureFromImage(img);
@@ -132,14 +137,39 @@ int main() {
 
         Texture2D texture = {0};
 
-        render_scene2(texture, GetScreenWidth(), GetScreenHeight());
+        fractal_view().resize(GetScreenWidth(), GetScreenHeight());
+        show_fractal_view(texture);
+
+        // mouse drag in whole pixels, the remainder carries over to the next frame
+        double drag_x = 0;
+        double drag_y = 0;
 
         while (!WindowShouldClose()) {
             int w = GetScreenWidth();
             int h = GetScreenHeight();
 
             if (texture.width != w || texture.height != h) {
-                render_scene2(texture, w, h);
+                fractal_view().resize(w, h);
+                show_fractal_view(texture);
+            }
+
+            if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
+                Vector2 delta = GetMouseDelta();
+                drag_x += delta.x;
+                drag_y += delta.y;
+
+                int dx = static_cast<int>(drag_x);
+                int dy = static_cast<int>(drag_y);
+
+                if (dx != 0 || dy != 0) {
+                    // dragging the picture right reveals what lies to the left
+                    fractal_view().pan(-dx, -dy);
+                    show_fractal_view(texture);
+                    drag_x -= dx;
+                    drag_y -= dy;
+                }
+            } else {
+                drag_x = drag_y = 0;
             }
 
             BeginDrawing();
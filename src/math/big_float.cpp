@@ -0,0 +1,312 @@
+#include "math/big_float.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+using namespace iheay::math;
+
+using Limbs = std::vector<uint32_t>;
+
+// local static helpers
+
+static size_t limbs_for_bits(int precision_bits) {
+    if (precision_bits <= 0)
+        throw std::runtime_error("BigFloat precision must be positive");
+
+    // at least 64 bits, so to_double always sees a full double mantissa
+    return std::max<size_t>(2, (static_cast<size_t>(precision_bits) + 31) / 32);
+}
+
+static int64_t bit_length(const Limbs& v) noexcept {
+    for (size_t i = v.size(); i-- > 0;) {
+        if (v[i] != 0) {
+            int bits = 0;
+            for (uint32_t top = v[i]; top != 0; top >>= 1)
+                ++bits;
+            return static_cast<int64_t>(i) * 32 + bits;
+        }
+    }
+    return 0;
+}
+
+// (src << shift) truncated to out_limbs, negative shift drops low bits
+static Limbs shifted(const Limbs& src, int64_t shift, size_t out_limbs) {
+    Limbs out(out_limbs, 0);
+
+    const int64_t limb_shift = shift >= 0 ? shift / 32 : -((-shift + 31) / 32);
+    const int bit_shift = static_cast<int>(shift - limb_shift * 32); // in [0, 32)
+
+    for (size_t i = 0; i < src.size(); ++i) {
+        if (src[i] == 0)
+            continue;
+
+        const uint64_t wide = static_cast<uint64_t>(src[i]) << bit_shift;
+        const int64_t lo = static_cast<int64_t>(i) + limb_shift;
+
+        if (lo >= 0 && lo < static_cast<int64_t>(out_limbs))
+            out[lo] |= static_cast<uint32_t>(wide);
+        if (lo + 1 >= 0 && lo + 1 < static_cast<int64_t>(out_limbs))
+            out[lo + 1] |= static_cast<uint32_t>(wide >> 32);
+    }
+
+    return out;
+}
+
+static int compare_magnitudes(const Limbs& a, const Limbs& b) noexcept {
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i])
+            return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// a += b, both of the same size
+static void add_in_place(Limbs& a, const Limbs& b) noexcept {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        const uint64_t sum = static_cast<uint64_t>(a[i]) + b[i] + carry;
+        a[i] = static_cast<uint32_t>(sum);
+        carry = sum >> 32;
+    }
+}
+
+// a -= b, requires a >= b
+static void sub_in_place(Limbs& a, const Limbs& b) noexcept {
+    int64_t borrow = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        int64_t diff = static_cast<int64_t>(a[i]) - b[i] - borrow;
+        borrow = diff < 0 ? 1 : 0;
+        if (diff < 0)
+            diff += int64_t(1) << 32;
+        a[i] = static_cast<uint32_t>(diff);
+    }
+}
+
+static void mul_small(Limbs& a, uint32_t factor, uint32_t addend) {
+    uint64_t carry = addend;
+    for (uint32_t& limb : a) {
+        const uint64_t prod = static_cast<uint64_t>(limb) * factor + carry;
+        limb = static_cast<uint32_t>(prod);
+        carry = prod >> 32;
+    }
+    if (carry != 0)
+        a.push_back(static_cast<uint32_t>(carry));
+}
+
+static void div_small(Limbs& a, uint32_t divisor) noexcept {
+    uint64_t rem = 0;
+    for (size_t i = a.size(); i-- > 0;) {
+        const uint64_t cur = (rem << 32) | a[i];
+        a[i] = static_cast<uint32_t>(cur / divisor);
+        rem = cur % divisor;
+    }
+}
+
+// private normalizing constructor
+
+BigFloat::BigFloat(bool negative, Limbs magnitude, int64_t exponent, size_t limbs) {
+    const int64_t bits = bit_length(magnitude);
+
+    if (bits == 0) {
+        m_limbs.assign(limbs, 0);
+        return;
+    }
+
+    const int64_t shift = static_cast<int64_t>(limbs) * 32 - bits;
+
+    m_negative = negative;
+    m_limbs = shifted(magnitude, shift, limbs);
+    m_exponent = exponent - shift;
+}
+
+// public constructor and fabric
+
+BigFloat::BigFloat(double value, int precision_bits) {
+    const size_t limbs = limbs_for_bits(precision_bits);
+
+    if (!std::isfinite(value))
+        throw std::runtime_error("BigFloat can't hold inf or nan");
+
+    if (value == 0.0) {
+        m_limbs.assign(limbs, 0);
+        return;
+    }
+
+    int exp = 0;
+    const double frac = std::frexp(std::abs(value), &exp); // in [0.5, 1)
+    const auto mantissa = static_cast<uint64_t>(std::ldexp(frac, 64));
+
+    *this = BigFloat(
+        value < 0,
+        { static_cast<uint32_t>(mantissa), static_cast<uint32_t>(mantissa >> 32) },
+        static_cast<int64_t>(exp) - 64,
+        limbs
+    );
+}
+
+BigFloat BigFloat::from_string(std::string_view text, int precision_bits) {
+    const size_t limbs = limbs_for_bits(precision_bits);
+
+    size_t i = 0;
+    bool negative = false;
+
+    if (i < text.size() && (text[i] == '-' || text[i] == '+')) {
+        negative = text[i] == '-';
+        ++i;
+    }
+
+    Limbs digits_value { 0 };
+    int64_t digit_count = 0;
+    int64_t frac_digits = 0;
+    bool seen_point = false;
+    int64_t exp10 = 0;
+
+    for (; i < text.size(); ++i) {
+        const char ch = text[i];
+
+        if (ch >= '0' && ch <= '9') {
+            mul_small(digits_value, 10, static_cast<uint32_t>(ch - '0'));
+            ++digit_count;
+            if (seen_point)
+                ++frac_digits;
+        } else if (ch == '.' && !seen_point) {
+            seen_point = true;
+        } else if ((ch == 'e' || ch == 'E') && digit_count > 0) {
+            try {
+                size_t used = 0;
+                exp10 = std::stoll(std::string(text.substr(i + 1)), &used);
+                if (i + 1 + used != text.size())
+                    throw std::invalid_argument("trailing characters");
+            } catch (const std::exception&) {
+                throw std::runtime_error("Invalid number: " + std::string(text));
+            }
+            break;
+        } else {
+            throw std::runtime_error("Invalid number: " + std::string(text));
+        }
+    }
+
+    if (digit_count == 0)
+        throw std::runtime_error("Invalid number: " + std::string(text));
+
+    const int64_t dec_exp = exp10 - frac_digits;
+    if (std::abs(dec_exp) > 100'000)
+        throw std::runtime_error("Number exponent out of range: " + std::string(text));
+
+    if (dec_exp >= 0) {
+        for (int64_t k = 0; k < dec_exp; ++k)
+            mul_small(digits_value, 10, 0);
+        return BigFloat(negative, std::move(digits_value), 0, limbs);
+    }
+
+    // N / 10^k: make room for the quotient bits first (10^k < 2^(4k)), then divide
+    const int64_t k = -dec_exp;
+    const int64_t extra_bits = static_cast<int64_t>(limbs) * 32 + 4 * k + 32;
+    const size_t wide_limbs = digits_value.size() + static_cast<size_t>(extra_bits / 32) + 1;
+
+    Limbs wide = shifted(digits_value, extra_bits, wide_limbs);
+    for (int64_t j = 0; j < k; ++j)
+        div_small(wide, 10);
+
+    return BigFloat(negative, std::move(wide), -extra_bits, limbs);
+}
+
+// conversions
+
+double BigFloat::to_double() const noexcept {
+    if (is_zero())
+        return 0.0;
+
+    const size_t n = m_limbs.size();
+    const uint64_t top = (static_cast<uint64_t>(m_limbs[n - 1]) << 32) | m_limbs[n - 2];
+
+    // ldexp takes an int, exponents beyond its range are 0 or inf anyway
+    const int64_t exp = std::clamp<int64_t>(m_exponent + static_cast<int64_t>(n - 2) * 32, -100'000, 100'000);
+    const double value = std::ldexp(static_cast<double>(top), static_cast<int>(exp));
+
+    return m_negative ? -value : value;
+}
+
+BigFloat BigFloat::with_precision(int precision_bits) const {
+    return BigFloat(m_negative, m_limbs, m_exponent, limbs_for_bits(precision_bits));
+}
+
+// arithmetic
+
+BigFloat BigFloat::operator-() const {
+    BigFloat res = *this;
+    if (!res.is_zero())
+        res.m_negative = !res.m_negative;
+    return res;
+}
+
+BigFloat BigFloat::operator+(const BigFloat& o) const {
+    return add(*this, o, false);
+}
+
+BigFloat BigFloat::operator-(const BigFloat& o) const {
+    return add(*this, o, true);
+}
+
+BigFloat BigFloat::add(const BigFloat& a, const BigFloat& b, bool negate_b) {
+    const size_t limbs = std::max(a.m_limbs.size(), b.m_limbs.size());
+    const bool b_negative = negate_b ? !b.m_negative : b.m_negative;
+
+    if (b.is_zero())
+        return BigFloat(a.m_negative, a.m_limbs, a.m_exponent, limbs);
+    if (a.is_zero())
+        return BigFloat(b_negative, b.m_limbs, b.m_exponent, limbs);
+
+    // common exponent keeps two guard limbs below the larger operand
+    const size_t work = limbs + 2;
+    const int64_t top_a = a.m_exponent + static_cast<int64_t>(a.m_limbs.size()) * 32;
+    const int64_t top_b = b.m_exponent + static_cast<int64_t>(b.m_limbs.size()) * 32;
+    const int64_t exponent = std::max(top_a, top_b) - static_cast<int64_t>(work) * 32;
+
+    // one extra limb for the carry
+    Limbs ma = shifted(a.m_limbs, a.m_exponent - exponent, work + 1);
+    Limbs mb = shifted(b.m_limbs, b.m_exponent - exponent, work + 1);
+
+    if (a.m_negative == b_negative) {
+        add_in_place(ma, mb);
+        return BigFloat(a.m_negative, std::move(ma), exponent, limbs);
+    }
+
+    if (compare_magnitudes(ma, mb) >= 0) {
+        sub_in_place(ma, mb);
+        return BigFloat(a.m_negative, std::move(ma), exponent, limbs);
+    }
+
+    sub_in_place(mb, ma);
+    return BigFloat(b_negative, std::move(mb), exponent, limbs);
+}
+
+BigFloat BigFloat::operator*(const BigFloat& o) const {
+    const size_t limbs = std::max(m_limbs.size(), o.m_limbs.size());
+
+    if (is_zero() || o.is_zero())
+        return BigFloat(false, { 0 }, 0, limbs);
+
+    Limbs prod(m_limbs.size() + o.m_limbs.size(), 0);
+
+    for (size_t i = 0; i < m_limbs.size(); ++i) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < o.m_limbs.size(); ++j) {
+            const uint64_t cur = static_cast<uint64_t>(m_limbs[i]) * o.m_limbs[j] + prod[i + j] + carry;
+            prod[i + j] = static_cast<uint32_t>(cur);
+            carry = cur >> 32;
+        }
+        prod[i + o.m_limbs.size()] = static_cast<uint32_t>(carry);
+    }
+
+    return BigFloat(m_negative != o.m_negative, std::move(prod), m_exponent + o.m_exponent, limbs);
+}
+
+BigFloat BigFloat::mul_pow2(int power) const {
+    BigFloat res = *this;
+    if (!res.is_zero())
+        res.m_exponent += power;
+    return res;
+}
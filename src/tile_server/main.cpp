@@ -0,0 +1,94 @@
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/palettes.hpp"
+#include "fractal/tile_server.hpp"
+#include "utils/logger.hpp"
+#include <charconv>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+
+#if !defined(_WIN32)
+    #include <pthread.h>
+#endif
+
+using namespace iheay;
+using namespace iheay::bmp;
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+// local tile server for map-style viewers: iheay_tile_server SOCKET_PATH [--workers N] [--tile-size N]
+// serves mandelbrot and julia tiles in the fire and gray palettes until SIGINT / SIGTERM,
+// see fractal/tile_server.hpp for the protocol
+
+struct MuColorizer {
+    using pixel_type = double;
+
+    double operator()(double mu, int max_iter) const { return std::min(mu, static_cast<double>(max_iter)); }
+};
+
+static bool parse_int(const char* text, int& out) {
+    const auto [end, error] = std::from_chars(text, text + std::strlen(text), out);
+    return error == std::errc{} && *end == '\0' && out > 0;
+}
+
+int main(int argc, char** argv) {
+#if defined(_WIN32)
+    (void)argc;
+    (void)argv;
+    std::cerr << "iheay_tile_server requires a POSIX system\n";
+    return 1;
+#else
+    TileServerOptions options;
+    std::string socket_path;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--workers") == 0 && has_value && parse_int(argv[i + 1], options.workers)) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--tile-size") == 0 && has_value && parse_int(argv[i + 1], options.tile_size)) {
+            ++i;
+        } else if (argv[i][0] != '-' && socket_path.empty()) {
+            socket_path = argv[i];
+        } else {
+            socket_path.clear();
+            break;
+        }
+    }
+
+    if (socket_path.empty()) {
+        std::cerr << "usage: iheay_tile_server SOCKET_PATH [--workers N] [--tile-size N]\n";
+        return 2;
+    }
+
+    auto builder = FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_max_iter(1000)
+            .set_kernel(Kernel::Simd)
+            .set_cycle_detection(true);
+
+    // every thread started from here on inherits the blocked signals, sigwait below collects them
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    try {
+        TileServer server(socket_path, options);
+        server.add_formula("mandelbrot", builder.set_initial_func(formulas::Zero {}).set_param_func(formulas::Identity {}).build());
+        server.add_formula("julia", builder.set_param_func(formulas::Constant { Complex::Algebraic(-0.8, 0.156) }).build());
+        server.add_palette("fire", palettes::fire);
+        server.add_palette("gray", palettes::gray);
+        server.start();
+
+        int signal = 0;
+        sigwait(&signals, &signal);
+        LOG_INFO("Tile server: got signal {}, stopping", signal);
+        server.stop();
+    } catch (const std::exception& e) {
+        LOG_ERROR("{}", e.what());
+        return 1;
+    }
+    return 0;
+#endif
+}
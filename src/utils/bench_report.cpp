@@ -0,0 +1,125 @@
+#include "utils/bench_report.hpp"
+
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace iheay::utils;
+
+// local static helpers
+
+[[noreturn]] static void fail(int line, const std::string& message) {
+    throw std::runtime_error(std::format("Bench report: line {}: {}", line, message));
+}
+
+static std::vector<std::string> split_tabs(const std::string& text) {
+    std::vector<std::string> fields;
+    size_t begin = 0;
+    while (true) {
+        const size_t end = text.find('\t', begin);
+        fields.push_back(text.substr(begin, end - begin));
+        if (end == std::string::npos)
+            return fields;
+        begin = end + 1;
+    }
+}
+
+template <typename T>
+static T parse_number(const std::string& value, int line, const char* column) {
+    T out {};
+    const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), out);
+    if (error != std::errc{} || end != value.data() + value.size())
+        fail(line, std::format("{}: '{}' is not a number", column, value));
+    return out;
+}
+
+static const char* const COLUMNS[] = {
+    "scene", "width", "height", "threads", "seconds",
+    "mpixels_per_s", "giterations_per_s", "efficiency", "peak_rss_kb"
+};
+
+static const size_t COLUMN_COUNT = std::size(COLUMNS);
+
+// ---------------- results ----------------
+
+std::string BenchResult::key() const {
+    return std::format("{} {}x{} {}t", scene, width, height, threads);
+}
+
+void iheay::utils::write_results(std::ostream& out, const std::vector<BenchResult>& results) {
+    out << '#';
+    for (size_t i = 0; i < COLUMN_COUNT; ++i)
+        out << (i == 0 ? " " : "\t") << COLUMNS[i];
+    out << '\n';
+
+    for (const BenchResult& r : results) {
+        out << std::format("{}\t{}\t{}\t{}\t{:.6f}\t{:.4f}\t{:.4f}\t{:.3f}\t{}\n",
+            r.scene, r.width, r.height, r.threads, r.seconds,
+            r.mpixels_per_second, r.giterations_per_second, r.efficiency, r.peak_rss_kb);
+    }
+}
+
+std::vector<BenchResult> iheay::utils::read_results(std::istream& in) {
+    std::vector<BenchResult> results;
+
+    std::string text;
+    for (int line = 1; std::getline(in, text); ++line) {
+        if (!text.empty() && text.back() == '\r')
+            text.pop_back();
+        if (text.empty() || text[0] == '#')
+            continue;
+
+        const std::vector<std::string> fields = split_tabs(text);
+        if (fields.size() != COLUMN_COUNT)
+            fail(line, std::format("expected {} tab-separated columns, got {}", COLUMN_COUNT, fields.size()));
+        if (fields[0].empty())
+            fail(line, "empty scene name");
+
+        BenchResult r;
+        r.scene = fields[0];
+        r.width = parse_number<int>(fields[1], line, COLUMNS[1]);
+        r.height = parse_number<int>(fields[2], line, COLUMNS[2]);
+        r.threads = parse_number<int>(fields[3], line, COLUMNS[3]);
+        r.seconds = parse_number<double>(fields[4], line, COLUMNS[4]);
+        r.mpixels_per_second = parse_number<double>(fields[5], line, COLUMNS[5]);
+        r.giterations_per_second = parse_number<double>(fields[6], line, COLUMNS[6]);
+        r.efficiency = parse_number<double>(fields[7], line, COLUMNS[7]);
+        r.peak_rss_kb = parse_number<long>(fields[8], line, COLUMNS[8]);
+        results.push_back(std::move(r));
+    }
+
+    return results;
+}
+
+std::vector<BenchResult> iheay::utils::load_results(const std::string& path) {
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error(std::format("Bench report: can't open {}", path));
+    return read_results(file);
+}
+
+// ---------------- comparison ----------------
+
+BenchComparison iheay::utils::compare_results(const std::vector<BenchResult>& baseline, const std::vector<BenchResult>& current, double threshold) {
+    std::unordered_map<std::string, const BenchResult*> by_key;
+    for (const BenchResult& r : baseline)
+        by_key[r.key()] = &r;
+
+    BenchComparison comparison;
+    for (const BenchResult& r : current) {
+        const auto it = by_key.find(r.key());
+        if (it == by_key.end() || it->second->mpixels_per_second <= 0.0)
+            continue;
+
+        ++comparison.compared;
+
+        const double slowdown = 1.0 - r.mpixels_per_second / it->second->mpixels_per_second;
+        if (slowdown > threshold)
+            comparison.regressions.push_back({ *it->second, r, slowdown });
+    }
+
+    return comparison;
+}
@@ -0,0 +1,146 @@
+#include "utils/thread_pool.hpp"
+#include "utils/trace.hpp"
+
+#include <algorithm>
+#include <format>
+#include <omp.h>
+
+using namespace iheay::utils;
+
+// construction
+
+WorkStealingPool::WorkStealingPool(int threads) {
+    if (threads <= 0)
+        threads = omp_get_max_threads();
+
+    for (int i = 0; i < threads; ++i)
+        m_queues.push_back(std::make_unique<Queue>());
+
+    // worker 0 is whoever calls run()
+    for (int i = 1; i < threads; ++i)
+        m_threads.emplace_back([this, i] { worker_loop(i); });
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& thread : m_threads)
+        thread.join();
+}
+
+WorkStealingPool& WorkStealingPool::shared() {
+    static WorkStealingPool pool;
+    return pool;
+}
+
+// running
+
+void WorkStealingPool::run(int count, const std::function<void(int task, int worker)>& task) {
+    if (count <= 0)
+        return;
+
+    std::lock_guard run_lock(m_run_mutex);
+
+    const int workers = thread_count();
+    const int block = (count + workers - 1) / workers;
+
+    for (int w = 0; w < workers; ++w) {
+        std::lock_guard lock(m_queues[w]->mutex);
+        for (int i = w * block; i < std::min(count, (w + 1) * block); ++i)
+            m_queues[w]->tasks.push_back(i);
+    }
+
+    m_steals = 0;
+    m_error = nullptr;
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_task = &task;
+        m_busy = workers - 1;
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    drain(0);
+
+    std::unique_lock lock(m_mutex);
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_task = nullptr;
+
+    if (m_error)
+        std::rethrow_exception(m_error);
+}
+
+void WorkStealingPool::worker_loop(int worker) {
+    TRACE_THREAD_NAME(std::format("pool worker {}", worker));
+
+    unsigned long seen = 0;
+
+    while (true) {
+        {
+            std::unique_lock lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop)
+                return;
+            seen = m_generation;
+        }
+
+        drain(worker);
+
+        {
+            std::lock_guard lock(m_mutex);
+            --m_busy;
+        }
+        m_done.notify_one();
+    }
+}
+
+// runs tasks until neither the own deque nor any other has work left
+void WorkStealingPool::drain(int worker) {
+    int task = 0;
+
+    while (pop_own(worker, task) || steal(worker, task)) {
+        try {
+            (*m_task)(task, worker);
+        } catch (...) {
+            std::lock_guard lock(m_mutex);
+            if (!m_error)
+                m_error = std::current_exception();
+        }
+    }
+}
+
+bool WorkStealingPool::pop_own(int worker, int& task) {
+    Queue& queue = *m_queues[worker];
+    std::lock_guard lock(queue.mutex);
+
+    if (queue.tasks.empty())
+        return false;
+
+    task = queue.tasks.front();
+    queue.tasks.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::steal(int worker, int& task) {
+    const int workers = thread_count();
+
+    for (int offset = 1; offset < workers; ++offset) {
+        Queue& victim = *m_queues[(worker + offset) % workers];
+        std::lock_guard lock(victim.mutex);
+
+        if (victim.tasks.empty())
+            continue;
+
+        task = victim.tasks.back();
+        victim.tasks.pop_back();
+        ++m_steals;
+        return true;
+    }
+
+    return false;
+}
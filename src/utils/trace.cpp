@@ -0,0 +1,213 @@
+#include "utils/trace.hpp"
+#include "utils/logger.hpp"
+
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#if defined(_WIN32)
+    #include <process.h>
+#else
+    #include <unistd.h>
+#endif
+
+using namespace iheay::utils;
+
+// local static helpers
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    int64_t start;
+    int64_t end;
+    TraceArg first;
+    TraceArg second;
+};
+
+const size_t CHUNK_EVENTS = 1024;
+
+// a full chunk is never written again, its successor is published through next
+struct Chunk {
+    TraceEvent events[CHUNK_EVENTS];
+    std::atomic<size_t> size = 0;
+    std::atomic<Chunk*> next = nullptr;
+};
+
+// the owning thread appends to tail and touches nothing else; head, skipped and name belong
+// to the registry mutex, so readers and clear() never meet the writer on the same fields
+struct Buffer {
+    int tid;
+    Chunk* tail;
+    Chunk* head;
+    size_t skipped = 0; // events of head dropped by clear()
+    std::string name;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Buffer>> buffers;
+};
+
+} // namespace
+
+// never destroyed, threads still recording at exit don't outlive their buffers
+static Registry& registry() {
+    static Registry* instance = new Registry;
+    return *instance;
+}
+
+// the calling thread's buffer, created by its first event
+static thread_local Buffer* t_buffer = nullptr;
+
+// kept per thread until the buffer exists, naming a thread costs nothing while it records nothing
+static thread_local std::string t_name;
+
+static Buffer& local_buffer() {
+    if (!t_buffer) {
+        auto created = std::make_unique<Buffer>();
+        created->tail = created->head = new Chunk;
+        created->name = t_name;
+
+        Registry& reg = registry();
+        std::lock_guard lock(reg.mutex);
+        created->tid = static_cast<int>(reg.buffers.size()) + 1;
+        reg.buffers.push_back(std::move(created));
+        t_buffer = reg.buffers.back().get();
+    }
+    return *t_buffer;
+}
+
+// calls visit(event) for every event of the buffer, under the registry mutex
+template <typename Visit>
+static void for_each_event(const Buffer& buffer, Visit visit) {
+    size_t first = buffer.skipped;
+    for (const Chunk* chunk = buffer.head; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+        const size_t size = chunk->size.load(std::memory_order_acquire);
+        for (size_t i = first; i < size; ++i)
+            visit(chunk->events[i]);
+        first = 0;
+    }
+}
+
+static std::string json_string(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        if (static_cast<unsigned char>(c) < 0x20)
+            out += std::format("\\u{:04x}", static_cast<int>(c));
+        else
+            out += c;
+    }
+    return out + '"';
+}
+
+static std::string json_args(const TraceEvent& event) {
+    std::string out;
+    for (const TraceArg* arg : { &event.first, &event.second }) {
+        if (arg->name)
+            out += std::format("{}{}:{}", out.empty() ? "" : ",", json_string(arg->name), arg->value);
+    }
+    return out;
+}
+
+// ---------------- Trace ----------------
+
+void Trace::set_thread_name(const std::string& name) {
+    t_name = name;
+
+    if (t_buffer) {
+        std::lock_guard lock(registry().mutex);
+        t_buffer->name = name;
+    }
+}
+
+void Trace::record(const char* name, int64_t start, int64_t end, const TraceArg& first, const TraceArg& second) {
+    Buffer& buffer = local_buffer();
+    Chunk* chunk = buffer.tail;
+    size_t size = chunk->size.load(std::memory_order_relaxed);
+
+    if (size == CHUNK_EVENTS) {
+        Chunk* next = new Chunk;
+        chunk->next.store(next, std::memory_order_release);
+        buffer.tail = chunk = next;
+        size = 0;
+    }
+
+    chunk->events[size] = TraceEvent { name, start, end, first, second };
+    chunk->size.store(size + 1, std::memory_order_release);
+}
+
+size_t Trace::event_count() {
+    Registry& reg = registry();
+    std::lock_guard lock(reg.mutex);
+
+    size_t count = 0;
+    for (const auto& buffer : reg.buffers)
+        for_each_event(*buffer, [&](const TraceEvent&) { ++count; });
+    return count;
+}
+
+void Trace::clear() {
+    Registry& reg = registry();
+    std::lock_guard lock(reg.mutex);
+
+    // every chunk but the tail is full and left alone by its writer
+    for (const auto& buffer : reg.buffers) {
+        Chunk* chunk = buffer->head;
+        while (Chunk* next = chunk->next.load(std::memory_order_acquire)) {
+            delete chunk;
+            chunk = next;
+        }
+        buffer->head = chunk;
+        buffer->skipped = chunk->size.load(std::memory_order_acquire);
+    }
+}
+
+void Trace::write_json(std::ostream& out) {
+#if defined(_WIN32)
+    const int pid = ::_getpid();
+#else
+    const int pid = static_cast<int>(::getpid());
+#endif
+
+    Registry& reg = registry();
+    std::lock_guard lock(reg.mutex);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    const char* separator = "\n";
+
+    for (const auto& buffer : reg.buffers) {
+        // threads get their name with their first event, idle ones stay out of the timeline
+        bool named = buffer->name.empty();
+
+        for_each_event(*buffer, [&](const TraceEvent& event) {
+            if (!named) {
+                out << separator << std::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":{},\"tid\":{},\"args\":{{\"name\":{}}}}}",
+                    pid, buffer->tid, json_string(buffer->name));
+                separator = ",\n";
+                named = true;
+            }
+
+            out << separator << std::format("{{\"name\":{},\"ph\":\"X\",\"pid\":{},\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f},\"args\":{{{}}}}}",
+                json_string(event.name), pid, buffer->tid, event.start / 1e3, (event.end - event.start) / 1e3, json_args(event));
+            separator = ",\n";
+        });
+    }
+
+    out << "\n]}\n";
+}
+
+void Trace::save(const std::string& path) {
+    std::ofstream file(path);
+    if (!file) throw std::runtime_error("Cannot create trace file: " + path);
+
+    write_json(file);
+    if (!file) throw std::runtime_error("Failed writing trace file: " + path);
+
+    LOG_INFO("Saved trace: {}", path);
+}
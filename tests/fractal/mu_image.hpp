@@ -0,0 +1,76 @@
+#pragma once // tests/fractal/mu_image.hpp
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <concepts>
+#include <vector>
+
+#include "fractal/escape_field.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+
+// image storing raw mu values, so renders can be compared exactly
+
+struct MuColorizer {
+    using pixel_type = double;
+
+    double operator()(double mu, int) const { return mu; }
+};
+
+class MuImage {
+public:
+    using pixel_type = double;
+
+    MuImage(int width, int height) : m_width(width), m_height(height), m_mu(width * height, -1.0) {}
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+    void set_pixel(int x, int y, double mu) { m_mu[y * m_width + x] = mu; }
+    double get_pixel(int x, int y) const { return m_mu[y * m_width + x]; }
+
+private:
+    int m_width;
+    int m_height;
+    std::vector<double> m_mu;
+};
+
+inline void expect_same_images(const MuImage& a, const MuImage& b) {
+    ASSERT_EQ(a.width(), b.width());
+    ASSERT_EQ(a.height(), b.height());
+
+    for (int y = 0; y < a.height(); ++y)
+        for (int x = 0; x < a.width(); ++x)
+            ASSERT_EQ(a.get_pixel(x, y), b.get_pixel(x, y)) << "at (" << x << ", " << y << ")";
+}
+
+// share of pixels whose mu differs by more than tolerance, between two MuImages or two EscapeFields
+template <typename Image>
+double mismatch_share(const Image& a, const Image& b, double tolerance = 0.0) {
+    auto mu = [](const Image& image, int x, int y) {
+        if constexpr (std::same_as<Image, MuImage>)
+            return image.get_pixel(x, y);
+        else
+            return image.mu(x, y);
+    };
+
+    int mismatches = 0;
+    for (int y = 0; y < a.height(); ++y)
+        for (int x = 0; x < a.width(); ++x)
+            if (std::abs(mu(a, x, y) - mu(b, x, y)) > tolerance)
+                ++mismatches;
+
+    return static_cast<double>(mismatches) / (a.width() * a.height());
+}
+
+// the Mandelbrot set rendered into mu images, the whole set by default
+inline auto mandelbrot_builder(iheay::math::Complex center = -0.75, double width = 3, int max_iter = 300) {
+    using namespace iheay::fractal;
+
+    return FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_viewport_center(center)
+            .set_viewport_width(width)
+            .set_max_iter(max_iter)
+            .set_initial_func(formulas::Zero{})
+            .set_param_func(formulas::Identity{});
+}
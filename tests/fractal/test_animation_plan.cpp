@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+#include "fractal/animation_plan.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+static const Complex SEAHORSE = Complex::Algebraic(-0.74364388703, 0.13182590421);
+
+static void mandelbrot_preview(const FractalKeyframe& key, EscapeField& field) {
+    FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_viewport(key.viewport)
+            .set_max_iter(key.config.max_iter)
+            .set_escape_radius(key.config.escape_radius)
+            .set_initial_func(formulas::Zero{})
+            .set_param_func(formulas::Identity{})
+            .set_cycle_detection(true)
+            .build()
+            .render_field(field);
+}
+
+static void julia_preview(const FractalKeyframe& key, EscapeField& field) {
+    FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_viewport(key.viewport)
+            .set_max_iter(key.config.max_iter)
+            .set_escape_radius(key.config.escape_radius)
+            .set_param_func(formulas::Constant{ key.julia_c })
+            .set_cycle_detection(true)
+            .build()
+            .render_field(field);
+}
+
+static FractalKeyframe keyframe(Complex center, double width, Complex julia_c = Complex::Zero()) {
+    return { { width, center }, { 200, 2.0 }, julia_c };
+}
+
+static PlanOptions small_options() {
+    PlanOptions options;
+    options.preview_width = 48;
+    options.preview_height = 32;
+    options.probe_max_iter = 4000;
+    options.smoothing = 0;
+    return options;
+}
+
+TEST(AnimationPlanTest, DeeperFramesGetMoreIterations) {
+    const std::vector<FractalKeyframe> keys {
+        keyframe(-0.75, 3.0),
+        keyframe(SEAHORSE, 1e-5),
+    };
+
+    const AnimationPlan plan = plan_animation(keys, 320, 180, mandelbrot_preview, small_options());
+
+    ASSERT_EQ(plan.frames.size(), 2u);
+    EXPECT_LT(plan.frames[0].key.config.max_iter, plan.frames[1].key.config.max_iter);
+    EXPECT_LT(plan.frames[0].key.config.max_iter, 1000);
+
+    // everything but max_iter comes from the keyframe
+    EXPECT_EQ(plan.frames[1].key.viewport.width, 1e-5);
+    EXPECT_EQ(plan.frames[1].key.config.escape_radius, 2.0);
+}
+
+TEST(AnimationPlanTest, BudgetLeavesAtMostToleranceEscapingLater) {
+    const PlanOptions options = small_options();
+    const FractalKeyframe key = keyframe(SEAHORSE, 1e-3);
+
+    const AnimationPlan plan = plan_animation({ key }, 320, 180, mandelbrot_preview, options);
+    const int max_iter = plan.frames[0].key.config.max_iter;
+
+    FractalKeyframe probe = key;
+    probe.config.max_iter = options.probe_max_iter;
+    EscapeField field(options.preview_width, options.preview_height);
+    mandelbrot_preview(probe, field);
+
+    auto escaping_from = [&](int from) {
+        int count = 0;
+        for (double mu : field.mu_data())
+            count += mu >= from && mu < options.probe_max_iter;
+        return count;
+    };
+
+    const double pixels = options.preview_width * options.preview_height;
+    ASSERT_GT(max_iter, options.min_max_iter);
+    EXPECT_LE(escaping_from(max_iter), options.escape_tolerance * pixels);
+    EXPECT_GT(escaping_from(max_iter - 1), options.escape_tolerance * pixels);
+}
+
+TEST(AnimationPlanTest, JuliaParameterDrivesBudget) {
+    // the Julia set of c = -0.8 + 0.156i is connected and pixels near it escape slowly,
+    // c = 1 lies far outside the Mandelbrot set and every pixel escapes within a few iterations
+    const std::vector<FractalKeyframe> keys {
+        keyframe(0, 3.0, Complex::Algebraic(-0.8, 0.156)),
+        keyframe(0, 3.0, Complex::Algebraic(1.0, 0.0)),
+    };
+
+    const AnimationPlan plan = plan_animation(keys, 320, 180, julia_preview, small_options());
+
+    EXPECT_GT(plan.frames[0].key.config.max_iter, plan.frames[1].key.config.max_iter);
+    EXPECT_EQ(plan.frames[1].key.config.max_iter, small_options().min_max_iter);
+    EXPECT_GT(plan.frames[0].seconds, plan.frames[1].seconds);
+}
+
+TEST(AnimationPlanTest, SmoothingTakesLargestBudgetNearby) {
+    const std::vector<FractalKeyframe> keys {
+        keyframe(-0.75, 3.0),
+        keyframe(-0.75, 3.0),
+        keyframe(SEAHORSE, 1e-4),
+        keyframe(-0.75, 3.0),
+    };
+
+    PlanOptions options = small_options();
+    const AnimationPlan raw = plan_animation(keys, 320, 180, mandelbrot_preview, options);
+
+    options.smoothing = 1;
+    const AnimationPlan smooth = plan_animation(keys, 320, 180, mandelbrot_preview, options);
+
+    const int deep = raw.frames[2].key.config.max_iter;
+    EXPECT_LT(raw.frames[1].key.config.max_iter, deep);
+    EXPECT_EQ(smooth.frames[0].key.config.max_iter, raw.frames[0].key.config.max_iter);
+    EXPECT_EQ(smooth.frames[1].key.config.max_iter, deep);
+    EXPECT_EQ(smooth.frames[3].key.config.max_iter, deep);
+}
+
+TEST(AnimationPlanTest, TotalAndRemainingFollowPredictions) {
+    std::vector<FractalKeyframe> keys;
+    for (double width : { 3.0, 1e-1, 1e-3, 1e-2, 1e-4 })
+        keys.push_back(keyframe(SEAHORSE, width));
+
+    const AnimationPlan plan = plan_animation(keys, 640, 360, mandelbrot_preview, small_options());
+
+    ASSERT_EQ(plan.frames.size(), keys.size());
+    double total = 0.0;
+    for (const FramePlan& frame : plan.frames) {
+        total += frame.seconds;
+        EXPECT_GT(frame.seconds, 0.0);
+    }
+    EXPECT_NEAR(plan.seconds, total, 1e-9 * total);
+
+    // on schedule the rest is what is left of the prediction, twice as slow doubles it
+    const double first = plan.frames[0].seconds;
+    EXPECT_NEAR(plan.remaining_seconds({}, 0.0), plan.seconds, 1e-12);
+    EXPECT_NEAR(plan.remaining_seconds({ 0 }, first), plan.seconds - first, 1e-9);
+    EXPECT_NEAR(plan.remaining_seconds({ 0 }, 2 * first), 2 * (plan.seconds - first), 1e-9);
+    EXPECT_NEAR(plan.remaining_seconds({ 0, 1, 2, 3, 4 }, 1.0), 0.0, 1e-9);
+
+    // frames finished out of order, the deepest first as a render farm takes them
+    const double deep = plan.frames[4].seconds + plan.frames[2].seconds;
+    EXPECT_NEAR(plan.remaining_seconds({ 4, 2 }, deep), plan.seconds - deep, 1e-9);
+    EXPECT_NEAR(plan.remaining_seconds({ 4, 2, 4, 7, -1 }, deep), plan.seconds - deep, 1e-9);
+
+    const std::vector<FractalKeyframe> planned = plan.keyframes();
+    ASSERT_EQ(planned.size(), keys.size());
+    EXPECT_EQ(planned[4].config.max_iter, plan.frames[4].key.config.max_iter);
+}
+
+TEST(AnimationPlanTest, RejectsInvalidOptions) {
+    const std::vector<FractalKeyframe> keys { keyframe(-0.75, 3.0) };
+
+    PlanOptions options = small_options();
+    options.probe_max_iter = options.min_max_iter - 1;
+    EXPECT_THROW(plan_animation(keys, 320, 180, mandelbrot_preview, options), std::runtime_error);
+
+    options = small_options();
+    options.escape_tolerance = 1.0;
+    EXPECT_THROW(plan_animation(keys, 320, 180, mandelbrot_preview, options), std::runtime_error);
+
+    EXPECT_THROW(plan_animation(keys, 0, 180, mandelbrot_preview, small_options()), std::runtime_error);
+    EXPECT_THROW(plan_animation(keys, 320, 180, nullptr, small_options()), std::runtime_error);
+}
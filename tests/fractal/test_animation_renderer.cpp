@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "bmp/bmp.hpp"
+#include "bmp/io/bmp_io.hpp"
+#include "fractal/animation_renderer.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "utils/trace.hpp"
+
+using namespace iheay::bmp;
+using namespace iheay::math;
+using namespace iheay::utils;
+using namespace iheay::fractal;
+
+struct GrayColorizer {
+    using pixel_type = BgrPixel;
+
+    BgrPixel operator()(double mu, int max_iter) const {
+        const uint8_t v = static_cast<uint8_t>(255 * std::min(mu, static_cast<double>(max_iter)) / max_iter);
+        return { v, v, v };
+    }
+};
+
+static const int WIDTH = 48;
+static const int HEIGHT = 32;
+
+static std::vector<FractalKeyframe> zoom_keyframes(int count) {
+    const FractalKeyframe start { { 3, Complex::Algebraic(-0.75, 0.0) }, { 200, 2.0 }, Complex::Zero() };
+    const FractalKeyframe end { { 0.01, Complex::Algebraic(-0.74364388703, 0.13182590421) }, { 600, 2.0 }, Complex::Zero() };
+
+    std::vector<FractalKeyframe> keyframes;
+    for (int i = 0; i < count; ++i)
+        keyframes.push_back(interpolate(start, end, static_cast<double>(i) / (count - 1)));
+    return keyframes;
+}
+
+static auto make_builder() {
+    return FractalRendererBuilder<GrayColorizer>
+        ::get_builder()
+            .set_initial_func(formulas::Zero{})
+            .set_param_func(formulas::Identity{});
+}
+
+static AnimationStages make_stages(std::vector<std::vector<BgrPixel>>& written) {
+    return {
+        [](const FractalKeyframe& key, EscapeField& field) {
+            make_builder().set_viewport(key.viewport).set_max_iter(key.config.max_iter).build().render_field(field);
+        },
+        [](const FractalKeyframe&, const EscapeField& field, Bmp& image) {
+            colorize(field, image, GrayColorizer{});
+        },
+        [&written](int frame, const Bmp& image) {
+            ASSERT_EQ(frame, static_cast<int>(written.size()));
+            written.push_back(image.pixels());
+        }
+    };
+}
+
+TEST(AnimationRendererTest, FramesMatchSequentialRenders) {
+    const std::vector<FractalKeyframe> keyframes = zoom_keyframes(7);
+
+    std::vector<std::vector<BgrPixel>> written;
+    const AnimationStats stats = AnimationRenderer(WIDTH, HEIGHT, make_stages(written), 2).render(keyframes);
+
+    EXPECT_EQ(stats.frames, 7);
+    ASSERT_EQ(written.size(), 7u);
+
+    for (int i = 0; i < 7; ++i) {
+        Bmp expected = Bmp::empty(WIDTH, HEIGHT);
+        make_builder().set_viewport(keyframes[i].viewport).set_max_iter(keyframes[i].config.max_iter).build().render(expected);
+
+        EXPECT_EQ(std::memcmp(written[i].data(), expected.pixels().data(), written[i].size() * sizeof(BgrPixel)), 0)
+            << "frame " << i;
+    }
+}
+
+TEST(AnimationRendererTest, BuffersAreReused) {
+    std::set<const EscapeField*> fields;
+    std::set<const Bmp*> images;
+
+    AnimationStages stages {
+        [&](const FractalKeyframe&, EscapeField& field) { fields.insert(&field); },
+        [&](const FractalKeyframe&, const EscapeField&, Bmp& image) { images.insert(&image); },
+        [](int, const Bmp&) {}
+    };
+
+    AnimationRenderer(WIDTH, HEIGHT, stages, 3).render(zoom_keyframes(20));
+
+    EXPECT_LE(fields.size(), 3u);
+    EXPECT_LE(images.size(), 3u);
+}
+
+TEST(AnimationRendererTest, StageErrorStopsThePipeline) {
+    int written = 0;
+
+    AnimationStages stages {
+        [](const FractalKeyframe&, EscapeField&) {},
+        [](const FractalKeyframe&, const EscapeField&, Bmp&) {},
+        [&](int frame, const Bmp&) {
+            if (frame == 3)
+                throw std::runtime_error("disk full");
+            ++written;
+        }
+    };
+
+    EXPECT_THROW(AnimationRenderer(WIDTH, HEIGHT, stages, 2).render(zoom_keyframes(50)), std::runtime_error);
+    EXPECT_EQ(written, 3);
+}
+
+TEST(AnimationRendererTest, RejectsInvalidSetup) {
+    std::vector<std::vector<BgrPixel>> written;
+
+    EXPECT_THROW(AnimationRenderer(0, HEIGHT, make_stages(written)), std::runtime_error);
+    EXPECT_THROW(AnimationRenderer(WIDTH, HEIGHT, make_stages(written), 0), std::runtime_error);
+    EXPECT_THROW(AnimationRenderer(WIDTH, HEIGHT, AnimationStages {}), std::runtime_error);
+}
+
+#ifndef IHEAY_DISABLE_TRACING
+TEST(AnimationRendererTest, TracesEveryStageOfEveryFrame) {
+    const std::string path = (std::filesystem::temp_directory_path() / ("iheay_trace_frame_" + std::to_string(::getpid()) + ".bmp")).string();
+    std::vector<std::vector<BgrPixel>> written;
+    AnimationStages stages = make_stages(written);
+    stages.write = [&](int, const Bmp& image) { io::save(image, path); };
+
+    Trace::clear();
+    Trace::enable();
+    AnimationRenderer(WIDTH, HEIGHT, stages, 2).render(zoom_keyframes(4));
+    Trace::disable();
+
+    std::ostringstream out;
+    Trace::write_json(out);
+    Trace::clear();
+    std::filesystem::remove(path);
+
+    const std::string json = out.str();
+    auto count = [&](const std::string& name) {
+        size_t found = 0;
+        for (size_t at = json.find("\"name\":\"" + name + "\""); at != std::string::npos; at = json.find("\"name\":\"" + name + "\"", at + 1))
+            ++found;
+        return found;
+    };
+
+    EXPECT_EQ(count("animation"), 1u);
+    EXPECT_EQ(count("compute frame"), 4u);
+    EXPECT_EQ(count("render"), 4u);
+    EXPECT_EQ(count("colorize frame"), 4u);
+    EXPECT_EQ(count("colorize"), 4u);
+    EXPECT_EQ(count("write frame"), 4u);
+    EXPECT_EQ(count("bmp save"), 4u);
+    EXPECT_EQ(count("animation colorize"), 1u);
+    EXPECT_EQ(count("animation write"), 1u);
+}
+#endif
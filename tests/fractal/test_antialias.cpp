@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include "bmp/bmp_structs.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/pixel_average.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+static auto make_renderer(Kernel kernel = Kernel::Scalar) {
+    return FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_viewport_width(3)
+            .set_viewport_center(-0.75)
+            .set_max_iter(200)
+            .set_initial_func(formulas::Zero{})
+            .set_param_func(formulas::Identity{})
+            .set_kernel(kernel)
+            .set_precision(Precision::Double)
+            .build();
+}
+
+static int changed_pixels(const MuImage& a, const MuImage& b) {
+    int changed = 0;
+    for (int y = 0; y < a.height(); ++y)
+        for (int x = 0; x < a.width(); ++x)
+            changed += a.get_pixel(x, y) != b.get_pixel(x, y);
+    return changed;
+}
+
+TEST(PixelAverageTest, AveragesByteChannels) {
+    PixelAverage<iheay::bmp::BgrPixel> average;
+    average.add({ 0, 0, 0 });
+    average.add({ 255, 100, 1 });
+
+    const iheay::bmp::BgrPixel pixel = average.result();
+    EXPECT_EQ(pixel.b, 128);
+    EXPECT_EQ(pixel.g, 50);
+    EXPECT_EQ(pixel.r, 1);
+}
+
+TEST(PixelAverageTest, AveragesArithmeticPixels) {
+    PixelAverage<double> average;
+    average.add(1.0);
+    average.add(2.0);
+    average.add(6.0);
+
+    EXPECT_DOUBLE_EQ(average.result(), 3.0);
+}
+
+TEST(AntialiasTest, RefinesOnlyEdgePixels) {
+    const auto renderer = make_renderer();
+
+    MuImage plain(160, 120);
+    MuImage smooth(160, 120);
+
+    renderer.render(plain);
+    const AntialiasStats stats = renderer.render_antialiased(smooth, { 1.0, 8, 16.0 });
+
+    EXPECT_GT(stats.edges, 0);
+    EXPECT_EQ(stats.refined, stats.edges);
+    EXPECT_EQ(stats.samples, stats.refined * 8);
+
+    // a refined pixel may still average back to its base value, nothing else may change
+    EXPECT_GT(changed_pixels(plain, smooth), 0);
+    EXPECT_LE(changed_pixels(plain, smooth), stats.refined);
+}
+
+TEST(AntialiasTest, BudgetCapsRefinedPixels) {
+    const auto renderer = make_renderer();
+    MuImage image(160, 120);
+
+    const AntialiasStats unlimited = renderer.render_antialiased(image, { 1.0, 8, 16.0 });
+    const AntialiasStats limited = renderer.render_antialiased(image, { 1.0, 8, 0.1 });
+
+    EXPECT_EQ(limited.edges, unlimited.edges);
+    EXPECT_EQ(limited.refined, static_cast<long>(0.1 * 160 * 120 / 8));
+    EXPECT_LT(limited.refined, unlimited.refined);
+}
+
+TEST(AntialiasTest, NoEdgesLeavesRenderUntouched) {
+    const auto renderer = make_renderer();
+
+    MuImage plain(80, 60);
+    MuImage smooth(80, 60);
+
+    renderer.render(plain);
+    const AntialiasStats stats = renderer.render_antialiased(smooth, { 1e9, 8, 1.0 });
+
+    EXPECT_EQ(stats.edges, 0);
+    EXPECT_EQ(stats.refined, 0);
+    expect_same_images(plain, smooth);
+}
+
+TEST(AntialiasTest, SameFrameSameJitter) {
+    const auto renderer = make_renderer();
+
+    MuImage first(80, 60);
+    MuImage second(80, 60);
+
+    renderer.render_antialiased(first);
+    renderer.render_antialiased(second);
+
+    expect_same_images(first, second);
+}
+
+TEST(AntialiasTest, VectorKernelMatchesScalar) {
+    MuImage scalar(120, 90);
+    MuImage vectorized(120, 90);
+
+    const AntialiasStats scalar_stats = make_renderer(Kernel::Scalar).render_antialiased(scalar);
+    const AntialiasStats vector_stats = make_renderer(Kernel::Simd).render_antialiased(vectorized);
+
+    EXPECT_EQ(scalar_stats.refined, vector_stats.refined);
+    expect_same_images(scalar, vectorized);
+}
+
+TEST(AntialiasTest, RejectsInvalidOptions) {
+    MuImage image(10, 10);
+
+    EXPECT_THROW(make_renderer().render_antialiased(image, { 1.0, 0, 1.0 }), std::runtime_error);
+    EXPECT_THROW(make_renderer().render_antialiased(image, { -1.0, 4, 1.0 }), std::runtime_error);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/escape_field.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+struct DistanceColorizer {
+    using pixel_type = double;
+
+    double operator()(double distance) const { return distance; }
+};
+
+// a one pixel boundary line, the usual way distance renders are shown
+struct BoundaryColorizer {
+    using pixel_type = double;
+
+    double operator()(double distance) const { return distance < 1.0 ? 1.0 : 0.0; }
+};
+
+// a large escape radius keeps the estimate accurate
+static auto distance_builder() {
+    return mandelbrot_builder(-0.75, 3, 200).set_escape_radius(1e3);
+}
+
+TEST(DistanceTest, EstimateBracketsKnownDistance) {
+    // c = -2.5 is 0.5 away from the tip of the set at -2
+    const auto renderer = distance_builder()
+        .set_viewport_center(-2.5)
+        .set_viewport_width(1e-6)
+        .build();
+
+    EscapeField field(3, 3, FieldChannels { .distance = true });
+    renderer.render_field(field);
+
+    EXPECT_GT(field.distance(1, 1), 0.25);
+    EXPECT_LT(field.distance(1, 1), 1.0);
+}
+
+TEST(DistanceTest, InteriorPixelsAreAtZero) {
+    const auto renderer = distance_builder().set_viewport_center(-0.1).set_viewport_width(0.01).build();
+
+    EscapeField field(4, 4, FieldChannels { .distance = true });
+    renderer.render_field(field);
+
+    for (int y = 0; y < 4; ++y)
+        for (int x = 0; x < 4; ++x)
+            EXPECT_EQ(field.distance(x, y), 0.0);
+}
+
+TEST(DistanceTest, DerivativeFuncMatchesBuiltIn) {
+    const auto builtin = distance_builder().build();
+    const auto custom = distance_builder()
+        .set_iteration_func([](const Complex& z, const Complex& c) { return z * z + c; })
+        .set_derivative_func([](const Complex& z, const Complex& dz, const Complex& dc) { return 2.0 * z * dz + dc; })
+        .build();
+
+    EscapeField expected(40, 30, FieldChannels { .distance = true });
+    EscapeField actual(40, 30, FieldChannels { .distance = true });
+    builtin.render_field(expected);
+    custom.render_field(actual);
+
+    for (int y = 0; y < 30; ++y)
+        for (int x = 0; x < 40; ++x)
+            EXPECT_DOUBLE_EQ(actual.distance(x, y), expected.distance(x, y));
+}
+
+TEST(DistanceTest, CustomIterationNeedsDerivativeFunc) {
+    const auto custom = distance_builder()
+        .set_iteration_func([](const Complex& z, const Complex& c) { return z * z + c; })
+        .build();
+
+    EscapeField field(8, 8, FieldChannels { .distance = true });
+    EXPECT_THROW(custom.render_field(field), std::runtime_error);
+
+    MuImage image(8, 8);
+    EXPECT_THROW(custom.render_distance(image, DistanceColorizer{}), std::runtime_error);
+}
+
+TEST(DistanceTest, SkippedDisksKeepTheBoundary) {
+    const auto renderer = distance_builder().build();
+
+    MuImage full(320, 240);
+    MuImage fast(320, 240);
+
+    const DistanceStats full_stats = renderer.render_distance(full, BoundaryColorizer{}, { 0.0 });
+    const DistanceStats fast_stats = renderer.render_distance(fast, BoundaryColorizer{}, { 4.0 });
+
+    EXPECT_EQ(full_stats.skipped, 0);
+    EXPECT_EQ(full_stats.iterated, 320 * 240);
+    EXPECT_GT(fast_stats.skipped, 320 * 240 / 4);
+    EXPECT_EQ(fast_stats.iterated + fast_stats.skipped, 320 * 240);
+    expect_same_images(full, fast);
+}
+
+TEST(DistanceTest, SkippedPixelsGetLowerBounds) {
+    const auto renderer = distance_builder().build();
+
+    MuImage full(160, 120);
+    MuImage fast(160, 120);
+
+    renderer.render_distance(full, DistanceColorizer{}, { 0.0 });
+    renderer.render_distance(fast, DistanceColorizer{}, { 4.0 });
+
+    for (int y = 0; y < 120; ++y) {
+        for (int x = 0; x < 160; ++x) {
+            if (fast.get_pixel(x, y) != full.get_pixel(x, y)) {
+                EXPECT_GE(fast.get_pixel(x, y), 4.0);
+            }
+        }
+    }
+}
+
+TEST(DistanceTest, BoundaryDistanceAddsAntialiasedPixels) {
+    const auto renderer = distance_builder().set_precision(Precision::Double).build();
+
+    MuImage image(160, 120);
+    const AntialiasStats plain = renderer.render_antialiased(image, { 1.0, 4, 16.0 });
+    const AntialiasStats boundary = renderer.render_antialiased(image, { 1.0, 4, 16.0, 2.0 });
+
+    EXPECT_GT(boundary.edges, plain.edges);
+    EXPECT_EQ(boundary.refined, boundary.edges);
+}
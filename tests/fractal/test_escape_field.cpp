@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/escape_field.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+struct DoubledColorizer {
+    using pixel_type = double;
+
+    double operator()(double mu, int) const { return 2 * mu; }
+};
+
+TEST(EscapeFieldTest, ColorizedFieldMatchesRender) {
+    for (Kernel kernel : { Kernel::Scalar, Kernel::Simd }) {
+        auto renderer = mandelbrot_builder().set_kernel(kernel).build();
+
+        MuImage direct(96, 64);
+        MuImage recolored(96, 64);
+        EscapeField field(96, 64);
+
+        renderer.render(direct);
+        renderer.render_field(field);
+        renderer.colorize(field, recolored);
+
+        EXPECT_EQ(field.max_iter(), 300);
+        expect_same_images(direct, recolored);
+    }
+}
+
+TEST(EscapeFieldTest, RecolorWithAnotherColorizer) {
+    EscapeField field(40, 30);
+    mandelbrot_builder().build().render_field(field);
+
+    MuImage doubled(40, 30);
+    colorize(field, doubled, DoubledColorizer{});
+
+    for (int y = 0; y < 30; ++y)
+        for (int x = 0; x < 40; ++x)
+            ASSERT_EQ(doubled.get_pixel(x, y), 2 * field.mu(x, y));
+
+    MuImage wrong_size(41, 30);
+    EXPECT_THROW(colorize(field, wrong_size, DoubledColorizer{}), std::runtime_error);
+}
+
+TEST(EscapeFieldTest, FinalZChannel) {
+    EscapeField field(64, 48, FieldChannels { .final_z = true });
+    mandelbrot_builder().set_kernel(Kernel::Simd).build().render_field(field);
+
+    for (int y = 0; y < field.height(); ++y) {
+        for (int x = 0; x < field.width(); ++x) {
+            if (field.mu(x, y) < field.max_iter()) {
+                ASSERT_GT(field.final_z(x, y), 2.0) << "at (" << x << ", " << y << ")";
+            }
+        }
+    }
+}
+
+TEST(EscapeFieldTest, DerivativeFollowsRecurrence) {
+    // outside the cardioid, nothing escapes within 4 iterations with a huge radius
+    const int max_iter = 4;
+    const Viewport viewport { 0.1, Complex::Algebraic(0.45, 0.3) };
+
+    auto renderer =
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_viewport(viewport)
+                .set_max_iter(max_iter)
+                .set_escape_radius(1e6)
+                .set_initial_func(formulas::Zero{})
+                .set_param_func(formulas::Identity{})
+                .build();
+
+    EscapeField field(8, 6, FieldChannels { .final_z = true, .derivative = true });
+    renderer.render_field(field);
+
+    const ViewportMapping mapping = ViewportMapping::from(viewport, 8, 6);
+
+    for (int y = 0; y < 6; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            const Complex c = mapping.pixel(x, y);
+            Complex z = Complex::Zero();
+            Complex dz = Complex::Zero();
+
+            for (int i = 0; i < max_iter; ++i) {
+                dz = 2.0 * z * dz + Complex(1.0);
+                z = z * z + c;
+            }
+
+            EXPECT_NEAR(field.derivative(x, y), std::hypot(dz.real(), dz.imag()), 1e-12);
+            EXPECT_NEAR(field.final_z(x, y), std::hypot(z.real(), z.imag()), 1e-12);
+        }
+    }
+}
+
+TEST(EscapeFieldTest, UnavailableChannelsThrow) {
+    EscapeField with_derivative(8, 8, FieldChannels { .derivative = true });
+
+    auto lambda = FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_iteration_func([](auto& z, auto& c) { return z * z + c; })
+            .build();
+
+    EXPECT_THROW(lambda.render_field(with_derivative), std::runtime_error);
+
+    auto perturbed = mandelbrot_builder().set_precision(Precision::Perturbation).build();
+    EXPECT_THROW(perturbed.render_field(with_derivative), std::runtime_error);
+
+    EscapeField mu_only(8, 8);
+    EXPECT_NO_THROW(perturbed.render_field(mu_only));
+}
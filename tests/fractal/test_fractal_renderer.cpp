@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <type_traits>
+
+#include "fractal/fractal_renderer_builder.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+TEST(FractalRendererTest, BuilderUsesConcreteFunctorTypes) {
+    auto builder = FractalRendererBuilder<MuColorizer>::get_builder();
+    auto renderer = builder.build();
+
+    static_assert(std::is_same_v<
+        decltype(renderer),
+        FractalRenderer<MuColorizer, formulas::Quadratic, formulas::Identity, formulas::Zero>
+    >);
+
+    auto lambda_builder = builder.set_param_func([](const Complex& pixel) { return pixel; });
+    static_assert(!std::is_same_v<decltype(lambda_builder), decltype(builder)>);
+}
+
+TEST(FractalRendererTest, SettersKeepTypeWhenFunctorTypeIsUnchanged) {
+    auto builder = FractalRendererBuilder<MuColorizer>::get_builder();
+
+    auto& same = builder.set_param_func(formulas::Zero{});
+    EXPECT_EQ(&same, &builder);
+}
+
+TEST(FractalRendererTest, FunctionFallbackMatchesConcreteFunctors) {
+    auto builder =
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_viewport_width(3)
+                .set_viewport_center(-0.75)
+                .set_max_iter(200)
+                .set_initial_func(formulas::Zero{})
+                .set_param_func(formulas::Identity{});
+
+    FractalRendererBuilder<MuColorizer> fallback = builder;
+
+    MuImage fast(64, 48);
+    MuImage slow(64, 48);
+
+    builder.build().render(fast);
+    fallback.build().render(slow);
+
+    expect_same_images(fast, slow);
+}
+
+TEST(FractalRendererTest, JuliaLambdaMatchesBuiltinConstant) {
+    const Complex c = Complex::Algebraic(-0.8, 0.156);
+
+    auto builtin =
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_max_iter(150)
+                .set_param_func(formulas::Constant{ c })
+                .build();
+
+    auto lambda =
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_max_iter(150)
+                .set_iteration_func([](auto& z, auto& c) { return z * z + c; })
+                .set_param_func([c](auto&) { return c; })
+                .build();
+
+    MuImage a(50, 50);
+    MuImage b(50, 50);
+
+    builtin.render(a);
+    lambda.render(b);
+
+    expect_same_images(a, b);
+}
+
+TEST(FractalRendererTest, InvalidBuilderValuesThrow) {
+    auto builder = FractalRendererBuilder<MuColorizer>::get_builder();
+
+    EXPECT_THROW(builder.set_viewport_width(0), std::runtime_error);
+    EXPECT_THROW(builder.set_max_iter(-1), std::runtime_error);
+    EXPECT_THROW(builder.set_escape_radius(0), std::runtime_error);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/incremental_renderer.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+static const Viewport start_viewport { 3.0, -0.75 };
+
+static auto make_renderer() {
+    return FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_viewport(start_viewport)
+            .set_max_iter(300)
+            .set_initial_func(formulas::Zero{})
+            .set_param_func(formulas::Identity{})
+            .set_kernel(Kernel::Simd)
+            .build();
+}
+
+TEST(IncrementalRendererTest, FirstFrameMatchesPlainRender) {
+    IncrementalRenderer incremental(make_renderer(), start_viewport);
+    incremental.resize(120, 80);
+
+    MuImage direct(120, 80);
+    MuImage colored(120, 80);
+
+    make_renderer().render(direct);
+    incremental.render(colored);
+
+    expect_same_images(direct, colored);
+    EXPECT_EQ(incremental.last_stats().computed, 120 * 80);
+}
+
+TEST(IncrementalRendererTest, PanComputesOnlyExposedStrips) {
+    IncrementalRenderer incremental(make_renderer(), start_viewport);
+    incremental.resize(200, 100);
+
+    incremental.pan(10, 0);
+    EXPECT_EQ(incremental.last_stats().computed, 10 * 100);
+    EXPECT_EQ(incremental.last_stats().copied, 190 * 100);
+
+    incremental.pan(-3, 7);
+    EXPECT_EQ(incremental.last_stats().computed, 200 * 100 - 197 * 93);
+    EXPECT_EQ(incremental.last_stats().copied, 197 * 93);
+
+    // same frame rendered from scratch
+    IncrementalRenderer fresh(make_renderer(), start_viewport);
+    fresh.set_mapping(incremental.mapping(), 200, 100);
+
+    EXPECT_LT(mismatch_share(incremental.field(), fresh.field(), 1e-6), 0.01);
+}
+
+TEST(IncrementalRendererTest, GrowingCanvasKeepsCornerAndStep) {
+    IncrementalRenderer incremental(make_renderer(), start_viewport);
+    incremental.resize(100, 60);
+
+    const ViewportMapping before = incremental.mapping();
+    incremental.resize(130, 70);
+
+    EXPECT_EQ(incremental.mapping().real_min, before.real_min);
+    EXPECT_EQ(incremental.mapping().imag_max, before.imag_max);
+    EXPECT_EQ(incremental.last_stats().copied, 100 * 60);
+    EXPECT_EQ(incremental.last_stats().computed, 130 * 70 - 100 * 60);
+
+    incremental.resize(90, 50);
+    EXPECT_EQ(incremental.last_stats().computed, 0);
+    EXPECT_EQ(incremental.field().max_iter(), 300);
+}
+
+TEST(IncrementalRendererTest, FractionalShiftOrFarPanRendersEverything) {
+    IncrementalRenderer incremental(make_renderer(), start_viewport);
+    incremental.resize(64, 48);
+
+    ViewportMapping half_pixel = incremental.mapping();
+    half_pixel.real_min += half_pixel.real_step / 2;
+    incremental.set_mapping(half_pixel, 64, 48);
+    EXPECT_EQ(incremental.last_stats().computed, 64 * 48);
+
+    incremental.pan(1000, 0);
+    EXPECT_EQ(incremental.last_stats().copied, 0);
+    EXPECT_EQ(incremental.last_stats().computed, 64 * 48);
+}
+
+TEST(IncrementalRendererTest, NeedsAFrameFirst) {
+    IncrementalRenderer incremental(make_renderer(), start_viewport);
+
+    EXPECT_THROW(incremental.field(), std::runtime_error);
+    EXPECT_THROW(incremental.pan(1, 1), std::runtime_error);
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <set>
+#include <vector>
+
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/perturbation.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+// straightforward BigFloat iteration of one Mandelbrot pixel
+static double brute_force_mu(const BigFloat& cr, const BigFloat& ci, const FractalConfig& config) {
+    BigFloat zr(0.0, cr.precision_bits());
+    BigFloat zi(0.0, cr.precision_bits());
+
+    int iter = 0;
+    while (iter < config.max_iter) {
+        const double re = zr.to_double();
+        const double im = zi.to_double();
+        if (re * re + im * im > config.escape_radius * config.escape_radius)
+            break;
+
+        const BigFloat re2 = zr * zr;
+        const BigFloat im2 = zi * zi;
+        zi = (zr * zi).mul_pow2(1) + ci;
+        zr = re2 - im2 + cr;
+        ++iter;
+    }
+
+    return calc_mu(Complex::Algebraic(zr.to_double(), zi.to_double()), iter, config.max_iter);
+}
+
+TEST(PerturbationTest, MatchesDoubleMandelbrotAtShallowZoom) {
+    auto builder =
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_viewport_width(1e-6)
+                .set_viewport_center(Complex::Algebraic(-0.7436438870371587, 0.1318259042053119))
+                .set_max_iter(1000)
+                .set_initial_func(formulas::Zero{})
+                .set_param_func(formulas::Identity{});
+
+    MuImage plain(64, 48);
+    MuImage perturbed(64, 48);
+
+    builder.build().render(plain);
+    builder.set_precision(Precision::Perturbation).build().render(perturbed);
+
+    EXPECT_LT(mismatch_share(plain, perturbed, 1e-3), 0.02);
+}
+
+TEST(PerturbationTest, MatchesDoubleJulia) {
+    auto builder =
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_viewport_width(0.01)
+                .set_viewport_center(Complex::Algebraic(0.1, 0.2))
+                .set_max_iter(500)
+                .set_param_func(formulas::Constant{ Complex::Algebraic(-0.8, 0.156) });
+
+    MuImage plain(48, 48);
+    MuImage perturbed(48, 48);
+
+    builder.build().render(plain);
+    builder.set_precision(Precision::Perturbation).build().render(perturbed);
+
+    EXPECT_LT(mismatch_share(plain, perturbed, 1e-3), 0.02);
+}
+
+TEST(PerturbationTest, DeepZoomMatchesBruteForce) {
+    const int precision = 256;
+    const DeepCenter center {
+        BigFloat::from_string("-0.743643887037158704752191506114774", precision),
+        BigFloat::from_string("0.131825904205311970493132056385139", precision)
+    };
+
+    const int width = 24;
+    const int height = 16;
+    const double viewport_width = 1e-20;
+    const FractalConfig config { 12000, 2.0 };
+
+    perturbation::Params params { perturbation::Family::Mandelbrot, center, Complex::Zero(), viewport_width, config };
+
+    std::vector<double> mu;
+    const perturbation::Report report = perturbation::render(params, width, height, mu);
+
+    EXPECT_EQ(report.glitched_pixels, 0);
+
+    // a double-precision render of this view would be a single flat color
+    std::set<double> distinct(mu.begin(), mu.end());
+    EXPECT_GT(distinct.size(), 100u);
+
+    const double step = viewport_width / (width - 1);
+    const double viewport_height = viewport_width * height / width;
+    const double imag_step = viewport_height / (height - 1);
+
+    for (int index : { 0, 5, 77, 150, 222, width * height - 1 }) {
+        const int x = index % width;
+        const int y = index / width;
+
+        const BigFloat cr = center.real.with_precision(precision) + BigFloat(x * step - viewport_width / 2, precision);
+        const BigFloat ci = center.imag.with_precision(precision) + BigFloat(viewport_height / 2 - y * imag_step, precision);
+
+        EXPECT_NEAR(mu[index], brute_force_mu(cr, ci, config), 1e-6) << "pixel " << index;
+    }
+}
+
+TEST(PerturbationTest, IteratesGlitchesDirectlyWhenReferencesRunOut) {
+    // the center escapes just left of the tip at -2, the pixels right of it stay longer than
+    // the only reference lasts and are all glitched
+    const int precision = 256;
+    const DeepCenter center {
+        BigFloat::from_string("-2.00000000000000000000000000000000001", precision),
+        BigFloat(0.0, precision)
+    };
+
+    const int width = 24;
+    const int height = 16;
+    const FractalConfig config { 3000, 2.0 };
+
+    // DoubleDouble still resolves the first view, the second one takes BigFloat
+    for (double viewport_width : { 1e-25, 1e-32 }) {
+        perturbation::Params params { perturbation::Family::Mandelbrot, center, Complex::Zero(), viewport_width, config, 1 };
+
+        std::vector<double> mu;
+        const perturbation::Report report = perturbation::render(params, width, height, mu);
+        EXPECT_EQ(report.references, 1);
+        EXPECT_EQ(report.glitched_pixels, width * height / 2);
+
+        const double step = viewport_width / (width - 1);
+        const double viewport_height = viewport_width * height / width;
+        const double imag_step = viewport_height / (height - 1);
+
+        // no pixel is left at mu 0
+        for (int index = 0; index < width * height; ++index) {
+            const int x = index % width;
+            const int y = index / width;
+
+            const BigFloat cr = center.real + BigFloat(x * step - viewport_width / 2, precision);
+            const BigFloat ci = center.imag + BigFloat(viewport_height / 2 - y * imag_step, precision);
+
+            EXPECT_NEAR(mu[index], brute_force_mu(cr, ci, config), 1e-6) << "pixel " << index << " of " << viewport_width;
+        }
+    }
+}
+
+TEST(PerturbationTest, PrecisionGrowsWithZoom) {
+    EXPECT_GE(perturbation::precision_for(1e-3), 64);
+    EXPECT_GT(perturbation::precision_for(1e-100), 64 + 300);
+}
+
+TEST(PerturbationTest, RequiresBuiltinFormula) {
+    auto builder =
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_initial_func([](auto&) { return Complex::Zero(); });
+
+    builder.set_precision(Precision::Perturbation);
+    EXPECT_THROW(builder.build(), std::runtime_error);
+}
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/precision_selector.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+static DeepCenter seahorse_center() {
+    return {
+        BigFloat::from_string("-0.743643887037158704752191506114774", 256),
+        BigFloat::from_string("0.131825904205311970493132056385139", 256)
+    };
+}
+
+TEST(PrecisionTest, SelectorThresholds) {
+    const Viewport vp { 3, Complex::Algebraic(-0.75, 0.0) };
+
+    EXPECT_EQ(select_precision(vp, 1e-4, 1000), Precision::Double);
+    EXPECT_EQ(select_precision(vp, 1e-12, 1000), Precision::Double);
+    EXPECT_EQ(select_precision(vp, 1e-15, 1000), Precision::DoubleDouble);
+    EXPECT_EQ(select_precision(vp, 1e-27, 1000), Precision::DoubleDouble);
+    EXPECT_EQ(select_precision(vp, 1e-30, 1000), Precision::Perturbation);
+
+    // large coordinates eat into the mantissa
+    const Viewport far { 3, Complex::Algebraic(1e6, 0.0) };
+    EXPECT_EQ(select_precision(far, 1e-9, 1000), Precision::DoubleDouble);
+}
+
+TEST(PrecisionTest, SelectorPicksFloatForShallowViews) {
+    const Viewport vp { 3, Complex::Zero() };
+
+    // the default builder view at full HD with long orbits
+    EXPECT_EQ(select_precision(vp, 3.0 / 1919, 5000), Precision::Float);
+    EXPECT_EQ(select_precision(vp, 3.0 / 1919, 20000), Precision::Float);
+
+    // shorter orbits gain nothing from float lanes
+    EXPECT_EQ(select_precision(vp, 3.0 / 1919, 300), Precision::Double);
+    EXPECT_EQ(select_precision(vp, 3.0 / 1919, 2000), Precision::Double);
+
+    // finer pixels would send most of the frame to the double re-run
+    EXPECT_EQ(select_precision(vp, 1e-5, 5000), Precision::Double);
+    EXPECT_EQ(select_precision(vp, 3e-4, 5000), Precision::Double);
+
+    // float lanes can't count that far
+    EXPECT_EQ(select_precision(vp, 3.0 / 1919, 1 << 24), Precision::Double);
+}
+
+// palette with steep bands, so mu errors show up as changed colors
+struct BandColorizer {
+    using pixel_type = int;
+
+    int operator()(double mu, int max_iter) const {
+        if (mu >= max_iter)
+            return 0;
+        return 1 + static_cast<int>(255 * (0.5 + 0.5 * std::sin(mu * 0.7)));
+    }
+};
+
+struct ByteImage {
+    using pixel_type = int;
+
+    ByteImage(int width, int height) : m_width(width), m_height(height), m_pixels(width * height) {}
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+    void set_pixel(int x, int y, int pixel) { m_pixels[y * m_width + x] = pixel; }
+    int get_pixel(int x, int y) const { return m_pixels[y * m_width + x]; }
+
+    int m_width;
+    int m_height;
+    std::vector<int> m_pixels;
+};
+
+TEST(PrecisionTest, FloatKernelIsVisiblyIdentical) {
+    struct View {
+        Viewport viewport;
+        int max_iter;
+    };
+
+    const View views[] = {
+        { { 3, Complex::Zero() }, 5000 },
+        { { 3, Complex::Algebraic(-0.75, 0.0) }, 8000 },
+        { { 0.5, Complex::Algebraic(-0.75, 0.1) }, 5000 },
+    };
+
+    for (const View& view : views) {
+        auto builder =
+            FractalRendererBuilder<BandColorizer>
+                ::get_builder()
+                    .set_viewport(view.viewport)
+                    .set_max_iter(view.max_iter)
+                    .set_initial_func(formulas::Zero{})
+                    .set_param_func(formulas::Identity{})
+                    .set_kernel(Kernel::Simd);
+
+        const int width = 480;
+        const int height = 270;
+        ASSERT_EQ(select_precision(view.viewport, view.viewport.width / (width - 1), view.max_iter), Precision::Float);
+
+        ByteImage reference(width, height);
+        ByteImage automatic(width, height);
+
+        builder.set_precision(Precision::Double).build().render(reference);
+        builder.set_precision(Precision::Auto).build().render(automatic);
+
+        // a pixel counts as visibly different when its 8-bit intensity moves by more than 2 steps;
+        // a few isolated boundary pixels are allowed, double and double-double disagree on as many
+        int different = 0;
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                different += std::abs(reference.get_pixel(x, y) - automatic.get_pixel(x, y)) > 2;
+
+        EXPECT_LE(different, width * height / 10000) << "view width " << view.viewport.width;
+    }
+}
+
+TEST(PrecisionTest, ForcedFloatReRunsWhatFloatCantResolve) {
+    auto builder =
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_viewport_width(1e-4)
+                .set_viewport_center(Complex::Algebraic(-0.7436, 0.1318))
+                .set_max_iter(1000)
+                .set_initial_func(formulas::Zero{})
+                .set_param_func(formulas::Identity{})
+                .set_kernel(Kernel::Simd);
+
+    MuImage reference(64, 48);
+    MuImage forced(64, 48);
+
+    builder.set_precision(Precision::Double).build().render(reference);
+    builder.set_precision(Precision::Float).build().render(forced);
+
+    // float_iterations is below one here, every escaping pixel goes back to double
+    EXPECT_LT(mismatch_share(reference, forced, 1e-9), 0.01);
+}
+
+TEST(PrecisionTest, FloatRequiresSimdKernel) {
+    auto builder =
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_initial_func(formulas::Zero{})
+                .set_param_func(formulas::Identity{})
+                .set_precision(Precision::Float);
+
+    EXPECT_THROW(builder.build(), std::runtime_error);
+    EXPECT_NO_THROW(builder.set_kernel(Kernel::Simd).build());
+}
+
+TEST(PrecisionTest, DoubleDoubleMatchesDoubleAtShallowZoom) {
+    auto builder =
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_viewport_center(-0.75)
+                .set_max_iter(300)
+                .set_initial_func(formulas::Zero{})
+                .set_param_func(formulas::Identity{});
+
+    MuImage plain(60, 40);
+    MuImage extended(60, 40);
+
+    builder.set_precision(Precision::Double).build().render(plain);
+    builder.set_precision(Precision::DoubleDouble).build().render(extended);
+
+    EXPECT_LT(mismatch_share(plain, extended, 1e-6), 0.01);
+}
+
+TEST(PrecisionTest, DoubleDoubleMatchesPerturbationAtMidDepth) {
+    auto builder =
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_viewport_width(1e-20)
+                .set_deep_center(seahorse_center())
+                .set_max_iter(12000)
+                .set_initial_func(formulas::Zero{})
+                .set_param_func(formulas::Identity{});
+
+    MuImage automatic(24, 16);
+    MuImage extended(24, 16);
+    MuImage perturbed(24, 16);
+
+    builder.build().render(automatic);
+    builder.set_precision(Precision::DoubleDouble).build().render(extended);
+    builder.set_precision(Precision::Perturbation).build().render(perturbed);
+
+    // Auto resolves to double-double at this depth
+    expect_same_images(automatic, extended);
+
+    // ~9000 iterations amplify rounding differences near the boundary,
+    // so only the smoothed value is compared loosely
+    EXPECT_LT(mismatch_share(extended, perturbed, 5e-2), 0.03);
+}
+
+TEST(PrecisionTest, FunctionFallbackCantUseDoubleDouble) {
+    FractalRendererBuilder<MuColorizer> builder = FractalRendererBuilder<MuColorizer>::get_builder();
+
+    builder.set_precision(Precision::DoubleDouble);
+    EXPECT_THROW(builder.build(), std::runtime_error);
+
+    // Auto quietly stays in double
+    builder.set_precision(Precision::Auto).set_viewport_width(1e-18).set_max_iter(50);
+
+    MuImage image(8, 8);
+    EXPECT_NO_THROW(builder.build().render(image));
+}
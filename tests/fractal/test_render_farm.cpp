@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <signal.h>
+#include <unistd.h>
+
+#include "fractal/animation_plan.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/render_farm.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+namespace fs = std::filesystem;
+
+static const int WIDTH = 200;
+static const int HEIGHT = 120;
+
+static const FractalKeyframe SEAHORSE { { 0.05, Complex::Algebraic(-0.745, 0.12) }, { 500, 2.0 }, Complex::Zero() };
+
+// what every worker runs, also used to render the reference in-process
+static void render_job(const FarmJob& job, EscapeField& field) {
+    FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_viewport(job.key.viewport)
+            .set_max_iter(job.key.config.max_iter)
+            .set_escape_radius(job.key.config.escape_radius)
+            .set_initial_func(formulas::Zero{})
+            .set_param_func(formulas::Identity{})
+            .set_kernel(Kernel::Simd)
+            .set_cycle_detection(true)
+            .build()
+            .render_field(field, job.mapping());
+}
+
+static EscapeField preview_of(const FractalKeyframe& key, int width, int height) {
+    FarmJob whole;
+    whole.key = key;
+    whole.frame_width = width;
+    whole.frame_height = height;
+    whole.region = { 0, 0, width, height };
+
+    EscapeField preview(width, height);
+    render_job(whole, preview);
+    return preview;
+}
+
+static void expect_matches_local_render(const FarmJob& job, const EscapeField& field) {
+    EscapeField local(job.region.width(), job.region.height());
+    render_job(job, local);
+
+    ASSERT_EQ(field.width(), local.width());
+    ASSERT_EQ(field.height(), local.height());
+    EXPECT_EQ(field.max_iter(), local.max_iter());
+    EXPECT_EQ(field.mu_data(), local.mu_data()) << "job " << job.id;
+}
+
+// marker file shared by the forked workers, so only the first attempt at a job dies
+class CrashMarker {
+public:
+    CrashMarker() : m_path(fs::temp_directory_path() / ("iheay_farm_crash_" + std::to_string(::getpid()))) {
+        fs::remove(m_path);
+    }
+
+    ~CrashMarker() { fs::remove(m_path); }
+
+    // true the first time any process asks
+    bool first() const {
+        if (fs::exists(m_path))
+            return false;
+        std::ofstream(m_path) << "crashed";
+        return true;
+    }
+
+private:
+    fs::path m_path;
+};
+
+TEST(RenderFarmTest, TilesMatchLocalRender) {
+    RenderFarm farm(render_job, { 3, 3 });
+
+    const std::vector<FarmJob> jobs = tile_jobs(SEAHORSE, WIDTH, HEIGHT, 64, preview_of(SEAHORSE, 50, 30));
+    ASSERT_EQ(jobs.size(), 8u);
+
+    EscapeField frame(WIDTH, HEIGHT);
+    std::multiset<int> seen;
+
+    const FarmStats stats = farm.run(jobs, [&](const FarmJob& job, const EscapeField& field) {
+        seen.insert(job.id);
+        expect_matches_local_render(job, field);
+        frame.copy_region(field, 0, 0, job.region.x0, job.region.y0, job.region.width(), job.region.height());
+    });
+
+    EXPECT_EQ(stats.jobs, 8);
+    EXPECT_EQ(stats.reassigned, 0);
+    EXPECT_EQ(seen.size(), 8u);
+    EXPECT_EQ(std::set<int>(seen.begin(), seen.end()).size(), 8u);
+
+    // the tiles add up to the frame
+    EscapeField whole(WIDTH, HEIGHT);
+    render_job(FarmJob { 0, 0, SEAHORSE, WIDTH, HEIGHT, { 0, 0, WIDTH, HEIGHT } }, whole);
+
+    int differing = 0;
+    for (int y = 0; y < HEIGHT; ++y)
+        for (int x = 0; x < WIDTH; ++x)
+            differing += std::abs(frame.mu(x, y) - whole.mu(x, y)) > 1e-6;
+    EXPECT_LE(differing, WIDTH * HEIGHT / 1000);
+}
+
+TEST(RenderFarmTest, AnimationFramesFromPlan) {
+    std::vector<FractalKeyframe> keys;
+    for (int i = 0; i < 6; ++i) {
+        FractalKeyframe key = SEAHORSE;
+        key.viewport.width = 3.0 * std::pow(0.3, i);
+        keys.push_back(key);
+    }
+
+    PlanOptions options;
+    options.probe_max_iter = 2000;
+    const AnimationPlan plan = plan_animation(keys, 80, 60,
+        [](const FractalKeyframe& key, EscapeField& field) {
+            render_job(FarmJob { 0, 0, key, field.width(), field.height(), { 0, 0, field.width(), field.height() } }, field);
+        }, options);
+
+    RenderFarm farm(render_job, { 2, 3 });
+
+    std::vector<int> frames;
+    farm.run(frame_jobs(plan, 80, 60), [&](const FarmJob& job, const EscapeField& field) {
+        frames.push_back(job.frame);
+        EXPECT_EQ(job.key.config.max_iter, plan.frames[job.frame].key.config.max_iter);
+        expect_matches_local_render(job, field);
+    });
+
+    std::sort(frames.begin(), frames.end());
+    EXPECT_EQ(frames, std::vector<int>({ 0, 1, 2, 3, 4, 5 }));
+}
+
+TEST(RenderFarmTest, KilledWorkerJobIsReassigned) {
+    const CrashMarker marker;
+
+    RenderFarm farm([&](const FarmJob& job, EscapeField& field) {
+        if (job.id == 2 && marker.first())
+            ::raise(SIGKILL);
+        render_job(job, field);
+    }, { 3, 3 });
+
+    std::multiset<int> seen;
+    const FarmStats stats = farm.run(tile_jobs(SEAHORSE, WIDTH, HEIGHT, 64, preview_of(SEAHORSE, 50, 30)),
+        [&](const FarmJob& job, const EscapeField& field) {
+            seen.insert(job.id);
+            expect_matches_local_render(job, field);
+        });
+
+    EXPECT_EQ(stats.reassigned, 1);
+    EXPECT_EQ(stats.respawned, 1);
+    EXPECT_EQ(seen.size(), 8u);
+    EXPECT_EQ(seen.count(2), 1u);
+}
+
+TEST(RenderFarmTest, SurvivesWorkersKilledFromOutside) {
+    RenderFarm farm(render_job, { 3, 3 });
+
+    const std::vector<int> pids = farm.worker_pids();
+    bool killed = false;
+    std::set<int> seen;
+
+    const FarmStats stats = farm.run(tile_jobs(SEAHORSE, WIDTH, HEIGHT, 32, preview_of(SEAHORSE, 50, 30)),
+        [&](const FarmJob& job, const EscapeField& field) {
+            if (!killed) {
+                ::kill(pids[0], SIGKILL);
+                ::kill(pids[2], SIGKILL);
+                killed = true;
+            }
+            EXPECT_TRUE(seen.insert(job.id).second);
+            expect_matches_local_render(job, field);
+        });
+
+    EXPECT_EQ(static_cast<long>(seen.size()), stats.jobs);
+    EXPECT_EQ(stats.respawned, 2);
+    EXPECT_NE(farm.worker_pids()[0], pids[0]);
+}
+
+TEST(RenderFarmTest, FailingJobStopsRunAndFarmStaysUsable) {
+    RenderFarm farm([](const FarmJob& job, EscapeField& field) {
+        if (job.frame == 1)
+            throw std::runtime_error("bad frame");
+        render_job(job, field);
+    }, { 2, 2 });
+
+    std::vector<FarmJob> jobs = tile_jobs(SEAHORSE, WIDTH, HEIGHT, 64, preview_of(SEAHORSE, 50, 30));
+    jobs[3].frame = 1;
+
+    EXPECT_THROW(farm.run(jobs, [](const FarmJob&, const EscapeField&) {}), std::runtime_error);
+
+    jobs[3].frame = 0;
+    int received = 0;
+    farm.run(jobs, [&](const FarmJob&, const EscapeField&) { ++received; });
+    EXPECT_EQ(received, 8);
+}
+
+TEST(RenderFarmTest, TileCostFollowsPreviewIterations) {
+    const FractalKeyframe whole_set { { 3.0, Complex::Algebraic(-0.75, 0.0) }, { 300, 2.0 }, Complex::Zero() };
+    const EscapeField preview = preview_of(whole_set, 64, 48);
+
+    const std::vector<FarmJob> jobs = tile_jobs(whole_set, 256, 192, 64, preview);
+
+    double total = 0.0;
+    for (const FarmJob& job : jobs)
+        total += job.cost;
+
+    double expected = 0.0;
+    for (double mu : preview.mu_data())
+        expected += std::min(mu, 300.0) + 1.0;
+    EXPECT_DOUBLE_EQ(total, expected);
+
+    // the corner tile is far outside the set, the one left of center holds the main cardioid
+    auto cost_at = [&](int x, int y) {
+        for (const FarmJob& job : jobs)
+            if (job.region.x0 == x && job.region.y0 == y)
+                return job.cost;
+        return -1.0;
+    };
+    EXPECT_LT(cost_at(0, 0), cost_at(128, 64) / 10);
+}
+
+TEST(RenderFarmTest, RejectsInvalidOptions) {
+    EXPECT_THROW(RenderFarm(render_job, { 0, 3 }), std::runtime_error);
+    EXPECT_THROW(RenderFarm(nullptr, { 2, 3 }), std::runtime_error);
+}
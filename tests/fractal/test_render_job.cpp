@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+
+#include "fractal/render_job.hpp"
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+static std::vector<RenderJob> parse(const std::string& text) {
+    std::istringstream input(text);
+    return parse_jobs(input);
+}
+
+// message of the parse error, empty when the text parses
+static std::string parse_error(const std::string& text) {
+    try {
+        parse(text);
+    } catch (const std::runtime_error& e) {
+        return e.what();
+    }
+    return {};
+}
+
+TEST(RenderJob, ReadsEveryKey) {
+    const auto jobs = parse(
+        "# two jobs\n"
+        "[job]\n"
+        "output = a.bmp\n"
+        "\n"
+        "[job]   # julia still\n"
+        "formula = julia\n"
+        "julia_c = -0.8, 0.156\n"
+        "center = 0.5 -0.25\n"
+        "view_width = 1.5\n"
+        "max_iter = 800\n"
+        "escape_radius = 4\n"
+        "size = 320x200\n"
+        "supersampling = 3\n"
+        "cycle_detection = false\n"
+        "output = out/julia.bmp\n"
+    );
+
+    ASSERT_EQ(jobs.size(), 2u);
+
+    EXPECT_EQ(jobs[0].line, 2);
+    EXPECT_EQ(jobs[0].formula, JobFormula::Mandelbrot);
+    EXPECT_EQ(jobs[0].output_path(0), "a.bmp");
+    EXPECT_FALSE(jobs[0].animated());
+
+    const RenderJob& julia = jobs[1];
+    EXPECT_EQ(julia.line, 5);
+    EXPECT_EQ(julia.formula, JobFormula::Julia);
+    EXPECT_DOUBLE_EQ(julia.start.julia_c.real(), -0.8);
+    EXPECT_DOUBLE_EQ(julia.start.julia_c.imag(), 0.156);
+    EXPECT_DOUBLE_EQ(julia.start.viewport.center.real(), 0.5);
+    EXPECT_DOUBLE_EQ(julia.start.viewport.center.imag(), -0.25);
+    EXPECT_DOUBLE_EQ(julia.start.viewport.width, 1.5);
+    EXPECT_EQ(julia.start.config.max_iter, 800);
+    EXPECT_DOUBLE_EQ(julia.start.config.escape_radius, 4.0);
+    EXPECT_EQ(julia.width, 320);
+    EXPECT_EQ(julia.height, 200);
+    EXPECT_EQ(julia.supersampling, 3);
+    EXPECT_FALSE(julia.cycle_detection);
+    EXPECT_FALSE(julia.auto_max_iter);
+    EXPECT_EQ(julia.output_path(0), "out/julia.bmp");
+}
+
+TEST(RenderJob, AnimationInterpolatesFromStartToEnd) {
+    const auto jobs = parse(
+        "[job]\n"
+        "center = -0.75 0\n"
+        "view_width = 4\n"
+        "max_iter = 200\n"
+        "frames = 5\n"
+        "end_center = -0.5 0.5\n"
+        "end_view_width = 0.25\n"
+        "end_max_iter = 1000\n"
+        "output = zoom/{:03}.bmp\n"
+    );
+
+    ASSERT_EQ(jobs.size(), 1u);
+    const RenderJob& job = jobs[0];
+
+    EXPECT_TRUE(job.animated());
+    EXPECT_EQ(job.output_path(0), "zoom/000.bmp");
+    EXPECT_EQ(job.output_path(4), "zoom/004.bmp");
+
+    const FractalKeyframe first = job.keyframe(0);
+    const FractalKeyframe middle = job.keyframe(2);
+    const FractalKeyframe last = job.keyframe(4);
+
+    EXPECT_DOUBLE_EQ(first.viewport.width, 4.0);
+    EXPECT_EQ(first.config.max_iter, 200);
+    EXPECT_NEAR(last.viewport.width, 0.25, 1e-12);
+    EXPECT_DOUBLE_EQ(last.viewport.center.imag(), 0.5);
+    EXPECT_EQ(last.config.max_iter, 1000);
+
+    EXPECT_NEAR(middle.viewport.width, 1.0, 1e-12); // zoomed geometrically
+    EXPECT_EQ(middle.config.max_iter, 600);
+}
+
+TEST(RenderJob, EndValuesDefaultToStart) {
+    const auto jobs = parse(
+        "[job]\n"
+        "formula = julia\n"
+        "julia_c = 0.285 0.01\n"
+        "max_iter = auto\n"
+        "frames = 3\n"
+        "output = f{}.bmp\n"
+    );
+
+    ASSERT_EQ(jobs.size(), 1u);
+    const RenderJob& job = jobs[0];
+
+    EXPECT_TRUE(job.auto_max_iter);
+    EXPECT_DOUBLE_EQ(job.keyframe(2).viewport.width, job.start.viewport.width);
+    EXPECT_DOUBLE_EQ(job.keyframe(2).julia_c.real(), 0.285);
+    EXPECT_EQ(job.output_path(2), "f2.bmp");
+}
+
+TEST(RenderJob, ErrorsNameTheLine) {
+    EXPECT_NE(parse_error("[job]\noutput = a.bmp\nmax_iter = lots\n").find("line 3"), std::string::npos);
+    EXPECT_NE(parse_error("[job]\noutput = a.bmp\n\ncolour = red\n").find("line 4"), std::string::npos);
+    EXPECT_NE(parse_error("output = a.bmp\n").find("line 1"), std::string::npos);
+    EXPECT_NE(parse_error("[jobs]\n").find("line 1"), std::string::npos);
+    EXPECT_NE(parse_error("[job]\noutput = a.bmp\nsize = 100\n").find("line 3"), std::string::npos);
+    EXPECT_NE(parse_error("[job]\noutput = a.bmp\ncenter = 1\n").find("line 3"), std::string::npos);
+}
+
+TEST(RenderJob, RejectsIncompleteJobs) {
+    // whole-job checks report the [job] line
+    EXPECT_NE(parse_error("\n[job]\nsize = 64x64\n").find("line 2"), std::string::npos);
+    EXPECT_FALSE(parse_error("[job]\noutput = a.bmp\nsize = 1x64\n").empty());
+    EXPECT_FALSE(parse_error("[job]\noutput = a.bmp\nsupersampling = 0\n").empty());
+    EXPECT_FALSE(parse_error("[job]\noutput = a.bmp\nview_width = -1\n").empty());
+
+    // every frame of an animation needs its own file
+    EXPECT_FALSE(parse_error("[job]\nframes = 10\noutput = same.bmp\n").empty());
+    EXPECT_FALSE(parse_error("[job]\nframes = 10\noutput = bad_{:q}.bmp\n").empty());
+    EXPECT_TRUE(parse_error("[job]\nframes = 1\noutput = still.bmp\n").empty());
+}
+
+TEST(RenderJob, EmptyFileHasNoJobs) {
+    EXPECT_TRUE(parse("").empty());
+    EXPECT_TRUE(parse("# nothing to do\n\n").empty());
+}
+
+TEST(RenderJob, MissingFileThrows) {
+    EXPECT_THROW(load_jobs("/nonexistent/jobs.txt"), std::runtime_error);
+}
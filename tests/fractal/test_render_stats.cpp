@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/render_stats.hpp"
+#include "utils/thread_pool.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+// CI also runs it in a whole build configured with -DIHEAY_RENDER_STATS=OFF
+
+static const int WIDTH = 200;
+static const int HEIGHT = 130;
+
+static auto mandelbrot() {
+    return FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_viewport({ 2.5, Complex::Algebraic(-0.6, 0.3) })
+            .set_max_iter(300)
+            .set_initial_func(formulas::Zero{})
+            .set_param_func(formulas::Identity{});
+}
+
+static PixelCounts count_image(const MuImage& image, int max_iter) {
+    PixelCounts counts;
+    for (int y = 0; y < image.height(); ++y)
+        for (int x = 0; x < image.width(); ++x)
+            (image.get_pixel(x, y) < max_iter ? counts.escaped : counts.interior) += 1;
+    return counts;
+}
+
+static long thread_pixels(const RenderStats& stats) {
+    long pixels = 0;
+    for (const ThreadStats& thread : stats.threads)
+        pixels += thread.pixels;
+    return pixels;
+}
+
+// renders with and without stats, the images must match and the stats must add up
+template <typename Builder>
+static RenderStats render_both(const Builder& builder) {
+    const auto renderer = builder.build();
+
+    MuImage plain(WIDTH, HEIGHT);
+    renderer.render(plain);
+
+    MuImage counted(WIDTH, HEIGHT);
+    RenderStats stats;
+    renderer.render(counted, stats);
+
+    expect_same_images(plain, counted);
+
+    if constexpr (render_stats_enabled) {
+        EXPECT_TRUE(stats.enabled);
+
+        const PixelCounts expected = count_image(plain, renderer.config().max_iter);
+        EXPECT_EQ(stats.total.escaped, expected.escaped);
+        EXPECT_EQ(stats.total.interior, expected.interior);
+        EXPECT_EQ(stats.total.pixels(), static_cast<long>(WIDTH) * HEIGHT);
+        EXPECT_EQ(thread_pixels(stats), stats.total.pixels());
+        EXPECT_GE(stats.total.iterations, stats.total.escaped);
+    }
+
+    return stats;
+}
+
+TEST(RenderStatsTest, CountsEveryPathWithoutChangingTheImage) {
+    render_both(mandelbrot());
+    render_both(mandelbrot().set_kernel(Kernel::Simd));
+    render_both(mandelbrot().set_kernel(Kernel::Simd).set_precision(Precision::Float));
+    render_both(mandelbrot().set_precision(Precision::DoubleDouble));
+    render_both(mandelbrot().set_precision(Precision::Perturbation));
+    render_both(mandelbrot().set_strategy(Strategy::Subdivision));
+    render_both(mandelbrot().set_cycle_detection(true));
+    render_both(mandelbrot().set_schedule(Schedule::WorkStealing).set_thread_pool(std::make_shared<iheay::utils::WorkStealingPool>(3)));
+    render_both(mandelbrot().set_kernel(Kernel::Simd).set_schedule(Schedule::WorkStealing));
+}
+
+TEST(RenderStatsTest, SplitsCountsIntoClippedTiles) {
+    if constexpr (!render_stats_enabled)
+        GTEST_SKIP() << "render stats compiled out";
+
+    const RenderStats stats = render_both(mandelbrot());
+
+    ASSERT_EQ(stats.tile_size, default_tile_size);
+    ASSERT_EQ(stats.tiles_x, 4);
+    ASSERT_EQ(stats.tiles_y, 3);
+    ASSERT_EQ(stats.tiles.size(), 12u);
+
+    EXPECT_EQ(stats.tile(0, 0).pixels(), 64 * 64);
+    EXPECT_EQ(stats.tile(3, 0).pixels(), (WIDTH - 3 * 64) * 64);
+    EXPECT_EQ(stats.tile(3, 2).pixels(), (WIDTH - 3 * 64) * (HEIGHT - 2 * 64));
+
+    PixelCounts sum;
+    for (const PixelCounts& tile : stats.tiles)
+        sum += tile;
+    EXPECT_EQ(sum.escaped, stats.total.escaped);
+    EXPECT_EQ(sum.interior, stats.total.interior);
+    EXPECT_EQ(sum.iterations, stats.total.iterations);
+}
+
+TEST(RenderStatsTest, NamesThePathAndTimesItsThreads) {
+    if constexpr (!render_stats_enabled)
+        GTEST_SKIP() << "render stats compiled out";
+
+    const RenderStats stats = render_both(mandelbrot().set_kernel(Kernel::Simd).set_precision(Precision::Double));
+
+    ASSERT_EQ(stats.phases.size(), 1u);
+    EXPECT_EQ(stats.phases[0].name, "simd double");
+    EXPECT_GT(stats.phases[0].wall_seconds, 0.0);
+    EXPECT_GE(stats.wall_seconds, stats.phases[0].wall_seconds);
+
+    ASSERT_FALSE(stats.threads.empty());
+    for (const ThreadStats& thread : stats.threads) {
+        EXPECT_GE(thread.busy_seconds, 0.0);
+        EXPECT_LE(thread.busy_seconds, stats.phases[0].wall_seconds);
+        EXPECT_NEAR(thread.busy_seconds + thread.idle_seconds, stats.phases[0].wall_seconds, 1e-9);
+    }
+    EXPECT_GT(stats.utilization(), 0.0);
+    EXPECT_LE(stats.utilization(), 1.0);
+}
+
+TEST(RenderStatsTest, CountsInteriorIterations) {
+    if constexpr (!render_stats_enabled)
+        GTEST_SKIP() << "render stats compiled out";
+
+    // the cardioid and the period-2 bulb are settled without iterating
+    const ViewportMapping mapping = ViewportMapping::from({ 2.5, Complex::Algebraic(-0.6, 0.3) }, WIDTH, HEIGHT);
+    long settled = 0;
+    for (int y = 0; y < HEIGHT; ++y) {
+        for (int x = 0; x < WIDTH; ++x) {
+            const Complex c = mapping.pixel(x, y);
+            settled += in_main_cardioid(c.real(), c.imag()) || in_period2_bulb(c.real(), c.imag());
+        }
+    }
+
+    for (Kernel kernel : { Kernel::Scalar, Kernel::Simd }) {
+        const RenderStats stats = render_both(mandelbrot().set_kernel(kernel));
+        EXPECT_GT(stats.total.interior, settled);
+        EXPECT_EQ(stats.total.interior_iterations, (stats.total.interior - settled) * 300);
+    }
+
+    // with cycle detection an interior orbit counts up to where the check stopped it,
+    // the same in the scalar loop and in the lanes
+    const RenderStats scalar = render_both(mandelbrot().set_cycle_detection(true));
+    const RenderStats lanes = render_both(mandelbrot().set_kernel(Kernel::Simd).set_cycle_detection(true));
+
+    EXPECT_GT(scalar.total.interior_iterations, 0);
+    EXPECT_LT(scalar.total.interior_iterations, (scalar.total.interior - settled) * 300);
+    EXPECT_EQ(lanes.total.interior_iterations, scalar.total.interior_iterations);
+}
+
+TEST(RenderStatsTest, UntimedPathsReportPixelsWithoutBusyTime) {
+    if constexpr (!render_stats_enabled)
+        GTEST_SKIP() << "render stats compiled out";
+
+    const RenderStats stats = render_both(mandelbrot().set_strategy(Strategy::Subdivision));
+
+    ASSERT_EQ(stats.phases.size(), 1u);
+    EXPECT_EQ(stats.phases[0].name, "double subdivision");
+
+    for (const ThreadStats& thread : stats.threads) {
+        EXPECT_EQ(thread.busy_seconds, 0.0);
+        EXPECT_EQ(thread.idle_seconds, 0.0);
+    }
+    EXPECT_EQ(stats.utilization(), 0.0);
+}
+
+TEST(RenderStatsTest, FieldStatsMatchTheField) {
+    const auto renderer = mandelbrot().set_kernel(Kernel::Simd).set_cycle_detection(true).build();
+
+    EscapeField plain(WIDTH, HEIGHT);
+    renderer.render_field(plain);
+
+    EscapeField counted(WIDTH, HEIGHT);
+    RenderStats stats;
+    renderer.render_field(counted, stats);
+
+    EXPECT_EQ(plain.mu_data(), counted.mu_data());
+
+    if constexpr (render_stats_enabled) {
+        long interior = 0;
+        for (double mu : counted.mu_data())
+            interior += mu >= counted.max_iter();
+
+        EXPECT_EQ(stats.total.interior, interior);
+        EXPECT_EQ(stats.total.escaped, static_cast<long>(WIDTH) * HEIGHT - interior);
+    } else {
+        EXPECT_FALSE(stats.enabled);
+        EXPECT_TRUE(stats.tiles.empty());
+    }
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/iteration_state.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+static const int WIDTH = 120;
+static const int HEIGHT = 80;
+
+static auto seahorse_builder(Kernel kernel, bool cycle_detection) {
+    return FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_viewport_width(0.02)
+            .set_viewport_center(Complex::Algebraic(-0.745, 0.12))
+            .set_initial_func(formulas::Zero{})
+            .set_param_func(formulas::Identity{})
+            .set_kernel(kernel)
+            .set_precision(Precision::Double)
+            .set_cycle_detection(cycle_detection);
+}
+
+static void expect_same_fields(const EscapeField& a, const EscapeField& b) {
+    ASSERT_EQ(a.max_iter(), b.max_iter());
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            ASSERT_EQ(a.mu(x, y), b.mu(x, y)) << "pixel " << x << ", " << y;
+            if (a.channels().final_z)
+                ASSERT_EQ(a.final_z(x, y), b.final_z(x, y)) << "pixel " << x << ", " << y;
+        }
+    }
+}
+
+TEST(ResumableTest, DeepeningMatchesFreshRender) {
+    for (Kernel kernel : { Kernel::Scalar, Kernel::Simd }) {
+        for (bool cycle_detection : { false, true }) {
+            auto builder = seahorse_builder(kernel, cycle_detection);
+
+            EscapeField deepened(WIDTH, HEIGHT, { .final_z = true });
+            IterationState state;
+            for (int max_iter : { 100, 400, 1600 })
+                builder.set_max_iter(max_iter).build().render_field(deepened, state);
+
+            EscapeField fresh(WIDTH, HEIGHT, { .final_z = true });
+            builder.set_max_iter(1600).build().render_field(fresh);
+
+            expect_same_fields(deepened, fresh);
+        }
+    }
+}
+
+TEST(ResumableTest, FirstPassMatchesRenderField) {
+    auto builder = seahorse_builder(Kernel::Simd, true).set_max_iter(300);
+
+    EscapeField resumable(WIDTH, HEIGHT);
+    IterationState state;
+    const ResumeStats stats = builder.build().render_field(resumable, state);
+
+    EscapeField plain(WIDTH, HEIGHT);
+    builder.build().render_field(plain);
+
+    expect_same_fields(resumable, plain);
+    // the main cardioid is settled without iterating
+    EXPECT_FALSE(stats.resumed);
+    EXPECT_GT(stats.iterated, 0);
+    EXPECT_LT(stats.iterated, WIDTH * HEIGHT);
+    EXPECT_EQ(state.max_iter, 300);
+    EXPECT_EQ(state.running(), stats.running);
+}
+
+TEST(ResumableTest, LaterPassesOnlyIterateRunningOrbits) {
+    auto builder = seahorse_builder(Kernel::Simd, true);
+
+    EscapeField field(WIDTH, HEIGHT);
+    IterationState state;
+
+    const ResumeStats first = builder.set_max_iter(100).build().render_field(field, state);
+    const ResumeStats second = builder.set_max_iter(1000).build().render_field(field, state);
+
+    EXPECT_GT(first.running, 0);
+    EXPECT_LT(first.running, WIDTH * HEIGHT);
+    EXPECT_TRUE(second.resumed);
+    EXPECT_EQ(second.iterated, first.running);
+    EXPECT_LE(second.running, first.running);
+
+    // every kept orbit is a pixel that is interior at the current max_iter
+    for (int index : state.pixel)
+        EXPECT_EQ(field.mu(index % WIDTH, index / WIDTH), 1000.0);
+}
+
+TEST(ResumableTest, StateOfAnotherFrameStartsOver) {
+    auto builder = seahorse_builder(Kernel::Scalar, false);
+
+    EscapeField field(WIDTH, HEIGHT);
+    IterationState state;
+    builder.set_max_iter(200).build().render_field(field, state);
+
+    // a different viewport
+    builder.set_viewport_width(0.03);
+    const ResumeStats moved = builder.set_max_iter(400).build().render_field(field, state);
+    EXPECT_FALSE(moved.resumed);
+
+    EscapeField fresh(WIDTH, HEIGHT);
+    builder.build().render_field(fresh);
+    expect_same_fields(field, fresh);
+
+    // a shallower pass can't reuse the deeper orbits
+    const ResumeStats shallower = builder.set_max_iter(300).build().render_field(field, state);
+    EXPECT_FALSE(shallower.resumed);
+    EXPECT_EQ(state.max_iter, 300);
+
+    // another formula on the same frame
+    auto julia = builder.set_param_func(formulas::Constant{ Complex::Algebraic(-0.8, 0.156) });
+    const ResumeStats other = julia.set_max_iter(600).build().render_field(field, state);
+    EXPECT_FALSE(other.resumed);
+
+    EscapeField julia_fresh(WIDTH, HEIGHT);
+    julia.build().render_field(julia_fresh);
+    expect_same_fields(field, julia_fresh);
+
+    // the same functors carrying another c
+    auto other_c = julia.set_param_func(formulas::Constant{ Complex::Algebraic(-0.4, 0.6) });
+    EXPECT_FALSE(other_c.set_max_iter(800).build().render_field(field, state).resumed);
+    EXPECT_TRUE(other_c.set_max_iter(900).build().render_field(field, state).resumed);
+}
+
+TEST(ResumableTest, RejectsDerivativeChannels) {
+    EscapeField field(WIDTH, HEIGHT, { .distance = true });
+    IterationState state;
+
+    EXPECT_THROW(seahorse_builder(Kernel::Scalar, false).set_max_iter(100).build().render_field(field, state), std::runtime_error);
+}
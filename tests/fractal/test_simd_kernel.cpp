@@ -0,0 +1,272 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <random>
+
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/simd/quadratic_kernel.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+struct SpanResult {
+    std::vector<double> out_real;
+    std::vector<double> out_imag;
+    std::vector<int> iter;
+    std::vector<int> cycle_iter;
+};
+
+static SpanResult run_span(const std::vector<Complex>& z, const std::vector<Complex>& c, int max_iter, simd::Isa isa, double cycle_tolerance_sq = 0.0) {
+    const int n = static_cast<int>(z.size());
+
+    std::vector<double> zr(n), zi(n), cr(n), ci(n);
+    for (int i = 0; i < n; ++i) {
+        zr[i] = z[i].real();
+        zi[i] = z[i].imag();
+        cr[i] = c[i].real();
+        ci[i] = c[i].imag();
+    }
+
+    SpanResult res { std::vector<double>(n), std::vector<double>(n), std::vector<int>(n), std::vector<int>(n) };
+
+    simd::QuadraticSpan span {
+        zr.data(), zi.data(), cr.data(), ci.data(),
+        res.out_real.data(), res.out_imag.data(), res.iter.data(),
+        n, res.cycle_iter.data()
+    };
+
+    simd::iterate_quadratic(span, max_iter, 4.0, isa, cycle_tolerance_sq);
+    return res;
+}
+
+TEST(SimdKernelTest, LaneCounts) {
+    EXPECT_EQ(simd::lane_count(simd::Isa::Scalar), 1);
+    EXPECT_EQ(simd::lane_count(simd::Isa::Avx2), 4);
+    EXPECT_EQ(simd::lane_count(simd::Isa::Avx512), 8);
+
+    EXPECT_EQ(simd::lane_count(simd::Isa::Scalar, true), 1);
+    EXPECT_EQ(simd::lane_count(simd::Isa::Avx2, true), 8);
+    EXPECT_EQ(simd::lane_count(simd::Isa::Avx512, true), 16);
+}
+
+TEST(SimdKernelTest, EveryIsaMatchesScalarLoop) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> dist(-2.0, 2.0);
+
+    // odd count, so the last lanes run out of pixels before the others
+    const int n = 1001;
+    std::vector<Complex> z(n), c(n);
+    for (int i = 0; i < n; ++i) {
+        z[i] = (i % 3 == 0) ? Complex::Algebraic(dist(rng), dist(rng)) : Complex::Zero();
+        c[i] = Complex::Algebraic(dist(rng) * 0.7, dist(rng) * 0.7);
+    }
+
+    const SpanResult reference = run_span(z, c, 500, simd::Isa::Scalar);
+
+    for (simd::Isa isa : { simd::Isa::Avx2, simd::Isa::Avx512 }) {
+        const SpanResult res = run_span(z, c, 500, isa);
+
+        for (int i = 0; i < n; ++i) {
+            ASSERT_EQ(res.iter[i], reference.iter[i]) << "pixel " << i;
+            ASSERT_EQ(res.out_real[i], reference.out_real[i]) << "pixel " << i;
+            ASSERT_EQ(res.out_imag[i], reference.out_imag[i]) << "pixel " << i;
+        }
+    }
+}
+
+TEST(SimdKernelTest, CycleDetectionMatchesScalarLoop) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> dist(-2.0, 2.0);
+
+    const int n = 777;
+    std::vector<Complex> z(n, Complex::Zero()), c(n);
+    for (int i = 0; i < n; ++i)
+        c[i] = Complex::Algebraic(dist(rng) * 0.8, dist(rng) * 0.6);
+
+    const SpanResult reference = run_span(z, c, 2000, simd::Isa::Scalar, 1e-20);
+
+    int cycled = 0;
+    for (int i = 0; i < n; ++i) {
+        cycled += reference.cycle_iter[i] > 0;
+
+        // the check stops an orbit before the limit, and only an interior one
+        ASSERT_LT(reference.cycle_iter[i], 2000) << "pixel " << i;
+        if (reference.cycle_iter[i] > 0)
+            ASSERT_EQ(reference.iter[i], 2000) << "pixel " << i;
+    }
+    EXPECT_GT(cycled, 0);
+
+    for (simd::Isa isa : { simd::Isa::Avx2, simd::Isa::Avx512 }) {
+        const SpanResult res = run_span(z, c, 2000, isa, 1e-20);
+
+        for (int i = 0; i < n; ++i) {
+            ASSERT_EQ(res.iter[i], reference.iter[i]) << "pixel " << i;
+            ASSERT_EQ(res.cycle_iter[i], reference.cycle_iter[i]) << "pixel " << i;
+            ASSERT_EQ(res.out_real[i], reference.out_real[i]) << "pixel " << i;
+            ASSERT_EQ(res.out_imag[i], reference.out_imag[i]) << "pixel " << i;
+        }
+    }
+}
+
+TEST(SimdKernelTest, FloatLanesMatchScalarFloatLoop) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+
+    const int n = 1003;
+    std::vector<float> zr(n, 0.0f), zi(n, 0.0f), cr(n), ci(n);
+    for (int i = 0; i < n; ++i) {
+        cr[i] = dist(rng) * 0.7f;
+        ci[i] = dist(rng) * 0.7f;
+    }
+
+    auto run = [&](simd::Isa isa, std::vector<float>& out_real, std::vector<float>& out_imag, std::vector<int>& iter) {
+        out_real.assign(n, 0.0f);
+        out_imag.assign(n, 0.0f);
+        iter.assign(n, 0);
+
+        simd::QuadraticSpanF span {
+            zr.data(), zi.data(), cr.data(), ci.data(),
+            out_real.data(), out_imag.data(), iter.data(),
+            n
+        };
+        simd::iterate_quadratic(span, 500, 4.0, isa);
+    };
+
+    std::vector<float> ref_real, ref_imag;
+    std::vector<int> ref_iter;
+    run(simd::Isa::Scalar, ref_real, ref_imag, ref_iter);
+
+    for (simd::Isa isa : { simd::Isa::Avx2, simd::Isa::Avx512 }) {
+        std::vector<float> out_real, out_imag;
+        std::vector<int> iter;
+        run(isa, out_real, out_imag, iter);
+
+        for (int i = 0; i < n; ++i) {
+            ASSERT_EQ(iter[i], ref_iter[i]) << "pixel " << i;
+            ASSERT_EQ(out_real[i], ref_real[i]) << "pixel " << i;
+            ASSERT_EQ(out_imag[i], ref_imag[i]) << "pixel " << i;
+        }
+    }
+}
+
+TEST(SimdKernelTest, SpanShorterThanLanes) {
+    std::vector<Complex> z { Complex::Zero(), Complex::Zero() };
+    std::vector<Complex> c { Complex::Algebraic(1.0, 1.0), Complex::Zero() };
+
+    const SpanResult res = run_span(z, c, 100, simd::detect_isa());
+
+    EXPECT_EQ(res.iter[0], 2);
+    EXPECT_EQ(res.iter[1], 100);
+}
+
+TEST(SimdKernelTest, MandelbrotRenderMatchesScalar) {
+    auto builder =
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_viewport_width(3)
+                .set_viewport_center(-0.75)
+                .set_max_iter(300)
+                .set_initial_func(formulas::Zero{})
+                .set_param_func(formulas::Identity{});
+
+    MuImage scalar(123, 77);
+    MuImage vectorized(123, 77);
+
+    // precision pinned to Double, the comparison is exact whatever Auto would pick
+    builder.set_kernel(Kernel::Scalar).build().render(scalar);
+    builder.set_kernel(Kernel::Simd).set_precision(Precision::Double).build().render(vectorized);
+
+    expect_same_images(scalar, vectorized);
+}
+
+TEST(SimdKernelTest, JuliaRenderMatchesScalar) {
+    auto builder =
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_max_iter(300)
+                .set_param_func(formulas::Constant{ Complex::Algebraic(-0.8, 0.156) });
+
+    MuImage scalar(90, 90);
+    MuImage vectorized(90, 90);
+
+    // precision pinned to Double, the comparison is exact whatever Auto would pick
+    builder.set_kernel(Kernel::Scalar).build().render(scalar);
+    builder.set_kernel(Kernel::Simd).set_precision(Precision::Double).build().render(vectorized);
+
+    expect_same_images(scalar, vectorized);
+}
+
+TEST(SimdKernelTest, SimdRequiresBuiltinFormula) {
+    auto builder =
+        FractalRendererBuilder<MuColorizer>
+            ::get_builder()
+                .set_iteration_func([](auto& z, auto& c) { return z * z * z + c; });
+
+    builder.set_kernel(Kernel::Simd);
+    EXPECT_THROW(builder.build(), std::runtime_error);
+}
+
+TEST(SimdKernelTest, ResumedSpanMatchesUninterruptedRun) {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> dist(-2.0, 2.0);
+
+    const int n = 901;
+    std::vector<Complex> z(n, Complex::Zero()), c(n);
+    std::vector<double> zr(n, 0.0), zi(n, 0.0), cr(n), ci(n);
+    for (int i = 0; i < n; ++i) {
+        c[i] = Complex::Algebraic(dist(rng) * 0.8, dist(rng) * 0.6);
+        cr[i] = c[i].real();
+        ci[i] = c[i].imag();
+    }
+
+    for (simd::Isa isa : { simd::Isa::Scalar, simd::Isa::Avx2, simd::Isa::Avx512 }) {
+        const SpanResult direct = run_span(z, c, 1500, isa, 1e-20);
+
+        // 100 iterations, then the orbits still running continue from where they stopped
+        std::vector<double> out_real(n), out_imag(n), saved_real(n), saved_imag(n);
+        std::vector<int> iter(n);
+        std::vector<unsigned char> cycled(n);
+
+        simd::QuadraticSpan first { zr.data(), zi.data(), cr.data(), ci.data(), out_real.data(), out_imag.data(), iter.data(), n };
+        first.out_saved_real = saved_real.data();
+        first.out_saved_imag = saved_imag.data();
+        first.cycled = cycled.data();
+        simd::iterate_quadratic(first, 100, 4.0, isa, 1e-20);
+
+        std::vector<int> running;
+        std::vector<double> rzr, rzi, rcr, rci, rsr, rsi;
+        for (int i = 0; i < n; ++i) {
+            // escaped and cycled pixels are final after the first span
+            if (iter[i] < 100 || cycled[i]) {
+                ASSERT_EQ(cycled[i] ? 1500 : iter[i], direct.iter[i]) << "pixel " << i;
+                continue;
+            }
+            running.push_back(i);
+            rzr.push_back(out_real[i]);
+            rzi.push_back(out_imag[i]);
+            rcr.push_back(cr[i]);
+            rci.push_back(ci[i]);
+            rsr.push_back(saved_real[i]);
+            rsi.push_back(saved_imag[i]);
+        }
+        ASSERT_GT(running.size(), 0u);
+
+        const int m = static_cast<int>(running.size());
+        std::vector<double> resumed_real(m), resumed_imag(m);
+        std::vector<int> resumed_iter(m);
+
+        simd::QuadraticSpan second { rzr.data(), rzi.data(), rcr.data(), rci.data(),
+            resumed_real.data(), resumed_imag.data(), resumed_iter.data(), m };
+        second.start_iter = 100;
+        second.saved_real = rsr.data();
+        second.saved_imag = rsi.data();
+        simd::iterate_quadratic(second, 1500, 4.0, isa, 1e-20);
+
+        for (int j = 0; j < m; ++j) {
+            const int i = running[j];
+            ASSERT_EQ(resumed_iter[j], direct.iter[i]) << "pixel " << i;
+            ASSERT_EQ(resumed_real[j], direct.out_real[i]) << "pixel " << i;
+            ASSERT_EQ(resumed_imag[j], direct.out_imag[i]) << "pixel " << i;
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cmath>
+
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/subdivision.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+TEST(SubdivisionTest, MatchesBruteForceOnWholeSet) {
+    auto builder = mandelbrot_builder(-0.75, 3, 500);
+
+    MuImage brute(320, 240);
+    MuImage subdivided(320, 240);
+
+    builder.build().render(brute);
+    builder.set_strategy(Strategy::Subdivision).build().render(subdivided);
+
+    // interior is never filled into escaped areas, bands stay within one iteration
+    EXPECT_LT(mismatch_share(brute, subdivided, 1.0), 0.005);
+    EXPECT_LT(mismatch_share(brute, subdivided, 1e-2), 0.1);
+}
+
+TEST(SubdivisionTest, MatchesBruteForceOnZoomFrame) {
+    auto builder = mandelbrot_builder(Complex::Algebraic(-0.7436447860, 0.1318252536), 3e-5, 2000);
+
+    MuImage brute(192, 108);
+    MuImage subdivided(192, 108);
+
+    builder.build().render(brute);
+    builder.set_strategy(Strategy::Subdivision).build().render(subdivided);
+
+    EXPECT_LT(mismatch_share(brute, subdivided, 1.0), 0.005);
+}
+
+TEST(SubdivisionTest, InteriorIsFilledFromBorders) {
+    const int width = 200;
+    const int height = 100;
+    const int max_iter = 100;
+
+    std::atomic<long> calls = 0;
+    std::vector<double> mu;
+
+    const subdivision::Stats stats = subdivision::render(width, height, max_iter,
+        [&](int, int) { ++calls; return Escape { max_iter, static_cast<double>(max_iter) }; },
+        mu
+    );
+
+    EXPECT_EQ(stats.computed, calls);
+    EXPECT_EQ(stats.computed + stats.filled, width * height);
+    EXPECT_EQ(stats.computed, 2 * width + 2 * (height - 2));
+
+    for (double value : mu)
+        ASSERT_EQ(value, max_iter);
+}
+
+TEST(SubdivisionTest, EveryPixelIsComputedOnceWithoutUniformBorders) {
+    const int width = 37;
+    const int height = 23;
+
+    std::vector<int> calls(width * height, 0);
+    std::vector<double> mu;
+
+    const subdivision::Stats stats = subdivision::render(width, height, 100,
+        [&](int x, int y) {
+            ++calls[y * width + x];
+            return Escape { (x + y) % 7, static_cast<double>(x * 1000 + y) };
+        },
+        mu
+    );
+
+    EXPECT_EQ(stats.filled, 0);
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            ASSERT_EQ(calls[y * width + x], 1) << "at (" << x << ", " << y << ")";
+            ASSERT_EQ(mu[y * width + x], x * 1000 + y);
+        }
+    }
+}
+
+TEST(SubdivisionTest, DoubleDoublePathIsSubdividedToo) {
+    auto builder = mandelbrot_builder(Complex::Algebraic(-0.743643887037158, 0.131825904205311), 1e-15, 3000)
+        .set_precision(Precision::DoubleDouble);
+
+    MuImage brute(64, 48);
+    MuImage subdivided(64, 48);
+
+    builder.build().render(brute);
+    builder.set_strategy(Strategy::Subdivision).build().render(subdivided);
+
+    EXPECT_LT(mismatch_share(brute, subdivided, 1.0), 0.01);
+}
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/cached_renderer.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+static auto make_renderer() {
+    return FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_max_iter(300)
+            .set_initial_func(formulas::Zero{})
+            .set_param_func(formulas::Identity{})
+            .set_kernel(Kernel::Simd)
+            .build();
+}
+
+static std::shared_ptr<const EscapeField> make_tile(int size) {
+    return std::make_shared<EscapeField>(size, size);
+}
+
+static TileKey key(int64_t tx) {
+    return { 1, 0, tx, 0, 100, 2.0 };
+}
+
+// square viewport of size x size pixels whose pixel (0, 0) is grid pixel (gx, gy) of level `level`
+template <typename Renderer>
+static Viewport aligned_viewport(const CachedRenderer<Renderer>& cached, int level, int64_t gx, int64_t gy, int size) {
+    const double step = cached.level_step(level);
+    const double width = step * (size - 1);
+
+    return {
+        width,
+        Complex::Algebraic(gx * step + width / 2, -gy * step - width / 2)
+    };
+}
+
+TEST(TileCacheTest, EvictsLeastRecentlyUsed) {
+    const size_t tile_bytes = TileCache::tile_bytes(*make_tile(16));
+    TileCache cache(3 * tile_bytes);
+
+    for (int64_t tx = 0; tx < 3; ++tx)
+        cache.insert(key(tx), make_tile(16));
+
+    // touching tile 0 makes tile 1 the oldest
+    EXPECT_TRUE(cache.find(key(0)));
+    cache.insert(key(3), make_tile(16));
+
+    EXPECT_FALSE(cache.find(key(1)));
+    EXPECT_TRUE(cache.find(key(0)));
+    EXPECT_TRUE(cache.find(key(2)));
+    EXPECT_TRUE(cache.find(key(3)));
+
+    const TileCache::Stats stats = cache.stats();
+    EXPECT_EQ(stats.hits, 4);
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.evictions, 1);
+    EXPECT_EQ(stats.tiles, 3u);
+    EXPECT_EQ(stats.bytes, 3 * tile_bytes);
+}
+
+TEST(TileCacheTest, KeyIncludesMaxIter) {
+    TileCache cache(1 << 20);
+    cache.insert(key(0), make_tile(8));
+
+    TileKey other = key(0);
+    other.max_iter = 200;
+
+    EXPECT_FALSE(cache.find(other));
+    EXPECT_TRUE(cache.find(key(0)));
+}
+
+TEST(TileCacheTest, FormulaHashIsFixed) {
+    // stored tiles are found by it, the published FNV-1a 64 values pin it across builds
+    EXPECT_EQ(formula_hash(""), 0xcbf29ce484222325ull);
+    EXPECT_EQ(formula_hash("a"), 0xaf63dc4c8601ec8cull);
+    EXPECT_EQ(formula_hash("foobar"), 0x85944171f73967e8ull);
+    EXPECT_NE(formula_hash("mandelbrot"), formula_hash("julia"));
+}
+
+TEST(TileCacheTest, OversizedTileIsNotKept) {
+    TileCache cache(1024);
+    cache.insert(key(0), make_tile(64));
+
+    EXPECT_EQ(cache.stats().tiles, 0u);
+    EXPECT_FALSE(cache.find(key(0)));
+}
+
+TEST(CachedRendererTest, LevelFollowsPixelStep) {
+    CachedRenderer cached(make_renderer(), "mandelbrot", std::make_shared<TileCache>(1 << 20), 32);
+
+    EXPECT_EQ(cached.level_for(1.0), 0);
+    EXPECT_EQ(cached.level_for(cached.level_step(3)), 3);
+    EXPECT_EQ(cached.level_for(cached.level_step(3) * 0.9), 4);
+    EXPECT_EQ(cached.level_step(1), cached.level_step(0) / 2);
+}
+
+TEST(CachedRendererTest, AlignedViewportMatchesDirectRender) {
+    CachedRenderer cached(make_renderer(), "mandelbrot", std::make_shared<TileCache>(64 << 20), 32);
+
+    const int level = 4;
+    const int64_t gx = -6 * 32 - 5;
+    const int64_t gy = -2 * 32 + 11;
+    const Viewport viewport = aligned_viewport(cached, level, gx, gy, 100);
+
+    EscapeField from_tiles(100, 100);
+    cached.render_field(from_tiles, viewport);
+
+    EXPECT_EQ(cached.last_stats().level, level);
+    EXPECT_EQ(cached.last_stats().tiles, 4 * 4);
+    EXPECT_EQ(from_tiles.max_iter(), 300);
+
+    const double step = cached.level_step(level);
+    EscapeField direct(100, 100);
+    make_renderer().render_field(direct, { gx * step, -gy * step, step, step });
+
+    // tile pixels are laid out from the tile corner, so a few boundary pixels may round differently
+    int mismatches = 0;
+    for (int y = 0; y < 100; ++y)
+        for (int x = 0; x < 100; ++x)
+            mismatches += std::abs(from_tiles.mu(x, y) - direct.mu(x, y)) > 1e-6;
+
+    EXPECT_LT(mismatches, 100);
+}
+
+TEST(CachedRendererTest, RepeatedAndOverlappingViewsHitTheCache) {
+    auto cache = std::make_shared<TileCache>(64 << 20);
+    CachedRenderer cached(make_renderer(), "mandelbrot", cache, 32);
+
+    const Viewport viewport = aligned_viewport(cached, 3, -64, -32, 64);
+
+    EscapeField first(64, 64);
+    cached.render_field(first, viewport);
+    EXPECT_EQ(cached.last_stats().rendered, 4);
+
+    EscapeField second(64, 64);
+    cached.render_field(second, viewport);
+    EXPECT_EQ(cached.last_stats().rendered, 0);
+    EXPECT_EQ(second.mu_data(), first.mu_data());
+
+    // half a tile to the right: two of the six tiles are new
+    EscapeField moved(64, 64);
+    cached.render_field(moved, aligned_viewport(cached, 3, -48, -32, 64));
+    EXPECT_EQ(cached.last_stats().tiles, 6);
+    EXPECT_EQ(cached.last_stats().rendered, 2);
+
+    const TileCache::Stats stats = cache->stats();
+    EXPECT_EQ(stats.misses, 6);
+    EXPECT_EQ(stats.hits, 8);
+    EXPECT_EQ(stats.tiles, 6u);
+}
+
+TEST(CachedRendererTest, BudgetBoundsHeldBytes) {
+    const size_t tile_bytes = TileCache::tile_bytes(EscapeField(32, 32));
+    auto cache = std::make_shared<TileCache>(3 * tile_bytes);
+    CachedRenderer cached(make_renderer(), "mandelbrot", cache, 32);
+
+    EscapeField field(64, 64);
+    cached.render_field(field, aligned_viewport(cached, 3, -64, -32, 64));
+
+    EXPECT_EQ(cache->stats().evictions, 1);
+    EXPECT_LE(cache->stats().bytes, cache->byte_budget());
+}
+
+TEST(CachedRendererTest, FormulasDoNotShareTiles) {
+    auto cache = std::make_shared<TileCache>(64 << 20);
+    CachedRenderer mandelbrot(make_renderer(), "mandelbrot", cache, 32);
+    CachedRenderer other(make_renderer(), "other", cache, 32);
+
+    const Viewport viewport = aligned_viewport(mandelbrot, 2, -40, -16, 32);
+    EscapeField field(32, 32);
+
+    mandelbrot.render_field(field, viewport);
+    other.render_field(field, viewport);
+
+    EXPECT_EQ(other.last_stats().rendered, other.last_stats().tiles);
+}
+
+TEST(CachedRendererTest, RejectsTooDeepViewport) {
+    CachedRenderer cached(make_renderer(), "mandelbrot", std::make_shared<TileCache>(1 << 20), 32);
+
+    EscapeField field(64, 64);
+    EXPECT_THROW(cached.render_field(field, Viewport { 1e-14, Complex::Algebraic(-0.75, 0.1) }), std::runtime_error);
+}
@@ -0,0 +1,350 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+#include "fractal/cached_renderer.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/tile_server.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::bmp;
+using namespace iheay::fractal;
+
+static std::string socket_path() {
+    const auto* test = ::testing::UnitTest::GetInstance()->current_test_info();
+    return (std::filesystem::temp_directory_path() / std::format("iheay_{}_{}.sock", test->name(), ::getpid())).string();
+}
+
+static BgrPixel gray(double mu, int max_iter) {
+    const uint8_t v = static_cast<uint8_t>(std::min(mu, static_cast<double>(max_iter)));
+    return {v, v, v};
+}
+
+static BgrPixel inverted(double mu, int max_iter) {
+    const uint8_t v = static_cast<uint8_t>(255 - std::min(mu, static_cast<double>(max_iter)));
+    return {v, v, v};
+}
+
+static bool eventually(const std::function<bool()>& condition) {
+    for (int i = 0; i < 5000; ++i) {
+        if (condition())
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return condition();
+}
+
+// fills tile (level, tx, ty) with mu = tx once the gate opens, counting the renders
+struct Gate {
+    std::mutex mutex;
+    std::condition_variable opened;
+    bool open = false;
+    std::atomic<int> entered = 0;
+
+    void release() {
+        {
+            std::lock_guard lock(mutex);
+            open = true;
+        }
+        opened.notify_all();
+    }
+
+    TileFieldFunc render(double step) {
+        return [this, step](const ViewportMapping& mapping, EscapeField& field) {
+            ++entered;
+            std::unique_lock lock(mutex);
+            opened.wait(lock, [&] { return open; });
+
+            const double tx = std::round(mapping.real_min / (step * field.width()));
+            field.set_max_iter(100);
+            for (int y = 0; y < field.height(); ++y)
+                for (int x = 0; x < field.width(); ++x)
+                    field.set_mu(x, y, tx);
+        };
+    }
+};
+
+static const int TILE = 8;
+
+static TileRequest tile(uint64_t id, int64_t tx, bool prefetch = false) {
+    return { id, prefetch, "gated", "gray", 0, tx, 0 };
+}
+
+// server with one gated formula at level 0
+static std::unique_ptr<TileServer> gated_server(Gate& gate, TileServerOptions options = {}) {
+    options.tile_size = TILE;
+    auto server = std::make_unique<TileServer>(socket_path(), options);
+    server->add_formula("gated", { 100, 2.0 }, gate.render(cached_root_extent / TILE));
+    server->add_palette("gray", gray);
+    server->add_palette("inverted", inverted);
+    server->start();
+    return server;
+}
+
+TEST(TileServer, ServesTilesOfTheCachedRendererGrid) {
+    const auto renderer = FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_max_iter(200)
+            .set_initial_func(formulas::Zero{})
+            .set_param_func(formulas::Identity{})
+            .build();
+
+    TileServerOptions options;
+    options.tile_size = 32;
+
+    TileServer server(socket_path(), options);
+    server.add_formula("mandelbrot", renderer);
+    server.add_palette("gray", gray);
+    server.start();
+
+    const CachedRenderer cached(renderer, "mandelbrot", std::make_shared<TileCache>(1 << 20), 32);
+    EXPECT_EQ(server.tile_mapping(3, -2, 1), cached.tile_mapping(3, -2, 1));
+
+    TileClient client(server.socket_path());
+    client.send({ 7, false, "mandelbrot", "gray", 3, -2, 1 });
+    const TileResponse response = client.receive();
+
+    ASSERT_EQ(response.error, "");
+    EXPECT_EQ(response.id, 7u);
+    ASSERT_EQ(response.width, 32);
+    ASSERT_EQ(response.height, 32);
+
+    EscapeField expected(32, 32);
+    renderer.render_field(expected, server.tile_mapping(3, -2, 1));
+
+    for (int y = 0; y < 32; ++y) {
+        for (int x = 0; x < 32; ++x) {
+            const BgrPixel want = gray(expected.mu(x, y), expected.max_iter());
+            const BgrPixel got = response.pixels[y * 32 + x];
+            ASSERT_EQ(got.b, want.b) << "at (" << x << ", " << y << ")";
+            ASSERT_EQ(got.r, want.r) << "at (" << x << ", " << y << ")";
+        }
+    }
+}
+
+TEST(TileServer, AnswersBadRequestsWithErrors) {
+    Gate gate;
+    gate.release();
+    auto server = gated_server(gate);
+
+    TileClient client(server->socket_path());
+
+    client.send({ 1, false, "burning_ship", "gray", 0, 0, 0 });
+    client.send({ 2, false, "gated", "rainbow", 0, 0, 0 });
+    client.send({ 3, false, "gated", "gray", 99, 0, 0 });
+    client.send({ 4, false, "gated", "gray", 0, 16, 0 });
+    client.send({ 5, false, "gated", "gray", 48, 0, INT64_MIN });
+
+    for (uint64_t id = 1; id <= 5; ++id) {
+        const TileResponse response = client.receive();
+        EXPECT_EQ(response.id, id);
+        EXPECT_NE(response.error, "");
+    }
+
+    // the connection stays usable, the last tile in range included
+    client.send(tile(6, -16));
+    const TileResponse response = client.receive();
+    EXPECT_EQ(response.id, 6u);
+    EXPECT_EQ(response.error, "");
+}
+
+TEST(TileServer, CoalescesIdenticalRequests) {
+    Gate gate;
+    auto server = gated_server(gate);
+
+    TileClient first(server->socket_path());
+    TileClient second(server->socket_path());
+
+    first.send(tile(1, 5));
+    second.send(tile(2, 5));
+
+    ASSERT_TRUE(eventually([&] { return server->stats().requests == 2; }));
+    gate.release();
+
+    const TileResponse a = first.receive();
+    const TileResponse b = second.receive();
+
+    EXPECT_EQ(a.id, 1u);
+    EXPECT_EQ(b.id, 2u);
+    EXPECT_EQ(a.pixels[0].g, 5);
+    EXPECT_EQ(b.pixels[0].g, 5);
+
+    EXPECT_EQ(gate.entered, 1);
+    EXPECT_EQ(server->stats().coalesced, 1);
+    EXPECT_EQ(server->stats().rendered, 1);
+}
+
+TEST(TileServer, ServesVisibleTilesBeforePrefetch) {
+    Gate gate;
+    auto server = gated_server(gate, { .workers = 1 });
+
+    TileClient client(server->socket_path());
+
+    // keeps the only worker busy while the rest queues up
+    client.send(tile(0, 0));
+    ASSERT_TRUE(eventually([&] { return gate.entered == 1; }));
+
+    client.send(tile(1, 1, true));
+    client.send(tile(2, 2, true));
+    client.send(tile(3, 3, false));
+    client.send(tile(4, 2, false)); // wanted as visible now, promotes the prefetch of tile 2
+
+    ASSERT_TRUE(eventually([&] { return server->stats().requests == 5; }));
+    gate.release();
+
+    std::vector<uint64_t> order;
+    for (int i = 0; i < 5; ++i)
+        order.push_back(client.receive().id);
+
+    // a promoted tile keeps its place in arrival order among the visible ones
+    EXPECT_EQ(order, (std::vector<uint64_t> { 0, 2, 4, 3, 1 }));
+    EXPECT_EQ(server->stats().rendered, 4);
+}
+
+TEST(TileServer, DropsQueuedRequestsOfDisconnectedClients) {
+    Gate gate;
+    auto server = gated_server(gate, { .workers = 1 });
+
+    TileClient client(server->socket_path());
+    client.send(tile(0, 0));
+    ASSERT_TRUE(eventually([&] { return gate.entered == 1; }));
+
+    {
+        TileClient leaving(server->socket_path());
+        leaving.send(tile(1, 1, true));
+        leaving.send(tile(2, 2, true));
+        leaving.send(tile(3, 0)); // joins the running render, which still completes
+        ASSERT_TRUE(eventually([&] { return server->stats().requests == 4; }));
+    }
+
+    ASSERT_TRUE(eventually([&] { return server->stats().dropped == 2; }));
+    gate.release();
+
+    EXPECT_EQ(client.receive().id, 0u);
+    ASSERT_TRUE(eventually([&] { return server->stats().rendered == 1; }));
+    EXPECT_EQ(gate.entered, 1);
+}
+
+TEST(TileServer, RefusesRequestsBeyondTheQueueLimit) {
+    Gate gate;
+    auto server = gated_server(gate, { .workers = 1, .queue_limit = 1 });
+
+    TileClient client(server->socket_path());
+    client.send(tile(0, 0));
+    ASSERT_TRUE(eventually([&] { return gate.entered == 1; }));
+
+    client.send(tile(1, 1));
+    client.send(tile(2, 2));
+
+    const TileResponse refused = client.receive();
+    EXPECT_EQ(refused.id, 2u);
+    EXPECT_EQ(refused.error, "busy");
+
+    gate.release();
+    EXPECT_EQ(client.receive().id, 0u);
+    EXPECT_EQ(client.receive().id, 1u);
+    EXPECT_EQ(server->stats().refused, 1);
+}
+
+TEST(TileServer, CachedTilesSkipRenderingForAnyPalette) {
+    Gate gate;
+    gate.release();
+    auto server = gated_server(gate);
+
+    TileClient client(server->socket_path());
+
+    client.send(tile(1, 9));
+    EXPECT_EQ(client.receive().pixels[0].r, 9);
+
+    client.send(tile(2, 9));
+    EXPECT_EQ(client.receive().pixels[0].r, 9);
+
+    client.send({ 3, false, "gated", "inverted", 0, 9, 0 });
+    EXPECT_EQ(client.receive().pixels[0].r, 246);
+
+    EXPECT_EQ(gate.entered, 1);
+    EXPECT_EQ(server->stats().cache_hits, 2);
+}
+
+// 256x256 tiles of mu 1, a few of them fill a socket's buffer
+static std::unique_ptr<TileServer> flat_server(TileServerOptions options = {}) {
+    options.tile_size = 256;
+    auto server = std::make_unique<TileServer>(socket_path(), options);
+    server->add_formula("flat", { 100, 2.0 }, [](const ViewportMapping&, EscapeField& field) {
+        field.set_max_iter(100);
+        for (int y = 0; y < field.height(); ++y)
+            for (int x = 0; x < field.width(); ++x)
+                field.set_mu(x, y, 1.0);
+    });
+    server->add_palette("gray", gray);
+    server->start();
+    return server;
+}
+
+TEST(TileServer, SlowReadersDontHoldUpOthers) {
+    auto server = flat_server({ .workers = 1 });
+
+    TileClient slow(server->socket_path());
+    TileClient quick(server->socket_path());
+
+    slow.send({ 0, false, "flat", "gray", 0, 0, 0 });
+    ASSERT_EQ(slow.receive().error, "");
+
+    // megabytes of cache hits nobody reads
+    for (uint64_t id = 0; id < 40; ++id)
+        slow.send({ id, false, "flat", "gray", 0, 0, 0 });
+    ASSERT_TRUE(eventually([&] { return server->stats().cache_hits == 40; }));
+
+    quick.send({ 100, false, "flat", "gray", 0, 1, 0 });
+    const TileResponse response = quick.receive();
+    EXPECT_EQ(response.id, 100u);
+    EXPECT_EQ(response.error, "");
+
+    for (uint64_t id = 0; id < 40; ++id)
+        EXPECT_EQ(slow.receive().id, id);
+    EXPECT_EQ(server->stats().overflowed, 0);
+}
+
+TEST(TileServer, ClosesConnectionsBeyondTheOutputLimit) {
+    auto server = flat_server({ .workers = 1, .output_limit = size_t(1) << 20 });
+
+    TileClient slow(server->socket_path());
+    for (uint64_t id = 0; id < 40; ++id)
+        slow.send({ id, false, "flat", "gray", 0, 0, 0 });
+    ASSERT_TRUE(eventually([&] { return server->stats().overflowed == 1; }));
+
+    // what was sent before the limit arrives, then the connection ends
+    EXPECT_THROW({
+        for (int i = 0; i < 40; ++i)
+            slow.receive();
+    }, std::runtime_error);
+}
+
+TEST(TileServer, StopDisconnectsClients) {
+    Gate gate;
+    auto server = gated_server(gate, { .workers = 1 });
+
+    TileClient client(server->socket_path());
+    client.send(tile(0, 0));
+    ASSERT_TRUE(eventually([&] { return gate.entered == 1; }));
+    client.send(tile(1, 1));
+
+    std::thread stopper([&] { server->stop(); });
+    gate.release();
+    stopper.join();
+
+    // the running tile may or may not make it out before the connection closes
+    EXPECT_THROW({
+        while (true)
+            client.receive();
+    }, std::runtime_error);
+    EXPECT_FALSE(std::filesystem::exists(server->socket_path()));
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <filesystem>
+
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/cached_renderer.hpp"
+#include "fractal/tile_store.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+// fresh directory per test, removed afterwards
+class TileStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        m_directory = std::filesystem::temp_directory_path() / (std::string("iheay_tile_store_") + info->name());
+        std::filesystem::remove_all(m_directory);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_directory);
+    }
+
+    std::filesystem::path m_directory;
+};
+
+static TileKey key(int64_t tx) {
+    return { 7, 3, tx, -2, 250, 2.0 };
+}
+
+static EscapeField ramp_tile(int size, double offset) {
+    EscapeField field(size, size);
+    field.set_max_iter(250);
+
+    Escape escape {};
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            escape.mu = offset + x + 0.25 * y;
+            field.store(x, y, escape);
+        }
+    }
+    return field;
+}
+
+static auto make_renderer() {
+    return FractalRendererBuilder<MuColorizer>
+        ::get_builder()
+            .set_max_iter(300)
+            .set_initial_func(formulas::Zero{})
+            .set_param_func(formulas::Identity{})
+            .build();
+}
+
+TEST_F(TileStoreTest, RoundTripsThroughMapping) {
+    TileStore store(m_directory, 16);
+    store.insert(key(1), ramp_tile(16, 10.0));
+
+    std::optional<MappedTile> tile = store.find(key(1));
+    ASSERT_TRUE(tile.has_value());
+    EXPECT_EQ(tile->size(), 16);
+    EXPECT_FLOAT_EQ(tile->mu(5, 4), 16.0f);
+
+    const EscapeField field = tile->to_field();
+    EXPECT_EQ(field.max_iter(), 250);
+    EXPECT_DOUBLE_EQ(field.mu(15, 15), 10.0 + 15 + 0.25 * 15);
+
+    EXPECT_FALSE(store.find(key(2)).has_value());
+
+    const TileStore::Stats stats = store.stats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.writes, 1);
+}
+
+TEST_F(TileStoreTest, SurvivesReopening) {
+    TileStore(m_directory, 16).insert(key(1), ramp_tile(16, 1.0));
+
+    TileStore reopened(m_directory, 16);
+    std::optional<MappedTile> tile = reopened.find(key(1));
+    ASSERT_TRUE(tile.has_value());
+    EXPECT_FLOAT_EQ(tile->mu(0, 0), 1.0f);
+
+    // another tile size reads a different layout, so the file is not trusted
+    EXPECT_FALSE(TileStore(m_directory, 8).find(key(1)).has_value());
+}
+
+TEST_F(TileStoreTest, ReplacingKeepsOpenMappingsIntact) {
+    TileStore store(m_directory, 16);
+    store.insert(key(1), ramp_tile(16, 1.0));
+
+    std::optional<MappedTile> old_tile = store.find(key(1));
+    ASSERT_TRUE(old_tile.has_value());
+
+    store.insert(key(1), ramp_tile(16, 100.0));
+
+    EXPECT_FLOAT_EQ(old_tile->mu(0, 0), 1.0f);
+    EXPECT_FLOAT_EQ(store.find(key(1))->mu(0, 0), 100.0f);
+}
+
+TEST_F(TileStoreTest, IgnoresTruncatedFiles) {
+    TileStore store(m_directory, 16);
+    store.insert(key(1), ramp_tile(16, 1.0));
+
+    std::filesystem::resize_file(store.tile_path(key(1)), 100);
+    EXPECT_FALSE(store.find(key(1)).has_value());
+}
+
+TEST_F(TileStoreTest, CachedRendererLoadsStoredTiles) {
+    auto store = std::make_shared<TileStore>(m_directory, 32);
+    const Viewport viewport { 1.5, Complex::Algebraic(-0.6, 0.1) };
+
+    CachedRenderer first(make_renderer(), "mandelbrot", std::make_shared<TileCache>(64 << 20), 32);
+    first.set_store(store);
+
+    EscapeField rendered(48, 48);
+    first.render_field(rendered, viewport);
+    EXPECT_EQ(first.last_stats().rendered, first.last_stats().tiles);
+
+    // a fresh cache, as after a restart
+    CachedRenderer second(make_renderer(), "mandelbrot", std::make_shared<TileCache>(64 << 20), 32);
+    second.set_store(store);
+
+    EscapeField loaded(48, 48);
+    second.render_field(loaded, viewport);
+    EXPECT_EQ(second.last_stats().rendered, 0);
+    EXPECT_EQ(second.last_stats().loaded, second.last_stats().tiles);
+
+    for (int y = 0; y < 48; ++y)
+        for (int x = 0; x < 48; ++x)
+            ASSERT_NEAR(loaded.mu(x, y), rendered.mu(x, y), 1e-6 * (1 + rendered.mu(x, y)));
+}
+
+TEST_F(TileStoreTest, RejectsMismatchedTileSize) {
+    CachedRenderer cached(make_renderer(), "mandelbrot", std::make_shared<TileCache>(1 << 20), 32);
+    EXPECT_THROW(cached.set_store(std::make_shared<TileStore>(m_directory, 16)), std::runtime_error);
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/tiles.hpp"
+#include "utils/thread_pool.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+TEST(TilesTest, CoverImageExactlyOnce) {
+    const int width = 150;
+    const int height = 97;
+
+    std::vector<int> covered(width * height, 0);
+
+    for (const Tile& tile : morton_tiles(width, height, 32)) {
+        EXPECT_GT(tile.width(), 0);
+        EXPECT_GT(tile.height(), 0);
+        for (int y = tile.y0; y < tile.y1; ++y)
+            for (int x = tile.x0; x < tile.x1; ++x)
+                ++covered[y * width + x];
+    }
+
+    for (int c : covered)
+        ASSERT_EQ(c, 1);
+}
+
+TEST(TilesTest, MortonOrder) {
+    const std::vector<Tile> tiles = morton_tiles(64, 64, 16);
+    ASSERT_EQ(tiles.size(), 16u);
+
+    // Z pattern over the first 2x2 block, then the next block to the right
+    EXPECT_EQ(tiles[0].x0, 0);  EXPECT_EQ(tiles[0].y0, 0);
+    EXPECT_EQ(tiles[1].x0, 16); EXPECT_EQ(tiles[1].y0, 0);
+    EXPECT_EQ(tiles[2].x0, 0);  EXPECT_EQ(tiles[2].y0, 16);
+    EXPECT_EQ(tiles[3].x0, 16); EXPECT_EQ(tiles[3].y0, 16);
+    EXPECT_EQ(tiles[4].x0, 32); EXPECT_EQ(tiles[4].y0, 0);
+}
+
+TEST(TilesTest, WorkStealingRenderMatchesStatic) {
+    auto pool = std::make_shared<iheay::utils::WorkStealingPool>(3);
+
+    for (Kernel kernel : { Kernel::Scalar, Kernel::Simd }) {
+        auto builder =
+            FractalRendererBuilder<MuColorizer>
+                ::get_builder()
+                    .set_viewport_width(3)
+                    .set_viewport_center(-0.75)
+                    .set_max_iter(300)
+                    .set_initial_func(formulas::Zero{})
+                    .set_param_func(formulas::Identity{})
+                    .set_kernel(kernel);
+
+        MuImage reference(150, 97);
+        MuImage tiled(150, 97);
+
+        builder.build().render(reference);
+        builder.set_schedule(Schedule::WorkStealing).set_thread_pool(pool).build().render(tiled);
+
+        expect_same_images(reference, tiled);
+    }
+}
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <numbers>
+
+#include "bmp/bmp.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/zoom_video.hpp"
+#include "mu_image.hpp"
+
+using namespace iheay::bmp;
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+struct GrayColorizer {
+    using pixel_type = BgrPixel;
+
+    BgrPixel operator()(double mu, int max_iter) const {
+        const uint8_t v = static_cast<uint8_t>(255 * std::min(mu, static_cast<double>(max_iter)) / max_iter);
+        return { v, v, v };
+    }
+};
+
+static const Complex CENTER = Complex::Algebraic(-0.74364388703, 0.13182590421);
+
+static auto zoom_builder(Kernel kernel = Kernel::Simd) {
+    return mandelbrot_builder(CENTER, 3, 400).set_kernel(kernel).set_precision(Precision::Double);
+}
+
+// renders strip rows straight into the ring, as render_zoom_video does
+static void fill_rows(const ZoomStrip& strip, const auto& renderer, long first_row, int rows, float* mu) {
+    renderer.render_points(strip.width(), rows, strip.sample_step(first_row + rows - 1),
+        [&](int x, int y) { return strip.point(x, first_row + y); },
+        [&](int x, int y, const Escape& escape) { mu[static_cast<size_t>(y) * strip.width() + x] = static_cast<float>(escape.mu); }
+    );
+}
+
+TEST(ZoomVideoTest, RenderPointsMatchesGridRender) {
+    for (Kernel kernel : { Kernel::Scalar, Kernel::Simd }) {
+        const auto renderer = zoom_builder(kernel).set_viewport_width(0.05).build();
+        const ViewportMapping mapping = ViewportMapping::from({ 0.05, CENTER }, 40, 30);
+
+        MuImage expected(40, 30);
+        MuImage actual(40, 30);
+        renderer.render(expected);
+        renderer.render_points(40, 30, mapping.real_step,
+            [&](int x, int y) { return mapping.pixel(x, y); },
+            [&](int x, int y, const Escape& escape) { actual.set_pixel(x, y, escape.mu); }
+        );
+
+        expect_same_images(expected, actual);
+    }
+}
+
+TEST(ZoomVideoTest, StripSamplesAreSquareAtEveryScale) {
+    ZoomStrip strip(CENTER, 1.0, 1e-4, 64, 48, 1.0, 0, [](long, int, float*) {});
+
+    EXPECT_GE(strip.width(), static_cast<int>(std::numbers::pi * std::hypot(63, 47.25)));
+
+    for (long row : { 0L, strip.rows() / 2, strip.rows() - 1 }) {
+        const Complex a = strip.point(0, row) - CENTER;
+        const Complex b = strip.point(0, row + 1) - CENTER;
+        const Complex c = strip.point(1, row) - CENTER;
+
+        const double radial = std::hypot(a.real(), a.imag()) - std::hypot(b.real(), b.imag());
+        const double angular = std::hypot(c.real() - a.real(), c.imag() - a.imag());
+
+        EXPECT_NEAR(angular, strip.sample_step(row), 1e-3 * strip.sample_step(row));
+        EXPECT_NEAR(radial / angular, 1.0, 0.02);
+    }
+}
+
+TEST(ZoomVideoTest, ResampledFramesFollowDirectRenders) {
+    const auto renderer = zoom_builder().build();
+    ZoomStrip strip(CENTER, 0.1, 0.001, 64, 48, 2.0, 0, [&](long first_row, int rows, float* mu) {
+        fill_rows(strip, renderer, first_row, rows, mu);
+    });
+
+    // mu at this depth is noisy from pixel to pixel, so the resampled frame is held
+    // to the same render shifted by a third of a pixel
+    auto close_pixels = [](const auto& mu, const MuImage& direct) {
+        int close = 0;
+        for (int y = 0; y < 48; ++y)
+            for (int x = 0; x < 64; ++x)
+                close += std::abs(mu(x, y) - direct.get_pixel(x, y)) < 1.0;
+        return close;
+    };
+
+    for (double width : { 0.1, 0.01, 0.001 }) {
+        EscapeField resampled(64, 48);
+        strip.resample({ width, CENTER }, 400, resampled);
+
+        MuImage direct(64, 48);
+        MuImage shifted(64, 48);
+        zoom_builder().set_viewport_width(width).build().render(direct);
+        zoom_builder()
+            .set_viewport_width(width)
+            .set_viewport_center(CENTER + Complex::Algebraic(width / 63 / 3, width / 63 / 3))
+            .build()
+            .render(shifted);
+
+        const int resampled_close = close_pixels([&](int x, int y) { return resampled.mu(x, y); }, direct);
+        const int shifted_close = close_pixels([&](int x, int y) { return shifted.get_pixel(x, y); }, direct);
+
+        EXPECT_GE(resampled_close, shifted_close) << "width " << width;
+        EXPECT_GT(resampled_close, 64 * 48 / 2) << "width " << width;
+    }
+}
+
+TEST(ZoomVideoTest, ZoomingInIteratesEveryRowOnce) {
+    const auto renderer = zoom_builder().build();
+    ZoomStrip strip(CENTER, 1.0, 1e-4, 32, 24, 1.0, 0, [&](long first_row, int rows, float* mu) {
+        fill_rows(strip, renderer, first_row, rows, mu);
+    });
+
+    EscapeField field(32, 24);
+    for (int i = 0; i <= 40; ++i)
+        strip.resample({ std::pow(1e-4, i / 40.0), CENTER }, 400, field);
+
+    EXPECT_LE(strip.iterated_rows(), strip.rows());
+    EXPECT_GT(strip.iterated_rows(), strip.rows() * 9 / 10);
+}
+
+TEST(ZoomVideoTest, LeavesTheInnerTileToTheCaller) {
+    const auto renderer = zoom_builder().build();
+    ZoomStrip strip(CENTER, 1.0, 1e-3, 64, 48, 1.0, 4, [&](long first_row, int rows, float* mu) {
+        fill_rows(strip, renderer, first_row, rows, mu);
+    });
+
+    EXPECT_LT(strip.rows(), ZoomStrip(CENTER, 1.0, 1e-3, 64, 48, 1.0, 0, [](long, int, float*) {}).rows());
+
+    for (double width : { 1.0, 0.03, 1e-3 }) {
+        EscapeField field(64, 48);
+        for (int y = 0; y < 48; ++y)
+            for (int x = 0; x < 64; ++x)
+                field.set_mu(x, y, -1);
+
+        const Tile inner = strip.resample({ width, CENTER }, 400, field);
+        EXPECT_EQ(inner.x0, 28);
+        EXPECT_EQ(inner.y0, 20);
+        EXPECT_EQ(inner.x1, 36);
+        EXPECT_EQ(inner.y1, 28);
+
+        for (int y = 0; y < 48; ++y) {
+            for (int x = 0; x < 64; ++x) {
+                const bool left = x >= inner.x0 && x < inner.x1 && y >= inner.y0 && y < inner.y1;
+                EXPECT_EQ(field.mu(x, y) < 0, left) << x << ", " << y << " at width " << width;
+            }
+        }
+    }
+}
+
+TEST(ZoomVideoTest, RendersEveryFrameInOrder) {
+    const FractalKeyframe start { { 0.5, CENTER }, { 200, 2.0 }, Complex::Zero() };
+    const FractalKeyframe end { { 0.005, CENTER }, { 200, 2.0 }, Complex::Zero() };
+
+    const auto builder = FractalRendererBuilder<GrayColorizer>
+        ::get_builder()
+            .set_initial_func(formulas::Zero{})
+            .set_param_func(formulas::Identity{});
+
+    std::vector<int> frames;
+    const ZoomVideoStats stats = render_zoom_video(builder, start, end, { 48, 32, 100, 1.0, 2 },
+        [&](int frame, const Bmp& image) {
+            EXPECT_EQ(image.width(), 48);
+            frames.push_back(frame);
+        });
+
+    ASSERT_EQ(frames.size(), 100u);
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(frames[i], i);
+
+    EXPECT_EQ(stats.animation.frames, 100);
+    EXPECT_LT(stats.samples, 100L * 48 * 32 / 2);
+}
+
+TEST(ZoomVideoTest, RejectsInvalidSetup) {
+    EXPECT_THROW(ZoomStrip(CENTER, 1.0, 0.0, 64, 48, 1.0, 0, [](long, int, float*) {}), std::runtime_error);
+    EXPECT_THROW(ZoomStrip(CENTER, 1.0, 0.1, 64, 48, 1.0, 0, nullptr), std::runtime_error);
+
+    ZoomStrip strip(CENTER, 1.0, 0.1, 64, 48, 1.0, 0, [](long, int, float*) {});
+    EscapeField wrong_size(32, 24);
+    EXPECT_THROW(strip.resample({ 1.0, CENTER }, 100, wrong_size), std::runtime_error);
+}
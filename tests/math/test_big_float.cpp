@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "math/big_float.hpp"
+
+using namespace iheay::math;
+
+TEST(BigFloatTest, DoubleRoundTrip) {
+    for (double v : { 0.0, 1.0, -1.0, 0.1, -123456.789, 1e-300, 3.5e200, -0.74364388703 }) {
+        EXPECT_EQ(BigFloat(v).to_double(), v);
+        EXPECT_EQ(BigFloat(v, 512).to_double(), v);
+    }
+}
+
+TEST(BigFloatTest, ZeroAndSign) {
+    EXPECT_TRUE(BigFloat().is_zero());
+    EXPECT_TRUE((BigFloat(2.5) - BigFloat(2.5)).is_zero());
+    EXPECT_TRUE((-BigFloat(3.0)).is_negative());
+    EXPECT_FALSE((-BigFloat(0.0)).is_negative());
+}
+
+TEST(BigFloatTest, Arithmetic) {
+    const BigFloat a(1.5);
+    const BigFloat b(-0.25);
+
+    EXPECT_EQ((a + b).to_double(), 1.25);
+    EXPECT_EQ((a - b).to_double(), 1.75);
+    EXPECT_EQ((b - a).to_double(), -1.75);
+    EXPECT_EQ((a * b).to_double(), -0.375);
+    EXPECT_EQ(a.mul_pow2(3).to_double(), 12.0);
+    EXPECT_EQ(a.mul_pow2(-1).to_double(), 0.75);
+}
+
+TEST(BigFloatTest, FromString) {
+    EXPECT_EQ(BigFloat::from_string("2", 64).to_double(), 2.0);
+    EXPECT_EQ(BigFloat::from_string("-0.5", 64).to_double(), -0.5);
+    EXPECT_EQ(BigFloat::from_string("1.5e3", 64).to_double(), 1500.0);
+    EXPECT_EQ(BigFloat::from_string("0.1", 128).to_double(), 0.1);
+    EXPECT_EQ(BigFloat::from_string("-0.74364388703", 128).to_double(), -0.74364388703);
+    EXPECT_EQ(BigFloat::from_string("2.5e-40", 128).to_double(), 2.5e-40);
+
+    EXPECT_THROW(BigFloat::from_string("", 64), std::runtime_error);
+    EXPECT_THROW(BigFloat::from_string("1.2.3", 64), std::runtime_error);
+    EXPECT_THROW(BigFloat::from_string("abc", 64), std::runtime_error);
+    EXPECT_THROW(BigFloat::from_string("1e", 64), std::runtime_error);
+}
+
+TEST(BigFloatTest, KeepsDigitsBeyondDouble) {
+    // 1 + 1e-60 is 1.0 as a double, but the difference must survive
+    const BigFloat one(1.0, 256);
+    const BigFloat x = BigFloat::from_string("1.000000000000000000000000000000000000000000000000000000000001", 256);
+
+    const double diff = (x - one).to_double();
+    EXPECT_NEAR(diff / 1e-60, 1.0, 1e-12);
+
+    // (1 + e)^2 - 1 - 2e == e^2
+    const BigFloat e = BigFloat::from_string("1e-30", 256);
+    const BigFloat y = one + e;
+    const double rest = (y * y - one - e.mul_pow2(1)).to_double();
+    EXPECT_NEAR(rest / 1e-60, 1.0, 1e-12);
+}
+
+TEST(BigFloatTest, PrecisionOfResult) {
+    const BigFloat a(1.0, 64);
+    const BigFloat b(1.0, 320);
+
+    EXPECT_EQ((a + b).precision_bits(), 320);
+    EXPECT_EQ(a.with_precision(200).precision_bits(), 224);
+    EXPECT_THROW(BigFloat(1.0, 0), std::runtime_error);
+}
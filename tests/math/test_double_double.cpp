@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "math/double_double.hpp"
+#include "math/big_float.hpp"
+
+using namespace iheay::math;
+
+// exact value of a DoubleDouble as BigFloat, for checking the low word
+static BigFloat exact(const DoubleDouble& v) {
+    return BigFloat(v.hi(), 256) + BigFloat(v.lo(), 256);
+}
+
+TEST(DoubleDoubleTest, SumAndProductAreExact) {
+    const double a = 1.0;
+    const double b = 1e-20;
+
+    const DoubleDouble s = DoubleDouble::Sum(a, b);
+    EXPECT_EQ(s.hi(), 1.0);
+    EXPECT_EQ(s.lo(), 1e-20);
+
+    const double x = 1.0 + std::ldexp(1.0, -30);
+    const DoubleDouble p = DoubleDouble::Product(x, x);
+    EXPECT_EQ(p.hi(), 1.0 + std::ldexp(1.0, -29));
+    EXPECT_EQ(p.lo(), std::ldexp(1.0, -60));
+}
+
+TEST(DoubleDoubleTest, ArithmeticKeepsLowBits) {
+    const DoubleDouble one(1.0);
+    const DoubleDouble tiny(1e-25);
+
+    const DoubleDouble sum = one + tiny;
+    EXPECT_EQ(sum.hi(), 1.0);
+    EXPECT_NEAR((sum - one).to_double(), 1e-25, 1e-40);
+
+    // (1 + e)^2 - 1 == 2e + e^2 with e = 2^-40
+    const DoubleDouble e(std::ldexp(1.0, -40));
+    const DoubleDouble sq = (one + e) * (one + e) - one;
+    EXPECT_EQ(sq.to_double(), std::ldexp(1.0, -39) + std::ldexp(1.0, -80));
+}
+
+TEST(DoubleDoubleTest, MatchesBigFloatToAbout106Bits) {
+    const DoubleDouble a = DoubleDouble::Sum(0.1, 1e-18);
+    const DoubleDouble b = DoubleDouble::Sum(-0.7436438870371587, 3e-20);
+
+    const BigFloat prod = exact(a * b);
+    const BigFloat ref = exact(a) * exact(b);
+    EXPECT_LT(std::abs((prod - ref).to_double()), 1e-31);
+
+    const BigFloat sum = exact(a + b);
+    const BigFloat ref_sum = exact(a) + exact(b);
+    EXPECT_LT(std::abs((sum - ref_sum).to_double()), 1e-32);
+}
+
+TEST(DoubleDoubleTest, Comparison) {
+    const DoubleDouble a = DoubleDouble::Sum(1.0, 1e-20);
+    const DoubleDouble b(1.0);
+
+    EXPECT_TRUE(b < a);
+    EXPECT_TRUE(a > b);
+    EXPECT_FALSE(a == b);
+    EXPECT_TRUE(-a < b);
+}
+
+TEST(DoubleDoubleComplexTest, Arithmetic) {
+    const DoubleDoubleComplex a(Complex(1.0, 2.0));
+    const DoubleDoubleComplex b(Complex(3.0, -4.0));
+
+    EXPECT_TRUE(Complex(a + b) == Complex(4.0, -2.0));
+    EXPECT_TRUE(Complex(a - b) == Complex(-2.0, 6.0));
+    EXPECT_TRUE(Complex(a * b) == Complex(11.0, 2.0));
+    EXPECT_TRUE(Complex(-a) == Complex(-1.0, -2.0));
+    EXPECT_TRUE(Complex(DoubleDoubleComplex::Zero()) == Complex::Zero());
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+
+#include "utils/bench_report.hpp"
+
+using namespace iheay::utils;
+
+static BenchResult result(const std::string& scene, int threads, double mpixels_per_second) {
+    BenchResult r;
+    r.scene = scene;
+    r.width = 640;
+    r.height = 360;
+    r.threads = threads;
+    r.seconds = 0.2304 / mpixels_per_second;
+    r.mpixels_per_second = mpixels_per_second;
+    r.giterations_per_second = 1.25;
+    r.efficiency = 0.875;
+    r.peak_rss_kb = 51200;
+    return r;
+}
+
+TEST(BenchReportTest, RoundTripsThroughText) {
+    const std::vector<BenchResult> written = { result("julia", 1, 12.5), result("sphere", 4, 230.0) };
+
+    std::stringstream text;
+    write_results(text, written);
+    const std::vector<BenchResult> read = read_results(text);
+
+    ASSERT_EQ(read.size(), 2u);
+    for (size_t i = 0; i < read.size(); ++i) {
+        EXPECT_EQ(read[i].key(), written[i].key());
+        EXPECT_NEAR(read[i].seconds, written[i].seconds, 1e-6);
+        EXPECT_DOUBLE_EQ(read[i].mpixels_per_second, written[i].mpixels_per_second);
+        EXPECT_DOUBLE_EQ(read[i].giterations_per_second, written[i].giterations_per_second);
+        EXPECT_DOUBLE_EQ(read[i].efficiency, written[i].efficiency);
+        EXPECT_EQ(read[i].peak_rss_kb, written[i].peak_rss_kb);
+    }
+}
+
+TEST(BenchReportTest, SkipsCommentsAndBlankLines) {
+    std::istringstream text(
+        "# host: 8 cores\n"
+        "\n"
+        "julia\t640\t360\t1\t0.01\t23.04\t1.5\t1.0\t1024\r\n"
+    );
+
+    const std::vector<BenchResult> read = read_results(text);
+    ASSERT_EQ(read.size(), 1u);
+    EXPECT_EQ(read[0].scene, "julia");
+    EXPECT_EQ(read[0].peak_rss_kb, 1024);
+}
+
+TEST(BenchReportTest, RejectsMalformedRecordsWithTheirLine) {
+    std::istringstream short_line("# columns\njulia\t640\t360\n");
+    try {
+        read_results(short_line);
+        FAIL() << "expected an error";
+    } catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find("line 2"), std::string::npos) << e.what();
+    }
+
+    std::istringstream bad_number("julia\t640\t360\tmany\t0.01\t23.04\t1.5\t1.0\t1024\n");
+    EXPECT_THROW(read_results(bad_number), std::runtime_error);
+}
+
+TEST(BenchReportTest, FlagsOnlySlowdownsBeyondTheThreshold) {
+    const std::vector<BenchResult> baseline = {
+        result("julia", 1, 100.0), result("julia", 4, 400.0), result("sphere", 1, 50.0)
+    };
+    const std::vector<BenchResult> current = {
+        result("julia", 1, 95.0),        // 5% slower, within 10%
+        result("julia", 4, 300.0),       // 25% slower
+        result("sphere", 1, 80.0),       // faster
+        result("seahorse_deep", 1, 1.0)  // not in the baseline
+    };
+
+    const BenchComparison comparison = compare_results(baseline, current, 0.1);
+    EXPECT_EQ(comparison.compared, 3);
+    ASSERT_EQ(comparison.regressions.size(), 1u);
+    EXPECT_EQ(comparison.regressions[0].current.key(), result("julia", 4, 1.0).key());
+    EXPECT_NEAR(comparison.regressions[0].slowdown, 0.25, 1e-12);
+
+    EXPECT_TRUE(compare_results(baseline, current, 0.3).regressions.empty());
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "utils/logger.hpp"
+
+using namespace iheay::utils;
+
+// cout is captured for the test and the level is back to printing everything after it
+class LoggerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_buffer = std::cout.rdbuf(m_out.rdbuf());
+    }
+
+    void TearDown() override {
+        std::cout.rdbuf(m_buffer);
+        Logger::set_level(LogLevel::Debug);
+    }
+
+    std::string printed() const { return m_out.str(); }
+
+private:
+    std::ostringstream m_out;
+    std::streambuf* m_buffer = nullptr;
+};
+
+TEST_F(LoggerTest, PrintsEverythingByDefault) {
+    LOG_DEBUG("debug {}", 1);
+    LOG_ERROR("error {}", 2);
+
+    EXPECT_NE(printed().find("[DEBUG]\033[0m debug 1"), std::string::npos);
+    EXPECT_NE(printed().find("[ERROR]\033[0m error 2"), std::string::npos);
+}
+
+TEST_F(LoggerTest, DropsMessagesBelowTheLevel) {
+    Logger::set_level(LogLevel::Warn);
+    EXPECT_FALSE(Logger::enabled(LogLevel::Debug));
+    EXPECT_FALSE(Logger::enabled(LogLevel::Info));
+    EXPECT_TRUE(Logger::enabled(LogLevel::Warn));
+    EXPECT_TRUE(Logger::enabled(LogLevel::Error));
+
+    LOG_DEBUG("debug");
+    LOG_INFO("info");
+    LOG_WARN("warn");
+    LOG_ERROR("error");
+
+    EXPECT_EQ(printed().find("debug"), std::string::npos);
+    EXPECT_EQ(printed().find("info"), std::string::npos);
+    EXPECT_NE(printed().find("warn"), std::string::npos);
+    EXPECT_NE(printed().find("error"), std::string::npos);
+
+    Logger::set_level(LogLevel::Off);
+    LOG_ERROR("after off");
+    EXPECT_EQ(printed().find("after off"), std::string::npos);
+}
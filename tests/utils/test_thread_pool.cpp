@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "utils/thread_pool.hpp"
+
+using namespace iheay::utils;
+
+TEST(ThreadPoolTest, RunsEveryTaskOnce) {
+    WorkStealingPool pool(4);
+    EXPECT_EQ(pool.thread_count(), 4);
+
+    std::vector<std::atomic<int>> hits(1000);
+
+    pool.run(1000, [&](int task, int worker) {
+        ASSERT_GE(worker, 0);
+        ASSERT_LT(worker, 4);
+        ++hits[task];
+    });
+
+    for (const auto& h : hits)
+        ASSERT_EQ(h, 1);
+}
+
+TEST(ThreadPoolTest, IsReusableAcrossRuns) {
+    WorkStealingPool pool(3);
+
+    for (int round = 0; round < 50; ++round) {
+        std::atomic<long> sum = 0;
+        pool.run(round, [&](int task, int) { sum += task; });
+        ASSERT_EQ(sum, static_cast<long>(round) * (round - 1) / 2);
+    }
+}
+
+TEST(ThreadPoolTest, IdleWorkersStealUnevenWork) {
+    WorkStealingPool pool(4);
+
+    // all the expensive tasks sit in the first worker's block
+    std::atomic<long> sink = 0;
+    pool.run(64, [&](int task, int) {
+        long local = 0;
+        const long cost = task < 16 ? 2'000'000 : 10;
+        for (long i = 0; i < cost; ++i)
+            local += i ^ task;
+        sink += local;
+    });
+
+    EXPECT_GT(pool.last_steals(), 0);
+}
+
+TEST(ThreadPoolTest, RethrowsTaskException) {
+    WorkStealingPool pool(2);
+
+    EXPECT_THROW(
+        pool.run(10, [](int task, int) {
+            if (task == 7)
+                throw std::runtime_error("task failed");
+        }),
+        std::runtime_error
+    );
+
+    // the pool is still usable afterwards
+    std::atomic<int> count = 0;
+    pool.run(10, [&](int, int) { ++count; });
+    EXPECT_EQ(count, 10);
+}
+
+TEST(ThreadPoolTest, SingleThreadRunsOnCaller) {
+    WorkStealingPool pool(1);
+
+    std::vector<int> order;
+    pool.run(5, [&](int task, int worker) {
+        EXPECT_EQ(worker, 0);
+        order.push_back(task);
+    });
+
+    EXPECT_EQ(order, (std::vector<int> { 0, 1, 2, 3, 4 }));
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/trace.hpp"
+
+using namespace iheay::utils;
+
+// CI also runs it in a whole build configured with -DIHEAY_TRACING=OFF
+
+#ifdef IHEAY_DISABLE_TRACING
+static const bool tracing_compiled = false;
+#else
+static const bool tracing_compiled = true;
+#endif
+
+// the trace is process-wide, every test starts from an empty one
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Trace::clear();
+        Trace::enable();
+    }
+
+    void TearDown() override {
+        Trace::disable();
+        Trace::clear();
+    }
+};
+
+static size_t count_of(const std::string& text, const std::string& what) {
+    size_t count = 0;
+    for (size_t at = text.find(what); at != std::string::npos; at = text.find(what, at + what.size()))
+        ++count;
+    return count;
+}
+
+TEST_F(TraceTest, RecordsNothingWhileDisabled) {
+    Trace::disable();
+    for (int i = 0; i < 100; ++i) {
+        TRACE_SCOPE("disabled", {"i", i});
+    }
+    EXPECT_EQ(Trace::event_count(), 0u);
+
+    Trace::enable();
+    {
+        TRACE_SCOPE("enabled");
+    }
+    EXPECT_EQ(Trace::event_count(), tracing_compiled ? 1u : 0u);
+}
+
+TEST_F(TraceTest, KeepsEveryThreadsEventsWhileBeingRead) {
+    const int threads = 4;
+    const int events = 3000; // a few chunks per thread
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([=] {
+            TRACE_THREAD_NAME("worker " + std::to_string(t));
+            for (int i = 0; i < events; ++i) {
+                TRACE_SCOPE("event", {"thread", t}, {"i", i});
+            }
+        });
+    }
+
+    // readers see a growing prefix, never a torn one
+    size_t seen = 0;
+    for (int i = 0; i < 50; ++i) {
+        const size_t count = Trace::event_count();
+        EXPECT_GE(count, seen);
+        seen = count;
+    }
+
+    for (std::thread& worker : workers)
+        worker.join();
+
+    // the threads are gone, their events stay
+    EXPECT_EQ(Trace::event_count(), tracing_compiled ? static_cast<size_t>(threads) * events : 0u);
+
+    Trace::clear();
+    EXPECT_EQ(Trace::event_count(), 0u);
+
+    {
+        TRACE_SCOPE("after clear");
+    }
+    EXPECT_EQ(Trace::event_count(), tracing_compiled ? 1u : 0u);
+}
+
+TEST_F(TraceTest, WritesChromeTraceEvents) {
+    if (!tracing_compiled)
+        GTEST_SKIP() << "tracing compiled out";
+
+    std::thread worker([] {
+        TRACE_THREAD_NAME("bmp \"writer\"");
+        TRACE_SCOPE("outer", {"width", 640}, {"height", 360});
+        TRACE_SCOPE("inner");
+    });
+    worker.join();
+
+    std::ostringstream out;
+    Trace::write_json(out);
+    const std::string json = out.str();
+
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+
+    EXPECT_EQ(count_of(json, "\"ph\":\"X\""), 2u);
+    EXPECT_EQ(count_of(json, "\"name\":\"thread_name\",\"ph\":\"M\""), 1u);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"bmp \\\"writer\\\"\"}"), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"outer\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"width\":640,\"height\":360}"), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"inner\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{}"), std::string::npos);
+}
+
+TEST_F(TraceTest, NestedScopesEndInOrder) {
+    if (!tracing_compiled)
+        GTEST_SKIP() << "tracing compiled out";
+
+    {
+        TRACE_SCOPE("outer");
+        TRACE_SCOPE("inner");
+    }
+
+    std::ostringstream out;
+    Trace::write_json(out);
+    const std::string json = out.str();
+
+    // the inner scope closes first, so it is recorded first
+    const size_t inner = json.find("\"name\":\"inner\"");
+    const size_t outer = json.find("\"name\":\"outer\"");
+    ASSERT_NE(inner, std::string::npos);
+    ASSERT_NE(outer, std::string::npos);
+    EXPECT_LT(inner, outer);
+}
@@ -0,0 +1,36 @@
+#include "bmp/bmp.hpp"
+#include "bmp/io/bmp_io.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/palettes.hpp"
+#include <omp.h>
+
+using namespace iheay::math;
+using namespace iheay::bmp;
+using namespace iheay::fractal;
+
+int main() {
+
+    // far beyond double precision: the viewport is 1e-20 wide
+    const int precision = 256;
+
+    auto renderer = 
+        FractalRendererBuilder<palettes::Fire>
+            ::get_builder()
+                .set_viewport_width(1e-20)
+                .set_deep_center({
+                    BigFloat::from_string("-0.743643887037158704752191506114774", precision),
+                    BigFloat::from_string("0.131825904205311970493132056385139", precision)
+                })
+                .set_max_iter(12000)
+                .set_initial_func( formulas::Zero{} )
+                .set_param_func( formulas::Identity{} )
+                .set_precision( Precision::Perturbation )
+                .build();
+
+    Bmp image = Bmp::empty(1500, 1000);
+    renderer.render(image);
+
+    io::save(image, "deep_zoom_mandelbrot.bmp");
+
+    return 0;
+}
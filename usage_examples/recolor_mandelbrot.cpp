@@ -0,0 +1,38 @@
+#include "bmp/bmp.hpp"
+#include "bmp/io/bmp_io.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/palettes.hpp"
+#include "fractal/escape_field.hpp"
+#include <format>
+
+using namespace iheay::math;
+using namespace iheay::bmp;
+using namespace iheay::fractal;
+
+// one expensive iteration pass, then as many palettes as we like
+
+int main() {
+
+    auto renderer = 
+        FractalRendererBuilder<palettes::Fire>
+            ::get_builder()
+                .set_viewport_center(Complex::Algebraic(-0.7436447860, 0.1318252536))
+                .set_viewport_width(3e-3)
+                .set_max_iter(3000)
+                .set_initial_func( formulas::Zero{} )
+                .set_param_func( formulas::Identity{} )
+                .set_kernel( Kernel::Simd )
+                .build();
+
+    EscapeField field(1500, 1000);
+    renderer.render_field(field);
+
+    for (int i = 0; i < 4; ++i) {
+        Bmp image = Bmp::empty(field.width(), field.height());
+        colorize(field, image, palettes::Fire{ i * 0.25 });
+
+        io::save(image, std::format("recolor_mandelbrot_{}.bmp", i));
+    }
+
+    return 0;
+}
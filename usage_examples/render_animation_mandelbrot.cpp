@@ -1,7 +1,10 @@
 #include "bmp/bmp.hpp"
 #include "bmp/io/bmp_io.hpp"
 #include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/palettes.hpp"
 #include "fractal/fractal_animation.hpp"
+#include "fractal/animation_plan.hpp"
+#include "fractal/animation_renderer.hpp"
 #include "utils/logger.hpp"
 #include <omp.h>
 #include <filesystem>
@@ -25,23 +28,6 @@ std::string create_new_dir_name(std::string dir_name) {
     return dir_name;
 }
 
-struct BgrColorizer {
-    using pixel_type = BgrPixel;
-
-    BgrPixel operator()(double mu, int max_iter) const {
-        if (mu >= max_iter)
-            return {0, 0, 0};
-
-        double t = mu / max_iter;
-
-        uint8_t r = static_cast<uint8_t>(9  * (1 - t) * t * t * t * 255);
-        uint8_t g = static_cast<uint8_t>(15 * (1 - t) * (1 - t) * t * t * 255);
-        uint8_t b = static_cast<uint8_t>(8.5 * (1 - t) * (1 - t) * (1 - t) * t * 255);
-
-        return {b, g, r};
-    }
-};
-
 void render_animation() {
 
     const int WIDTH = 1920;
@@ -52,10 +38,6 @@ void render_animation() {
     fs::path directory_path = dir_name;
     fs::create_directory(directory_path);
 
-    volatile double time_start = omp_get_wtime();
-
-    Bmp image = Bmp::empty(WIDTH, HEIGHT);
-
     FractalKeyframe start {
         { 5, Complex::Algebraic(-0.75, 0.0) },
         { 300, 2.0 },
@@ -68,34 +50,43 @@ void render_animation() {
         Complex::Algebraic(-0.8, 0.156)
     };
 
+    std::vector<FractalKeyframe> keyframes;
+    for (int i = 0; i < FRAMES_COUNT; ++i)
+        keyframes.push_back(interpolate(start, end, static_cast<double>(i) / (FRAMES_COUNT - 1)));
+
     auto renderer_builder = 
-        FractalRendererBuilder<BgrColorizer>
+        FractalRendererBuilder<palettes::Fire>
             ::get_builder()
-                .set_initial_func( [](auto&) { return Complex::Zero(); } )
-                .set_param_func( [](auto& pixel) { return pixel; } );
-
-    for (int i = 0; i < FRAMES_COUNT; ++i) {
-        double t = static_cast<double>(i) / (FRAMES_COUNT - 1);
-
-        auto key = interpolate(start, end, t);
-
-        LOG_INFO("Rendering frame {} / {}", i, FRAMES_COUNT);
-
-        auto renderer =
-            renderer_builder
-                .set_viewport(key.viewport)
-                .build();
-
-        renderer.render(image);
-
-        std::string filename = std::format("{}/frame_{:04}.bmp", dir_name, i);
-
-        io::save(image, filename);
-    }
-
-    volatile double time_end = omp_get_wtime();
+                .set_initial_func( formulas::Zero{} )
+                .set_param_func( formulas::Identity{} )
+                .set_kernel( Kernel::Simd )
+                .set_cycle_detection( true )
+                .set_schedule( Schedule::WorkStealing );
+
+    // per-frame max_iter from 64x36 previews instead of interpolate()'s zoom formula, logs the predicted time
+    const AnimationPlan plan = plan_animation(keyframes, WIDTH, HEIGHT,
+        [&](const FractalKeyframe& key, EscapeField& field) {
+            renderer_builder.set_viewport(key.viewport).set_max_iter(key.config.max_iter).build().render_field(field);
+        });
+
+    // iteration of frame i + 2, edge refinement of frame i + 1 and the write of frame i overlap
+    AnimationStages stages {
+        [&](const FractalKeyframe& key, EscapeField& field) {
+            renderer_builder.set_viewport(key.viewport).set_max_iter(key.config.max_iter).build().render_field(field);
+        },
+        [builder = renderer_builder](const FractalKeyframe& key, const EscapeField& field, Bmp& image) mutable {
+            auto renderer = builder.set_viewport(key.viewport).set_max_iter(key.config.max_iter).build();
+
+            // extra samples only along the boundary, at most one more sample per pixel on average
+            const AntialiasStats aa = renderer.render_antialiased(field, image, { 2.0, 8, 1.0 });
+            LOG_INFO("{} of {} edge pixels refined", aa.refined, aa.edges);
+        },
+        [&](int frame, const Bmp& image) {
+            io::save(image, std::format("{}/frame_{:04}.bmp", dir_name, frame));
+        }
+    };
 
-    LOG_INFO("Animation rendering finished in {:.3f} seconds", time_end - time_start);
+    AnimationRenderer(WIDTH, HEIGHT, stages).render(plan.keyframes());
 }
 
 int main() {
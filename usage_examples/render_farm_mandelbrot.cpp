@@ -0,0 +1,69 @@
+#include "bmp/bmp.hpp"
+#include "bmp/io/bmp_io.hpp"
+#include "fractal/animation_plan.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/palettes.hpp"
+#include "fractal/render_farm.hpp"
+#include "utils/logger.hpp"
+#include <filesystem>
+#include <format>
+#include <thread>
+
+using namespace iheay::bmp;
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+namespace fs = std::filesystem;
+
+// the zoom of render_animation_mandelbrot on one worker process per core:
+// frames are planned from previews, handed out longest first and colorized as they come back
+
+static auto make_builder() {
+    return FractalRendererBuilder<palettes::Fire>
+        ::get_builder()
+            .set_initial_func( formulas::Zero{} )
+            .set_param_func( formulas::Identity{} )
+            .set_kernel( Kernel::Simd )
+            .set_cycle_detection( true );
+}
+
+int main() {
+    const int WIDTH = 1920;
+    const int HEIGHT = 1080;
+    const int FRAMES_COUNT = 300;
+
+    const std::string dir_name = "farm_frames";
+    fs::create_directories(dir_name);
+
+    const FractalKeyframe start { { 5, Complex::Algebraic(-0.75, 0.0) }, { 300, 2.0 }, Complex::Zero() };
+    const FractalKeyframe end { { 0.001, Complex::Algebraic(-0.74364388703, 0.13182590421) }, { 2000, 2.0 }, Complex::Zero() };
+
+    // workers are forked before the coordinator starts any threads of its own
+    RenderFarm farm([](const FarmJob& job, EscapeField& field) {
+        make_builder()
+            .set_viewport(job.key.viewport)
+            .set_max_iter(job.key.config.max_iter)
+            .build()
+            .render_field(field, job.mapping());
+    }, { static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) });
+
+    std::vector<FractalKeyframe> keyframes;
+    for (int i = 0; i < FRAMES_COUNT; ++i)
+        keyframes.push_back(interpolate(start, end, static_cast<double>(i) / (FRAMES_COUNT - 1)));
+
+    const AnimationPlan plan = plan_animation(keyframes, WIDTH, HEIGHT,
+        [](const FractalKeyframe& key, EscapeField& field) {
+            make_builder().set_viewport(key.viewport).set_max_iter(key.config.max_iter).build().render_field(field);
+        });
+
+    Bmp image = Bmp::empty(WIDTH, HEIGHT);
+
+    const FarmStats stats = farm.run(frame_jobs(plan, WIDTH, HEIGHT), [&](const FarmJob& job, const EscapeField& field) {
+        colorize(field, image, palettes::Fire {});
+        io::save(image, std::format("{}/frame_{:04}.bmp", dir_name, job.frame));
+    });
+
+    LOG_INFO("{} frames in {:.1f} seconds, {:.1f} predicted on one core", stats.jobs, stats.seconds, plan.seconds);
+
+    return 0;
+}
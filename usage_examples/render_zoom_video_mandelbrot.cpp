@@ -0,0 +1,43 @@
+#include "bmp/bmp.hpp"
+#include "bmp/io/bmp_io.hpp"
+#include "fractal/fractal_renderer_builder.hpp"
+#include "fractal/palettes.hpp"
+#include "fractal/zoom_video.hpp"
+#include "utils/logger.hpp"
+#include <filesystem>
+#include <format>
+
+using namespace iheay::bmp;
+using namespace iheay::math;
+using namespace iheay::fractal;
+
+namespace fs = std::filesystem;
+
+// the zoom of render_animation_mandelbrot straight into its end point,
+// iterated once as an exponential map strip and resampled into every frame
+
+int main() {
+    const std::string dir_name = "zoom_frames";
+    fs::create_directories(dir_name);
+
+    const Complex target = Complex::Algebraic(-0.74364388703, 0.13182590421);
+
+    const FractalKeyframe start { { 5, target }, { 300, 2.0 }, Complex::Zero() };
+    const FractalKeyframe end { { 0.001, target }, { 2000, 2.0 }, Complex::Zero() };
+
+    auto builder =
+        FractalRendererBuilder<palettes::Fire>
+            ::get_builder()
+                .set_initial_func( formulas::Zero{} )
+                .set_param_func( formulas::Identity{} )
+                .set_kernel( Kernel::Simd );
+
+    const ZoomVideoStats stats = render_zoom_video(builder, start, end, { 1920, 1080, 300 },
+        [&](int frame, const Bmp& image) {
+            io::save(image, std::format("{}/frame_{:04}.bmp", dir_name, frame));
+        });
+
+    LOG_INFO("{} frames from a {}x{} strip", stats.animation.frames, stats.strip_width, stats.strip_rows);
+
+    return 0;
+}